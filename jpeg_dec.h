@@ -1,87 +1,261 @@
 #ifndef _JPEG_DEC_H_
 #define _JPEG_DEC_H_
 
+#include <stdlib.h>
+#include <string.h>
 #include <ESP32_JPEG_Library.h>
-#include "FS.h"
+#include "esp_timer.h"
+#include "src/mem/pipeline_arena.h"
+#include "src/decode/image_source.h"
+#include "src/decode/baseline_jpeg.h"
+#include "src/trace/pipeline_trace.h"
 
-size_t getFileSize(fs::FS &fs, const char *path) {
-  File file = fs.open(path);
-  if (!file) {
-    Serial.println("- failed to open file for getting size");
-    return 0;
-  }
+/* Default per-image time budget: a floor plus an allowance per megapixel of the header, since
+   the time includes the callback (flush, resampler) and a fixed budget cut off large photos.
+   The header comes from the file, so the total is capped below the 5 s task watchdog */
+#define JPEG_DEC_DEFAULT_MAX_US (1000 * 1000)
+#define JPEG_DEC_DEFAULT_US_PER_MPIX (1000 * 1000)
+#define JPEG_DEC_DEFAULT_CEILING_US (4000 * 1000)
 
-  size_t len = file.size();
-  file.close();
-  return len;
-}
+typedef enum {
+  JPEG_DEC_BACKEND_DEFAULT = 0,  /* JPEG_DEC_BACKEND below */
+  JPEG_DEC_BACKEND_LIBRARY,      /* ESP32_JPEG_Library */
+  JPEG_DEC_BACKEND_BASELINE,     /* src/decode/baseline_jpeg.h */
+} jpeg_dec_backend_t;
 
-void readFile(fs::FS &fs, const char *path, uint8_t *buf, size_t buf_len) {
-  Serial.printf("Reading file: %s\r\n", path);
+/* Decoder used when the limits do not name one; build with -DJPEG_DEC_BACKEND=JPEG_DEC_BACKEND_BASELINE to switch */
+#ifndef JPEG_DEC_BACKEND
+#define JPEG_DEC_BACKEND JPEG_DEC_BACKEND_LIBRARY
+#endif
 
-  File file = fs.open(path);
-  if (!file || file.isDirectory()) {
-    Serial.println("- failed to open file for reading");
-    return;
-  }
+typedef enum {
+  JPEG_DEC_OK = 0,
+  JPEG_DEC_STOPPED,     /* the callback returned 0 or *cancel was set */
+  JPEG_DEC_ERR_ARG,
+  JPEG_DEC_ERR_NO_MEM,
+  JPEG_DEC_ERR_HEADER,  /* not a JPEG, or a layout the block decoder cannot handle */
+  JPEG_DEC_ERR_DATA,    /* corrupt or truncated entropy-coded data */
+  JPEG_DEC_ERR_STALL,   /* the decoder stopped producing lines */
+  JPEG_DEC_ERR_BUDGET,  /* more strips or more time than the image can need */
+  JPEG_DEC_ERR_SOURCE,  /* the image source could not hand out the image */
+} jpeg_dec_result_t;
 
-  size_t len = file.size();
-  len = len > buf_len ? buf_len : len;
-  while (len) {
-    size_t read_len = len > 512 ? 512 : len;
-    read_len = file.read(buf, read_len);
-    buf += read_len;
-    len -= read_len;
-  }
+typedef struct {
+  uint32_t max_us;        /* 0: JPEG_DEC_DEFAULT_MAX_US plus JPEG_DEC_DEFAULT_US_PER_MPIX per megapixel,
+                             at most JPEG_DEC_DEFAULT_CEILING_US */
+  uint16_t max_strips;    /* 0: the strip count the header implies, plus one */
+  volatile bool *cancel;  /* checked before every strip, may be set from another task */
+  jpeg_dec_backend_t backend; /* DEFAULT: JPEG_DEC_BACKEND */
+} jpeg_dec_limits_t;
 
-  file.close();
+typedef struct {
+  int width;
+  int height;
+  int lines;              /* lines accepted by the callback */
+  int strips;             /* jpeg_dec_process() calls */
+  uint32_t elapsed_us;
+  jpeg_error_t last_error; /* last error from the library, JPEG_ERR_OK if none */
+} jpeg_dec_report_t;
 
-  Serial.println("Read file done");
+inline const char *jpeg_dec_result_name(jpeg_dec_result_t result) {
+  switch (result) {
+    case JPEG_DEC_OK: return "ok";
+    case JPEG_DEC_STOPPED: return "stopped";
+    case JPEG_DEC_ERR_ARG: return "invalid argument";
+    case JPEG_DEC_ERR_NO_MEM: return "out of memory";
+    case JPEG_DEC_ERR_HEADER: return "bad or unsupported header";
+    case JPEG_DEC_ERR_DATA: return "corrupt data";
+    case JPEG_DEC_ERR_STALL: return "decoder stalled";
+    case JPEG_DEC_ERR_BUDGET: return "budget exceeded";
+    case JPEG_DEC_ERR_SOURCE: return "image source failed";
+  }
+  return "unknown";
+}
+
+inline const char *jpeg_dec_backend_name(jpeg_dec_backend_t backend) {
+  if (backend == JPEG_DEC_BACKEND_DEFAULT) {
+    backend = JPEG_DEC_BACKEND;
+  }
+  return backend == JPEG_DEC_BACKEND_BASELINE ? "baseline" : "library";
 }
 
-bool esp_jpeg_decoder_one_picture_block_out(unsigned char *in_buf, int in_len, int (*jpegDrawCallback)(jpeg_dec_io_t *jpeg_io, jpeg_dec_header_info_t *out_info)) {
+/*
+ * Decode one picture block by block, handing each block to jpegDrawCallback.
+ * Every library call is checked and the loop is bounded by a strip and a time
+ * budget, so a corrupt or truncated stream ends with an error code instead of
+ * spinning or writing through a NULL buffer. The decode also stops after the
+ * current block when the callback returns 0 or *limits->cancel becomes true.
+ * All resources are released before returning, whatever the outcome.
+ * limits->backend picks the ESP32_JPEG library or the in-tree decoder.
+ */
+inline jpeg_dec_result_t esp_jpeg_decoder_block_out(unsigned char *in_buf, int in_len, int (*jpegDrawCallback)(jpeg_dec_io_t *jpeg_io, jpeg_dec_header_info_t *out_info),
+                                                    const jpeg_dec_limits_t *limits = NULL, jpeg_dec_report_t *report = NULL) {
   unsigned char *output_block = NULL;
   int output_len = 0;
   jpeg_dec_io_t *jpeg_io = NULL;
   jpeg_dec_header_info_t *out_info = NULL;
   jpeg_dec_handle_t *jpeg_dec = NULL;
+  jpeg_dec_report_t local_report;
+  jpeg_dec_result_t result = JPEG_DEC_OK;
+  jpeg_error_t ret = JPEG_ERR_OK;
+  int block_lines = 0;
+  int max_strips = 0;
+  int64_t start = esp_timer_get_time();
+  uint32_t max_us = (limits != NULL && limits->max_us) ? limits->max_us : JPEG_DEC_DEFAULT_MAX_US;
+  volatile bool *cancel = limits != NULL ? limits->cancel : NULL;
+  jpeg_dec_backend_t backend = (limits != NULL && limits->backend) ? limits->backend : JPEG_DEC_BACKEND;
+  bool baseline = backend == JPEG_DEC_BACKEND_BASELINE;
+
+  if (report == NULL) {
+    report = &local_report;
+  }
+  memset(report, 0, sizeof(*report));
+  if (in_buf == NULL || in_len <= 0 || jpegDrawCallback == NULL) {
+    return JPEG_DEC_ERR_ARG;
+  }
 
   // Generate configuration
   jpeg_dec_config_t config = DEFAULT_JPEG_DEC_CONFIG();
   config.block_enable = 1;
 
-  // Create jpeg_dec
-  jpeg_dec = jpeg_dec_open(&config);
-
-  // Create io_callback handle
+  // Create jpeg_dec, io_callback and out_info handles
+  jpeg_dec = baseline ? baseline_jpeg_open(&config) : jpeg_dec_open(&config);
   jpeg_io = (jpeg_dec_io_t *)calloc(1, sizeof(jpeg_dec_io_t));
-
-  // Create out_info handle
   out_info = (jpeg_dec_header_info_t *)calloc(1, sizeof(jpeg_dec_header_info_t));
+  if (jpeg_dec == NULL || jpeg_io == NULL || out_info == NULL) {
+    result = JPEG_DEC_ERR_NO_MEM;
+    goto done;
+  }
 
   // Set input buffer and buffer len to io_callback
   jpeg_io->inbuf = in_buf;
   jpeg_io->inbuf_len = in_len;
 
   // Parse jpeg picture header and get picture for user and decoder
-  jpeg_dec_parse_header(jpeg_dec, jpeg_io, out_info);
+  PIPELINE_TRACE_BEGIN(TRACE_JPEG_HEADER, 0);
+  ret = baseline ? baseline_jpeg_parse_header(jpeg_dec, jpeg_io, out_info) : jpeg_dec_parse_header(jpeg_dec, jpeg_io, out_info);
+  PIPELINE_TRACE_END(TRACE_JPEG_HEADER, out_info->width);
+  if (ret != JPEG_ERR_OK) {
+    report->last_error = ret;
+    result = ret == JPEG_ERR_MEM ? JPEG_DEC_ERR_NO_MEM : JPEG_DEC_ERR_HEADER;
+    goto done;
+  }
+  report->width = out_info->width;
+  report->height = out_info->height;
 
-  output_len = out_info->width * (out_info->y_factory[0] << 3) * 2;
-  // Malloc output block buffer
-  output_block = (unsigned char *)jpeg_malloc_align(output_len, 16);
+  // A block is one MCU row: 8 lines per vertical sampling unit of the tallest component
+  for (int c = 0; c < out_info->component_num && c < 3; c++) {
+    if (out_info->y_factory[c] > block_lines) {
+      block_lines = out_info->y_factory[c];
+    }
+  }
+  if (out_info->width <= 0 || out_info->height <= 0 || jpeg_io->output_height <= 0 || block_lines < 1 || block_lines > 2) {
+    result = JPEG_DEC_ERR_HEADER;
+    goto done;
+  }
+  block_lines <<= 3;
+  max_strips = (limits != NULL && limits->max_strips) ? limits->max_strips : (jpeg_io->output_height + block_lines - 1) / block_lines + 1;
+  if (limits == NULL || limits->max_us == 0) {
+    uint64_t us = JPEG_DEC_DEFAULT_MAX_US + (uint64_t)out_info->width * out_info->height * JPEG_DEC_DEFAULT_US_PER_MPIX / 1000000;
+    max_us = us < JPEG_DEC_DEFAULT_CEILING_US ? (uint32_t)us : JPEG_DEC_DEFAULT_CEILING_US;
+  }
 
+  output_len = out_info->width * block_lines * 2;
+  // Malloc output block buffer
+  output_block = (unsigned char *)pipeline_malloc_align(output_len, ARENA_INTERNAL);
+  if (output_block == NULL) {
+    result = JPEG_DEC_ERR_NO_MEM;
+    goto done;
+  }
   jpeg_io->outbuf = output_block;
 
   while (jpeg_io->output_line < jpeg_io->output_height) {
-    jpeg_dec_process(jpeg_dec, jpeg_io);
-    jpegDrawCallback(jpeg_io, out_info);
+    if (cancel != NULL && *cancel) {
+      result = JPEG_DEC_STOPPED;
+      break;
+    }
+    if (report->strips >= max_strips || (uint32_t)(esp_timer_get_time() - start) > max_us) {
+      result = JPEG_DEC_ERR_BUDGET;
+      break;
+    }
+
+    int before = jpeg_io->output_line;
+    PIPELINE_TRACE_BEGIN(TRACE_JPEG_PROCESS, report->strips);
+    ret = baseline ? baseline_jpeg_process(jpeg_dec, jpeg_io) : jpeg_dec_process(jpeg_dec, jpeg_io);
+    PIPELINE_TRACE_END(TRACE_JPEG_PROCESS, report->strips);
+    report->strips++;
+    if (ret != JPEG_ERR_OK) {
+      report->last_error = ret;
+      result = ret == JPEG_ERR_MEM ? JPEG_DEC_ERR_NO_MEM : JPEG_DEC_ERR_DATA;
+      break;
+    }
+    // No progress, or more lines than the block buffer holds
+    if (jpeg_io->output_line <= before || jpeg_io->cur_line <= 0 || jpeg_io->cur_line > block_lines) {
+      result = JPEG_DEC_ERR_STALL;
+      break;
+    }
+
+    PIPELINE_TRACE_BEGIN(TRACE_JPEG_CALLBACK, jpeg_io->cur_line);
+    int accepted = jpegDrawCallback(jpeg_io, out_info);
+    PIPELINE_TRACE_END(TRACE_JPEG_CALLBACK, jpeg_io->cur_line);
+    if (!accepted) {
+      result = JPEG_DEC_STOPPED;
+      break;
+    }
+    report->lines += jpeg_io->cur_line;
   }
 
-  jpeg_dec_close(jpeg_dec);
+done:
+  if (jpeg_dec != NULL) {
+    if (baseline) {
+      baseline_jpeg_close(jpeg_dec);
+    } else {
+      jpeg_dec_close(jpeg_dec);
+    }
+  }
   free(jpeg_io);
   free(out_info);
-  jpeg_free_align(output_block);
-  return true;
+  pipeline_free_align(output_block);
+  report->elapsed_us = (uint32_t)(esp_timer_get_time() - start);
+  return result;
+}
+
+/*
+ * Decode straight from an image source: the span it hands out goes to the
+ * library as it is, so mapped flash and mmap()ed files are read in place.
+ * The source is released before returning.
+ */
+inline jpeg_dec_result_t esp_jpeg_decoder_block_out(image_source &source, int (*jpegDrawCallback)(jpeg_dec_io_t *jpeg_io, jpeg_dec_header_info_t *out_info),
+                                                    const jpeg_dec_limits_t *limits = NULL, jpeg_dec_report_t *report = NULL) {
+  const uint8_t *data = NULL;
+  size_t len = 0;
+  image_source_err_t err = source.acquire(&data, &len);
+  if (err != IMAGE_SOURCE_OK) {
+    if (report != NULL) {
+      memset(report, 0, sizeof(*report));
+    }
+    return err == IMAGE_SOURCE_ERR_NO_MEM ? JPEG_DEC_ERR_NO_MEM : JPEG_DEC_ERR_SOURCE;
+  }
+  /* The library only reads its input; inbuf is not const in its API */
+  jpeg_dec_result_t result = esp_jpeg_decoder_block_out((unsigned char *)data, (int)len, jpegDrawCallback, limits, report);
+  source.release();
+  return result;
+}
+
+/*
+ * Convenience wrapper: returns true only when the whole picture went through.
+ * lines_out receives the lines accepted by the callback.
+ */
+inline bool esp_jpeg_decoder_one_picture_block_out(unsigned char *in_buf, int in_len, int (*jpegDrawCallback)(jpeg_dec_io_t *jpeg_io, jpeg_dec_header_info_t *out_info),
+                                                   volatile bool *cancel = NULL, int *lines_out = NULL) {
+  jpeg_dec_limits_t limits = {};
+  jpeg_dec_report_t report;
+  limits.cancel = cancel;
+  jpeg_dec_result_t result = esp_jpeg_decoder_block_out(in_buf, in_len, jpegDrawCallback, &limits, &report);
+  if (lines_out != NULL) {
+    *lines_out = report.lines;
+  }
+  return result == JPEG_DEC_OK;
 }
 
-#endif  // _JPEG_DEC_H_
\ No newline at end of file
+#endif  // _JPEG_DEC_H_
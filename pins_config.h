@@ -11,6 +11,7 @@
 #define TFT_QSPI_D3 39
 #define TFT_QSPI_RST -1
 #define TFT_TE 0
+#define TFT2_QSPI_CS -1 /* second panel on the same QSPI bus, -1 if not fitted */
 #define TFT_BL 1
 
 #define TP_I2C_SDA 8
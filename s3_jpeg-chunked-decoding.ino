@@ -1,25 +1,313 @@
 #include "SD_MMC.h"
+#include "esp_heap_caps.h"
 #include "jpeg_dec.h"
 #include "pins_config.h"
 #include "src/lcd/nv3041a_lcd.h"
+#include "src/lcd/te_sync.h"
+#include "src/lcd/panel_scheduler.h"
+#include "src/touch/gt911_touch.h"
+#include "src/sd/sd_loader.h"
+#include "src/sd/sd_image_source.h"
+#include "src/sd/sd_avi_reader.h"
+#include "src/mem/pipeline_arena.h"
+#include "src/asset/rgb565_asset.h"
+#include "src/decode/async_decoder.h"
+#include "src/gallery/transition.h"
+#include "src/gallery/thumb_grid.h"
+#include "src/gallery/swipe_prefetch.h"
+#include "src/gallery/media_catalog.h"
+#include "src/gfx/strip_renderer.h"
+#include "src/gfx/strip_scaler.h"
+#include "src/gfx/strip_blitter.h"
+#include "src/video/avi_player.h"
+#include "src/audio/i2s_audio_sink.h"
+#include "src/trace/pipeline_trace.h"
 nv3041a_lcd lcd = nv3041a_lcd(TFT_QSPI_CS, TFT_QSPI_SCK, TFT_QSPI_D0, TFT_QSPI_D1, TFT_QSPI_D2, TFT_QSPI_D3, TFT_QSPI_RST);
+nv3041a_lcd lcd2 = nv3041a_lcd(TFT2_QSPI_CS, TFT_QSPI_SCK, TFT_QSPI_D0, TFT_QSPI_D1, TFT_QSPI_D2, TFT_QSPI_D3, TFT_QSPI_RST);
+te_sync panel_te = te_sync(LCD_V_RES);
+panel_scheduler bus_sched;
+async_decoder decoder = async_decoder(lcd, 2);
+strip_renderer overlay = strip_renderer(LCD_V_RES);
+int overlay_clock = -1;
+strip_scaler fit_scaler = strip_scaler(LCD_H_RES, LCD_V_RES);
+strip_blitter blitter = strip_blitter(LCD_H_RES, LCD_V_RES);
+blit_rotate_t blit_rot = BLIT_ROT_0;
+blit_scale_t blit_scale = BLIT_SCALE_1;
+transition fade = transition(lcd);
+thumb_cache thumbs = thumb_cache(SD_MMC, "/.thumbs.bin", 110, 84); /* 4 x 3 cells on the panel */
+thumb_grid grid = thumb_grid(SD_MMC, lcd, thumbs);
+i2s_audio_sink speaker = i2s_audio_sink(I2S_BCLK, I2S_LRC, I2S_DOUT);
+gt911_touch touch = gt911_touch(TP_I2C_SDA, TP_I2C_SCL, TP_RST, TP_INT);
+
+/* Drag demo in loop(): the test image follows the finger */
+uint8_t *drag_jpeg = NULL;
+size_t drag_jpeg_size = 0;
+int16_t drag_x = 0, drag_y = 0;           // image origin on the panel
+int16_t drag_grab_x = 0, drag_grab_y = 0; // finger minus origin at touch-down
+bool dragging = false;
+
+/* Swipe gallery in loop() over the grid's images: the neighbour in the drag direction decodes while the finger moves */
+swipe_prefetch *swipe = NULL;
+std::vector<const char *> swipe_paths;
+sd_loader swipe_loader = sd_loader(SD_MMC);
+int swipe_index = 0;
+int swipe_dir = 0; // 1: next image, -1: previous, 0: not yet decided
+uint16_t swipe_start_x = 0, swipe_last_x = 0;
 
 #define TEST_NUM 10
 #define TEST_IMAGE_FILE_PATH "/img_480_272.jpg"
 #define TEST_IMAGE_WIDTH (480)
 #define TEST_IMAGE_HEIGHT (272)
+#define TEST_IMAGE_PARTITION "assets" /* data partition with a JPEG written at offset 0, optional */
+#define TEST_ASSET_FILE_PATH "/img_480_272.r565" /* made with tools/rgb565_pack, optional */
+#define TEST_IMAGE2_FILE_PATH "/img2_480_272.jpg" /* second image for the transition test, optional */
+#define TRANSITION_MS 500
+#define TRANSITION_FPS 30
+#define GRID_DIR "/gallery" /* JPEGs for the thumbnail grid, optional */
+#define CATALOG_FILE_PATH "/.catalog.bin" /* index of GRID_DIR, rebuilt when missing */
+#define PREVIEW_FILE_PATH "/camera.jpg" /* camera JPEG with an EXIF preview, optional */
+#define VIDEO_FILE_PATH "/video.avi" /* Motion JPEG AVI, PCM audio optional; tools/avi_play --gen makes one */
+#define VIDEO_TEST_MS 10000 /* then a seek back to the start */
+#define DUAL_TEST_MS 3000 /* both panels decoding at once, needs TFT2_QSPI_CS */
+#define SOAK_TEST_NUM 0 /* e.g. 100000 to check that the heap stays flat; tools/arena_soak runs the same check on the host */
+#define FIT_MODE SCALE_FIT /* images that are not 480x272: letterbox (SCALE_FIT) or crop (SCALE_COVER) */
+#define FIT_FILTER SCALE_AREA /* SCALE_NEAREST for video */
+#define SWIPE_START_PX 16 /* horizontal travel that picks the neighbour to decode */
+#define SWIPE_COMMIT_PX 120 /* travel at release that moves to it */
+
+static int scaledStripCallback(void *ctx, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t *pixels) {
+  overlay.render(pixels, x, y, w, h);
+  lcd.draw16bitbergbbitmap(x, y, w, h, pixels);
+  return 1;
+}
 
 //jpeg绘制回调
 static int jpegDrawCallback(jpeg_dec_io_t *jpeg_io, jpeg_dec_header_info_t *out_info) {
-  lcd.draw16bitbergbbitmap(0, jpeg_io->output_line - jpeg_io->cur_line, out_info->width, jpeg_io->cur_line, (uint16_t *)jpeg_io->outbuf);
+  uint16_t y = jpeg_io->output_line - jpeg_io->cur_line;
+  if (out_info->width != LCD_H_RES || out_info->height != LCD_V_RES) {
+    /* Other sizes go through the resampler, which hands back panel-sized strips */
+    if (y == 0) {
+      uint16_t ax, ay, aw, ah;
+      if (!fit_scaler.start(out_info->width, out_info->height, FIT_MODE, FIT_FILTER, scaledStripCallback, NULL)) {
+        return 0;
+      }
+      fit_scaler.area(&ax, &ay, &aw, &ah);
+      lcd.fillRect(0, 0, LCD_H_RES, ay, 0x0000);
+      lcd.fillRect(0, ay + ah, LCD_H_RES, LCD_V_RES - ay - ah, 0x0000);
+      lcd.fillRect(0, ay, ax, ah, 0x0000);
+      lcd.fillRect(ax + aw, ay, LCD_H_RES - ax - aw, ah, 0x0000);
+    }
+    return fit_scaler.push((uint16_t *)jpeg_io->outbuf, y, jpeg_io->cur_line) ? 1 : 0;
+  }
+  /* UI is drawn into the strip itself, before it goes to the panel */
+  overlay.render((uint16_t *)jpeg_io->outbuf, 0, y, out_info->width, jpeg_io->cur_line);
+  lcd.draw16bitbergbbitmap(0, y, out_info->width, jpeg_io->cur_line, (uint16_t *)jpeg_io->outbuf);
+  return 1;
+}
+
+static int blitStripCallback(void *ctx, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t *pixels) {
+  lcd.draw16bitbergbbitmap(x, y, w, h, pixels);
+  return 1;
+}
+
+/* Rotated and scaled by blit_rot and blit_scale, centred on the panel */
+static int jpegBlitCallback(jpeg_dec_io_t *jpeg_io, jpeg_dec_header_info_t *out_info) {
+  uint16_t y = jpeg_io->output_line - jpeg_io->cur_line;
+  if (y == 0) {
+    uint16_t w, h;
+    strip_blitter::outputSize(out_info->width, out_info->height, blit_rot, blit_scale, &w, &h);
+    if (!blitter.start(out_info->width, out_info->height, BLIT_SRC_RGB565_BE, BLIT_DST_RGB565_BE, blit_rot, blit_scale,
+                       (LCD_H_RES - w) / 2, (LCD_V_RES - h) / 2, blitStripCallback, NULL)) {
+      return 0;
+    }
+  }
+  return blitter.push(jpeg_io->outbuf, y, jpeg_io->cur_line) ? 1 : 0;
+}
+
+static int jpegDragCallback(jpeg_dec_io_t *jpeg_io, jpeg_dec_header_info_t *out_info) {
+  uint16_t y = jpeg_io->output_line - jpeg_io->cur_line;
+  if (y == 0 && !blitter.start(out_info->width, out_info->height, BLIT_SRC_RGB565_BE, BLIT_DST_RGB565_BE, BLIT_ROT_0,
+                               BLIT_SCALE_1, drag_x, drag_y, blitStripCallback, NULL)) {
+    return 0;
+  }
+  return blitter.push(jpeg_io->outbuf, y, jpeg_io->cur_line) ? 1 : 0;
+}
+
+/* fillRect() clipped to the panel */
+static void fillClipped(int x, int y, int w, int h, uint16_t color) {
+  int x1 = x + w < LCD_H_RES ? x + w : LCD_H_RES, y1 = y + h < LCD_V_RES ? y + h : LCD_V_RES;
+  x = x < 0 ? 0 : x;
+  y = y < 0 ? 0 : y;
+  if (x < x1 && y < y1) {
+    lcd.fillRect(x, y, x1 - x, y1 - y, color);
+  }
+}
+
+/* Same crop as the swipe_prefetch frames: the top-left of the image, black where it is smaller than the panel */
+static int jpegCropCallback(jpeg_dec_io_t *jpeg_io, jpeg_dec_header_info_t *out_info) {
+  uint16_t y = jpeg_io->output_line - jpeg_io->cur_line;
+  if (y >= LCD_V_RES) {
+    return 0; /* the rest is off the panel */
+  }
+  uint16_t w = out_info->width < LCD_H_RES ? out_info->width : LCD_H_RES;
+  uint16_t h = y + jpeg_io->cur_line <= LCD_V_RES ? jpeg_io->cur_line : LCD_V_RES - y;
+  if (y == 0 && (out_info->width < LCD_H_RES || out_info->height < LCD_V_RES)) {
+    lcd.fillScreen(0x0000);
+  }
+  uint16_t *src = (uint16_t *)jpeg_io->outbuf;
+  if (w == out_info->width) {
+    lcd.draw16bitbergbbitmap(0, y, w, h, src);
+  } else {
+    for (uint16_t row = 0; row < h; row++) {
+      lcd.draw16bitbergbbitmap(0, y + row, w, 1, src + row * out_info->width);
+    }
+  }
+  return 1;
+}
+
+/* A swipe the prefetcher had not decoded: read and decode it now */
+static void showGalleryImage(int index) {
+  uint8_t *jpeg = NULL;
+  size_t len = 0;
+  sd_load_err_t err = swipe_loader.load(swipe_paths[index], &jpeg, &len);
+  if (err != SD_LOAD_OK) {
+    Serial.printf("%s: %s\n", swipe_paths[index], sd_loader::errName(err));
+    lcd.fillScreen(0x0000);
+    return;
+  }
+  esp_jpeg_decoder_block_out(jpeg, len, jpegCropCallback);
+  pipeline_free_align(jpeg);
+  lcd.flush();
+}
+
+static void swipeLoop() {
+  uint16_t x, y;
+  if (!touch.getTouch(&x, &y)) {
+    if (dragging) {
+      /* Finger up: far enough and still heading the way of the decode in flight, that neighbour comes in */
+      int dx = swipe_last_x - swipe_start_x;
+      int dir = dx < 0 ? 1 : -1;
+      if (swipe_dir != 0 && abs(dx) >= SWIPE_COMMIT_PX && dir == swipe_dir) {
+        int next = swipe->neighbour(swipe_index, swipe_dir);
+        if (!swipe->complete(next, lcd)) {
+          showGalleryImage(next);
+        }
+        swipe_index = next;
+        swipe_prefetch_stats_t ss = swipe->stats();
+        Serial.printf("Swipe to %d: %u hits, %u misses, %u cancelled, %u failed, longest cancel %u us\n", swipe_index,
+                      ss.hits, ss.misses, ss.cancelled, ss.failed, ss.max_cancel_us);
+      } else if (swipe_dir != 0) {
+        swipe->cancel();
+      }
+      dragging = false;
+      swipe_dir = 0;
+    }
+    delay(10);
+    return;
+  }
+  if (!dragging) {
+    dragging = true;
+    swipe_start_x = swipe_last_x = x;
+    return;
+  }
+  swipe_last_x = x;
+  int dx = x - swipe_start_x;
+  if (abs(dx) >= SWIPE_START_PX) {
+    /* Finger moving left brings in the next image; back past the start switches the decode to the other side */
+    int dir = dx < 0 ? 1 : -1;
+    if (swipe_dir == 0) {
+      swipe->dragBegin(swipe_index, dir);
+    } else {
+      swipe->dragUpdate(swipe_index, dir);
+    }
+    swipe_dir = dir;
+  }
+  delay(5);
+}
+
+static int jpegDrawCallback2(jpeg_dec_io_t *jpeg_io, jpeg_dec_header_info_t *out_info) {
+  lcd2.draw16bitbergbbitmap(0, jpeg_io->output_line - jpeg_io->cur_line, out_info->width, jpeg_io->cur_line, (uint16_t *)jpeg_io->outbuf);
   return 1;
 }
 
+#if PIPELINE_TRACE
+static size_t traceWrite(const uint8_t *data, size_t len, void *ctx) {
+  return Serial.write(data, len);
+}
+#endif
+
+typedef struct {
+  uint8_t *jpeg;
+  size_t len;
+  uint32_t images;
+  SemaphoreHandle_t done;
+} dual_test_t;
+
+static void panel2Task(void *arg) {
+  dual_test_t *test = (dual_test_t *)arg;
+  uint32_t t = millis();
+  while (millis() - t < DUAL_TEST_MS) {
+    esp_jpeg_decoder_one_picture_block_out(test->jpeg, test->len, jpegDrawCallback2);
+    test->images++;
+  }
+  xSemaphoreGive(test->done);
+  vTaskDelete(NULL);
+}
+
 void setup() {
   Serial.begin(115200); /* prepare for possible serial debug */
   Serial.println("Hello Arduino!");
 
+  /* Reserve all pipeline buffers up front so the heap cannot fragment later; sizes in src/mem/pipeline_arena.h */
+  if (!pipeline_mem.begin(ARENA_INTERNAL_SIZE, ARENA_PSRAM_SIZE)) {
+    Serial.println("Pipeline arena reservation failed");
+  }
+
   lcd.begin();
+  touch.begin();
+
+  /* Fill rate against the bus limit: 32 MHz QSPI moves 4 bits per clock, 16 MB/s */
+  const char *fill_names[] = { "solid", "checker", "gradient" };
+  for (int k = 0; k < 3; k++) {
+    uint32_t us = micros();
+    for (int i = 0; i < TEST_NUM; i++) {
+      uint16_t c = (i & 1) ? 0xF800 : 0x001F;
+      if (k == 0) {
+        lcd.fillScreen(c);
+      } else if (k == 1) {
+        lcd.fillPattern(0, 0, LCD_H_RES, LCD_V_RES, c, 0xFFFF, LCD_PATTERN_CHECKER, 4);
+      } else {
+        lcd.fillGradient(0, 0, LCD_H_RES, LCD_V_RES, c, 0xFFFF);
+      }
+    }
+    lcd.flush();
+    us = micros() - us;
+    uint64_t bytes_per_sec = (uint64_t)TEST_NUM * LCD_H_RES * LCD_V_RES * 2 * 1000000 / us;
+    Serial.printf("Fill %s: %u us per screen, %u KB/s, %u%% of bus\n", fill_names[k], us / TEST_NUM,
+                  (unsigned)(bytes_per_sec / 1024), (unsigned)(bytes_per_sec / 160000));
+  }
+  /* Pace strip writes to the TE signal so an image lands in one scan pass while decode keeps up */
+  if (panel_te.begin(TFT_TE)) {
+    lcd.setTeSync(&panel_te);
+  }
+  /* A second panel shares the bus; strips of both are interleaved fairly */
+  if (TFT2_QSPI_CS >= 0) {
+    lcd2.begin();
+    lcd.setScheduler(&bus_sched);
+    lcd2.setScheduler(&bus_sched);
+  }
+
+  if (!fit_scaler.begin()) {
+    Serial.println("Resampler buffers failed, only 480x272 images will show");
+  }
+
+  /* Caption bar over the photo: translucent panel, clock and file name */
+  if (overlay.begin()) {
+    overlay.fillRoundRect(8, LCD_V_RES - 72, LCD_H_RES - 16, 64, 10, 0x0000, 140);
+    overlay_clock = overlay.drawText(20, LCD_V_RES - 68, "00:00", &font_lato_48_digits, 0xFFFF);
+    overlay.drawText(180, LCD_V_RES - 56, TEST_IMAGE_FILE_PATH + 1, &font_lato_20, 0xFFE0);
+    overlay.drawLine(180, LCD_V_RES - 28, LCD_H_RES - 24, LCD_V_RES - 28, 0xFFFF, 1, 128);
+  }
 
   pinMode(TFT_BL, OUTPUT);
   digitalWrite(TFT_BL, HIGH);
@@ -32,24 +320,428 @@ void setup() {
     return;
   }
 
-  uint8_t *image_jpeg = NULL;
-  size_t image_jpeg_size = getFileSize(SD_MMC, TEST_IMAGE_FILE_PATH);
+#if PIPELINE_TRACE
+  /* Timeline of the SD load and the decode benchmark, dumped for tools/trace_json when that ends */
+  if (pipeline_tracer.begin()) {
+    pipeline_tracer.setEnabled(true);
+  }
+#endif
+
   /* The buffer used by JPEG decoder must be 16-byte aligned */
-  image_jpeg = (unsigned char *)jpeg_malloc_align(image_jpeg_size, 16);
-  if (image_jpeg == NULL) {
-    Serial.println("Image memory allocation failed");
+  uint8_t *image_jpeg = NULL;
+  size_t image_jpeg_size = 0;
+  sd_loader loader(SD_MMC);
+  sd_load_err_t err = loader.load(TEST_IMAGE_FILE_PATH, &image_jpeg, &image_jpeg_size);
+  if (err != SD_LOAD_OK) {
+    Serial.printf("Image load failed: %s\n", sd_loader::errName(err));
     return;
   }
-  readFile(SD_MMC, TEST_IMAGE_FILE_PATH, image_jpeg, image_jpeg_size);
+  sd_load_stats_t load_stats = loader.lastStats();
+  Serial.printf("Read %u bytes in %u us (open %u us, %u reads), %u KB/s, %u.%u%% of bus\n",
+                (unsigned)load_stats.bytes, load_stats.read_us, load_stats.open_us, load_stats.reads,
+                load_stats.bytes_per_sec / 1024, load_stats.bus_permille / 10, load_stats.bus_permille % 10);
 
   jpeg_error_t ret = JPEG_ERR_OK;
+  /* A corrupt test image fails fast here instead of hanging the benchmark */
+  jpeg_dec_report_t report;
+  jpeg_dec_result_t result = esp_jpeg_decoder_block_out(image_jpeg, image_jpeg_size, jpegDrawCallback, NULL, &report);
+  if (result != JPEG_DEC_OK) {
+    Serial.printf("JPEG decode failed: %s after %d of %d lines (%d strips, %u us, library error %d)\n",
+                  jpeg_dec_result_name(result), report.lines, report.height, report.strips, report.elapsed_us, report.last_error);
+    pipeline_free_align(image_jpeg);
+    return;
+  }
+  overlay.resetStats();
+  fit_scaler.resetStats();
   uint32_t t = millis();
   for (int i = 0; i < TEST_NUM; i++) {
+    char clock[8];
+    snprintf(clock, sizeof(clock), "%02u:%02u", (unsigned)(millis() / 60000 % 60), (unsigned)(millis() / 1000 % 60));
+    overlay.setText(overlay_clock, clock);
+    panel_te.beginFrame();
     esp_jpeg_decoder_one_picture_block_out(image_jpeg, image_jpeg_size, jpegDrawCallback);
   }
   Serial.printf("JPEG decode %d images, average time is %d ms\n", TEST_NUM, (millis() - t) / TEST_NUM);
-  jpeg_free_align(image_jpeg);
+  strip_scale_stats_t sc = fit_scaler.stats();
+  if (sc.frames > 0) {
+    Serial.printf("Resampled %u images, %u.%u MP/s of source, %u of %u rows filtered\n", sc.frames,
+                  (unsigned)(sc.src_pixels / (sc.scale_us + 1)), (unsigned)(sc.src_pixels * 10 / (sc.scale_us + 1) % 10),
+                  sc.hpass_rows, sc.src_rows);
+  }
+  strip_render_stats_t ov = overlay.stats();
+  Serial.printf("Overlay %u us per image, %u of %u item/strip pairs skipped, %u spans, %u pixels\n",
+                (unsigned)(ov.render_us / TEST_NUM), ov.items_skipped, ov.items_skipped + ov.items_drawn,
+                ov.spans, (unsigned)ov.pixels);
+  te_stats_t te = panel_te.stats();
+  Serial.printf("TE period %u us (%u..%u, jitter %u), %u strips, %u delayed for %u us, %u late, %u unsafe, %u missed edges\n",
+                te.period_us, te.period_min_us, te.period_max_us, te.jitter_us, te.strips, te.delayed, (unsigned)te.wait_us,
+                te.late, te.unsafe, te.missed);
+#if PIPELINE_TRACE
+  trace_stats_t ts = pipeline_tracer.stats();
+  if (ts.capacity > 0) {
+    /* Recording cost against the time it covers */
+    uint32_t overhead_permille = ts.span_us ? (uint64_t)(ts.recorded - ts.overwritten) * ts.record_ns / ts.span_us : 0;
+    Serial.printf("Trace %u events over %u ms (%u overwritten), %u ns each, %u.%u%% overhead, binary dump follows\n",
+                  ts.recorded, ts.span_us / 1000, ts.overwritten, ts.record_ns, overhead_permille / 10, overhead_permille % 10);
+    Serial.flush();
+    pipeline_tracer.dump(traceWrite, NULL);
+    Serial.flush();
+    Serial.println("\nTrace dump end");
+  }
+#endif
+
+  /* The same image through each decoder behind jpeg_dec.h */
+  const jpeg_dec_backend_t backends[] = { JPEG_DEC_BACKEND_LIBRARY, JPEG_DEC_BACKEND_BASELINE };
+  for (jpeg_dec_backend_t backend : backends) {
+    jpeg_dec_limits_t limits = {};
+    limits.backend = backend;
+    int decoded = 0;
+    t = millis();
+    while (decoded < TEST_NUM) {
+      panel_te.beginFrame();
+      result = esp_jpeg_decoder_block_out(image_jpeg, image_jpeg_size, jpegDrawCallback, &limits, &report);
+      if (result != JPEG_DEC_OK) {
+        break;
+      }
+      decoded++;
+    }
+    if (decoded < TEST_NUM) {
+      Serial.printf("JPEG decode (%s) failed: %s\n", jpeg_dec_backend_name(backend), jpeg_dec_result_name(result));
+    } else {
+      Serial.printf("JPEG decode (%s) %d images, average time is %d ms\n", jpeg_dec_backend_name(backend), TEST_NUM,
+                    (millis() - t) / TEST_NUM);
+    }
+  }
+
+  /* Rotation and downscale on the way to the panel: one specialised loop per case against deciding per pixel */
+  if (blitter.begin()) {
+    uint64_t fast_px = 0, fast_us = 0, slow_px = 0, slow_us = 0;
+    for (int r = 0; r < BLIT_ROT_MAX; r++) {
+      for (int k = 0; k < BLIT_SCALE_MAX; k++) {
+        uint32_t mps_x10[2];
+        for (int g = 0; g < 2; g++) {
+          blit_rot = (blit_rotate_t)r;
+          blit_scale = (blit_scale_t)k;
+          blitter.setGeneric(g == 1);
+          blitter.resetStats();
+          lcd.fillRect(0, 0, LCD_H_RES, LCD_V_RES, 0x0000);
+          for (int i = 0; i < TEST_NUM; i++) {
+            esp_jpeg_decoder_one_picture_block_out(image_jpeg, image_jpeg_size, jpegBlitCallback);
+          }
+          strip_blit_stats_t bs = blitter.stats();
+          mps_x10[g] = bs.out_pixels * 10 / (bs.blit_us + 1);
+          (g ? slow_px : fast_px) += bs.out_pixels;
+          (g ? slow_us : fast_us) += bs.blit_us;
+        }
+        Serial.printf("Blit 565be rotated %d scaled 1/%d: %u.%u MP/s specialised, %u.%u MP/s generic\n", r * 90, 1 << k,
+                      mps_x10[0] / 10, mps_x10[0] % 10, mps_x10[1] / 10, mps_x10[1] % 10);
+      }
+    }
+    uint32_t fast_x10 = fast_px * 10 / (fast_us + 1), slow_x10 = slow_px * 10 / (slow_us + 1);
+    Serial.printf("Blit overall %u.%u MP/s specialised, %u.%u MP/s generic, %u.%ux\n", fast_x10 / 10, fast_x10 % 10,
+                  slow_x10 / 10, slow_x10 % 10, fast_x10 * 10 / (slow_x10 + 1) / 10, fast_x10 * 10 / (slow_x10 + 1) % 10);
+    blitter.end();
+  } else {
+    Serial.println("Blitter buffers failed, rotation benchmark skipped");
+  }
+
+  /* The same decode fed by each image source: SD reads the file in, flash is mapped and read in place */
+  sd_image_source sd_source(loader, TEST_IMAGE_FILE_PATH);
+  flash_image_source flash_source(TEST_IMAGE_PARTITION);
+  image_source *sources[] = { &sd_source, &flash_source };
+  for (image_source *source : sources) {
+    int decoded = 0;
+    t = millis();
+    while (decoded < TEST_NUM) {
+      panel_te.beginFrame();
+      if (esp_jpeg_decoder_block_out(*source, jpegDrawCallback) != JPEG_DEC_OK) {
+        break;
+      }
+      decoded++;
+    }
+    image_source_stats_t ss = source->stats();
+    if (decoded > 0) {
+      Serial.printf("Source %s: %d images, %d ms each, %u us of it to get %u bytes, %u bytes copied\n", source->name(), decoded,
+                    (millis() - t) / decoded, ss.acquire_us, (unsigned)ss.bytes, (unsigned)ss.copied);
+    }
+  }
+
+  /* Same images through the async decoder; the main loop stays free while they decode */
+  if (decoder.begin()) {
+    decode_job_desc_t job = {};
+    job.data = image_jpeg;
+    job.len = image_jpeg_size;
+    int submitted = 0;
+    uint32_t idle_loops = 0;
+    t = millis();
+    while (submitted < TEST_NUM || decoder.pending() > 0) {
+      if (submitted < TEST_NUM && decoder.submit(job) != DECODE_JOB_NONE) {
+        submitted++;
+      }
+      idle_loops++;
+      delay(1);
+    }
+    async_decode_stats_t as = decoder.stats();
+    Serial.printf("Async decode %d images in %d ms, %u main loop passes meanwhile, %u rejected while full, avg queue wait %u us\n",
+                  TEST_NUM, millis() - t, idle_loops, as.rejected, (unsigned)(as.total_wait_us / TEST_NUM));
+  }
+
+  uint8_t *asset_data = NULL;
+  size_t asset_size = 0;
+  rgb565_asset asset;
+  if (loader.load(TEST_ASSET_FILE_PATH, &asset_data, &asset_size) == SD_LOAD_OK && asset.open(asset_data, asset_size)) {
+    t = millis();
+    for (int i = 0; i < TEST_NUM; i++) {
+      asset.draw(lcd, 0, 0);
+    }
+    Serial.printf("R565 draw %d images, average time is %d ms, %u bytes vs %u bytes JPEG\n", TEST_NUM, (millis() - t) / TEST_NUM,
+                  (unsigned)asset_size, (unsigned)image_jpeg_size);
+  }
+  pipeline_free_align(asset_data);
+
+  /* Transitions between two images, composed strip by strip from PSRAM frames */
+  uint8_t *image2_jpeg = NULL;
+  size_t image2_jpeg_size = 0;
+  bool have_image2 = loader.load(TEST_IMAGE2_FILE_PATH, &image2_jpeg, &image2_jpeg_size) == SD_LOAD_OK;
+  if (have_image2 && !fade.begin()) {
+    Serial.println("Transition buffers failed, transitions skipped");
+  } else if (have_image2) {
+    const char *kinds[] = { "crossfade", "slide left", "slide right", "wipe down", "wipe right" };
+    /* Start from what is on screen now */
+    fade.load(image_jpeg, image_jpeg_size);
+    fade.run(TRANSITION_CUT);
+    for (int k = 0; k < 5; k++) {
+      fade.resetStats();
+      fade.load(k & 1 ? image_jpeg : image2_jpeg, k & 1 ? image_jpeg_size : image2_jpeg_size);
+      fade.run((transition_kind_t)(TRANSITION_CROSSFADE + k), TRANSITION_MS, TRANSITION_FPS);
+      transition_stats_t ts = fade.stats();
+      Serial.printf("Transition %s: %u steps in %u ms, %u.%u fps (target %d), %u late, %u strips sent, %u skipped, %u KB, compose %u us\n",
+                    kinds[k], ts.steps, ts.last_ms, ts.last_fps_x10 / 10, ts.last_fps_x10 % 10, TRANSITION_FPS, ts.late_steps,
+                    ts.strips_sent, ts.strips_skipped, (unsigned)(ts.bytes / 1024), (unsigned)ts.compose_us);
+    }
+    fade.end();
+  }
+  pipeline_free_align(image2_jpeg);
+
+  /* Embedded preview of a camera file: the first few KB and a small decode instead of the whole image */
+  uint8_t *preview_jpeg = NULL;
+  size_t preview_jpeg_size = 0;
+  jpeg_thumb_info_t preview;
+  int64_t preview_us = esp_timer_get_time();
+  err = loader.loadThumbnail(PREVIEW_FILE_PATH, &preview_jpeg, &preview_jpeg_size, &preview);
+  if (err == SD_LOAD_OK) {
+    size_t preview_read = loader.lastStats().bytes;
+    esp_jpeg_decoder_one_picture_block_out(preview_jpeg, preview_jpeg_size, jpegDrawCallback);
+    preview_us = esp_timer_get_time() - preview_us;
+    pipeline_free_align(preview_jpeg);
+    int64_t full_us = esp_timer_get_time();
+    if (loader.load(PREVIEW_FILE_PATH, &preview_jpeg, &preview_jpeg_size) == SD_LOAD_OK) {
+      esp_jpeg_decoder_one_picture_block_out(preview_jpeg, preview_jpeg_size, jpegDrawCallback);
+    }
+    full_us = esp_timer_get_time() - full_us;
+    Serial.printf("Preview %ux%u (%s): %u of %u bytes read, on screen in %u ms vs %u ms for the whole image\n",
+                  preview.width, preview.height, preview.source == JPEG_THUMB_EXIF ? "EXIF" : "JFXX", (unsigned)preview_read,
+                  (unsigned)preview_jpeg_size, (unsigned)(preview_us / 1000), (unsigned)(full_us / 1000));
+  } else if (err != SD_LOAD_ERR_OPEN) {
+    Serial.printf("Preview: %s, the image has to be decoded and scaled\n", sd_loader::errName(err));
+  }
+  pipeline_free_align(preview_jpeg);
+
+  /* Media catalog: a boot with the index against listing the folder and reading every header */
+  media_catalog catalog(SD_MMC, CATALOG_FILE_PATH);
+  bool indexed = catalog.load(GRID_DIR);
+  uint32_t load_us = catalog.stats().load_us;
+  catalog.refresh(GRID_DIR);
+  media_catalog_stats_t ms = catalog.stats();
+  Serial.printf("Catalog %d files in %u dirs: index %s in %u us, %s %u ms (listing %u ms, %u headers read in %u ms, %u KB)\n",
+                catalog.count(), ms.dirs, indexed ? "loaded" : "missing", load_us, indexed ? "rescan" : "build",
+                (ms.list_us + ms.probe_us) / 1000, ms.list_us / 1000, ms.probed, ms.probe_us / 1000, (unsigned)(ms.probe_bytes / 1024));
+  if (indexed) {
+    /* What the same boot costs without it */
+    media_catalog cold(SD_MMC, CATALOG_FILE_PATH ".cold");
+    cold.refresh(GRID_DIR);
+    media_catalog_stats_t cs = cold.stats();
+    SD_MMC.remove(CATALOG_FILE_PATH ".cold");
+    Serial.printf("Catalog without index: %u ms (listing %u ms, %u headers read in %u ms)\n", (cs.list_us + cs.probe_us) / 1000,
+                  cs.list_us / 1000, cs.probed, cs.probe_us / 1000);
+  }
+  /* Opening previews: scanning each file's headers against reading straight from the indexed offset */
+  uint32_t scan_us = 0, direct_us = 0, opened = 0;
+  media_entry_t me;
+  for (int i = 0; opened < 8 && catalog.get(i, &me); i++) {
+    if (!(me.flags & MEDIA_THUMB)) {
+      continue;
+    }
+    int64_t t0 = esp_timer_get_time();
+    loader.loadThumbnail(me.path, &preview_jpeg, &preview_jpeg_size);
+    pipeline_free_align(preview_jpeg);
+    int64_t t1 = esp_timer_get_time();
+    loader.loadRange(me.path, me.thumb_offset, me.thumb_length, &preview_jpeg);
+    pipeline_free_align(preview_jpeg);
+    direct_us += esp_timer_get_time() - t1;
+    scan_us += t1 - t0;
+    opened++;
+  }
+  preview_jpeg = NULL;
+  if (opened > 0) {
+    Serial.printf("Preview open %u files: %u us each scanning headers, %u us each from the index\n", opened, scan_us / opened,
+                  direct_us / opened);
+  }
+
+  /* Thumbnail grid: the first visit makes the tiles in the background, the second reads them from the SD cache */
+  int grid_files = catalog.count() > 0 ? grid.loadCatalog(catalog) : grid.loadDirectory(GRID_DIR);
+  if (thumbs.begin() && grid_files > 0 && grid.begin()) {
+    for (int pass = 0; pass < 2; pass++) {
+      grid.show(0);
+      while (!grid.update()) {
+        delay(1);
+      }
+    }
+    thumb_grid_stats_t gs = grid.stats();
+    thumb_cache_stats_t cs = thumbs.stats();
+    Serial.printf("Thumbnail grid %d images: full grid %u ms cold, %u ms warm, %u made (%u from previews, %u ms each), %u failed, %u tiles cached, %u evicted\n",
+                  grid.count(), gs.cold_ms, gs.warm_ms, gs.made, gs.embedded, gs.made ? (unsigned)(gs.make_us / gs.made / 1000) : 0,
+                  gs.failed, thumbs.used(), cs.evictions);
+    /* Its task and tile buffers are not needed past the test; the file list stays for the swipe gallery */
+    grid.end();
+  }
+
+  /* Video: the audio clock paces the frames, late ones are dropped, seeking is an index lookup */
+  sd_avi_reader video_file(SD_MMC, loader);
+  if (video_file.open(VIDEO_FILE_PATH) == SD_LOAD_OK) {
+    avi_player player;
+    avi_err_t verr = player.open(video_file, &speaker);
+    if (verr != AVI_OK) {
+      Serial.printf("Video: %s\n", avi_demux::errName(verr));
+    }
+    avi_info_t vi = player.info();
+    /* Panel-sized video goes straight out: the resampler's strips make room for the output strip */
+    bool panel_sized = vi.width == LCD_H_RES && vi.height == LCD_V_RES;
+    if (panel_sized) {
+      fit_scaler.end();
+    }
+    for (int pass = 0; verr == AVI_OK && pass < 2; pass++) {
+      t = millis();
+      while (millis() - t < (pass ? 2000 : VIDEO_TEST_MS) && player.update(jpegDrawCallback)) {
+      }
+      avi_player_stats_t vs = player.stats();
+      audio_sink_stats_t as = speaker.stats();
+      Serial.printf("Video %ux%u %s: %u shown, %u dropped, %u failed, %u without DHT | drift mean %u us max %u us | "
+                    "decode %u us/frame | %s, %u underruns\n",
+                    vi.width, vi.height, vi.indexed ? "idx1" : "scanned", vs.shown, vs.dropped, vs.failed, vs.dht_inserted,
+                    vs.shown ? (unsigned)(vs.drift_sum_us / vs.shown) : 0, (unsigned)vs.max_drift_us,
+                    vs.shown ? (unsigned)(vs.decode_us / vs.shown) : 0, player.audioClock() ? "audio clock" : "timer clock",
+                    as.underruns);
+      if (pass == 0) {
+        player.seek(0);
+        Serial.printf("Video seek to 0 in %u us\n", player.stats().last_seek_us);
+        player.resetStats();
+        speaker.resetStats();
+      }
+    }
+    player.close();
+    video_file.close();
+    if (panel_sized && !fit_scaler.begin()) {
+      Serial.println("Resampler buffers failed, only 480x272 images will show");
+    }
+  }
+
+  /* Both panels decoding flat out: neither should starve the other */
+  if (TFT2_QSPI_CS >= 0) {
+    dual_test_t test = { image_jpeg, image_jpeg_size, 0, xSemaphoreCreateBinary() };
+    uint32_t images = 0;
+    bus_sched.resetStats();
+    t = millis();
+    xTaskCreatePinnedToCore(panel2Task, "panel2", 8 * 1024, &test, 1, NULL, 0);
+    while (millis() - t < DUAL_TEST_MS) {
+      esp_jpeg_decoder_one_picture_block_out(image_jpeg, image_jpeg_size, jpegDrawCallback);
+      images++;
+    }
+    xSemaphoreTake(test.done, portMAX_DELAY);
+    vSemaphoreDelete(test.done);
+    for (int i = 0; i < 2; i++) {
+      panel_sched_stats_t ps = bus_sched.stats((i ? lcd2 : lcd).schedulerId());
+      Serial.printf("panel %d: %u images, %u.%u fps, %u.%u%% of bus, %u strips waited %u us (max %u us)\n", i, i ? test.images : images,
+                    ps.fps_x10 / 10, ps.fps_x10 % 10, ps.share_permille / 10, ps.share_permille % 10, ps.waited,
+                    (unsigned)ps.wait_us, ps.max_wait_us);
+    }
+  }
+
+  for (int i = 0; i < SOAK_TEST_NUM; i++) {
+    esp_jpeg_decoder_one_picture_block_out(image_jpeg, image_jpeg_size, jpegDrawCallback);
+    if (i % 1000 == 0 || i == SOAK_TEST_NUM - 1) {
+      arena_stats_t in = pipeline_mem.stats(ARENA_INTERNAL);
+      arena_stats_t ps = pipeline_mem.stats(ARENA_PSRAM);
+      Serial.printf("soak %d: heap free %u min %u largest %u | arena int peak %u frag %u%% failed %u | psram peak %u frag %u%% failed %u\n",
+                    i, heap_caps_get_free_size(MALLOC_CAP_DEFAULT), heap_caps_get_minimum_free_size(MALLOC_CAP_DEFAULT),
+                    heap_caps_get_largest_free_block(MALLOC_CAP_DEFAULT),
+                    in.peak, in.frag_permille / 10, in.failed, ps.peak, ps.frag_permille / 10, ps.failed);
+    }
+  }
+  /* With a gallery, loop() swipes through it; otherwise the test image stays loaded for the drag demo */
+  for (int i = 0; i < grid.count(); i++) {
+    swipe_paths.push_back(grid.path(i));
+  }
+  if (swipe_paths.size() > 1) {
+    swipe = new swipe_prefetch(SD_MMC, swipe_paths.data(), swipe_paths.size());
+    if (!swipe->begin()) {
+      Serial.println("Swipe prefetch frames failed, swipe gallery skipped");
+      delete swipe;
+      swipe = NULL;
+    }
+  }
+  if (swipe != NULL) {
+    pipeline_free_align(image_jpeg);
+    showGalleryImage(swipe_index);
+    Serial.println("Swipe left or right to change image");
+  } else if (blitter.begin()) {
+    drag_jpeg = image_jpeg;
+    drag_jpeg_size = image_jpeg_size;
+    esp_jpeg_decoder_one_picture_block_out(drag_jpeg, drag_jpeg_size, jpegDragCallback);
+    Serial.println("Drag the image to move it");
+  } else {
+    Serial.println("Blitter buffers failed, drag demo skipped");
+    pipeline_free_align(image_jpeg);
+  }
 }
 
 void loop() {
+  if (swipe != NULL) {
+    swipeLoop();
+    return;
+  }
+  if (drag_jpeg == NULL) {
+    return;
+  }
+  /* Drawn where the finger is predicted to be when the redraw reaches the panel, not where it was */
+  uint16_t x, y;
+  int64_t t = esp_timer_get_time();
+  if (!touch.getPredictedTouch(&x, &y)) {
+    dragging = false;
+    delay(10);
+    return;
+  }
+  if (!dragging) {
+    dragging = true;
+    drag_grab_x = x - drag_x;
+    drag_grab_y = y - drag_y;
+    return;
+  }
+  int16_t nx = x - drag_grab_x, ny = y - drag_grab_y;
+  if (nx == drag_x && ny == drag_y) {
+    delay(5);
+    return;
+  }
+
+  /* Clear what the image uncovers: the rows it left, then the columns beside it */
+  int top = ny > drag_y ? drag_y : ny + LCD_V_RES, rows = abs(ny - drag_y);
+  fillClipped(drag_x, top, LCD_H_RES, rows, 0x0000);
+  int left = nx > drag_x ? drag_x : nx + LCD_H_RES;
+  fillClipped(left, ny > drag_y ? ny : drag_y, abs(nx - drag_x), LCD_V_RES - rows, 0x0000);
+  drag_x = nx;
+  drag_y = ny;
+  esp_jpeg_decoder_one_picture_block_out(drag_jpeg, drag_jpeg_size, jpegDragCallback);
+  lcd.flush();
+  /* Touch sample to pixels on the panel: how far ahead the next prediction has to look */
+  touch.addLatencySample((uint32_t)(esp_timer_get_time() - t));
 }
@@ -0,0 +1,160 @@
+#include <string.h>
+#include "rgb565_asset.h"
+
+rgb565_asset::rgb565_asset()
+{
+    _data = NULL;
+    _len = 0;
+    _width = 0;
+    _height = 0;
+    _strip_h = 0;
+    _strips = 0;
+    _codec = RGB565_CODEC_RAW;
+}
+
+bool rgb565_asset::open(const uint8_t *data, size_t len)
+{
+    _data = NULL;
+    if (data == NULL || len < RGB565_ASSET_HEADER_SIZE || memcmp(data, RGB565_ASSET_MAGIC, 4) != 0 ||
+        data[4] != RGB565_ASSET_VERSION || data[5] > RGB565_CODEC_RLE) {
+        return false;
+    }
+
+    uint16_t width = rd16(data + 6);
+    uint16_t height = rd16(data + 8);
+    uint16_t strip_h = rd16(data + 10);
+    uint16_t strips = rd16(data + 12);
+    if (width == 0 || height == 0 || strip_h == 0 || strips != (height + strip_h - 1) / strip_h) {
+        return false;
+    }
+
+    // Offsets must be monotonic and inside the file
+    size_t table_end = RGB565_ASSET_HEADER_SIZE + ((size_t)strips + 1) * 4;
+    if (table_end > len) {
+        return false;
+    }
+    uint32_t prev = table_end;
+    for (uint16_t i = 0; i <= strips; i++) {
+        uint32_t off = rd32(data + RGB565_ASSET_HEADER_SIZE + i * 4);
+        if (off < prev || off > len) {
+            return false;
+        }
+        prev = off;
+    }
+
+    _data = data;
+    _len = len;
+    _width = width;
+    _height = height;
+    _strip_h = strip_h;
+    _strips = strips;
+    _codec = (rgb565_codec_t)data[5];
+    return true;
+}
+
+uint16_t rgb565_asset::width()
+{
+    return _width;
+}
+
+uint16_t rgb565_asset::height()
+{
+    return _height;
+}
+
+uint16_t rgb565_asset::stripHeight()
+{
+    return _strip_h;
+}
+
+uint16_t rgb565_asset::stripCount()
+{
+    return _strips;
+}
+
+rgb565_codec_t rgb565_asset::codec()
+{
+    return _codec;
+}
+
+uint16_t rgb565_asset::stripRows(uint16_t i)
+{
+    uint32_t y = (uint32_t)i * _strip_h;
+    if (y >= _height) {
+        return 0;
+    }
+    return _height - y < _strip_h ? _height - y : _strip_h;
+}
+
+bool rgb565_asset::decodeStrip(uint16_t i, uint16_t *out)
+{
+    if (_data == NULL || i >= _strips) {
+        return false;
+    }
+
+    const uint8_t *src = _data + rd32(_data + RGB565_ASSET_HEADER_SIZE + i * 4);
+    const uint8_t *end = _data + rd32(_data + RGB565_ASSET_HEADER_SIZE + (i + 1) * 4);
+    size_t remain = (size_t)_width * stripRows(i);
+
+    if (_codec == RGB565_CODEC_RAW) {
+        if ((size_t)(end - src) != remain * 2) {
+            return false;
+        }
+        memcpy(out, src, remain * 2);
+        return true;
+    }
+
+    while (remain > 0) {
+        if (src >= end) {
+            return false;
+        }
+        uint8_t c = *src++;
+        size_t n = (c & 0x7F) + 1;
+        if (n > remain) {
+            return false;
+        }
+        if (c & 0x80) {
+            if (end - src < 2) {
+                return false;
+            }
+            uint16_t px;
+            memcpy(&px, src, 2);
+            src += 2;
+            for (size_t k = 0; k < n; k++) {
+                out[k] = px;
+            }
+        } else {
+            if ((size_t)(end - src) < n * 2) {
+                return false;
+            }
+            memcpy(out, src, n * 2);
+            src += n * 2;
+        }
+        out += n;
+        remain -= n;
+    }
+    return src == end;
+}
+
+bool rgb565_asset::decode(uint16_t *strip_buf, strip_cb_t cb, void *ctx)
+{
+    for (uint16_t i = 0; i < _strips; i++) {
+        if (!decodeStrip(i, strip_buf)) {
+            return false;
+        }
+        if (!cb(ctx, i * _strip_h, _width, stripRows(i), strip_buf)) {
+            break;
+        }
+    }
+    return _data != NULL;
+}
+
+uint16_t rgb565_asset::rd16(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+uint32_t rgb565_asset::rd32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
@@ -0,0 +1,74 @@
+#ifndef _RGB565_ASSET_H
+#define _RGB565_ASSET_H
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Pre-decoded RGB565 asset (".r565") for UI graphics.
+ *
+ * Layout, all header fields little-endian:
+ *   0  char[4]  magic "R565"
+ *   4  uint8    version (1)
+ *   5  uint8    codec (RGB565_CODEC_RAW or RGB565_CODEC_RLE)
+ *   6  uint16   width
+ *   8  uint16   height
+ *   10 uint16   strip_height
+ *   12 uint16   strip_count
+ *   14 uint16   reserved
+ *   16 uint32   offsets[strip_count + 1], from the start of the file
+ *   ..          strip data
+ *
+ * Pixels are RGB565 in panel byte order (high byte first), so a decoded strip
+ * can go to the panel untouched. RLE works on 16-bit pixels over the whole
+ * strip: a control byte c < 0x80 is followed by c + 1 literal pixels, c >= 0x80
+ * by one pixel repeated (c & 0x7F) + 1 times.
+ */
+
+class nv3041a_lcd;
+
+#define RGB565_ASSET_MAGIC "R565"
+#define RGB565_ASSET_VERSION (1)
+#define RGB565_ASSET_HEADER_SIZE (16)
+
+typedef enum {
+    RGB565_CODEC_RAW = 0,
+    RGB565_CODEC_RLE = 1,
+} rgb565_codec_t;
+
+class rgb565_asset
+{
+public:
+    typedef int (*strip_cb_t)(void *ctx, uint16_t y, uint16_t w, uint16_t h, uint16_t *pixels);
+
+    rgb565_asset();
+
+    // The data must stay valid while the asset is used; nothing is copied
+    bool open(const uint8_t *data, size_t len);
+
+    uint16_t width();
+    uint16_t height();
+    uint16_t stripHeight();
+    uint16_t stripCount();
+    rgb565_codec_t codec();
+
+    // Pixels in strip i; the last strip may be shorter than stripHeight()
+    uint16_t stripRows(uint16_t i);
+    // out must hold width() * stripHeight() pixels
+    bool decodeStrip(uint16_t i, uint16_t *out);
+    // Decode strip by strip through one strip buffer; stops early if the callback returns 0
+    bool decode(uint16_t *strip_buf, strip_cb_t cb, void *ctx);
+    // Stream all strips to the panel at (x, y) through draw16bitbergbbitmap(), two strip
+    // buffers in turn, clipped to the panel; returns once the last transfer is done
+    bool draw(nv3041a_lcd &lcd, uint16_t x, uint16_t y);
+
+private:
+    static uint16_t rd16(const uint8_t *p);
+    static uint32_t rd32(const uint8_t *p);
+
+    const uint8_t *_data;
+    size_t _len;
+    uint16_t _width, _height, _strip_h, _strips;
+    rgb565_codec_t _codec;
+};
+
+#endif
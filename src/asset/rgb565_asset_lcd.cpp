@@ -0,0 +1,51 @@
+#include <string.h>
+#include "rgb565_asset.h"
+#include "../../pins_config.h"
+#include "../lcd/nv3041a_lcd.h"
+#include "../mem/pipeline_arena.h"
+
+bool rgb565_asset::draw(nv3041a_lcd &lcd, uint16_t x, uint16_t y)
+{
+    if (_data == NULL) {
+        return false;
+    }
+    // Only the part on the panel is sent; columns past the right edge are dropped from each row
+    if (x >= LCD_H_RES || y >= LCD_V_RES) {
+        return true;
+    }
+    uint16_t vis_w = _width < LCD_H_RES - x ? _width : LCD_H_RES - x;
+    uint16_t vis_h = _height < LCD_V_RES - y ? _height : LCD_V_RES - y;
+
+    size_t bytes = (size_t)_width * _strip_h * sizeof(uint16_t);
+    uint16_t *strip[2];
+    strip[0] = (uint16_t *)pipeline_malloc_align(bytes, ARENA_INTERNAL);
+    strip[1] = (uint16_t *)pipeline_malloc_align(bytes, ARENA_INTERNAL);
+    if (strip[0] == NULL || strip[1] == NULL) {
+        pipeline_free_align(strip[0]);
+        pipeline_free_align(strip[1]);
+        return false;
+    }
+
+    // Transfers are asynchronous: one strip is decoded while the other is on the bus
+    bool ok = true;
+    for (uint16_t i = 0; ok && i < _strips && i * _strip_h < vis_h; i++) {
+        uint16_t *buf = strip[i & 1];
+        uint16_t top = i * _strip_h;
+        uint16_t rows = stripRows(i) < vis_h - top ? stripRows(i) : vis_h - top;
+        // The buffer last went out two strips ago; only the strip just queued may still be sending
+        lcd.flush(1);
+        ok = decodeStrip(i, buf);
+        if (ok) {
+            if (vis_w < _width) {
+                for (uint16_t r = 1; r < rows; r++) {
+                    memmove(buf + r * vis_w, buf + r * _width, vis_w * sizeof(uint16_t));
+                }
+            }
+            lcd.draw16bitbergbbitmap(x, y + top, vis_w, rows, buf);
+        }
+    }
+    lcd.flush();
+    pipeline_free_align(strip[0]);
+    pipeline_free_align(strip[1]);
+    return ok;
+}
@@ -0,0 +1,29 @@
+#include <string.h>
+#include "audio_sink.h"
+
+audio_sink::audio_sink()
+{
+    _rate = 0;
+    _frame_bytes = 0;
+    resetStats();
+}
+
+uint32_t audio_sink::rate()
+{
+    return _rate;
+}
+
+uint8_t audio_sink::frameBytes()
+{
+    return _frame_bytes;
+}
+
+audio_sink_stats_t audio_sink::stats()
+{
+    return _stats;
+}
+
+void audio_sink::resetStats()
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
@@ -0,0 +1,51 @@
+#ifndef _AUDIO_SINK_H
+#define _AUDIO_SINK_H
+#include <stdint.h>
+#include <stddef.h>
+
+typedef struct {
+    uint64_t written;      // sample frames taken by write() since start()
+    uint32_t writes;
+    uint32_t blocked_us;   // write() waiting for room
+    uint32_t underruns;    // times the output ran dry and played silence
+    uint32_t silence_ms;   // silence played because of them
+} audio_sink_stats_t;
+
+/*
+ * Where PCM goes, and the clock it plays by.
+ *
+ * write() queues interleaved little-endian samples, waiting up to its
+ * timeout for room; played() counts the sample frames that have actually
+ * left the output since start(), which is what video is timed against.
+ * Silence played because the writer fell behind does not count, so the clock
+ * stops when the audio does. i2s_audio_sink (src/audio) drives the I2S
+ * amplifier; tools/host has a stand-in that plays at a simulated rate.
+ */
+class audio_sink
+{
+public:
+    virtual ~audio_sink() {}
+
+    // 16-bit PCM, one or two channels
+    virtual bool start(uint32_t rate, uint8_t channels) = 0;
+    virtual void stop() = 0;
+    // Bytes taken, a multiple of the frame size
+    virtual size_t write(const void *pcm, size_t len, uint32_t timeout_ms) = 0;
+    virtual uint64_t played() = 0;
+    virtual const char *name() = 0;
+
+    uint32_t rate();
+    uint8_t frameBytes();
+
+    audio_sink_stats_t stats();
+    void resetStats();
+
+protected:
+    audio_sink();
+
+    uint32_t _rate;
+    uint8_t _frame_bytes;
+    audio_sink_stats_t _stats;
+};
+
+#endif
@@ -0,0 +1,164 @@
+#include <string.h>
+#include "esp_err.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "i2s_audio_sink.h"
+
+static const char *TAG = "i2s_audio";
+
+static bool IRAM_ATTR i2sSent(i2s_chan_handle_t handle, i2s_event_data_t *event, void *ctx)
+{
+    ((i2s_audio_sink *)ctx)->onSent(event->size, esp_timer_get_time());
+    return false;
+}
+
+i2s_audio_sink::i2s_audio_sink(int8_t bclk, int8_t lrc, int8_t dout, uint16_t buffer_ms)
+{
+    _bclk = bclk;
+    _lrc = lrc;
+    _dout = dout;
+    _buffer_ms = buffer_ms;
+    _tx = NULL;
+    _dma_frames = 0;
+    portMUX_INITIALIZE(&_mux);
+    _sent = 0;
+    _sent_us = 0;
+    _written = 0;
+    _silence = 0;
+}
+
+i2s_audio_sink::~i2s_audio_sink()
+{
+    stop();
+}
+
+bool i2s_audio_sink::start(uint32_t rate, uint8_t channels)
+{
+    stop();
+    if (rate == 0 || channels < 1 || channels > 2 || _dout < 0) {
+        return false;
+    }
+    _rate = rate;
+    _frame_bytes = 2 * channels;
+
+    // One DMA buffer holds at most 4092 bytes
+    uint32_t frames = rate * _buffer_ms / 1000 / I2S_AUDIO_DMA_BUFFERS;
+    uint32_t max_frames = 4092 / _frame_bytes;
+    _dma_frames = frames < 64 ? 64 : (frames > max_frames ? max_frames : frames);
+
+    i2s_chan_config_t chan = I2S_CHANNEL_DEFAULT_CONFIG(I2S_NUM_0, I2S_ROLE_MASTER);
+    chan.dma_desc_num = I2S_AUDIO_DMA_BUFFERS;
+    chan.dma_frame_num = _dma_frames;
+    chan.auto_clear = true; // silence, not the last buffer over again, when the writer falls behind
+    esp_err_t err = i2s_new_channel(&chan, &_tx, NULL);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "channel: %s", esp_err_to_name(err));
+        _tx = NULL;
+        return false;
+    }
+
+    i2s_std_config_t std = {};
+    std.clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(rate);
+    std.slot_cfg = I2S_STD_PHILIPS_SLOT_DEFAULT_CONFIG(I2S_DATA_BIT_WIDTH_16BIT,
+                                                       channels == 2 ? I2S_SLOT_MODE_STEREO : I2S_SLOT_MODE_MONO);
+    // Mono goes out on both slots; the amplifier mixes them
+    std.slot_cfg.slot_mask = I2S_STD_SLOT_BOTH;
+    std.gpio_cfg.mclk = I2S_GPIO_UNUSED;
+    std.gpio_cfg.bclk = (gpio_num_t)_bclk;
+    std.gpio_cfg.ws = (gpio_num_t)_lrc;
+    std.gpio_cfg.dout = (gpio_num_t)_dout;
+    std.gpio_cfg.din = I2S_GPIO_UNUSED;
+
+    i2s_event_callbacks_t cbs = {};
+    cbs.on_sent = i2sSent;
+    err = i2s_channel_init_std_mode(_tx, &std);
+    if (err == ESP_OK) {
+        err = i2s_channel_register_event_callback(_tx, &cbs, this);
+    }
+    portENTER_CRITICAL(&_mux);
+    _sent = 0;
+    _sent_us = esp_timer_get_time();
+    portEXIT_CRITICAL(&_mux);
+    _written = 0;
+    _silence = 0;
+    if (err == ESP_OK) {
+        err = i2s_channel_enable(_tx);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "start: %s", esp_err_to_name(err));
+        i2s_del_channel(_tx);
+        _tx = NULL;
+        return false;
+    }
+    return true;
+}
+
+void i2s_audio_sink::stop()
+{
+    if (_tx == NULL) {
+        return;
+    }
+    i2s_channel_disable(_tx);
+    i2s_del_channel(_tx);
+    _tx = NULL;
+}
+
+size_t i2s_audio_sink::write(const void *pcm, size_t len, uint32_t timeout_ms)
+{
+    if (_tx == NULL || len < _frame_bytes) {
+        return 0;
+    }
+    int64_t t = esp_timer_get_time();
+    len -= len % _frame_bytes;
+
+    // The DMA got past everything written: what it sent since was silence
+    portENTER_CRITICAL(&_mux);
+    uint64_t sent = _sent;
+    portEXIT_CRITICAL(&_mux);
+    if (sent > _written + _silence) {
+        if (_written > 0) {
+            _stats.underruns++;
+            _stats.silence_ms += (uint32_t)((sent - _written - _silence) / _frame_bytes * 1000 / _rate);
+        }
+        _silence = sent - _written;
+    }
+
+    size_t done = 0;
+    i2s_channel_write(_tx, pcm, len, &done, timeout_ms);
+    _written += done;
+    _stats.written += done / _frame_bytes;
+    _stats.writes++;
+    _stats.blocked_us += (uint32_t)(esp_timer_get_time() - t);
+    return done;
+}
+
+uint64_t i2s_audio_sink::played()
+{
+    if (_frame_bytes == 0) {
+        return 0;
+    }
+    portENTER_CRITICAL(&_mux);
+    uint64_t sent = _sent;
+    int64_t at = _sent_us;
+    portEXIT_CRITICAL(&_mux);
+
+    // Into the buffer on the wire now, at most all of it
+    uint64_t part = (uint64_t)(esp_timer_get_time() - at) * _rate / 1000000;
+    part = (part < _dma_frames ? part : _dma_frames) * _frame_bytes;
+    uint64_t p = sent + part > _silence ? sent + part - _silence : 0;
+    p = p < _written ? p : _written;
+    return p / _frame_bytes;
+}
+
+const char *i2s_audio_sink::name()
+{
+    return "i2s";
+}
+
+void IRAM_ATTR i2s_audio_sink::onSent(size_t bytes, int64_t now_us)
+{
+    portENTER_CRITICAL_ISR(&_mux);
+    _sent += bytes;
+    _sent_us = now_us;
+    portEXIT_CRITICAL_ISR(&_mux);
+}
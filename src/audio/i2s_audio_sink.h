@@ -0,0 +1,47 @@
+#ifndef _I2S_AUDIO_SINK_H
+#define _I2S_AUDIO_SINK_H
+#include "freertos/FreeRTOS.h"
+#include "driver/i2s_std.h"
+#include "audio_sink.h"
+
+#define I2S_AUDIO_DMA_BUFFERS (8)
+
+/*
+ * 16-bit PCM to an I2S amplifier (MAX98357A and the like: BCLK, LRC, DIN).
+ *
+ * The DMA ring holds about `buffer_ms` of audio in I2S_AUDIO_DMA_BUFFERS
+ * pieces, which is how long the writer may be away, e.g. decoding a video
+ * frame, before the output runs dry. The clock counts DMA buffers as the
+ * driver reports them sent, plus the time since the last one, and is held
+ * back by the silence the driver sent in place of audio that was not written
+ * in time.
+ */
+class i2s_audio_sink : public audio_sink
+{
+public:
+    i2s_audio_sink(int8_t bclk, int8_t lrc, int8_t dout, uint16_t buffer_ms = 100);
+    ~i2s_audio_sink();
+
+    bool start(uint32_t rate, uint8_t channels);
+    void stop();
+    size_t write(const void *pcm, size_t len, uint32_t timeout_ms);
+    uint64_t played();
+    const char *name();
+
+    // From the driver's interrupt
+    void onSent(size_t bytes, int64_t now_us);
+
+private:
+    int8_t _bclk, _lrc, _dout;
+    uint16_t _buffer_ms;
+    i2s_chan_handle_t _tx;
+    uint32_t _dma_frames;     // per DMA buffer
+
+    portMUX_TYPE _mux;
+    volatile uint64_t _sent;  // bytes the DMA has sent, silence included
+    volatile int64_t _sent_us;
+    uint64_t _written;        // bytes handed to the driver
+    uint64_t _silence;        // of _sent, bytes of silence between written audio
+};
+
+#endif
@@ -0,0 +1,314 @@
+#include <stdlib.h>
+#include <string.h>
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "../../jpeg_dec.h"
+#include "../mem/pipeline_arena.h"
+#include "async_decoder.h"
+
+#define ASYNC_DECODER_STACK_SIZE (4 * 1024)
+#define ASYNC_DECODER_GEN_MASK (0x7FFFFF)
+
+static const char *TAG = "async_decoder";
+
+// The decoder callback carries no user context, so the worker publishes itself here
+static async_decoder *s_active = NULL;
+
+async_decoder::async_decoder(nv3041a_lcd &lcd, uint8_t depth)
+    : _lcd(lcd)
+{
+    _depth = depth ? depth : 1;
+    _slots = NULL;
+    _current = NULL;
+    _queue = NULL;
+    _space = NULL;
+    _lock = NULL;
+    _task = NULL;
+    _pending = 0;
+    resetStats();
+}
+
+async_decoder::~async_decoder()
+{
+    if (_task != NULL) {
+        vTaskDelete(_task);
+    }
+    if (_slots != NULL) {
+        for (int i = 0; i < _depth; i++) {
+            if (_slots[i].done != NULL) {
+                vSemaphoreDelete(_slots[i].done);
+            }
+        }
+        free(_slots);
+    }
+    if (_queue != NULL) {
+        vQueueDelete(_queue);
+    }
+    if (_space != NULL) {
+        vSemaphoreDelete(_space);
+    }
+    if (_lock != NULL) {
+        vSemaphoreDelete(_lock);
+    }
+}
+
+bool async_decoder::begin(UBaseType_t priority, BaseType_t core)
+{
+    _slots = (slot_t *)calloc(_depth, sizeof(slot_t));
+    _queue = xQueueCreate(_depth, sizeof(slot_t *));
+    _space = xSemaphoreCreateCounting(_depth, _depth);
+    _lock = xSemaphoreCreateMutex();
+    if (_slots == NULL || _queue == NULL || _space == NULL || _lock == NULL) {
+        ESP_LOGE(TAG, "out of memory");
+        return false;
+    }
+    for (int i = 0; i < _depth; i++) {
+        _slots[i].result.state = DECODE_JOB_UNKNOWN;
+        _slots[i].done = xSemaphoreCreateBinary();
+        if (_slots[i].done == NULL) {
+            return false;
+        }
+    }
+
+    return xTaskCreatePinnedToCore(taskEntry, "async_decode", ASYNC_DECODER_STACK_SIZE, this, priority, &_task, core) == pdPASS;
+}
+
+decode_job_t async_decoder::submit(const decode_job_desc_t &desc, uint32_t timeout_ms)
+{
+    if (_task == NULL || desc.data == NULL || desc.len == 0 || desc.x >= _lcd.width() || desc.y >= _lcd.height()) {
+        return DECODE_JOB_NONE;
+    }
+
+    // Back-pressure: one token per job queued or running
+    if (xSemaphoreTake(_space, pdMS_TO_TICKS(timeout_ms)) != pdTRUE) {
+        xSemaphoreTake(_lock, portMAX_DELAY);
+        _stats.rejected++;
+        xSemaphoreGive(_lock);
+        return DECODE_JOB_NONE;
+    }
+
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    // Holding a token guarantees a slot whose previous job has fully ended
+    slot_t *slot = NULL;
+    for (int i = 0; i < _depth && slot == NULL; i++) {
+        if (!_slots[i].busy) {
+            slot = &_slots[i];
+        }
+    }
+    int index = slot - _slots;
+    slot->generation = (slot->generation + 1) & ASYNC_DECODER_GEN_MASK;
+    slot->busy = true;
+    slot->cancel = false;
+    slot->desc = desc;
+    slot->submit_us = esp_timer_get_time();
+    memset(&slot->result, 0, sizeof(slot->result));
+    slot->result.job = (decode_job_t)((slot->generation << 8) | index);
+    slot->result.state = DECODE_JOB_QUEUED;
+    slot->result.user = desc.user;
+    xSemaphoreTake(slot->done, 0);
+
+    _pending++;
+    _stats.submitted++;
+    if ((uint32_t)_pending > _stats.max_depth) {
+        _stats.max_depth = _pending;
+    }
+    decode_job_t job = slot->result.job;
+    xSemaphoreGive(_lock);
+
+    xQueueSend(_queue, &slot, portMAX_DELAY);
+    return job;
+}
+
+async_decoder::slot_t *async_decoder::lookup(decode_job_t job)
+{
+    if (job < 0 || _slots == NULL || (job & 0xFF) >= _depth) {
+        return NULL;
+    }
+    slot_t *slot = &_slots[job & 0xFF];
+    return slot->result.job == job ? slot : NULL;
+}
+
+decode_job_state_t async_decoder::state(decode_job_t job)
+{
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    slot_t *slot = lookup(job);
+    decode_job_state_t s = slot ? slot->result.state : DECODE_JOB_UNKNOWN;
+    xSemaphoreGive(_lock);
+    return s;
+}
+
+bool async_decoder::progress(decode_job_t job, uint16_t *lines, uint16_t *height)
+{
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    slot_t *slot = lookup(job);
+    if (slot != NULL) {
+        *lines = slot->result.lines;
+        *height = slot->result.height;
+    }
+    xSemaphoreGive(_lock);
+    return slot != NULL;
+}
+
+bool async_decoder::wait(decode_job_t job, uint32_t timeout_ms, decode_result_t *result)
+{
+    int64_t deadline = esp_timer_get_time() + (int64_t)timeout_ms * 1000;
+
+    for (;;) {
+        xSemaphoreTake(_lock, portMAX_DELAY);
+        slot_t *slot = lookup(job);
+        bool ended = slot != NULL && slot->result.state >= DECODE_JOB_DONE;
+        if (ended && result != NULL) {
+            *result = slot->result;
+        }
+        xSemaphoreGive(_lock);
+
+        if (slot == NULL || ended) {
+            return ended;
+        }
+        int64_t remain = deadline - esp_timer_get_time();
+        if (remain <= 0) {
+            return false;
+        }
+        xSemaphoreTake(slot->done, pdMS_TO_TICKS((remain + 999) / 1000));
+    }
+}
+
+bool async_decoder::cancel(decode_job_t job)
+{
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    slot_t *slot = lookup(job);
+    bool live = slot != NULL && slot->result.state < DECODE_JOB_DONE;
+    if (live && !slot->cancel) {
+        slot->cancel_us = esp_timer_get_time();
+        slot->cancel = true;
+    }
+    xSemaphoreGive(_lock);
+    return live;
+}
+
+int async_decoder::pending()
+{
+    return _pending;
+}
+
+async_decode_stats_t async_decoder::stats()
+{
+    return _stats;
+}
+
+void async_decoder::resetStats()
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+void async_decoder::taskEntry(void *arg)
+{
+    async_decoder *self = (async_decoder *)arg;
+    slot_t *slot;
+
+    for (;;) {
+        if (xQueueReceive(self->_queue, &slot, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        self->run(slot);
+    }
+}
+
+int async_decoder::drawCallback(jpeg_dec_io_t *jpeg_io, jpeg_dec_header_info_t *out_info)
+{
+    async_decoder *self = s_active;
+    slot_t *slot = self->_current;
+    const decode_job_desc_t &d = slot->desc;
+
+    uint16_t max_w = self->_lcd.width() - d.x;
+    uint16_t max_h = self->_lcd.height() - d.y;
+    if (d.w && d.w < max_w) {
+        max_w = d.w;
+    }
+    if (d.h && d.h < max_h) {
+        max_h = d.h;
+    }
+
+    int y = jpeg_io->output_line - jpeg_io->cur_line;
+    int w = out_info->width < max_w ? out_info->width : max_w;
+    int h = jpeg_io->cur_line;
+    if (y + h > max_h) {
+        h = max_h > y ? max_h - y : 0;
+    }
+
+    if (h > 0 && w > 0) {
+        uint16_t *px = (uint16_t *)jpeg_io->outbuf;
+        // Pack clipped rows in place; each row only moves towards the start of the block
+        if (w < out_info->width) {
+            for (int row = 1; row < h; row++) {
+                memmove(px + row * w, px + row * out_info->width, w * sizeof(uint16_t));
+            }
+        }
+        self->_lcd.draw16bitbergbbitmap(d.x, d.y + y, w, h, px);
+    }
+
+    xSemaphoreTake(self->_lock, portMAX_DELAY);
+    slot->result.width = out_info->width;
+    slot->result.height = out_info->height;
+    slot->result.lines += h;
+    xSemaphoreGive(self->_lock);
+    return 1;
+}
+
+void async_decoder::run(slot_t *slot)
+{
+    int64_t start = esp_timer_get_time();
+
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    slot->result.state = DECODE_JOB_RUNNING;
+    slot->result.wait_us = (uint32_t)(start - slot->submit_us);
+    xSemaphoreGive(_lock);
+
+    // A job cancelled while queued is never started
+    jpeg_dec_result_t err = JPEG_DEC_STOPPED;
+    if (!slot->cancel) {
+        jpeg_dec_limits_t limits = {};
+        limits.cancel = &slot->cancel;
+        _current = slot;
+        s_active = this;
+        err = esp_jpeg_decoder_block_out((unsigned char *)slot->desc.data, slot->desc.len, drawCallback, &limits);
+        s_active = NULL;
+        _current = NULL;
+    }
+
+    if (slot->desc.flags & DECODE_JOB_FREE_INPUT) {
+        pipeline_free_align((void *)slot->desc.data);
+    }
+
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    int64_t end = esp_timer_get_time();
+    slot->result.decode_us = (uint32_t)(end - start);
+    slot->result.err = err;
+    if (err == JPEG_DEC_OK) {
+        slot->result.state = DECODE_JOB_DONE;
+        _stats.completed++;
+    } else if (err == JPEG_DEC_STOPPED) {
+        slot->result.state = DECODE_JOB_CANCELLED;
+        slot->result.cancel_us = (uint32_t)(end - slot->cancel_us);
+        _stats.cancelled++;
+    } else {
+        slot->result.state = DECODE_JOB_FAILED;
+        _stats.failed++;
+        ESP_LOGW(TAG, "job %ld: %s after %u lines", (long)slot->result.job, jpeg_dec_result_name(err), slot->result.lines);
+    }
+    _stats.total_wait_us += slot->result.wait_us;
+    _stats.total_decode_us += slot->result.decode_us;
+    decode_result_t result = slot->result;
+    xSemaphoreGive(_lock);
+
+    if (slot->desc.done != NULL) {
+        slot->desc.done(&result);
+    }
+
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    slot->busy = false;
+    _pending--;
+    xSemaphoreGive(_lock);
+    xSemaphoreGive(slot->done);
+    xSemaphoreGive(_space);
+}
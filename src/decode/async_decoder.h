@@ -0,0 +1,134 @@
+#ifndef _ASYNC_DECODER_H
+#define _ASYNC_DECODER_H
+#include <stdio.h>
+#include <ESP32_JPEG_Library.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "../lcd/nv3041a_lcd.h"
+#include "../../jpeg_dec.h"
+
+// Job handle: slot index plus a generation count, so stale handles are detected
+typedef int32_t decode_job_t;
+#define DECODE_JOB_NONE (-1)
+
+#define DECODE_JOB_FREE_INPUT (1 << 0) // pipeline_free_align() the input when the job ends
+
+typedef enum {
+    DECODE_JOB_UNKNOWN = 0, // invalid handle, or the slot was reused by a later job
+    DECODE_JOB_QUEUED,
+    DECODE_JOB_RUNNING,
+    DECODE_JOB_DONE,
+    DECODE_JOB_FAILED,
+    DECODE_JOB_CANCELLED,
+} decode_job_state_t;
+
+typedef struct {
+    decode_job_t job;
+    decode_job_state_t state;
+    uint16_t width;
+    uint16_t height;
+    uint16_t lines;      // lines that reached the panel
+    uint32_t wait_us;    // time spent queued
+    uint32_t decode_us;  // decode + flush time on the worker
+    uint32_t cancel_us;  // time from cancel() until the worker let go of the job
+    jpeg_dec_result_t err; // why a FAILED job failed
+    void *user;
+} decode_result_t;
+
+// Runs on the decode worker task; keep it short
+typedef void (*decode_done_cb_t)(const decode_result_t *result);
+
+typedef struct {
+    const uint8_t *data;   // 16-byte aligned JPEG, valid until the job ends
+    size_t len;
+    uint16_t x, y;         // top-left corner on the panel
+    uint16_t w, h;         // clip rectangle, 0 = up to the panel edge
+    uint32_t flags;
+    decode_done_cb_t done;
+    void *user;
+} decode_job_desc_t;
+
+typedef struct {
+    uint32_t submitted;
+    uint32_t completed;
+    uint32_t failed;
+    uint32_t cancelled;
+    uint32_t rejected;     // submit() timed out on a full queue
+    uint32_t max_depth;    // most jobs queued or running at once
+    uint64_t total_wait_us;
+    uint64_t total_decode_us;
+} async_decode_stats_t;
+
+/*
+ * Non-blocking JPEG decode on a dedicated worker task.
+ *
+ * submit() queues a job and returns a handle at once; the worker decodes jobs in
+ * order, strip by strip, straight into the destination rectangle on the panel.
+ * The caller can poll state() and progress(), block in wait() with a timeout, or
+ * get a completion callback with timing and result, and cancel() a job that is
+ * no longer wanted: a queued job is dropped, a running one stops after the strip
+ * being drawn. At most `depth` jobs are queued or running; beyond that submit()
+ * blocks for up to its timeout and then fails, so a producer that outruns the
+ * decoder is pushed back rather than growing a backlog. Results stay readable until the job's slot is reused.
+ *
+ * The decoder callback carries no user context and finds its instance through a
+ * file-static pointer, so only one async_decoder instance may be begun at a time.
+ * Other modules that decode in the background keep their own and are unaffected.
+ */
+class async_decoder
+{
+public:
+    async_decoder(nv3041a_lcd &lcd, uint8_t depth = 4);
+    ~async_decoder();
+
+    bool begin(UBaseType_t priority = 2, BaseType_t core = 0);
+
+    // Returns DECODE_JOB_NONE if the job is invalid or the queue stayed full for timeout_ms
+    decode_job_t submit(const decode_job_desc_t &desc, uint32_t timeout_ms = 0);
+
+    decode_job_state_t state(decode_job_t job);
+    // Lines on the panel so far and the image height (0 until the header is parsed)
+    bool progress(decode_job_t job, uint16_t *lines, uint16_t *height);
+    // A queued job is dropped, a running one stops after the current strip
+    bool cancel(decode_job_t job);
+    // True once the job has ended; fills result if given
+    bool wait(decode_job_t job, uint32_t timeout_ms, decode_result_t *result = NULL);
+    // Jobs queued or running
+    int pending();
+
+    async_decode_stats_t stats();
+    void resetStats();
+
+private:
+    typedef struct {
+        decode_job_desc_t desc;
+        decode_result_t result;
+        uint32_t generation;
+        bool busy;            // from submit() until the completion callback has returned
+        volatile bool cancel;
+        int64_t submit_us;
+        int64_t cancel_us;
+        SemaphoreHandle_t done;
+    } slot_t;
+
+    static void taskEntry(void *arg);
+    static int drawCallback(jpeg_dec_io_t *jpeg_io, jpeg_dec_header_info_t *out_info);
+    slot_t *lookup(decode_job_t job);
+    void run(slot_t *slot);
+
+    nv3041a_lcd &_lcd;
+    uint8_t _depth;
+    slot_t *_slots;
+    slot_t *_current;
+    QueueHandle_t _queue;
+    SemaphoreHandle_t _space;
+    SemaphoreHandle_t _lock;
+    TaskHandle_t _task;
+    int _pending;
+
+    async_decode_stats_t _stats;
+};
+
+#endif
@@ -0,0 +1,197 @@
+#include <string.h>
+#include "baseline_idct.h"
+
+#define CONST_BITS (13)
+#define PASS1_BITS (2)
+
+#define FIX_0_298631336 (2446)
+#define FIX_0_390180644 (3196)
+#define FIX_0_541196100 (4433)
+#define FIX_0_765366865 (6270)
+#define FIX_0_899976223 (7373)
+#define FIX_1_175875602 (9633)
+#define FIX_1_501321110 (12299)
+#define FIX_1_847759065 (15137)
+#define FIX_1_961570560 (16069)
+#define FIX_2_053119869 (16819)
+#define FIX_2_562915447 (20995)
+#define FIX_3_072711026 (25172)
+
+typedef int32_t v4si __attribute__((vector_size(16)));
+
+static inline uint8_t clamp_sample(int32_t v)
+{
+    v += 128;
+    return v < 0 ? 0 : (v > 255 ? 255 : v);
+}
+
+// One 1-D pass over x[0..7], results descaled by `shift` with rounding. T is a
+// scalar or a vector of lanes that all go through the same arithmetic
+template <typename T>
+static inline void idct8(const T *x, T *y, int shift)
+{
+    T z1, z2, z3, z4, z5;
+    T tmp0, tmp1, tmp2, tmp3, tmp10, tmp11, tmp12, tmp13;
+    const int32_t round = 1 << (shift - 1);
+
+    // Even part
+    z2 = x[2];
+    z3 = x[6];
+    z1 = (z2 + z3) * FIX_0_541196100;
+    tmp2 = z1 + z3 * -FIX_1_847759065;
+    tmp3 = z1 + z2 * FIX_0_765366865;
+    tmp0 = (x[0] + x[4]) * (1 << CONST_BITS);
+    tmp1 = (x[0] - x[4]) * (1 << CONST_BITS);
+    tmp10 = tmp0 + tmp3;
+    tmp13 = tmp0 - tmp3;
+    tmp11 = tmp1 + tmp2;
+    tmp12 = tmp1 - tmp2;
+
+    // Odd part
+    tmp0 = x[7];
+    tmp1 = x[5];
+    tmp2 = x[3];
+    tmp3 = x[1];
+    z1 = tmp0 + tmp3;
+    z2 = tmp1 + tmp2;
+    z3 = tmp0 + tmp2;
+    z4 = tmp1 + tmp3;
+    z5 = (z3 + z4) * FIX_1_175875602;
+    tmp0 = tmp0 * FIX_0_298631336;
+    tmp1 = tmp1 * FIX_2_053119869;
+    tmp2 = tmp2 * FIX_3_072711026;
+    tmp3 = tmp3 * FIX_1_501321110;
+    z1 = z1 * -FIX_0_899976223;
+    z2 = z2 * -FIX_2_562915447;
+    z3 = z3 * -FIX_1_961570560 + z5;
+    z4 = z4 * -FIX_0_390180644 + z5;
+    tmp0 += z1 + z3;
+    tmp1 += z2 + z4;
+    tmp2 += z2 + z3;
+    tmp3 += z1 + z4;
+
+    y[0] = (tmp10 + tmp3 + round) >> shift;
+    y[7] = (tmp10 - tmp3 + round) >> shift;
+    y[1] = (tmp11 + tmp2 + round) >> shift;
+    y[6] = (tmp11 - tmp2 + round) >> shift;
+    y[2] = (tmp12 + tmp1 + round) >> shift;
+    y[5] = (tmp12 - tmp1 + round) >> shift;
+    y[3] = (tmp13 + tmp0 + round) >> shift;
+    y[4] = (tmp13 - tmp0 + round) >> shift;
+}
+
+void baseline_idct_scalar(const int32_t *coef, uint8_t *out, int stride)
+{
+    int32_t ws[64];
+    int32_t x[8], y[8];
+
+    // Columns
+    for (int c = 0; c < 8; c++) {
+        const int32_t *in = coef + c;
+        if ((in[8] | in[16] | in[24] | in[32] | in[40] | in[48] | in[56]) == 0) {
+            int32_t dc = in[0] * (1 << PASS1_BITS);
+            for (int r = 0; r < 8; r++) {
+                ws[r * 8 + c] = dc;
+            }
+            continue;
+        }
+        for (int r = 0; r < 8; r++) {
+            x[r] = in[r * 8];
+        }
+        idct8(x, y, CONST_BITS - PASS1_BITS);
+        for (int r = 0; r < 8; r++) {
+            ws[r * 8 + c] = y[r];
+        }
+    }
+
+    // Rows, with the level shift and range limit
+    for (int r = 0; r < 8; r++) {
+        const int32_t *w = ws + r * 8;
+        uint8_t *o = out + r * stride;
+        if ((w[1] | w[2] | w[3] | w[4] | w[5] | w[6] | w[7]) == 0) {
+            memset(o, clamp_sample((w[0] + (1 << (PASS1_BITS + 2))) >> (PASS1_BITS + 3)), 8);
+            continue;
+        }
+        idct8(w, y, CONST_BITS + PASS1_BITS + 3);
+        for (int i = 0; i < 8; i++) {
+            o[i] = clamp_sample(y[i]);
+        }
+    }
+}
+
+// 4x4 transpose of a..d in place
+static inline void transpose4(v4si &a, v4si &b, v4si &c, v4si &d)
+{
+    v4si t0 = __builtin_shuffle(a, b, (v4si){0, 4, 1, 5});
+    v4si t1 = __builtin_shuffle(a, b, (v4si){2, 6, 3, 7});
+    v4si t2 = __builtin_shuffle(c, d, (v4si){0, 4, 1, 5});
+    v4si t3 = __builtin_shuffle(c, d, (v4si){2, 6, 3, 7});
+    a = __builtin_shuffle(t0, t2, (v4si){0, 1, 4, 5});
+    b = __builtin_shuffle(t0, t2, (v4si){2, 3, 6, 7});
+    c = __builtin_shuffle(t1, t3, (v4si){0, 1, 4, 5});
+    d = __builtin_shuffle(t1, t3, (v4si){2, 3, 6, 7});
+}
+
+void baseline_idct_vector(const int32_t *coef, uint8_t *out, int stride)
+{
+    // ws[r][h]: row r, columns 4h..4h+3
+    v4si ws[8][2];
+    v4si x[8], y[8];
+
+    // Columns 0-3, then 4-7: each vector holds one row of four columns
+    for (int h = 0; h < 2; h++) {
+        for (int r = 0; r < 8; r++) {
+            memcpy(&x[r], coef + r * 8 + h * 4, sizeof(v4si));
+        }
+        v4si ac = x[1] | x[2] | x[3] | x[4] | x[5] | x[6] | x[7];
+        if ((ac[0] | ac[1] | ac[2] | ac[3]) == 0) {
+            v4si dc = x[0] * (1 << PASS1_BITS);
+            for (int r = 0; r < 8; r++) {
+                ws[r][h] = dc;
+            }
+            continue;
+        }
+        idct8(x, y, CONST_BITS - PASS1_BITS);
+        for (int r = 0; r < 8; r++) {
+            ws[r][h] = y[r];
+        }
+    }
+
+    // Rows 0-3, then 4-7: transposed so each vector holds one column of four rows
+    for (int h = 0; h < 2; h++) {
+        v4si (*w)[2] = ws + h * 4;
+        for (int c = 0; c < 2; c++) {
+            x[c * 4 + 0] = w[0][c];
+            x[c * 4 + 1] = w[1][c];
+            x[c * 4 + 2] = w[2][c];
+            x[c * 4 + 3] = w[3][c];
+            transpose4(x[c * 4 + 0], x[c * 4 + 1], x[c * 4 + 2], x[c * 4 + 3]);
+        }
+        idct8(x, y, CONST_BITS + PASS1_BITS + 3);
+        // Back to rows, level-shifted and clamped
+        for (int c = 0; c < 2; c++) {
+            transpose4(y[c * 4 + 0], y[c * 4 + 1], y[c * 4 + 2], y[c * 4 + 3]);
+        }
+        for (int j = 0; j < 4; j++) {
+            uint8_t *o = out + (h * 4 + j) * stride;
+            for (int c = 0; c < 2; c++) {
+                v4si v = y[c * 4 + j] + 128;
+                v = v < 0 ? 0 : v;
+                v = v > 255 ? 255 : v;
+                o[c * 4 + 0] = v[0];
+                o[c * 4 + 1] = v[1];
+                o[c * 4 + 2] = v[2];
+                o[c * 4 + 3] = v[3];
+            }
+        }
+    }
+}
+
+void baseline_idct_dc(int32_t dc, uint8_t *out, int stride)
+{
+    // Both passes of the full transform reduce to this when the AC terms are zero
+    uint8_t v = clamp_sample(((dc * (1 << PASS1_BITS)) + (1 << (PASS1_BITS + 2))) >> (PASS1_BITS + 3));
+    for (int r = 0; r < 8; r++) {
+        memset(out + r * stride, v, 8);
+    }
+}
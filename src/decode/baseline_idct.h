@@ -0,0 +1,30 @@
+#ifndef _BASELINE_IDCT_H
+#define _BASELINE_IDCT_H
+#include <stdint.h>
+
+// Vector IDCT where the compiler maps GCC vector types onto SIMD registers; scalar elsewhere
+#ifndef BASELINE_IDCT_VECTOR
+#if defined(__SSE2__) || defined(__ARM_NEON)
+#define BASELINE_IDCT_VECTOR 1
+#else
+#define BASELINE_IDCT_VECTOR 0
+#endif
+#endif
+
+/*
+ * 8x8 inverse DCT, the accurate fixed-point Loeffler-Ligtenberg-Moschytz
+ * algorithm of libjpeg's jpeg_idct_islow (13-bit constants, two extra bits
+ * between passes), so the output matches libjpeg sample for sample.
+ *
+ * `coef` holds dequantized coefficients in natural (row-major) order; the
+ * 8x8 result is level-shifted, clamped to 0..255 and written `stride` bytes
+ * apart. The scalar version skips columns and rows whose AC terms are all
+ * zero; the vector version transforms four columns, then four rows, at a
+ * time and gives the same result.
+ */
+void baseline_idct_scalar(const int32_t *coef, uint8_t *out, int stride);
+void baseline_idct_vector(const int32_t *coef, uint8_t *out, int stride);
+// A block with only a DC term is flat
+void baseline_idct_dc(int32_t dc, uint8_t *out, int stride);
+
+#endif
@@ -0,0 +1,682 @@
+#include <stdlib.h>
+#include <string.h>
+#include "../mem/pipeline_arena.h"
+#include "baseline_idct.h"
+#include "baseline_jpeg.h"
+
+#define BJ_LOOKAHEAD (9)
+#define BJ_MAX_COMPONENTS (3)
+#define BJ_TABLES (4)
+
+#define M_SOF0 (0xC0)
+#define M_SOF1 (0xC1)
+#define M_DHT (0xC4)
+#define M_RST0 (0xD0)
+#define M_SOI (0xD8)
+#define M_EOI (0xD9)
+#define M_SOS (0xDA)
+#define M_DQT (0xDB)
+#define M_DRI (0xDD)
+
+#if BASELINE_IDCT_VECTOR
+#define BJ_IDCT baseline_idct_vector
+#else
+#define BJ_IDCT baseline_idct_scalar
+#endif
+
+// Natural index of the k-th coefficient in zigzag order
+static const uint8_t s_natural[64] = {
+    0,  1,  8,  16, 9,  2,  3,  10, 17, 24, 32, 25, 18, 11, 4,  5,
+    12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6,  7,  14, 21, 28,
+    35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+    58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63,
+};
+
+typedef struct {
+    uint16_t look[1 << BJ_LOOKAHEAD]; // length << 8 | symbol for codes up to 9 bits, 0 otherwise
+    int16_t fast_ac[1 << BJ_LOOKAHEAD]; // value << 8 | run << 4 | code + value bits, 0 if not that short
+    int32_t maxcode[17];              // largest code of each length, -1 if there is none
+    int32_t valoffset[17];
+    uint8_t huffval[256];
+    uint16_t count;
+    bool defined;
+} bj_huff_t;
+
+typedef struct {
+    uint8_t id;
+    uint8_t h, v;
+    uint8_t tq;
+    uint8_t td, ta;
+    int32_t dc_pred;
+    uint8_t *plane;    // this component's samples for one MCU row
+    int stride;
+} bj_comp_t;
+
+typedef struct {
+    jpeg_dec_config_t config;
+    uint16_t qt[BJ_TABLES][64];       // zigzag order, as in the file
+    bool qt_defined[BJ_TABLES];
+    bj_huff_t dc[BJ_TABLES];
+    bj_huff_t ac[BJ_TABLES];
+    bj_comp_t comp[BJ_MAX_COMPONENTS];
+    int ncomp;
+    int width, height;
+    int hmax, vmax;
+    int mcus_x, mcus_y, mcu_row;
+    int restart_interval, restarts_left, next_rst;
+
+    // Entropy-coded data; acc holds nbits bits, most significant first
+    const uint8_t *p, *end;
+    uint32_t acc;
+    int nbits;
+    int fake;          // zero bits fed in after a marker or the end of the data
+    bool marker;
+
+    uint8_t *planes;
+    bool ready;
+} bj_dec_t;
+
+static uint16_t be16(const uint8_t *p)
+{
+    return (p[0] << 8) | p[1];
+}
+
+static bool huff_build(bj_huff_t *h, const uint8_t *counts, const uint8_t *vals, int n)
+{
+    int32_t code = 0;
+    int k = 0;
+
+    memset(h, 0, sizeof(*h));
+    for (int len = 1; len <= 16; len++) {
+        h->valoffset[len] = k - code;
+        for (int i = 0; i < counts[len - 1]; i++, k++, code++) {
+            // More codes of this length than there is room for
+            if (code >= (1 << len)) {
+                return false;
+            }
+            if (len <= BJ_LOOKAHEAD) {
+                int shift = BJ_LOOKAHEAD - len;
+                for (int s = 0; s < (1 << shift); s++) {
+                    h->look[(code << shift) | s] = (len << 8) | vals[k];
+                }
+            }
+        }
+        h->maxcode[len] = counts[len - 1] ? code - 1 : -1;
+        code <<= 1;
+    }
+    memcpy(h->huffval, vals, n);
+    h->count = n;
+
+    // Short AC codes resolved together with their value
+    for (int i = 0; i < (1 << BJ_LOOKAHEAD); i++) {
+        if (h->look[i] == 0) {
+            continue;
+        }
+        int len = h->look[i] >> 8;
+        int rs = h->look[i] & 0xFF;
+        int run = rs >> 4, s = rs & 15;
+        if (s == 0 || len + s > BJ_LOOKAHEAD) {
+            continue;
+        }
+        int v = ((i << len) & ((1 << BJ_LOOKAHEAD) - 1)) >> (BJ_LOOKAHEAD - s);
+        if (v < (1 << (s - 1))) {
+            v -= (1 << s) - 1;
+        }
+        if (v >= -128 && v <= 127) {
+            h->fast_ac[i] = (int16_t)(v * 256 + run * 16 + len + s);
+        }
+    }
+    h->defined = true;
+    return true;
+}
+
+// Top up the bit buffer to at least 25 bits. A marker or the end of the data feeds
+// zero bits instead, counted in `fake` so running past the real data is caught
+static inline void fill(bj_dec_t *d)
+{
+    while (d->nbits <= 24) {
+        uint32_t b = 0;
+        if (!d->marker && d->p < d->end) {
+            b = *d->p++;
+            if (b == 0xFF) {
+                if (d->p < d->end && *d->p == 0x00) {
+                    d->p++;
+                } else {
+                    // Left in place for the restart or end-of-scan handling
+                    d->p--;
+                    d->marker = true;
+                    b = 0;
+                    d->fake += 8;
+                }
+            }
+        } else {
+            d->fake += 8;
+        }
+        d->acc |= b << (24 - d->nbits);
+        d->nbits += 8;
+    }
+}
+
+static inline void skip_bits(bj_dec_t *d, int n)
+{
+    d->acc <<= n;
+    d->nbits -= n;
+}
+
+// n in 1..16
+static inline int get_bits(bj_dec_t *d, int n)
+{
+    if (d->nbits < n) {
+        fill(d);
+    }
+    int v = d->acc >> (32 - n);
+    skip_bits(d, n);
+    return v;
+}
+
+static inline int extend(int v, int s)
+{
+    return v < (1 << (s - 1)) ? v - (1 << s) + 1 : v;
+}
+
+static inline int huff_decode(bj_dec_t *d, const bj_huff_t *h)
+{
+    if (d->nbits < 16) {
+        fill(d);
+    }
+    uint16_t e = h->look[d->acc >> (32 - BJ_LOOKAHEAD)];
+    if (e != 0) {
+        skip_bits(d, e >> 8);
+        return e & 0xFF;
+    }
+    for (int len = BJ_LOOKAHEAD + 1; len <= 16; len++) {
+        int32_t code = d->acc >> (32 - len);
+        if (code <= h->maxcode[len]) {
+            int32_t i = code + h->valoffset[len];
+            if (i < 0 || i >= h->count) {
+                return -1;
+            }
+            skip_bits(d, len);
+            return h->huffval[i];
+        }
+    }
+    return -1;
+}
+
+// Dequantized 8-bit coefficients stay within +-1024; corrupt data can go far past that,
+// and the IDCT's 32-bit intermediates only have headroom for this range
+static inline int32_t dequant(int32_t v, int32_t q)
+{
+    v *= q;
+    return v < -1024 ? -1024 : (v > 1024 ? 1024 : v);
+}
+
+// One 8x8 block, dequantized into coef (natural order). Returns false on bad data
+static bool decode_block(bj_dec_t *d, bj_comp_t *c, int32_t *coef, bool *ac)
+{
+    const bj_huff_t *dc = &d->dc[c->td];
+    const bj_huff_t *act = &d->ac[c->ta];
+    const uint16_t *q = d->qt[c->tq];
+
+    int t = huff_decode(d, dc);
+    if (t < 0 || t > 11) {
+        return false;
+    }
+    int diff = t ? extend(get_bits(d, t), t) : 0;
+    // Valid predictions stay within +-1024; keep a corrupt run from overflowing
+    c->dc_pred = c->dc_pred + diff < -16384 ? -16384 : (c->dc_pred + diff > 16384 ? 16384 : c->dc_pred + diff);
+    memset(coef, 0, 64 * sizeof(int32_t));
+    coef[0] = dequant(c->dc_pred, q[0]);
+    *ac = false;
+
+    for (int k = 1; k < 64;) {
+        if (d->nbits < 16) {
+            fill(d);
+        }
+        int f = act->fast_ac[d->acc >> (32 - BJ_LOOKAHEAD)];
+        if (f != 0) {
+            k += (f >> 4) & 15;
+            skip_bits(d, f & 15);
+            if (k > 63) {
+                return false;
+            }
+            coef[s_natural[k]] = dequant(f >> 8, q[k]);
+            *ac = true;
+            k++;
+            continue;
+        }
+        int rs = huff_decode(d, act);
+        if (rs < 0) {
+            return false;
+        }
+        int r = rs >> 4, s = rs & 15;
+        if (s == 0) {
+            if (r != 15) {
+                break;
+            }
+            k += 16;
+            continue;
+        }
+        k += r;
+        if (k > 63 || s > 10) {
+            return false;
+        }
+        coef[s_natural[k]] = dequant(extend(get_bits(d, s), s), q[k]);
+        *ac = true;
+        k++;
+    }
+    return true;
+}
+
+static bool restart(bj_dec_t *d)
+{
+    d->acc = 0;
+    d->nbits = 0;
+    d->fake = 0;
+    d->marker = false;
+    // Fill bytes may precede the marker
+    while (d->p + 1 < d->end && d->p[0] == 0xFF && d->p[1] == 0xFF) {
+        d->p++;
+    }
+    if (d->p + 1 >= d->end || d->p[0] != 0xFF || d->p[1] != M_RST0 + d->next_rst) {
+        return false;
+    }
+    d->p += 2;
+    d->next_rst = (d->next_rst + 1) & 7;
+    for (int i = 0; i < d->ncomp; i++) {
+        d->comp[i].dc_pred = 0;
+    }
+    d->restarts_left = d->restart_interval;
+    return true;
+}
+
+static jpeg_error_t decode_mcu_row(bj_dec_t *d)
+{
+    int32_t coef[64];
+    bool ac;
+
+    for (int mx = 0; mx < d->mcus_x; mx++) {
+        if (d->restart_interval) {
+            if (d->restarts_left == 0 && !restart(d)) {
+                return JPEG_ERR_BAD_DATA;
+            }
+            d->restarts_left--;
+        }
+        for (int i = 0; i < d->ncomp; i++) {
+            bj_comp_t *c = &d->comp[i];
+            for (int by = 0; by < c->v; by++) {
+                uint8_t *row = c->plane + by * 8 * c->stride + mx * c->h * 8;
+                for (int bx = 0; bx < c->h; bx++) {
+                    if (!decode_block(d, c, coef, &ac)) {
+                        return JPEG_ERR_BAD_DATA;
+                    }
+                    if (ac) {
+                        BJ_IDCT(coef, row + bx * 8, c->stride);
+                    } else {
+                        baseline_idct_dc(coef[0], row + bx * 8, c->stride);
+                    }
+                }
+            }
+        }
+        // Truncated: the MCU needed bits past the end of the scan
+        if (d->fake > d->nbits) {
+            return JPEG_ERR_BAD_DATA;
+        }
+    }
+    return JPEG_ERR_OK;
+}
+
+static inline uint8_t clamp8(int v)
+{
+    return v < 0 ? 0 : (v > 255 ? 255 : v);
+}
+
+template <int TYPE>
+static inline void put_pixel(uint8_t *dst, int r, int g, int b)
+{
+    if (TYPE == JPEG_RAW_TYPE_RGB888) {
+        dst[0] = r;
+        dst[1] = g;
+        dst[2] = b;
+        return;
+    }
+    uint16_t px = ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+    if (TYPE == JPEG_RAW_TYPE_RGB565_BE) {
+        dst[0] = px >> 8;
+        dst[1] = px & 0xFF;
+    } else {
+        dst[0] = px & 0xFF;
+        dst[1] = px >> 8;
+    }
+}
+
+// YCbCr to the output format straight from the component planes, one line per call.
+// The chroma terms are worked out once per chroma sample and used for 1 or 2 pixels
+template <int TYPE>
+static void convert_line(bj_dec_t *d, int y, uint8_t *dst)
+{
+    const int bpp = TYPE == JPEG_RAW_TYPE_RGB888 ? 3 : 2;
+    const uint8_t *py = d->comp[0].plane + y * d->comp[0].stride;
+
+    if (d->ncomp == 1) {
+        for (int x = 0; x < d->width; x++) {
+            put_pixel<TYPE>(dst + x * bpp, py[x], py[x], py[x]);
+        }
+        return;
+    }
+
+    int cy = d->vmax == 2 ? y >> 1 : y;
+    const uint8_t *pcb = d->comp[1].plane + cy * d->comp[1].stride;
+    const uint8_t *pcr = d->comp[2].plane + cy * d->comp[2].stride;
+    int hs = d->hmax == 2 ? 1 : 0;
+    for (int cx = 0; (cx << hs) < d->width; cx++) {
+        // libjpeg's jdcolor.c constants, 16 fraction bits
+        int cb = pcb[cx] - 128, cr = pcr[cx] - 128;
+        int dr = (91881 * cr + 32768) >> 16;
+        int dg = (-22554 * cb - 46802 * cr + 32768) >> 16;
+        int db = (116130 * cb + 32768) >> 16;
+        for (int k = 0; k <= hs; k++) {
+            int x = (cx << hs) + k;
+            if (x >= d->width) {
+                break;
+            }
+            int l = py[x];
+            put_pixel<TYPE>(dst + x * bpp, clamp8(l + dr), clamp8(l + dg), clamp8(l + db));
+        }
+    }
+}
+
+static jpeg_error_t parse_dqt(bj_dec_t *d, const uint8_t *p, int len)
+{
+    while (len > 0) {
+        int pq = p[0] >> 4, tq = p[0] & 15;
+        int n = pq ? 128 : 64;
+        if (tq >= BJ_TABLES || pq > 1 || len < 1 + n) {
+            return JPEG_ERR_BAD_DATA;
+        }
+        for (int k = 0; k < 64; k++) {
+            d->qt[tq][k] = pq ? be16(p + 1 + k * 2) : p[1 + k];
+        }
+        d->qt_defined[tq] = true;
+        p += 1 + n;
+        len -= 1 + n;
+    }
+    return JPEG_ERR_OK;
+}
+
+static jpeg_error_t parse_dht(bj_dec_t *d, const uint8_t *p, int len)
+{
+    while (len > 0) {
+        if (len < 17) {
+            return JPEG_ERR_BAD_DATA;
+        }
+        int tc = p[0] >> 4, th = p[0] & 15;
+        int n = 0;
+        for (int i = 0; i < 16; i++) {
+            n += p[1 + i];
+        }
+        if (tc > 1 || th >= BJ_TABLES || n > 256 || len < 17 + n) {
+            return JPEG_ERR_BAD_DATA;
+        }
+        if (!huff_build(tc ? &d->ac[th] : &d->dc[th], p + 1, p + 17, n)) {
+            return JPEG_ERR_BAD_DATA;
+        }
+        p += 17 + n;
+        len -= 17 + n;
+    }
+    return JPEG_ERR_OK;
+}
+
+static jpeg_error_t parse_sof(bj_dec_t *d, const uint8_t *p, int len)
+{
+    if (len < 6) {
+        return JPEG_ERR_BAD_DATA;
+    }
+    if (p[0] != 8) {
+        return JPEG_ERR_UNSUPPORT_STD;
+    }
+    d->height = be16(p + 1);
+    d->width = be16(p + 3);
+    d->ncomp = p[5];
+    if (d->width == 0 || d->height == 0 || len < 6 + d->ncomp * 3) {
+        return JPEG_ERR_BAD_DATA;
+    }
+    if (d->ncomp != 1 && d->ncomp != 3) {
+        return JPEG_ERR_UNSUPPORT_FMT;
+    }
+    for (int i = 0; i < d->ncomp; i++) {
+        bj_comp_t *c = &d->comp[i];
+        c->id = p[6 + i * 3];
+        c->h = p[7 + i * 3] >> 4;
+        c->v = p[7 + i * 3] & 15;
+        c->tq = p[8 + i * 3];
+        if (c->tq >= BJ_TABLES || c->h == 0 || c->v == 0) {
+            return JPEG_ERR_BAD_DATA;
+        }
+    }
+    if (d->ncomp == 1) {
+        // A single-component scan is not interleaved: one block per MCU whatever the factors say
+        d->comp[0].h = d->comp[0].v = 1;
+    } else if (d->comp[0].h > 2 || d->comp[0].v > 2 || d->comp[1].h != 1 || d->comp[1].v != 1 || d->comp[2].h != 1 ||
+               d->comp[2].v != 1) {
+        return JPEG_ERR_UNSUPPORT_FMT;
+    }
+    d->hmax = d->comp[0].h;
+    d->vmax = d->comp[0].v;
+    d->mcus_x = (d->width + d->hmax * 8 - 1) / (d->hmax * 8);
+    d->mcus_y = (d->height + d->vmax * 8 - 1) / (d->vmax * 8);
+    return JPEG_ERR_OK;
+}
+
+static jpeg_error_t parse_sos(bj_dec_t *d, const uint8_t *p, int len)
+{
+    if (len < 1 || p[0] != d->ncomp || len < 4 + p[0] * 2) {
+        // Several scans, one per component, is legal baseline but not something cameras write
+        return len >= 1 && p[0] != d->ncomp ? JPEG_ERR_UNSUPPORT_FMT : JPEG_ERR_BAD_DATA;
+    }
+    for (int i = 0; i < d->ncomp; i++) {
+        int id = p[1 + i * 2];
+        int j = 0;
+        while (j < d->ncomp && d->comp[j].id != id) {
+            j++;
+        }
+        if (j == d->ncomp) {
+            return JPEG_ERR_BAD_DATA;
+        }
+        bj_comp_t *c = &d->comp[j];
+        c->td = p[2 + i * 2] >> 4;
+        c->ta = p[2 + i * 2] & 15;
+        if (c->td >= BJ_TABLES || c->ta >= BJ_TABLES || !d->dc[c->td].defined || !d->ac[c->ta].defined ||
+            !d->qt_defined[c->tq]) {
+            return JPEG_ERR_BAD_DATA;
+        }
+    }
+    // Spectral selection and approximation must cover the whole block in one go
+    const uint8_t *s = p + 1 + d->ncomp * 2;
+    if (s[0] != 0 || s[1] != 63 || s[2] != 0) {
+        return JPEG_ERR_UNSUPPORT_STD;
+    }
+    return JPEG_ERR_OK;
+}
+
+static jpeg_error_t alloc_planes(bj_dec_t *d)
+{
+    size_t total = 0;
+    for (int i = 0; i < d->ncomp; i++) {
+        bj_comp_t *c = &d->comp[i];
+        c->stride = d->mcus_x * c->h * 8;
+        total += (size_t)c->stride * c->v * 8;
+    }
+    // Internal RAM keeps the IDCT stores and the conversion reads fast; big images make do with PSRAM.
+    // The caller's output strip, one MCU row of RGB565, has to fit in internal RAM after the planes
+    size_t strip = (size_t)d->width * d->vmax * 8 * 2;
+    bool room = !pipeline_mem.started() || pipeline_mem.stats(ARENA_INTERNAL).largest_free >= total + strip + 64;
+    d->planes = room ? (uint8_t *)pipeline_malloc_align(total, ARENA_INTERNAL) : NULL;
+    if (d->planes == NULL) {
+        d->planes = (uint8_t *)pipeline_malloc_align(total, ARENA_PSRAM);
+    }
+    if (d->planes == NULL) {
+        return JPEG_ERR_MEM;
+    }
+    uint8_t *at = d->planes;
+    for (int i = 0; i < d->ncomp; i++) {
+        d->comp[i].plane = at;
+        at += (size_t)d->comp[i].stride * d->comp[i].v * 8;
+    }
+    return JPEG_ERR_OK;
+}
+
+jpeg_dec_handle_t *baseline_jpeg_open(jpeg_dec_config_t *config)
+{
+    if (config == NULL) {
+        return NULL;
+    }
+    bj_dec_t *d = (bj_dec_t *)calloc(1, sizeof(bj_dec_t));
+    if (d != NULL) {
+        d->config = *config;
+    }
+    return (jpeg_dec_handle_t *)d;
+}
+
+jpeg_error_t baseline_jpeg_parse_header(jpeg_dec_handle_t *jpeg_dec, jpeg_dec_io_t *io, jpeg_dec_header_info_t *out_info)
+{
+    bj_dec_t *d = (bj_dec_t *)jpeg_dec;
+    if (d == NULL || io == NULL || out_info == NULL || io->inbuf == NULL || io->inbuf_len <= 0 || d->ready) {
+        return JPEG_ERR_INVALID_PARAM;
+    }
+
+    const uint8_t *p = io->inbuf;
+    const uint8_t *end = p + io->inbuf_len;
+    bool sof = false;
+    jpeg_error_t err = JPEG_ERR_OK;
+    if (end - p < 4 || p[0] != 0xFF || p[1] != M_SOI) {
+        return JPEG_ERR_BAD_DATA;
+    }
+    p += 2;
+
+    for (;;) {
+        // Any number of 0xFF may pad the gap before a marker
+        while (p < end && *p != 0xFF) {
+            p++;
+        }
+        while (p < end && *p == 0xFF) {
+            p++;
+        }
+        if (end - p < 3) {
+            return JPEG_ERR_BAD_DATA;
+        }
+        uint8_t m = p[0];
+        int len = be16(p + 1);
+        if (len < 2 || len > end - p - 1) {
+            return JPEG_ERR_BAD_DATA;
+        }
+        const uint8_t *seg = p + 3;
+        len -= 2;
+        p += 1 + len + 2;
+
+        if (m == M_DQT) {
+            err = parse_dqt(d, seg, len);
+        } else if (m == M_DHT) {
+            err = parse_dht(d, seg, len);
+        } else if (m == M_SOF0 || m == M_SOF1) {
+            err = sof ? JPEG_ERR_BAD_DATA : parse_sof(d, seg, len);
+            sof = true;
+        } else if (m >= 0xC2 && m <= 0xCF && m != M_DHT && m != 0xC8 && m != 0xCC) {
+            // Progressive, lossless, hierarchical or arithmetic coding
+            return JPEG_ERR_UNSUPPORT_STD;
+        } else if (m == M_DRI) {
+            err = len >= 2 ? JPEG_ERR_OK : JPEG_ERR_BAD_DATA;
+            d->restart_interval = len >= 2 ? be16(seg) : 0;
+        } else if (m == M_SOS) {
+            err = sof ? parse_sos(d, seg, len) : JPEG_ERR_BAD_DATA;
+            break;
+        } else if (m == M_EOI || m == M_SOI) {
+            return JPEG_ERR_BAD_DATA;
+        }
+        // APPn, COM and the rest are skipped
+        if (err != JPEG_ERR_OK) {
+            return err;
+        }
+    }
+    if (err != JPEG_ERR_OK) {
+        return err;
+    }
+    err = alloc_planes(d);
+    if (err != JPEG_ERR_OK) {
+        return err;
+    }
+
+    d->p = p;
+    d->end = end;
+    d->restarts_left = d->restart_interval;
+    d->ready = true;
+
+    memset(out_info, 0, sizeof(*out_info));
+    out_info->width = d->width;
+    out_info->height = d->height;
+    out_info->component_num = d->ncomp;
+    for (int i = 0; i < d->ncomp; i++) {
+        out_info->x_factory[i] = d->comp[i].h;
+        out_info->y_factory[i] = d->comp[i].v;
+    }
+    io->output_line = 0;
+    io->cur_line = 0;
+    io->output_height = d->height;
+    io->inbuf_remain = (int)(end - p);
+    return JPEG_ERR_OK;
+}
+
+jpeg_error_t baseline_jpeg_process(jpeg_dec_handle_t *jpeg_dec, jpeg_dec_io_t *io)
+{
+    bj_dec_t *d = (bj_dec_t *)jpeg_dec;
+    if (d == NULL || io == NULL || io->outbuf == NULL || !d->ready) {
+        return JPEG_ERR_INVALID_PARAM;
+    }
+    if (d->mcu_row >= d->mcus_y || io->output_line >= io->output_height) {
+        return JPEG_ERR_NO_MORE_DATA;
+    }
+
+    int bpp = d->config.output_type == JPEG_RAW_TYPE_RGB888 ? 3 : 2;
+    int mcu_h = d->vmax * 8;
+    int done = 0;
+    do {
+        jpeg_error_t err = decode_mcu_row(d);
+        if (err != JPEG_ERR_OK) {
+            return err;
+        }
+        int lines = d->height - d->mcu_row * mcu_h;
+        lines = lines < mcu_h ? lines : mcu_h;
+        for (int y = 0; y < lines; y++) {
+            uint8_t *dst = io->outbuf + (size_t)(done + y) * d->width * bpp;
+            switch (d->config.output_type) {
+            case JPEG_RAW_TYPE_RGB565_BE:
+                convert_line<JPEG_RAW_TYPE_RGB565_BE>(d, y, dst);
+                break;
+            case JPEG_RAW_TYPE_RGB565_LE:
+                convert_line<JPEG_RAW_TYPE_RGB565_LE>(d, y, dst);
+                break;
+            default:
+                convert_line<JPEG_RAW_TYPE_RGB888>(d, y, dst);
+                break;
+            }
+        }
+        d->mcu_row++;
+        done += lines;
+    } while (!d->config.block_enable && d->mcu_row < d->mcus_y);
+
+    io->cur_line = done;
+    io->output_line += done;
+    io->inbuf_remain = (int)(d->end - d->p);
+    return JPEG_ERR_OK;
+}
+
+jpeg_error_t baseline_jpeg_close(jpeg_dec_handle_t *jpeg_dec)
+{
+    bj_dec_t *d = (bj_dec_t *)jpeg_dec;
+    if (d == NULL) {
+        return JPEG_ERR_INVALID_PARAM;
+    }
+    pipeline_free_align(d->planes);
+    free(d);
+    return JPEG_ERR_OK;
+}
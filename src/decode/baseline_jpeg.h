@@ -0,0 +1,28 @@
+#ifndef _BASELINE_JPEG_H
+#define _BASELINE_JPEG_H
+#include <ESP32_JPEG_Library.h>
+
+/*
+ * In-tree baseline JPEG decoder with the block contract of the ESP32_JPEG
+ * library, so jpeg_dec.h can drive either one (jpeg_dec_limits_t.backend,
+ * JPEG_DEC_BACKEND).
+ *
+ * Takes sequential Huffman-coded 8-bit JPEGs: greyscale, or YCbCr with the
+ * luma sampled 1x1, 2x1, 1x2 or 2x2 and chroma 1x1, with or without restart
+ * intervals. Progressive, arithmetic-coded and 12-bit files are refused with
+ * JPEG_ERR_UNSUPPORT_STD, other layouts with JPEG_ERR_UNSUPPORT_FMT.
+ *
+ * With config->block_enable each process() call decodes one MCU row (8 or 16
+ * lines, fewer at the bottom) into io->outbuf, sets io->cur_line and advances
+ * io->output_line; without it, one call decodes the whole picture. Huffman
+ * codes are resolved 9 bits at a time through lookup tables, short AC codes
+ * together with their value; blocks go through the IDCT of baseline_idct.h
+ * and each output line is converted from YCbCr to RGB565 in one pass, chroma
+ * replicated, using libjpeg's fixed-point coefficients.
+ */
+jpeg_dec_handle_t *baseline_jpeg_open(jpeg_dec_config_t *config);
+jpeg_error_t baseline_jpeg_parse_header(jpeg_dec_handle_t *jpeg_dec, jpeg_dec_io_t *io, jpeg_dec_header_info_t *out_info);
+jpeg_error_t baseline_jpeg_process(jpeg_dec_handle_t *jpeg_dec, jpeg_dec_io_t *io);
+jpeg_error_t baseline_jpeg_close(jpeg_dec_handle_t *jpeg_dec);
+
+#endif
@@ -0,0 +1,248 @@
+#include <string.h>
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "image_source.h"
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+static const char *TAG = "image_source";
+
+static bool is_aligned(const void *p)
+{
+    return ((uintptr_t)p & 15) == 0;
+}
+
+image_source::image_source()
+{
+    _held = false;
+    resetStats();
+}
+
+image_source_err_t image_source::acquired(image_source_err_t err, const uint8_t *data, size_t len, uint32_t t0,
+                                          size_t copied)
+{
+    if (err == IMAGE_SOURCE_OK && !is_aligned(data)) {
+        err = IMAGE_SOURCE_ERR_ALIGN;
+    }
+    if (err == IMAGE_SOURCE_OK) {
+        _held = true;
+        _stats.bytes = len;
+        _stats.copied = copied;
+        _stats.acquire_us = (uint32_t)esp_timer_get_time() - t0;
+        _stats.acquires++;
+    } else {
+        ESP_LOGW(TAG, "%s: %s", name(), errName(err));
+    }
+    return err;
+}
+
+image_source_stats_t image_source::stats()
+{
+    return _stats;
+}
+
+void image_source::resetStats()
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+const char *image_source::errName(image_source_err_t err)
+{
+    switch (err) {
+    case IMAGE_SOURCE_OK:
+        return "ok";
+    case IMAGE_SOURCE_ERR_OPEN:
+        return "not found";
+    case IMAGE_SOURCE_ERR_EMPTY:
+        return "empty";
+    case IMAGE_SOURCE_ERR_RANGE:
+        return "out of range";
+    case IMAGE_SOURCE_ERR_ALIGN:
+        return "not 16-byte aligned";
+    case IMAGE_SOURCE_ERR_MAP:
+        return "mapping failed";
+    case IMAGE_SOURCE_ERR_NO_MEM:
+        return "out of memory";
+    case IMAGE_SOURCE_ERR_READ:
+        return "read failed";
+    case IMAGE_SOURCE_ERR_BUSY:
+        return "already acquired";
+    default:
+        return "unknown";
+    }
+}
+
+ram_image_source::ram_image_source(const uint8_t *data, size_t len)
+{
+    set(data, len);
+}
+
+void ram_image_source::set(const uint8_t *data, size_t len)
+{
+    _data = data;
+    _len = len;
+}
+
+image_source_err_t ram_image_source::acquire(const uint8_t **data, size_t *len)
+{
+    uint32_t t = (uint32_t)esp_timer_get_time();
+    image_source_err_t err = _held ? IMAGE_SOURCE_ERR_BUSY : IMAGE_SOURCE_OK;
+    if (err == IMAGE_SOURCE_OK && (_data == NULL || _len == 0)) {
+        err = IMAGE_SOURCE_ERR_EMPTY;
+    }
+    *data = _data;
+    *len = _len;
+    return acquired(err, _data, _len, t, 0);
+}
+
+void ram_image_source::release()
+{
+    _held = false;
+}
+
+const char *ram_image_source::name()
+{
+    return "ram";
+}
+
+#ifdef ESP_PLATFORM
+flash_image_source::flash_image_source(const char *label, uint32_t offset, size_t len)
+{
+    _label = label;
+    _offset = offset;
+    _len = len;
+    _map = 0;
+}
+
+flash_image_source::~flash_image_source()
+{
+    release();
+}
+
+image_source_err_t flash_image_source::acquire(const uint8_t **data, size_t *len)
+{
+    uint32_t t = (uint32_t)esp_timer_get_time();
+    const void *ptr = NULL;
+    size_t size = 0;
+
+    *data = NULL;
+    *len = 0;
+    if (_held) {
+        return acquired(IMAGE_SOURCE_ERR_BUSY, NULL, 0, t, 0);
+    }
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, _label);
+    image_source_err_t err = part == NULL ? IMAGE_SOURCE_ERR_OPEN : IMAGE_SOURCE_OK;
+    if (err == IMAGE_SOURCE_OK) {
+        size = _len != 0 ? _len : (_offset < part->size ? part->size - _offset : 0);
+        if (_offset >= part->size || size > part->size - _offset) {
+            err = IMAGE_SOURCE_ERR_RANGE;
+        } else if ((_offset & 15) != 0) {
+            err = IMAGE_SOURCE_ERR_ALIGN;
+        }
+    }
+    // The MMU maps whole 64 KB pages; the driver hands back a pointer to our offset within them
+    if (err == IMAGE_SOURCE_OK &&
+        esp_partition_mmap(part, _offset, size, ESP_PARTITION_MMAP_DATA, &ptr, &_map) != ESP_OK) {
+        err = IMAGE_SOURCE_ERR_MAP;
+    }
+    if (err == IMAGE_SOURCE_OK) {
+        const uint8_t *p = (const uint8_t *)ptr;
+        // An erased partition reads 0xFF; say so instead of handing the decoder a blank
+        if (p[0] != 0xFF || p[1] != 0xD8) {
+            err = IMAGE_SOURCE_ERR_EMPTY;
+            esp_partition_munmap(_map);
+            _map = 0;
+        }
+    }
+    if (err == IMAGE_SOURCE_OK) {
+        *data = (const uint8_t *)ptr;
+        *len = size;
+    }
+    return acquired(err, *data, size, t, 0);
+}
+
+void flash_image_source::release()
+{
+    if (_map != 0) {
+        esp_partition_munmap(_map);
+        _map = 0;
+    }
+    _held = false;
+}
+
+const char *flash_image_source::name()
+{
+    return _label;
+}
+#endif
+
+#ifdef __linux__
+mmap_image_source::mmap_image_source(const char *path)
+    : _path(path)
+{
+    _map = NULL;
+    _map_len = 0;
+}
+
+mmap_image_source::~mmap_image_source()
+{
+    release();
+}
+
+image_source_err_t mmap_image_source::acquire(const uint8_t **data, size_t *len)
+{
+    uint32_t t = (uint32_t)esp_timer_get_time();
+    struct stat st;
+
+    *data = NULL;
+    *len = 0;
+    if (_held) {
+        return acquired(IMAGE_SOURCE_ERR_BUSY, NULL, 0, t, 0);
+    }
+    int fd = open(_path.c_str(), O_RDONLY);
+    image_source_err_t err = fd < 0 ? IMAGE_SOURCE_ERR_OPEN : IMAGE_SOURCE_OK;
+    if (err == IMAGE_SOURCE_OK && (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))) {
+        err = IMAGE_SOURCE_ERR_OPEN;
+    }
+    if (err == IMAGE_SOURCE_OK && st.st_size == 0) {
+        err = IMAGE_SOURCE_ERR_EMPTY;
+    }
+    if (err == IMAGE_SOURCE_OK) {
+        _map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (_map == MAP_FAILED) {
+            _map = NULL;
+            err = IMAGE_SOURCE_ERR_MAP;
+        } else {
+            _map_len = st.st_size;
+            madvise(_map, _map_len, MADV_SEQUENTIAL);
+        }
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+    if (err == IMAGE_SOURCE_OK) {
+        *data = (const uint8_t *)_map;
+        *len = _map_len;
+    }
+    return acquired(err, *data, *len, t, 0);
+}
+
+void mmap_image_source::release()
+{
+    if (_map != NULL) {
+        munmap(_map, _map_len);
+        _map = NULL;
+        _map_len = 0;
+    }
+    _held = false;
+}
+
+const char *mmap_image_source::name()
+{
+    return _path.c_str();
+}
+#endif
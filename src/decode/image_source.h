@@ -0,0 +1,125 @@
+#ifndef _IMAGE_SOURCE_H
+#define _IMAGE_SOURCE_H
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+typedef enum {
+    IMAGE_SOURCE_OK = 0,
+    IMAGE_SOURCE_ERR_OPEN,   // file or partition not found
+    IMAGE_SOURCE_ERR_EMPTY,
+    IMAGE_SOURCE_ERR_RANGE,  // offset or length outside the partition or file
+    IMAGE_SOURCE_ERR_ALIGN,  // the decoder needs the JPEG 16-byte aligned
+    IMAGE_SOURCE_ERR_MAP,    // the MMU or mmap() refused the mapping
+    IMAGE_SOURCE_ERR_NO_MEM,
+    IMAGE_SOURCE_ERR_READ,
+    IMAGE_SOURCE_ERR_BUSY,   // acquired and not yet released
+} image_source_err_t;
+
+typedef struct {
+    size_t bytes;           // size of the last image handed out
+    uint32_t acquire_us;    // time until the decoder could start on it
+    size_t copied;          // bytes moved to get it there; 0 for mapped sources
+    uint32_t acquires;
+} image_source_stats_t;
+
+/*
+ * Where a JPEG comes from.
+ *
+ * acquire() hands out the whole image as one 16-byte aligned, read-only span,
+ * which is what the block decoder takes; release() gives it back. Sources
+ * that already hold the bytes in the address space (a RAM buffer, a flash
+ * partition mapped through the cache MMU, an mmap()ed file on the host)
+ * return a pointer into them and copy nothing; only a file on SD has to be
+ * read in first (sd_image_source in src/sd). One source serves one
+ * acquire() at a time.
+ */
+class image_source
+{
+public:
+    virtual ~image_source() {}
+
+    virtual image_source_err_t acquire(const uint8_t **data, size_t *len) = 0;
+    virtual void release() = 0;
+    virtual const char *name() = 0;
+
+    image_source_stats_t stats();
+    void resetStats();
+    static const char *errName(image_source_err_t err);
+
+protected:
+    image_source();
+    // Common bookkeeping at the end of acquire()
+    image_source_err_t acquired(image_source_err_t err, const uint8_t *data, size_t len, uint32_t t0, size_t copied);
+
+    bool _held;
+    image_source_stats_t _stats;
+};
+
+// A JPEG already in memory: a const array compiled into the firmware, or a buffer filled elsewhere
+class ram_image_source : public image_source
+{
+public:
+    ram_image_source(const uint8_t *data = NULL, size_t len = 0);
+
+    void set(const uint8_t *data, size_t len);
+    image_source_err_t acquire(const uint8_t **data, size_t *len);
+    void release();
+    const char *name();
+
+private:
+    const uint8_t *_data;
+    size_t _len;
+};
+
+#ifdef ESP_PLATFORM
+#include "esp_partition.h"
+
+/*
+ * A JPEG written into a data partition, e.g. with
+ *   esptool.py write_flash <partition address + offset> image.jpg
+ * Mapped into the data address space through the cache MMU on acquire() and
+ * unmapped on release(), so the decoder reads flash directly and the image
+ * costs no RAM and no load time. With len 0 the mapping runs to the end of
+ * the partition; the decoder stops at EOI and never looks at the erased
+ * bytes after it. The offset must be a multiple of 16.
+ */
+class flash_image_source : public image_source
+{
+public:
+    flash_image_source(const char *label, uint32_t offset = 0, size_t len = 0);
+    ~flash_image_source();
+
+    image_source_err_t acquire(const uint8_t **data, size_t *len);
+    void release();
+    const char *name();
+
+private:
+    const char *_label;
+    uint32_t _offset;
+    size_t _len;
+    esp_partition_mmap_handle_t _map;
+};
+#endif
+
+#ifdef __linux__
+// Host builds: a file mmap()ed read-only, so host tools decode through the same path as the device
+class mmap_image_source : public image_source
+{
+public:
+    mmap_image_source(const char *path);
+    ~mmap_image_source();
+
+    image_source_err_t acquire(const uint8_t **data, size_t *len);
+    void release();
+    const char *name();
+
+private:
+    std::string _path;
+    void *_map;
+    size_t _map_len;
+};
+#endif
+
+#endif
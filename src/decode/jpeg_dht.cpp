@@ -0,0 +1,106 @@
+#include <string.h>
+#include "jpeg_dht.h"
+
+#define JPEG_M_SOI (0xD8)
+#define JPEG_M_SOS (0xDA)
+#define JPEG_M_DHT (0xC4)
+
+// Luminance DC, luminance AC, chrominance DC, chrominance AC: marker, length, class/id, 16 counts, symbols
+const uint8_t jpeg_dht_default[JPEG_DHT_DEFAULT_SIZE] = {
+    0xFF, 0xC4, 0x00, 0x1F, 0x00,
+    0x00, 0x01, 0x05, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B,
+
+    0xFF, 0xC4, 0x00, 0xB5, 0x10,
+    0x00, 0x02, 0x01, 0x03, 0x03, 0x02, 0x04, 0x03, 0x05, 0x05, 0x04, 0x04, 0x00, 0x00, 0x01, 0x7D,
+    0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07,
+    0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xA1, 0x08, 0x23, 0x42, 0xB1, 0xC1, 0x15, 0x52, 0xD1, 0xF0,
+    0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0A, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2A, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+    0x4A, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+    0x6A, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89,
+    0x8A, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7,
+    0xA8, 0xA9, 0xAA, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xC2, 0xC3, 0xC4, 0xC5,
+    0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA, 0xE1, 0xE2,
+    0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9, 0xEA, 0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8,
+    0xF9, 0xFA,
+
+    0xFF, 0xC4, 0x00, 0x1F, 0x01,
+    0x00, 0x03, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B,
+
+    0xFF, 0xC4, 0x00, 0xB5, 0x11,
+    0x00, 0x02, 0x01, 0x02, 0x04, 0x04, 0x03, 0x04, 0x07, 0x05, 0x04, 0x04, 0x00, 0x01, 0x02, 0x77,
+    0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71,
+    0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xA1, 0xB1, 0xC1, 0x09, 0x23, 0x33, 0x52, 0xF0,
+    0x15, 0x62, 0x72, 0xD1, 0x0A, 0x16, 0x24, 0x34, 0xE1, 0x25, 0xF1, 0x17, 0x18, 0x19, 0x1A, 0x26,
+    0x27, 0x28, 0x29, 0x2A, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48,
+    0x49, 0x4A, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68,
+    0x69, 0x6A, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+    0x88, 0x89, 0x8A, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A, 0xA2, 0xA3, 0xA4, 0xA5,
+    0xA6, 0xA7, 0xA8, 0xA9, 0xAA, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xC2, 0xC3,
+    0xC4, 0xC5, 0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA,
+    0xE2, 0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9, 0xEA, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8,
+    0xF9, 0xFA,
+};
+
+jpeg_dht_result_t jpeg_dht_scan(const uint8_t *data, size_t len, size_t *sos)
+{
+    if (len < 4 || data[0] != 0xFF || data[1] != JPEG_M_SOI) {
+        return JPEG_DHT_NOT_JPEG;
+    }
+    size_t pos = 2;
+    while (pos + 1 < len) {
+        if (data[pos] != 0xFF) {
+            return JPEG_DHT_NOT_JPEG;
+        }
+        // Any marker may be preceded by fill bytes
+        while (pos + 1 < len && data[pos + 1] == 0xFF) {
+            pos++;
+        }
+        if (pos + 1 >= len) {
+            break;
+        }
+        uint8_t m = data[pos + 1];
+        if (m == JPEG_M_DHT) {
+            return JPEG_DHT_PRESENT;
+        }
+        if (m == JPEG_M_SOS) {
+            if (sos != NULL) {
+                *sos = pos;
+            }
+            return JPEG_DHT_MISSING;
+        }
+        if (m == 0x01 || (m >= 0xD0 && m <= 0xD7)) {
+            pos += 2;
+            continue;
+        }
+        if (pos + 4 > len) {
+            break;
+        }
+        size_t seg = (data[pos + 2] << 8) | data[pos + 3];
+        if (seg < 2) {
+            return JPEG_DHT_NOT_JPEG;
+        }
+        pos += 2 + seg;
+    }
+    return JPEG_DHT_NOT_JPEG;
+}
+
+uint8_t *jpeg_dht_fix(uint8_t *buf, size_t *len, jpeg_dht_result_t *result)
+{
+    size_t sos = 0;
+    jpeg_dht_result_t r = jpeg_dht_scan(buf + JPEG_DHT_DEFAULT_SIZE, *len, &sos);
+    if (result != NULL) {
+        *result = r;
+    }
+    if (r != JPEG_DHT_MISSING) {
+        // Complete, or not something the tables would help; the decoder has the last word
+        return buf + JPEG_DHT_DEFAULT_SIZE;
+    }
+    // Headers down into the headroom, the tables in the gap they leave in front of SOS
+    memmove(buf, buf + JPEG_DHT_DEFAULT_SIZE, sos);
+    memcpy(buf + sos, jpeg_dht_default, JPEG_DHT_DEFAULT_SIZE);
+    *len += JPEG_DHT_DEFAULT_SIZE;
+    return buf;
+}
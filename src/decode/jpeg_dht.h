@@ -0,0 +1,34 @@
+#ifndef _JPEG_DHT_H
+#define _JPEG_DHT_H
+#include <stdint.h>
+#include <stddef.h>
+
+// The tables of ITU-T T.81 K.3 as four DHT segments; 432 bytes keeps a 16-byte aligned frame aligned
+#define JPEG_DHT_DEFAULT_SIZE (432)
+
+typedef enum {
+    JPEG_DHT_PRESENT = 0,
+    JPEG_DHT_MISSING,     // SOS reached with no DHT segment before it
+    JPEG_DHT_NOT_JPEG,    // no SOI, or the segments run off the end before SOS
+} jpeg_dht_result_t;
+
+extern const uint8_t jpeg_dht_default[JPEG_DHT_DEFAULT_SIZE];
+
+/*
+ * MJPEG frames without Huffman tables.
+ *
+ * Motion JPEG as cameras and AVI files carry it (the AVI1 APP0 flavour)
+ * commonly drops the DHT segments from every frame, relying on the standard
+ * tables of T.81 Annex K; neither decoder behind jpeg_dec.h assumes them.
+ * jpeg_dht_scan() walks the marker segments up to SOS. jpeg_dht_fix() takes a
+ * frame read JPEG_DHT_DEFAULT_SIZE bytes into its buffer and, when the tables
+ * are missing, moves the headers down into that headroom and puts the default
+ * tables between them and SOS, so the entropy-coded data is never copied.
+ * Either way the result starts 16-byte aligned if the buffer does.
+ */
+// *sos: offset of the SOS marker, when one is found
+jpeg_dht_result_t jpeg_dht_scan(const uint8_t *data, size_t len, size_t *sos);
+// The frame is at buf + JPEG_DHT_DEFAULT_SIZE, *len bytes; returns where the decodable frame starts, and its length
+uint8_t *jpeg_dht_fix(uint8_t *buf, size_t *len, jpeg_dht_result_t *result = NULL);
+
+#endif
@@ -0,0 +1,267 @@
+#include <string.h>
+#include "jpeg_thumb.h"
+
+#define JPEG_M_SOI (0xD8)
+#define JPEG_M_EOI (0xD9)
+#define JPEG_M_SOS (0xDA)
+#define JPEG_M_APP0 (0xE0)
+#define JPEG_M_APP1 (0xE1)
+
+#define EXIF_TAG_COMPRESSION (0x0103)
+#define EXIF_TAG_JPEG_OFFSET (0x0201)
+#define EXIF_TAG_JPEG_LENGTH (0x0202)
+#define EXIF_COMPRESSION_JPEG (6)
+#define EXIF_TYPE_SHORT (3)
+
+// TIFF fields in the byte order the EXIF block declares
+typedef struct {
+    const uint8_t *base;
+    uint32_t len;
+    bool le;
+} tiff_t;
+
+static uint16_t be16(const uint8_t *p)
+{
+    return (p[0] << 8) | p[1];
+}
+
+static uint16_t tiff16(const tiff_t *t, uint32_t off)
+{
+    const uint8_t *p = t->base + off;
+    return t->le ? p[0] | (p[1] << 8) : (p[0] << 8) | p[1];
+}
+
+static uint32_t tiff32(const tiff_t *t, uint32_t off)
+{
+    uint32_t a = tiff16(t, off), b = tiff16(t, off + 2);
+    return t->le ? a | (b << 16) : (a << 16) | b;
+}
+
+static bool is_sof(uint8_t m)
+{
+    return m >= 0xC0 && m <= 0xCF && m != 0xC4 && m != 0xC8 && m != 0xCC;
+}
+
+// Frame header at p (its marker), avail bytes from there on
+static bool parse_sof(const uint8_t *p, uint32_t avail, jpeg_frame_t *frame)
+{
+    uint8_t m = p[1];
+    if (avail < 12 || be16(p + 2) < 8) {
+        return false;
+    }
+    frame->height = be16(p + 5);
+    frame->width = be16(p + 7);
+    frame->components = p[9];
+    frame->sampling = p[11];
+    frame->progressive = m == 0xC2 || m == 0xC6 || m == 0xCA || m == 0xCE;
+    return frame->width != 0 && frame->height != 0 && frame->components != 0;
+}
+
+// Size and coding from the thumbnail's own frame header
+static bool thumb_frame(const uint8_t *p, uint32_t len, jpeg_thumb_info_t *info)
+{
+    if (len < 4 || p[0] != 0xFF || p[1] != JPEG_M_SOI) {
+        return false;
+    }
+    uint32_t pos = 2;
+    while (pos + 4 <= len) {
+        uint8_t m = p[pos + 1];
+        if (p[pos] != 0xFF) {
+            return false;
+        }
+        if (m == 0xFF) {
+            pos++;
+            continue;
+        }
+        if (m == JPEG_M_SOS || m == JPEG_M_EOI) {
+            return false;
+        }
+        if (is_sof(m)) {
+            jpeg_frame_t frame;
+            if (!parse_sof(p + pos, len - pos, &frame)) {
+                return false;
+            }
+            info->width = frame.width;
+            info->height = frame.height;
+            info->progressive = frame.progressive;
+            return true;
+        }
+        pos += 2 + be16(p + pos + 2);
+    }
+    return false;
+}
+
+// TIFF header, then past IFD0 to IFD1, which describes the thumbnail
+static jpeg_thumb_result_t exif_thumb(const uint8_t *tiff, uint32_t len, uint32_t *off, uint32_t *size)
+{
+    if (len < 8 || !((tiff[0] == 'I' && tiff[1] == 'I') || (tiff[0] == 'M' && tiff[1] == 'M'))) {
+        return JPEG_THUMB_BAD;
+    }
+    tiff_t t = {tiff, len, tiff[0] == 'I'};
+    if (tiff16(&t, 2) != 42) {
+        return JPEG_THUMB_BAD;
+    }
+
+    uint32_t ifd = tiff32(&t, 4);
+    if (ifd >= len - 2 || (uint32_t)tiff16(&t, ifd) * 12 + 6 > len - ifd) {
+        return JPEG_THUMB_BAD;
+    }
+    ifd = tiff32(&t, ifd + 2 + tiff16(&t, ifd) * 12);
+    if (ifd == 0) {
+        return JPEG_THUMB_NONE;
+    }
+    if (ifd >= len - 2 || (uint32_t)tiff16(&t, ifd) * 12 + 2 > len - ifd) {
+        return JPEG_THUMB_BAD;
+    }
+
+    uint16_t n = tiff16(&t, ifd);
+    uint32_t compression = EXIF_COMPRESSION_JPEG;
+    *off = 0;
+    *size = 0;
+    for (uint16_t i = 0; i < n; i++) {
+        uint32_t e = ifd + 2 + i * 12;
+        uint32_t value = tiff16(&t, e + 2) == EXIF_TYPE_SHORT ? tiff16(&t, e + 8) : tiff32(&t, e + 8);
+        switch (tiff16(&t, e)) {
+        case EXIF_TAG_COMPRESSION:
+            compression = value;
+            break;
+        case EXIF_TAG_JPEG_OFFSET:
+            *off = value;
+            break;
+        case EXIF_TAG_JPEG_LENGTH:
+            *size = value;
+            break;
+        default:
+            break;
+        }
+    }
+    // IFD1 may describe an uncompressed TIFF strip instead
+    if (compression != EXIF_COMPRESSION_JPEG || *size == 0) {
+        return JPEG_THUMB_NONE;
+    }
+    if (*off > len || *size > len - *off) {
+        return JPEG_THUMB_BAD;
+    }
+    return JPEG_THUMB_OK;
+}
+
+// Walk the segments ahead of the image data. Without a frame to fill in, stop at the
+// first usable thumbnail; with one, go on to the frame header and note any thumbnail
+static jpeg_thumb_result_t walk(const uint8_t *head, size_t len, jpeg_thumb_info_t *thumb, bool *has_thumb,
+                                jpeg_frame_t *frame, uint32_t *need)
+{
+    if (len < 4) {
+        *need = JPEG_THUMB_HEAD_SIZE;
+        return JPEG_THUMB_NEED_MORE;
+    }
+    if (head[0] != 0xFF || head[1] != JPEG_M_SOI) {
+        return JPEG_THUMB_NOT_JPEG;
+    }
+
+    bool bad = false;
+    size_t pos = 2;
+    for (;;) {
+        if (pos + 4 > len) {
+            *need = pos + 4;
+            return JPEG_THUMB_NEED_MORE;
+        }
+        uint8_t m = head[pos + 1];
+        if (head[pos] != 0xFF) {
+            // Not a marker where one should be; the decoder will have its say on the file
+            break;
+        }
+        if (m == 0xFF) {
+            pos++;
+            continue;
+        }
+        if (is_sof(m) && frame != NULL) {
+            if (pos + 12 > len) {
+                *need = pos + 12;
+                return JPEG_THUMB_NEED_MORE;
+            }
+            return parse_sof(head + pos, len - pos, frame) ? JPEG_THUMB_OK : JPEG_THUMB_BAD;
+        }
+        // Thumbnails live in the application segments ahead of the frame
+        if (m == JPEG_M_SOS || m == JPEG_M_EOI || m == JPEG_M_SOI || is_sof(m)) {
+            break;
+        }
+        uint32_t seg = be16(head + pos + 2);
+        if (seg < 2) {
+            break;
+        }
+
+        if ((m == JPEG_M_APP0 || m == JPEG_M_APP1) && !*has_thumb) {
+            // The identifier first, so segments of no interest (XMP, ICC) are never read whole
+            if (pos + 10 > len) {
+                *need = pos + 10;
+                return JPEG_THUMB_NEED_MORE;
+            }
+            const uint8_t *p = head + pos + 4;
+            bool exif = m == JPEG_M_APP1 && seg >= 8 && memcmp(p, "Exif\0\0", 6) == 0;
+            bool jfxx = m == JPEG_M_APP0 && seg >= 8 && memcmp(p, "JFXX\0", 5) == 0 && p[5] == 0x10;
+            if (exif || jfxx) {
+                if (pos + 2 + seg > len) {
+                    *need = pos + 2 + seg;
+                    return JPEG_THUMB_NEED_MORE;
+                }
+                uint32_t off = 0, size = seg - 8;
+                jpeg_thumb_result_t r = exif ? exif_thumb(p + 6, seg - 8, &off, &size) : JPEG_THUMB_OK;
+                if (r == JPEG_THUMB_OK) {
+                    thumb->source = exif ? JPEG_THUMB_EXIF : JPEG_THUMB_JFXX;
+                    thumb->offset = pos + 10 + off;
+                    thumb->length = size;
+                    *has_thumb = thumb_frame(head + thumb->offset, size, thumb);
+                    if (*has_thumb && frame == NULL) {
+                        return JPEG_THUMB_OK;
+                    }
+                    r = *has_thumb ? JPEG_THUMB_OK : JPEG_THUMB_BAD;
+                }
+                // A later segment may still hold a usable one
+                bad |= r == JPEG_THUMB_BAD;
+            }
+        }
+        pos += 2 + seg;
+    }
+    return bad && frame == NULL ? JPEG_THUMB_BAD : JPEG_THUMB_NONE;
+}
+
+jpeg_thumb_result_t jpeg_thumb_find(const uint8_t *head, size_t len, jpeg_thumb_info_t *info)
+{
+    bool found = false;
+    uint32_t need = 0;
+    memset(info, 0, sizeof(*info));
+    jpeg_thumb_result_t r = walk(head, len, info, &found, NULL, &need);
+    if (r != JPEG_THUMB_OK) {
+        memset(info, 0, sizeof(*info));
+    }
+    info->need = need;
+    return r;
+}
+
+jpeg_thumb_result_t jpeg_probe(const uint8_t *head, size_t len, jpeg_probe_t *info)
+{
+    memset(info, 0, sizeof(*info));
+    jpeg_thumb_result_t r = walk(head, len, &info->thumb, &info->has_thumb, &info->frame, &info->need);
+    if (!info->has_thumb) {
+        memset(&info->thumb, 0, sizeof(info->thumb));
+    }
+    return r;
+}
+
+const char *jpeg_thumb_result_name(jpeg_thumb_result_t result)
+{
+    switch (result) {
+    case JPEG_THUMB_OK:
+        return "ok";
+    case JPEG_THUMB_NONE:
+        return "no thumbnail";
+    case JPEG_THUMB_NEED_MORE:
+        return "needs more of the file";
+    case JPEG_THUMB_NOT_JPEG:
+        return "not a JPEG";
+    case JPEG_THUMB_BAD:
+        return "damaged thumbnail";
+    default:
+        return "unknown";
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef _JPEG_THUMB_H
+#define _JPEG_THUMB_H
+#include <stdint.h>
+#include <stddef.h>
+
+// Enough for the JFIF/EXIF headers of most camera files; a larger APP1 asks for more
+#define JPEG_THUMB_HEAD_SIZE (4 * 1024)
+// An APP segment is at most 64 KB; allow for a few ahead of the one with the thumbnail
+#define JPEG_THUMB_MAX_HEAD (128 * 1024)
+
+typedef enum {
+    JPEG_THUMB_OK = 0,
+    JPEG_THUMB_NONE,      // no embedded JPEG thumbnail ahead of the image data
+    JPEG_THUMB_NEED_MORE, // the headers run past the bytes given; info->need says how far
+    JPEG_THUMB_NOT_JPEG,
+    JPEG_THUMB_BAD,       // a thumbnail is declared, but its offset, length or data is wrong
+} jpeg_thumb_result_t;
+
+typedef enum {
+    JPEG_THUMB_EXIF = 0,  // APP1 "Exif", IFD1 JPEGInterchangeFormat
+    JPEG_THUMB_JFXX,      // APP0 "JFXX" extension, JPEG-coded thumbnail
+} jpeg_thumb_source_t;
+
+typedef struct {
+    jpeg_thumb_source_t source;
+    uint32_t offset;      // of the thumbnail's SOI, from the start of the file
+    uint32_t length;
+    uint16_t width;       // from the thumbnail's own frame header
+    uint16_t height;
+    bool progressive;     // the block decoder cannot take these; decode the image instead
+    uint32_t need;        // JPEG_THUMB_NEED_MORE: bytes from the start of the file to pass next
+} jpeg_thumb_info_t;
+
+typedef struct {
+    uint16_t width;
+    uint16_t height;
+    uint8_t components;
+    uint8_t sampling;     // first component's factors, h << 4 | v: 0x11 4:4:4, 0x21 4:2:2, 0x22 4:2:0
+    bool progressive;
+} jpeg_frame_t;
+
+typedef struct {
+    jpeg_frame_t frame;
+    bool has_thumb;
+    jpeg_thumb_info_t thumb;
+    uint32_t need;        // JPEG_THUMB_NEED_MORE: bytes from the start of the file to pass next
+} jpeg_probe_t;
+
+/*
+ * Embedded thumbnail scanner.
+ *
+ * Walks the marker segments from SOI up to the first frame header or SOS,
+ * never touching entropy-coded data, and looks for a JPEG-coded thumbnail in
+ * an EXIF APP1 segment (IFD1) or a JFIF extension APP0 segment. `head` is the
+ * start of the file; when the segment holding the thumbnail runs past `len`,
+ * the call asks for more instead of failing, so a caller can start with the
+ * first few KB and read further only when the file needs it. The thumbnail is
+ * a complete baseline JPEG and goes through the usual block decode path.
+ * Uncompressed JFIF thumbnails are reported as JPEG_THUMB_NONE.
+ */
+jpeg_thumb_result_t jpeg_thumb_find(const uint8_t *head, size_t len, jpeg_thumb_info_t *info);
+// The same walk on to the image's own frame header, noting any thumbnail on the way.
+// JPEG_THUMB_OK once the frame is read; JPEG_THUMB_NONE if there is no frame header
+jpeg_thumb_result_t jpeg_probe(const uint8_t *head, size_t len, jpeg_probe_t *info);
+const char *jpeg_thumb_result_name(jpeg_thumb_result_t result);
+
+#endif
@@ -0,0 +1,337 @@
+#include <string.h>
+#include <strings.h>
+#include <algorithm>
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "../mem/pipeline_arena.h"
+#include "media_catalog.h"
+
+static const char *TAG = "media_catalog";
+
+static bool is_jpeg_name(const char *name)
+{
+    const char *ext = strrchr(name, '.');
+    return ext && (strcasecmp(ext, ".jpg") == 0 || strcasecmp(ext, ".jpeg") == 0);
+}
+
+static uint16_t rd16(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+static uint32_t rd32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void wr16(uint8_t *p, uint16_t v)
+{
+    p[0] = v;
+    p[1] = v >> 8;
+}
+
+static void wr32(uint8_t *p, uint32_t v)
+{
+    wr16(p, v);
+    wr16(p + 2, v >> 16);
+}
+
+media_catalog::media_catalog(fs::FS &fs, const char *index_path)
+    : _fs(fs), _index_path(index_path), _loader(fs)
+{
+    static_assert(sizeof(record_t) == MEDIA_CATALOG_RECORD_SIZE, "record layout");
+    _image = NULL;
+    _image_len = 0;
+    _records = NULL;
+    _pool = NULL;
+    _count = 0;
+    resetStats();
+}
+
+media_catalog::~media_catalog()
+{
+    clear();
+}
+
+void media_catalog::clear()
+{
+    pipeline_free_align(_image);
+    _image = NULL;
+    _image_len = 0;
+    _records = NULL;
+    _pool = NULL;
+    _count = 0;
+}
+
+bool media_catalog::load(const char *root)
+{
+    int64_t t = esp_timer_get_time();
+    uint8_t *image = NULL;
+    size_t len = 0;
+
+    clear();
+    if (_loader.load(_index_path.c_str(), &image, &len) != SD_LOAD_OK) {
+        return false;
+    }
+
+    bool ok = len >= MEDIA_CATALOG_HEADER_SIZE && memcmp(image, MEDIA_CATALOG_MAGIC, 4) == 0 &&
+              image[4] == MEDIA_CATALOG_VERSION && rd16(image + 6) == MEDIA_CATALOG_RECORD_SIZE;
+    uint32_t count = ok ? rd32(image + 8) : 0;
+    uint32_t pool = ok ? rd32(image + 12) : 0;
+    ok = ok && pool > 0 && MEDIA_CATALOG_HEADER_SIZE + (uint64_t)count * MEDIA_CATALOG_RECORD_SIZE + pool == len &&
+         image[len - 1] == '\0';
+
+    // Records are used in place; they must point into the pool and stay sorted for find()
+    const record_t *records = (const record_t *)(image + MEDIA_CATALOG_HEADER_SIZE);
+    const char *strings = (const char *)(image + len - pool);
+    for (uint32_t i = 0; ok && i < count; i++) {
+        ok = records[i].path < pool && (i == 0 || strcmp(strings + records[i - 1].path, strings + records[i].path) < 0);
+    }
+    if (ok && strcmp(strings, root) != 0) {
+        ESP_LOGW(TAG, "%s indexes %s, not %s", _index_path.c_str(), strings, root);
+        ok = false;
+    } else if (!ok) {
+        ESP_LOGW(TAG, "%s is damaged", _index_path.c_str());
+    }
+    if (!ok) {
+        pipeline_free_align(image);
+        return false;
+    }
+
+    _image = image;
+    _image_len = len;
+    _records = records;
+    _pool = strings;
+    _count = count;
+    _stats.load_us = (uint32_t)(esp_timer_get_time() - t);
+    return true;
+}
+
+const char *media_catalog::root()
+{
+    return _pool != NULL ? _pool : "";
+}
+
+void media_catalog::list(const char *dir, std::vector<item_t> &items)
+{
+    File root = _fs.open(dir);
+    if (!root || !root.isDirectory()) {
+        ESP_LOGW(TAG, "not a directory: %s", dir);
+        return;
+    }
+    _stats.dirs++;
+
+    File file = root.openNextFile();
+    while (file) {
+        // Skips hidden files, and with them the caches kept next to the images
+        if (file.name()[0] != '.') {
+            if (file.isDirectory()) {
+                std::string sub = file.path();
+                file.close();
+                list(sub.c_str(), items);
+            } else if (is_jpeg_name(file.name())) {
+                item_t item;
+                memset(&item.rec, 0, sizeof(item.rec));
+                item.path = file.path();
+                item.rec.size = file.size();
+                item.rec.mtime = (uint32_t)file.getLastWrite();
+                items.push_back(item);
+            }
+        }
+        file.close();
+        file = root.openNextFile();
+    }
+    root.close();
+}
+
+void media_catalog::probe(item_t &item)
+{
+    int64_t t = esp_timer_get_time();
+    jpeg_probe_t info;
+    sd_load_err_t err = _loader.probe(item.path.c_str(), &info);
+    _stats.probed++;
+    _stats.probe_bytes += _loader.lastStats().bytes;
+
+    if (err == SD_LOAD_OK) {
+        item.rec.width = info.frame.width;
+        item.rec.height = info.frame.height;
+        item.rec.components = info.frame.components;
+        item.rec.sampling = info.frame.sampling;
+        item.rec.flags = info.frame.progressive ? MEDIA_PROGRESSIVE : 0;
+        if (info.has_thumb) {
+            item.rec.flags |= MEDIA_THUMB;
+            item.rec.thumb_offset = info.thumb.offset;
+            item.rec.thumb_length = info.thumb.length;
+        }
+    } else {
+        item.rec.flags = MEDIA_UNREADABLE;
+        if (err != SD_LOAD_ERR_NOT_JPEG) {
+            // A read error says nothing about the file; a zero mtime has it probed again next time
+            ESP_LOGW(TAG, "failed to read %s: %s", item.path.c_str(), sd_loader::errName(err));
+            item.rec.mtime = 0;
+        }
+    }
+    _stats.probe_us += (uint32_t)(esp_timer_get_time() - t);
+}
+
+int media_catalog::refresh(const char *root)
+{
+    std::vector<item_t> items;
+
+    _stats.scanned = 0;
+    _stats.dirs = 0;
+    _stats.probed = 0;
+    _stats.probe_us = 0;
+    _stats.probe_bytes = 0;
+    _stats.added = 0;
+    _stats.changed = 0;
+    _stats.removed = 0;
+
+    int64_t t = esp_timer_get_time();
+    list(root, items);
+    std::sort(items.begin(), items.end(), [](const item_t &a, const item_t &b) {
+        return a.path < b.path;
+    });
+    _stats.list_us = (uint32_t)(esp_timer_get_time() - t);
+    _stats.scanned = items.size();
+
+    bool same_root = _image != NULL && strcmp(this->root(), root) == 0;
+    uint32_t kept = 0;
+    for (item_t &item : items) {
+        int i = same_root ? find(item.path.c_str()) : -1;
+        if (i >= 0 && _records[i].size == item.rec.size && _records[i].mtime == item.rec.mtime) {
+            item.rec = _records[i];
+        } else {
+            if (i >= 0) {
+                _stats.changed++;
+            } else {
+                _stats.added++;
+            }
+            probe(item);
+        }
+        kept += i >= 0 ? 1 : 0;
+    }
+    _stats.removed = (same_root ? _count : 0) - kept;
+
+    int delta = _stats.added + _stats.changed + _stats.removed;
+    if (delta > 0 || !same_root) {
+        if (build(root, items)) {
+            save();
+        }
+    }
+    return delta;
+}
+
+bool media_catalog::build(const char *root, const std::vector<item_t> &items)
+{
+    size_t pool = strlen(root) + 1;
+    for (const item_t &item : items) {
+        pool += item.path.size() + 1;
+    }
+    size_t len = MEDIA_CATALOG_HEADER_SIZE + items.size() * MEDIA_CATALOG_RECORD_SIZE + pool;
+    uint8_t *image = (uint8_t *)pipeline_malloc_align(len, ARENA_PSRAM);
+    if (image == NULL) {
+        ESP_LOGE(TAG, "no memory for a %u byte index", (unsigned)len);
+        return false;
+    }
+
+    memset(image, 0, MEDIA_CATALOG_HEADER_SIZE);
+    memcpy(image, MEDIA_CATALOG_MAGIC, 4);
+    image[4] = MEDIA_CATALOG_VERSION;
+    wr16(image + 6, MEDIA_CATALOG_RECORD_SIZE);
+    wr32(image + 8, items.size());
+    wr32(image + 12, pool);
+
+    record_t *records = (record_t *)(image + MEDIA_CATALOG_HEADER_SIZE);
+    char *strings = (char *)(image + len - pool);
+    size_t at = strlen(root) + 1;
+    memcpy(strings, root, at);
+    for (size_t i = 0; i < items.size(); i++) {
+        records[i] = items[i].rec;
+        records[i].path = at;
+        memcpy(strings + at, items[i].path.c_str(), items[i].path.size() + 1);
+        at += items[i].path.size() + 1;
+    }
+
+    clear();
+    _image = image;
+    _image_len = len;
+    _records = records;
+    _pool = strings;
+    _count = items.size();
+    return true;
+}
+
+bool media_catalog::save()
+{
+    if (_image == NULL) {
+        return false;
+    }
+    int64_t t = esp_timer_get_time();
+    std::string tmp = _index_path + ".tmp";
+    File file = _fs.open(tmp.c_str(), "w");
+    bool ok = file && file.write(_image, _image_len) == _image_len;
+    if (file) {
+        file.close();
+    }
+    // Swapped in whole: a power cut leaves the old index, the new one or none, never a torn one
+    ok = ok && (!_fs.exists(_index_path.c_str()) || _fs.remove(_index_path.c_str())) &&
+         _fs.rename(tmp.c_str(), _index_path.c_str());
+    if (!ok) {
+        ESP_LOGE(TAG, "failed to write %s", _index_path.c_str());
+    }
+    _stats.save_us = (uint32_t)(esp_timer_get_time() - t);
+    return ok;
+}
+
+int media_catalog::count()
+{
+    return _count;
+}
+
+bool media_catalog::get(int index, media_entry_t *entry)
+{
+    if (index < 0 || (uint32_t)index >= _count) {
+        return false;
+    }
+    const record_t &r = _records[index];
+    entry->path = _pool + r.path;
+    entry->size = r.size;
+    entry->mtime = r.mtime;
+    entry->width = r.width;
+    entry->height = r.height;
+    entry->components = r.components;
+    entry->sampling = r.sampling;
+    entry->flags = r.flags;
+    entry->thumb_offset = r.thumb_offset;
+    entry->thumb_length = r.thumb_length;
+    return true;
+}
+
+int media_catalog::find(const char *path)
+{
+    int lo = 0, hi = (int)_count - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        int c = strcmp(_pool + _records[mid].path, path);
+        if (c == 0) {
+            return mid;
+        }
+        if (c < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return -1;
+}
+
+media_catalog_stats_t media_catalog::stats()
+{
+    return _stats;
+}
+
+void media_catalog::resetStats()
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
@@ -0,0 +1,127 @@
+#ifndef _MEDIA_CATALOG_H
+#define _MEDIA_CATALOG_H
+#include <stdio.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "FS.h"
+#include "../sd/sd_loader.h"
+
+#define MEDIA_CATALOG_MAGIC "MCAT"
+#define MEDIA_CATALOG_VERSION (1)
+#define MEDIA_CATALOG_HEADER_SIZE (16)
+#define MEDIA_CATALOG_RECORD_SIZE (32)
+
+#define MEDIA_PROGRESSIVE (1 << 0)
+#define MEDIA_THUMB (1 << 1)      // thumb_offset/thumb_length locate an embedded JPEG preview
+#define MEDIA_UNREADABLE (1 << 2) // no frame header found; listed so it is not probed again
+
+typedef struct {
+    const char *path;
+    uint32_t size;
+    uint32_t mtime;
+    uint16_t width;
+    uint16_t height;
+    uint8_t components;
+    uint8_t sampling;      // as jpeg_frame_t: 0x11 4:4:4, 0x21 4:2:2, 0x22 4:2:0
+    uint8_t flags;
+    uint32_t thumb_offset;
+    uint32_t thumb_length;
+} media_entry_t;
+
+typedef struct {
+    uint32_t load_us;      // reading and checking the index
+    uint32_t scanned;      // files listed by the last refresh
+    uint32_t dirs;
+    uint32_t list_us;      // walking the directories
+    uint32_t probed;       // files whose headers had to be read
+    uint32_t probe_us;
+    uint64_t probe_bytes;
+    uint32_t added;
+    uint32_t changed;
+    uint32_t removed;
+    uint32_t save_us;
+} media_catalog_stats_t;
+
+/*
+ * Index of the JPEGs under a directory tree, kept on SD.
+ *
+ * Layout, little-endian:
+ *   0  char[4]  magic "MCAT"
+ *   4  uint8    version (1)
+ *   5  uint8    reserved
+ *   6  uint16   record size (32)
+ *   8  uint32   record count
+ *   12 uint32   string pool size
+ *   16 record[count], sorted by path:
+ *        uint32 path (pool offset), size, mtime, thumb offset, thumb length,
+ *        uint16 width, height, uint8 components, sampling, flags, reserved,
+ *        uint32 reserved
+ *   ..  pool: NUL-terminated strings, the root directory first
+ *
+ * load() reads the file in one request and uses it in place, so a boot with
+ * an index costs one read however many files there are. refresh() walks the
+ * tree and reads headers only of files that are new or whose size or mtime
+ * changed; the rest keep their records. The index is rewritten, through a
+ * temporary file, only when something changed.
+ */
+class media_catalog
+{
+public:
+    media_catalog(fs::FS &fs, const char *index_path);
+    ~media_catalog();
+
+    // Index of an earlier refresh of `root`; false if missing, damaged or for another root
+    bool load(const char *root);
+    // Bring the catalog in line with the card; returns the records added, changed or removed
+    int refresh(const char *root);
+    bool save();
+    void clear();
+
+    int count();
+    bool get(int index, media_entry_t *entry);
+    // Index of the record for `path`, or -1
+    int find(const char *path);
+
+    media_catalog_stats_t stats();
+    void resetStats();
+
+private:
+    typedef struct {
+        uint32_t path;
+        uint32_t size;
+        uint32_t mtime;
+        uint32_t thumb_offset;
+        uint32_t thumb_length;
+        uint16_t width;
+        uint16_t height;
+        uint8_t components;
+        uint8_t sampling;
+        uint8_t flags;
+        uint8_t reserved;
+        uint32_t reserved2;
+    } record_t;
+
+    typedef struct {
+        std::string path;
+        record_t rec;
+    } item_t;
+
+    void list(const char *dir, std::vector<item_t> &items);
+    void probe(item_t &item);
+    bool build(const char *root, const std::vector<item_t> &items);
+    const char *root();
+
+    fs::FS &_fs;
+    std::string _index_path;
+    sd_loader _loader;
+    uint8_t *_image;         // the index as on SD
+    size_t _image_len;
+    const record_t *_records;
+    const char *_pool;
+    uint32_t _count;
+
+    media_catalog_stats_t _stats;
+};
+
+#endif
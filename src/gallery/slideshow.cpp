@@ -0,0 +1,354 @@
+#include <string.h>
+#include <strings.h>
+#include <algorithm>
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "Arduino.h"
+#include "../../jpeg_dec.h"
+#include "../mem/pipeline_arena.h"
+#include "slideshow.h"
+
+#define SLIDESHOW_STACK_SIZE (4 * 1024)
+#define SLIDESHOW_DWELL_DEFAULT_MS (3000)
+
+static const char *TAG = "slideshow";
+
+static bool is_jpeg_name(const char *name)
+{
+    const char *ext = strrchr(name, '.');
+    return ext && (strcasecmp(ext, ".jpg") == 0 || strcasecmp(ext, ".jpeg") == 0);
+}
+
+slideshow::slideshow(fs::FS &fs)
+    : _fs(fs), _loader(fs)
+{
+    _dwell_ms = SLIDESHOW_DWELL_DEFAULT_MS;
+    for (int i = 0; i < 2; i++) {
+        _slot[i].buf = NULL;
+        _slot[i].cap = 0;
+        _slot[i].len = 0;
+        _slot[i].index = -1;
+        _slot[i].read_us = 0;
+        _slot[i].cancelled = false;
+        _slot[i].state = SLOT_EMPTY;
+    }
+    _cur = 0;
+    _index = -1;
+    _shown = false;
+    _shown_at = 0;
+    _load_slot = 0;
+    _task = NULL;
+    _loaded = NULL;
+    _lock = xSemaphoreCreateMutex();
+    resetStats();
+}
+
+slideshow::~slideshow()
+{
+    end();
+    for (int i = 0; i < 2; i++) {
+        pipeline_free_align(_slot[i].buf);
+    }
+    if (_lock != NULL) {
+        vSemaphoreDelete(_lock);
+    }
+}
+
+void slideshow::addFile(const char *path, uint32_t dwell_ms)
+{
+    entry_t entry;
+    entry.path = path;
+    entry.dwell_ms = dwell_ms;
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    _entries.push_back(entry);
+    xSemaphoreGive(_lock);
+}
+
+int slideshow::loadDirectory(const char *dir)
+{
+    File root = _fs.open(dir);
+    if (!root || !root.isDirectory()) {
+        ESP_LOGW(TAG, "not a directory: %s", dir);
+        return 0;
+    }
+
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    size_t first = _entries.size();
+    xSemaphoreGive(_lock);
+    File file = root.openNextFile();
+    while (file) {
+        if (!file.isDirectory() && is_jpeg_name(file.name())) {
+            addFile(file.path());
+        }
+        file.close();
+        file = root.openNextFile();
+    }
+    root.close();
+
+    // Directory order is whatever FAT hands back; play in name order instead
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    std::sort(_entries.begin() + first, _entries.end(), [](const entry_t &a, const entry_t &b) {
+        return a.path < b.path;
+    });
+    int added = _entries.size() - first;
+    xSemaphoreGive(_lock);
+    return added;
+}
+
+int slideshow::loadPlaylist(const char *path)
+{
+    File file = _fs.open(path);
+    if (!file || file.isDirectory()) {
+        ESP_LOGW(TAG, "failed to open playlist %s", path);
+        return 0;
+    }
+
+    size_t len = file.size();
+    char *text = (char *)malloc(len + 1);
+    if (text == NULL) {
+        file.close();
+        return 0;
+    }
+    len = file.read((uint8_t *)text, len);
+    text[len] = '\0';
+    file.close();
+
+    int added = 0;
+    char *save = NULL;
+    for (char *line = strtok_r(text, "\r\n", &save); line != NULL; line = strtok_r(NULL, "\r\n", &save)) {
+        while (*line == ' ' || *line == '\t') {
+            line++;
+        }
+        if (*line == '\0' || *line == '#') {
+            continue;
+        }
+        uint32_t dwell_ms = 0;
+        char *sep = strpbrk(line, " \t");
+        if (sep != NULL) {
+            *sep = '\0';
+            dwell_ms = strtoul(sep + 1, NULL, 10);
+        }
+        addFile(line, dwell_ms);
+        added++;
+    }
+    free(text);
+    return added;
+}
+
+void slideshow::clear()
+{
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    _entries.clear();
+    // sd_loader cannot stop mid-file: a load already running finishes, but its result is dropped
+    _slot[0].cancelled = true;
+    _slot[1].cancelled = true;
+    xSemaphoreGive(_lock);
+
+    for (int i = 0; i < 2; i++) {
+        waitIdle(&_slot[i]);
+        _slot[i].index = -1;
+        _slot[i].state = SLOT_EMPTY;
+    }
+    _index = -1;
+    _shown = false;
+}
+
+int slideshow::count()
+{
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    int n = _entries.size();
+    xSemaphoreGive(_lock);
+    return n;
+}
+
+void slideshow::setDwell(uint32_t dwell_ms)
+{
+    _dwell_ms = dwell_ms;
+}
+
+bool slideshow::begin(UBaseType_t priority, BaseType_t core)
+{
+    _loaded = xSemaphoreCreateBinary();
+    if (_loaded == NULL || _lock == NULL) {
+        return false;
+    }
+    return xTaskCreatePinnedToCore(taskEntry, "slideshow_sd", SLIDESHOW_STACK_SIZE, this, priority, &_task, core) == pdPASS;
+}
+
+void slideshow::end()
+{
+    if (_task == NULL) {
+        return;
+    }
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    _slot[0].cancelled = true;
+    _slot[1].cancelled = true;
+    xSemaphoreGive(_lock);
+
+    // Idle means blocked waiting for the next notify, so nothing is left holding _loaded or _lock
+    for (int i = 0; i < 2; i++) {
+        waitIdle(&_slot[i]);
+        _slot[i].index = -1;
+        _slot[i].state = SLOT_EMPTY;
+    }
+    vTaskDelete(_task);
+    _task = NULL;
+    vSemaphoreDelete(_loaded);
+    _loaded = NULL;
+    _index = -1;
+    _shown = false;
+}
+
+bool slideshow::update(draw_cb_t drawCallback)
+{
+    if (_shown) {
+        xSemaphoreTake(_lock, portMAX_DELAY);
+        uint32_t dwell_ms = _index < (int)_entries.size() ? _entries[_index].dwell_ms : 0;
+        xSemaphoreGive(_lock);
+        if (dwell_ms == 0) {
+            dwell_ms = _dwell_ms;
+        }
+        if (millis() - _shown_at < dwell_ms) {
+            return false;
+        }
+    }
+    return showNext(drawCallback);
+}
+
+bool slideshow::showNext(draw_cb_t drawCallback)
+{
+    int n = count();
+    if (n == 0 || _task == NULL) {
+        return false;
+    }
+
+    int index = _shown ? (_index + 1) % n : 0;
+    slot_t *slot = &_slot[_cur];
+    if (slot->index != index || slot->state == SLOT_EMPTY) {
+        prefetch(_cur, index);
+    }
+
+    // Only time spent here is SD latency on the critical path
+    uint32_t t = (uint32_t)esp_timer_get_time();
+    bool stalled = (slot->state == SLOT_LOADING);
+    waitIdle(slot);
+    uint32_t wait_us = (uint32_t)esp_timer_get_time() - t;
+
+    // The loader is idle now: start reading N+1 while N decodes
+    prefetch(_cur ^ 1, (index + 1) % n);
+
+    _index = index;
+    _shown = true;
+    _cur ^= 1;
+
+    if (slot->state != SLOT_READY) {
+        _stats.failed++;
+        _shown_at = millis() - _dwell_ms;
+        return false;
+    }
+
+    t = (uint32_t)esp_timer_get_time();
+    // A corrupt file leaves a partial image up for its dwell rather than stalling the show
+    jpeg_dec_result_t derr = esp_jpeg_decoder_block_out(slot->buf, slot->len, drawCallback);
+    uint32_t decode_us = (uint32_t)esp_timer_get_time() - t;
+    if (derr != JPEG_DEC_OK) {
+        _stats.decode_failed++;
+        _stats.last_decode_error = derr;
+        ESP_LOGW(TAG, "%s: %s", slot->path.c_str(), jpeg_dec_result_name(derr));
+    }
+    _shown_at = millis();
+
+    _stats.transitions++;
+    _stats.stalls += stalled ? 1 : 0;
+    _stats.last_read_us = slot->read_us;
+    _stats.last_wait_us = wait_us;
+    _stats.last_decode_us = decode_us;
+    _stats.total_read_us += slot->read_us;
+    _stats.total_wait_us += wait_us;
+    _stats.total_decode_us += decode_us;
+    return true;
+}
+
+int slideshow::current()
+{
+    return _index;
+}
+
+slideshow_stats_t slideshow::stats()
+{
+    return _stats;
+}
+
+void slideshow::resetStats()
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+void slideshow::prefetch(int slot, int index)
+{
+    // The task serves one slot at a time, and a slot it is still filling must not be re-pointed
+    waitIdle(&_slot[0]);
+    waitIdle(&_slot[1]);
+
+    slot_t *s = &_slot[slot];
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    s->index = index;
+    // A clear() from another task may have emptied the playlist since index was picked
+    bool gone = index >= (int)_entries.size();
+    s->path = gone ? std::string() : _entries[index].path;
+    s->cancelled = gone;
+    s->state = SLOT_LOADING;
+    xSemaphoreGive(_lock);
+    _load_slot = slot;
+    xTaskNotifyGive(_task);
+}
+
+void slideshow::waitIdle(slot_t *slot)
+{
+    while (slot->state == SLOT_LOADING) {
+        xSemaphoreTake(_loaded, pdMS_TO_TICKS(10));
+    }
+}
+
+void slideshow::taskEntry(void *arg)
+{
+    slideshow *self = (slideshow *)arg;
+
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        self->load(&self->_slot[self->_load_slot]);
+        xSemaphoreGive(self->_loaded);
+    }
+}
+
+void slideshow::load(slot_t *slot)
+{
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    std::string path = slot->path;
+    bool cancelled = slot->cancelled;
+    xSemaphoreGive(_lock);
+    if (cancelled) {
+        slot->state = SLOT_EMPTY;
+        return;
+    }
+    uint32_t t = (uint32_t)esp_timer_get_time();
+
+    size_t len = 0;
+    // Buffers only grow, so a steady playlist stops allocating after one lap
+    sd_load_err_t err = _loader.load(path.c_str(), &slot->buf, &slot->cap, &len);
+    uint32_t read_us = (uint32_t)esp_timer_get_time() - t;
+
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    if (slot->cancelled) {
+        slot->state = SLOT_EMPTY;
+    } else if (err != SD_LOAD_OK) {
+        ESP_LOGW(TAG, "failed to load %s: %s", path.c_str(), sd_loader::errName(err));
+        _stats.last_error = err;
+        slot->state = SLOT_FAILED;
+    } else {
+        slot->len = len;
+        slot->read_us = read_us;
+        slot->state = SLOT_READY;
+    }
+    xSemaphoreGive(_lock);
+}
@@ -0,0 +1,115 @@
+#ifndef _SLIDESHOW_H
+#define _SLIDESHOW_H
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "FS.h"
+#include <ESP32_JPEG_Library.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "../sd/sd_loader.h"
+#include "../../jpeg_dec.h"
+
+typedef struct {
+    uint32_t transitions;
+    uint32_t stalls;          // transitions where the prefetch was not ready yet
+    uint32_t failed;          // files that could not be read
+    sd_load_err_t last_error;
+    uint32_t decode_failed;   // images that were read but did not decode completely
+    jpeg_dec_result_t last_decode_error;
+    uint32_t last_read_us;    // SD read time of the image just shown
+    uint32_t last_wait_us;    // time the transition waited on SD (0 when hidden)
+    uint32_t last_decode_us;  // decode + flush time of the image just shown
+    uint64_t total_read_us;
+    uint64_t total_wait_us;
+    uint64_t total_decode_us;
+} slideshow_stats_t;
+
+/*
+ * Playlist-driven slideshow with double-buffered SD prefetch.
+ *
+ * While image N is decoded and drawn from one aligned buffer, a background task
+ * reads image N+1 from SD into the other, so the SD read is only on the critical
+ * path when it takes longer than the decode.
+ *
+ * Playlist files list one path per line, optionally followed by a dwell time in
+ * milliseconds ("/img/a.jpg 5000"); lines starting with '#' are ignored.
+ */
+class slideshow
+{
+public:
+    typedef int (*draw_cb_t)(jpeg_dec_io_t *jpeg_io, jpeg_dec_header_info_t *out_info);
+
+    slideshow(fs::FS &fs);
+    ~slideshow();
+
+    void addFile(const char *path, uint32_t dwell_ms = 0);
+    int loadDirectory(const char *dir);
+    int loadPlaylist(const char *path);
+    // Drops a prefetch in flight and waits for the SD task to let go of its slot
+    void clear();
+    int count();
+
+    void setDwell(uint32_t dwell_ms);
+    bool begin(UBaseType_t priority = 1, BaseType_t core = 0);
+    // Drops any prefetch, waits for the SD task to go idle and deletes it; begin() may be called again
+    void end();
+
+    // Call from loop(): advances once the current image's dwell has elapsed
+    bool update(draw_cb_t drawCallback);
+    bool showNext(draw_cb_t drawCallback);
+    int current();
+
+    slideshow_stats_t stats();
+    void resetStats();
+
+private:
+    typedef struct {
+        std::string path;
+        uint32_t dwell_ms;
+    } entry_t;
+
+    typedef enum {
+        SLOT_EMPTY,
+        SLOT_LOADING,
+        SLOT_READY,
+        SLOT_FAILED,
+    } slot_state_t;
+
+    typedef struct {
+        uint8_t *buf;
+        size_t cap;
+        size_t len;
+        int index;
+        std::string path;       // copied when queued, so the task never reads _entries
+        uint32_t read_us;
+        volatile bool cancelled;
+        volatile slot_state_t state;
+    } slot_t;
+
+    static void taskEntry(void *arg);
+    void prefetch(int slot, int index);
+    void waitIdle(slot_t *slot);
+    void load(slot_t *slot);
+
+    fs::FS &_fs;
+    sd_loader _loader;
+    std::vector<entry_t> _entries;
+    uint32_t _dwell_ms;
+
+    slot_t _slot[2];
+    int _cur;
+    int _index;
+    bool _shown;
+    uint32_t _shown_at;
+    volatile int _load_slot;
+
+    TaskHandle_t _task;
+    SemaphoreHandle_t _loaded;
+    SemaphoreHandle_t _lock;
+
+    slideshow_stats_t _stats;
+};
+
+#endif
@@ -0,0 +1,319 @@
+#include <string.h>
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "Arduino.h"
+#include "../../jpeg_dec.h"
+#include "../../pins_config.h"
+#include "../mem/pipeline_arena.h"
+#include "swipe_prefetch.h"
+
+#define SWIPE_PREFETCH_STACK_SIZE (4 * 1024)
+#define SWIPE_PREFETCH_FRAME_SIZE (LCD_H_RES * LCD_V_RES * sizeof(uint16_t))
+
+static const char *TAG = "swipe_prefetch";
+
+// The decoder callback carries no user context, so only one prefetcher decodes at a time
+static swipe_prefetch *s_active = NULL;
+
+swipe_prefetch::swipe_prefetch(fs::FS &fs, const char *const *paths, int count)
+    : _loader(fs)
+{
+    _paths = paths;
+    _count = count;
+    _frame[0] = NULL;
+    _frame[1] = NULL;
+    _back = 0;
+    _lines = 0;
+    _task = NULL;
+    _done = NULL;
+    _lock = NULL;
+    _pending = -1;
+    _target = -1;
+    _ready = -1;
+    _ready_lines = 0;
+    _ready_us = 0;
+    _busy = false;
+    _cancel = false;
+    _cancel_us = 0;
+    _dir = 0;
+    resetStats();
+}
+
+swipe_prefetch::~swipe_prefetch()
+{
+    end();
+}
+
+bool swipe_prefetch::begin(UBaseType_t priority, BaseType_t core)
+{
+    for (int i = 0; i < 2; i++) {
+        _frame[i] = (uint16_t *)pipeline_malloc_align(SWIPE_PREFETCH_FRAME_SIZE, ARENA_PSRAM);
+        if (_frame[i] == NULL) {
+            ESP_LOGE(TAG, "no PSRAM for prefetch frame");
+            return false;
+        }
+    }
+
+    _done = xSemaphoreCreateBinary();
+    _lock = xSemaphoreCreateMutex();
+    if (_done == NULL || _lock == NULL) {
+        return false;
+    }
+
+    return xTaskCreatePinnedToCore(taskEntry, "swipe_prefetch", SWIPE_PREFETCH_STACK_SIZE, this, priority, &_task, core) == pdPASS;
+}
+
+void swipe_prefetch::end()
+{
+    if (_task != NULL) {
+        cancel();
+        // The decoder stops within one strip of the cancel
+        while (_busy) {
+            xSemaphoreTake(_done, pdMS_TO_TICKS(10));
+        }
+        vTaskDelete(_task);
+        _task = NULL;
+    }
+    if (_done != NULL) {
+        vSemaphoreDelete(_done);
+        _done = NULL;
+    }
+    if (_lock != NULL) {
+        vSemaphoreDelete(_lock);
+        _lock = NULL;
+    }
+    for (int i = 0; i < 2; i++) {
+        pipeline_free_align(_frame[i]);
+        _frame[i] = NULL;
+    }
+}
+
+int swipe_prefetch::neighbour(int current, int dir)
+{
+    if (_count <= 0) {
+        return -1;
+    }
+    int index = current + (dir > 0 ? 1 : -1);
+    return (index % _count + _count) % _count;
+}
+
+void swipe_prefetch::dragBegin(int current, int dir)
+{
+    _dir = dir > 0 ? 1 : -1;
+    request(neighbour(current, _dir));
+}
+
+void swipe_prefetch::dragUpdate(int current, int dir)
+{
+    if (dir == 0) {
+        return;
+    }
+    dir = dir > 0 ? 1 : -1;
+    // Gesture reversed: the speculative work on the old neighbour is wasted
+    if (dir != _dir) {
+        _dir = dir;
+        request(neighbour(current, _dir));
+    }
+}
+
+void swipe_prefetch::cancel()
+{
+    if (_lock == NULL) {
+        return;
+    }
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    // Started but not yet picked up by the task: dropped before any work
+    _stats.cancelled += _pending >= 0 ? 1 : 0;
+    _pending = -1;
+    if (_busy && !_cancel) {
+        _cancel_us = esp_timer_get_time();
+        _cancel = true;
+    }
+    if (_ready >= 0) {
+        _stats.cancelled++;
+        _stats.wasted_lines += _ready_lines;
+        _stats.wasted_us += _ready_us;
+        _ready = -1;
+    }
+    xSemaphoreGive(_lock);
+}
+
+bool swipe_prefetch::complete(int index, nv3041a_lcd &lcd)
+{
+    // A decode queued or still running for the right image is cheaper to finish than to restart
+    for (;;) {
+        xSemaphoreTake(_lock, portMAX_DELAY);
+        bool wait = (_busy && _target == index && !_cancel) || _pending == index;
+        xSemaphoreGive(_lock);
+        if (!wait) {
+            break;
+        }
+        xSemaphoreTake(_done, pdMS_TO_TICKS(10));
+    }
+
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    bool hit = (_ready == index);
+    int front = _back;
+    if (hit) {
+        _ready = -1;
+        _back ^= 1;
+        _stats.hits++;
+    } else {
+        _stats.misses++;
+    }
+    xSemaphoreGive(_lock);
+
+    if (!hit) {
+        cancel();
+        return false;
+    }
+
+    lcd.lcd_draw_bitmap(0, 0, LCD_H_RES, LCD_V_RES, _frame[front]);
+    return true;
+}
+
+swipe_prefetch_stats_t swipe_prefetch::stats()
+{
+    // The prefetch task updates the counters under _lock
+    if (_lock == NULL) {
+        return _stats;
+    }
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    swipe_prefetch_stats_t s = _stats;
+    xSemaphoreGive(_lock);
+    return s;
+}
+
+void swipe_prefetch::resetStats()
+{
+    if (_lock == NULL) {
+        memset(&_stats, 0, sizeof(_stats));
+        return;
+    }
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    memset(&_stats, 0, sizeof(_stats));
+    xSemaphoreGive(_lock);
+}
+
+void swipe_prefetch::request(int index)
+{
+    if (index < 0 || _task == NULL) {
+        return;
+    }
+
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    if ((_busy && _target == index && !_cancel) || _ready == index || _pending == index) {
+        xSemaphoreGive(_lock);
+        return;
+    }
+    if (_busy && !_cancel) {
+        _cancel_us = esp_timer_get_time();
+        _cancel = true;
+    }
+    if (_ready >= 0) {
+        _stats.cancelled++;
+        _stats.wasted_lines += _ready_lines;
+        _stats.wasted_us += _ready_us;
+        _ready = -1;
+    }
+    _stats.cancelled += _pending >= 0 ? 1 : 0;
+    _pending = index;
+    _stats.started++;
+    xSemaphoreGive(_lock);
+
+    xTaskNotifyGive(_task);
+}
+
+void swipe_prefetch::taskEntry(void *arg)
+{
+    swipe_prefetch *self = (swipe_prefetch *)arg;
+
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        for (;;) {
+            xSemaphoreTake(self->_lock, portMAX_DELAY);
+            int index = self->_pending;
+            if (index < 0) {
+                xSemaphoreGive(self->_lock);
+                break;
+            }
+            self->_pending = -1;
+            self->_target = index;
+            self->_cancel = false;
+            self->_busy = true;
+            xSemaphoreGive(self->_lock);
+
+            self->run(index);
+        }
+    }
+}
+
+int swipe_prefetch::drawCallback(jpeg_dec_io_t *jpeg_io, jpeg_dec_header_info_t *out_info)
+{
+    swipe_prefetch *self = s_active;
+
+    self->_lines += jpeg_io->cur_line;
+    if (self->_cancel) {
+        return 0;
+    }
+
+    int y = jpeg_io->output_line - jpeg_io->cur_line;
+    int w = out_info->width > LCD_H_RES ? LCD_H_RES : out_info->width;
+    uint16_t *src = (uint16_t *)jpeg_io->outbuf;
+    uint16_t *frame = self->_frame[self->_back];
+    for (int row = 0; row < jpeg_io->cur_line && y + row < LCD_V_RES; row++) {
+        memcpy(frame + (y + row) * LCD_H_RES, src + row * out_info->width, w * sizeof(uint16_t));
+    }
+    return 1;
+}
+
+void swipe_prefetch::run(int index)
+{
+    uint32_t t = (uint32_t)esp_timer_get_time();
+    const char *path = _paths[index];
+    _lines = 0;
+
+    uint8_t *jpeg = NULL;
+    size_t len = 0;
+    bool ok = false;
+    sd_load_err_t err = _loader.load(path, &jpeg, &len);
+    if (err == SD_LOAD_OK) {
+        memset(_frame[_back], 0, SWIPE_PREFETCH_FRAME_SIZE);
+        s_active = this;
+        // Stops within one strip of a cancel; the rest of the image is never decoded
+        jpeg_dec_limits_t limits = {};
+        limits.cancel = &_cancel;
+        jpeg_dec_result_t derr = esp_jpeg_decoder_block_out(jpeg, len, drawCallback, &limits);
+        s_active = NULL;
+        pipeline_free_align(jpeg);
+        // STOPPED only follows a cancel. Never serve a half-decoded frame; complete() reports a miss instead
+        ok = derr == JPEG_DEC_OK || derr == JPEG_DEC_STOPPED;
+        if (!ok) {
+            ESP_LOGW(TAG, "failed to decode %s: %s", path, jpeg_dec_result_name(derr));
+        }
+    } else {
+        ESP_LOGW(TAG, "failed to load %s: %s", path, sd_loader::errName(err));
+    }
+    t = (uint32_t)esp_timer_get_time() - t;
+
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    if (_cancel) {
+        uint32_t latency = (uint32_t)(esp_timer_get_time() - _cancel_us);
+        _stats.max_cancel_us = latency > _stats.max_cancel_us ? latency : _stats.max_cancel_us;
+    }
+    if (!ok) {
+        // A broken or missing file is not speculation lost to a reversed gesture
+        _stats.failed++;
+    } else if (_cancel) {
+        _stats.cancelled++;
+        _stats.wasted_lines += _lines;
+        _stats.wasted_us += t;
+    } else {
+        _ready = index;
+        _ready_lines = _lines;
+        _ready_us = t;
+    }
+    _busy = false;
+    xSemaphoreGive(_lock);
+    xSemaphoreGive(_done);
+}
@@ -0,0 +1,85 @@
+#ifndef _SWIPE_PREFETCH_H
+#define _SWIPE_PREFETCH_H
+#include <stdio.h>
+#include "FS.h"
+#include <ESP32_JPEG_Library.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "../lcd/nv3041a_lcd.h"
+#include "../sd/sd_loader.h"
+
+typedef struct {
+    uint32_t started;      // speculative decodes started
+    uint32_t hits;         // swipe completions served from the prefetched frame
+    uint32_t misses;       // swipe completions that had to decode on demand
+    uint32_t cancelled;    // speculative decodes dropped (gesture reversed), queued, running or done
+    uint32_t wasted_lines; // decoded lines thrown away
+    uint32_t wasted_us;    // decode time thrown away
+    uint32_t failed;       // speculative decodes that could not read or decode the file
+    uint32_t max_cancel_us; // longest time from cancel to the decoder going idle
+} swipe_prefetch_stats_t;
+
+/*
+ * Speculative decode of the neighbouring gallery image.
+ *
+ * When a horizontal drag starts, the image next to the current one in the drag
+ * direction is read from SD and decoded by a background task into a full-frame
+ * PSRAM buffer. If the swipe completes onto that image the frame goes out with
+ * a single lcd_draw_bitmap(); if the drag reverses the decode is cancelled and
+ * the other neighbour is started instead. Two frames are kept so that a new
+ * speculative decode never overwrites the frame whose DMA may still be running.
+ */
+class swipe_prefetch
+{
+public:
+    swipe_prefetch(fs::FS &fs, const char *const *paths, int count);
+    ~swipe_prefetch();
+
+    bool begin(UBaseType_t priority = 1, BaseType_t core = 0);
+    // Cancels any speculative decode, waits for the task to go idle, deletes it and frees the frames
+    void end();
+
+    // dir > 0: next image, dir < 0: previous image
+    void dragBegin(int current, int dir);
+    void dragUpdate(int current, int dir);
+    void cancel();
+
+    // Show image `index` from the prefetched frame. Returns false on a miss.
+    bool complete(int index, nv3041a_lcd &lcd);
+
+    int neighbour(int current, int dir);
+    swipe_prefetch_stats_t stats();
+    void resetStats();
+
+private:
+    static void taskEntry(void *arg);
+    static int drawCallback(jpeg_dec_io_t *jpeg_io, jpeg_dec_header_info_t *out_info);
+    void request(int index);
+    void run(int index);
+
+    sd_loader _loader;
+    const char *const *_paths;
+    int _count;
+
+    uint16_t *_frame[2];
+    int _back;
+    uint32_t _lines;
+    TaskHandle_t _task;
+    SemaphoreHandle_t _done;
+    SemaphoreHandle_t _lock;
+
+    volatile int _pending;
+    volatile int _target;
+    volatile int _ready;
+    uint32_t _ready_lines;
+    uint32_t _ready_us;
+    volatile bool _busy;
+    volatile bool _cancel;
+    int64_t _cancel_us;
+    int _dir;
+
+    swipe_prefetch_stats_t _stats;
+};
+
+#endif
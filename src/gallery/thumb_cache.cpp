@@ -0,0 +1,270 @@
+#include <string.h>
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "../mem/pipeline_arena.h"
+#include "thumb_cache.h"
+
+// Slots looked at from a path's home slot before the home slot is reused
+#define THUMB_CACHE_PROBE (8)
+
+static const char *TAG = "thumb_cache";
+
+static uint16_t rd16(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+static uint32_t rd32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void wr16(uint8_t *p, uint16_t v)
+{
+    p[0] = v;
+    p[1] = v >> 8;
+}
+
+static void wr32(uint8_t *p, uint32_t v)
+{
+    wr16(p, v);
+    wr16(p + 2, v >> 16);
+}
+
+thumb_cache::thumb_cache(fs::FS &fs, const char *path, uint16_t tile_w, uint16_t tile_h, uint16_t slots)
+    : _fs(fs)
+{
+    _path = path;
+    _tile_w = tile_w;
+    _tile_h = tile_h;
+    _slots = slots ? slots : 1;
+    _tile_bytes = (uint32_t)tile_w * tile_h * sizeof(uint16_t);
+    _tile_stride = (_tile_bytes + THUMB_CACHE_ALIGN - 1) / THUMB_CACHE_ALIGN * THUMB_CACHE_ALIGN;
+    _tile_base = (THUMB_CACHE_HEADER_SIZE + (uint32_t)_slots * THUMB_CACHE_ENTRY_SIZE + THUMB_CACHE_ALIGN - 1) /
+                 THUMB_CACHE_ALIGN * THUMB_CACHE_ALIGN;
+    _index = NULL;
+    _open = false;
+    _lock = NULL;
+    resetStats();
+}
+
+thumb_cache::~thumb_cache()
+{
+    end();
+    if (_lock != NULL) {
+        vSemaphoreDelete(_lock);
+    }
+}
+
+bool thumb_cache::begin()
+{
+    if (_open) {
+        return true;
+    }
+    if (_lock == NULL) {
+        _lock = xSemaphoreCreateMutex();
+    }
+    if (_index == NULL) {
+        _index = (entry_t *)pipeline_malloc_align((size_t)_slots * sizeof(entry_t), ARENA_PSRAM);
+    }
+    if (_lock == NULL || _index == NULL) {
+        return false;
+    }
+
+    if (_fs.exists(_path)) {
+        _file = _fs.open(_path, "r+");
+        uint8_t header[THUMB_CACHE_HEADER_SIZE];
+        if (_file && _file.read(header, sizeof(header)) == sizeof(header) &&
+                memcmp(header, THUMB_CACHE_MAGIC, 4) == 0 && header[4] == THUMB_CACHE_VERSION &&
+                rd16(header + 6) == _tile_w && rd16(header + 8) == _tile_h && rd16(header + 10) == _slots) {
+            bool ok = true;
+            uint8_t raw[THUMB_CACHE_ENTRY_SIZE];
+            for (uint16_t i = 0; i < _slots && ok; i++) {
+                ok = _file.read(raw, sizeof(raw)) == sizeof(raw);
+                _index[i].hash = rd32(raw) | ((uint64_t)rd32(raw + 4) << 32);
+                _index[i].size = rd32(raw + 8);
+                _index[i].mtime = rd32(raw + 12);
+            }
+            if (ok) {
+                _open = true;
+                return true;
+            }
+        }
+        if (_file) {
+            _file.close();
+        }
+        ESP_LOGW(TAG, "%s: other layout or damaged, starting afresh", _path);
+    }
+    return create();
+}
+
+bool thumb_cache::create()
+{
+    _file = _fs.open(_path, "w+");
+    if (!_file) {
+        ESP_LOGE(TAG, "cannot create %s", _path);
+        return false;
+    }
+    uint8_t header[THUMB_CACHE_HEADER_SIZE] = {0};
+    memcpy(header, THUMB_CACHE_MAGIC, 4);
+    header[4] = THUMB_CACHE_VERSION;
+    wr16(header + 6, _tile_w);
+    wr16(header + 8, _tile_h);
+    wr16(header + 10, _slots);
+    bool ok = _file.write(header, sizeof(header)) == sizeof(header);
+
+    memset(_index, 0, (size_t)_slots * sizeof(entry_t));
+    uint8_t zero[THUMB_CACHE_ENTRY_SIZE] = {0};
+    for (uint16_t i = 0; i < _slots && ok; i++) {
+        ok = _file.write(zero, sizeof(zero)) == sizeof(zero);
+    }
+    _file.flush();
+    _open = ok;
+    return ok;
+}
+
+void thumb_cache::end()
+{
+    if (_open) {
+        _file.close();
+        _open = false;
+    }
+    pipeline_free_align(_index);
+    _index = NULL;
+}
+
+uint64_t thumb_cache::hashPath(const char *path)
+{
+    uint64_t h = 14695981039346656037ull;
+    for (const uint8_t *p = (const uint8_t *)path; *p; p++) {
+        h = (h ^ *p) * 1099511628211ull;
+    }
+    // Zero marks a free slot
+    return h ? h : 1;
+}
+
+uint32_t thumb_cache::tileOffset(int slot)
+{
+    return _tile_base + (uint32_t)slot * _tile_stride;
+}
+
+int thumb_cache::probe(uint64_t hash, bool *found)
+{
+    int home = hash % _slots;
+    int free_slot = -1;
+    for (int i = 0; i < THUMB_CACHE_PROBE && i < _slots; i++) {
+        int s = (home + i) % _slots;
+        if (_index[s].hash == hash) {
+            *found = true;
+            return s;
+        }
+        if (_index[s].hash == 0 && free_slot < 0) {
+            free_slot = s;
+        }
+    }
+    *found = false;
+    return free_slot >= 0 ? free_slot : home;
+}
+
+int thumb_cache::find(const char *path, uint32_t size, uint32_t mtime)
+{
+    if (!_open) {
+        return -1;
+    }
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    _stats.lookups++;
+    bool found;
+    int slot = probe(hashPath(path), &found);
+    if (found && (_index[slot].size != size || _index[slot].mtime != mtime)) {
+        _stats.stale++;
+        found = false;
+    }
+    _stats.hits += found ? 1 : 0;
+    xSemaphoreGive(_lock);
+    return found ? slot : -1;
+}
+
+bool thumb_cache::read(int slot, uint16_t *tile)
+{
+    if (!_open || slot < 0 || slot >= _slots) {
+        return false;
+    }
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    int64_t t = esp_timer_get_time();
+    bool ok = _file.seek(tileOffset(slot)) && _file.read((uint8_t *)tile, _tile_bytes) == _tile_bytes;
+    _stats.read_us += esp_timer_get_time() - t;
+    _stats.reads++;
+    xSemaphoreGive(_lock);
+    return ok;
+}
+
+bool thumb_cache::writeEntry(int slot)
+{
+    uint8_t raw[THUMB_CACHE_ENTRY_SIZE];
+    wr32(raw, (uint32_t)_index[slot].hash);
+    wr32(raw + 4, (uint32_t)(_index[slot].hash >> 32));
+    wr32(raw + 8, _index[slot].size);
+    wr32(raw + 12, _index[slot].mtime);
+    return _file.seek(THUMB_CACHE_HEADER_SIZE + (uint32_t)slot * THUMB_CACHE_ENTRY_SIZE) &&
+           _file.write(raw, sizeof(raw)) == sizeof(raw);
+}
+
+int thumb_cache::store(const char *path, uint32_t size, uint32_t mtime, const uint16_t *tile)
+{
+    if (!_open) {
+        return -1;
+    }
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    int64_t t = esp_timer_get_time();
+    uint64_t hash = hashPath(path);
+    bool found;
+    int slot = probe(hash, &found);
+    bool ok = true;
+    if (_index[slot].hash != 0) {
+        // Retire the old entry first, so a cut write cannot pair it with the new tile
+        _stats.evictions += found ? 0 : 1;
+        memset(&_index[slot], 0, sizeof(entry_t));
+        ok = writeEntry(slot);
+    }
+    ok = ok && _file.seek(tileOffset(slot)) && _file.write((const uint8_t *)tile, _tile_bytes) == _tile_bytes;
+    if (ok) {
+        _index[slot].hash = hash;
+        _index[slot].size = size;
+        _index[slot].mtime = mtime;
+        ok = writeEntry(slot);
+    }
+    _file.flush();
+    _stats.write_us += esp_timer_get_time() - t;
+    _stats.stores += ok ? 1 : 0;
+    xSemaphoreGive(_lock);
+    return ok ? slot : -1;
+}
+
+uint16_t thumb_cache::tileWidth()
+{
+    return _tile_w;
+}
+
+uint16_t thumb_cache::tileHeight()
+{
+    return _tile_h;
+}
+
+uint16_t thumb_cache::used()
+{
+    uint16_t n = 0;
+    for (uint16_t i = 0; _index != NULL && i < _slots; i++) {
+        n += _index[i].hash != 0;
+    }
+    return n;
+}
+
+thumb_cache_stats_t thumb_cache::stats()
+{
+    return _stats;
+}
+
+void thumb_cache::resetStats()
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
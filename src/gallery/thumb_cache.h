@@ -0,0 +1,100 @@
+#ifndef _THUMB_CACHE_H
+#define _THUMB_CACHE_H
+#include <stdio.h>
+#include <stdint.h>
+#include "FS.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#define THUMB_CACHE_MAGIC "TCAC"
+#define THUMB_CACHE_VERSION (1)
+#define THUMB_CACHE_HEADER_SIZE (16)
+#define THUMB_CACHE_ENTRY_SIZE (16)
+#define THUMB_CACHE_ALIGN (512)
+
+typedef struct {
+    uint32_t lookups;
+    uint32_t hits;
+    uint32_t stale;         // path found but size or mtime changed
+    uint32_t stores;
+    uint32_t evictions;     // valid tiles overwritten for lack of room
+    uint32_t reads;
+    uint64_t read_us;
+    uint64_t write_us;
+} thumb_cache_stats_t;
+
+/*
+ * Packed thumbnail cache: one file on SD holding fixed-size RGB565 tiles.
+ *
+ * Layout, all header fields little-endian:
+ *   0  char[4]  magic "TCAC"
+ *   4  uint8    version (1)
+ *   5  uint8    reserved
+ *   6  uint16   tile width
+ *   8  uint16   tile height
+ *   10 uint16   slots
+ *   12 uint32   reserved
+ *   16 entry[slots], 16 bytes each:
+ *        uint64 FNV-1a hash of the path, uint32 file size, uint32 mtime;
+ *        an all-zero entry is a free slot
+ *   ..  tiles, from the first 512-byte boundary after the index, each padded to
+ *       a whole number of 512-byte sectors so a tile read never splits a sector
+ *
+ * Tiles are in panel byte order and go to the panel as they are read. Slots
+ * are found by open addressing on the path hash; when the probe window is
+ * full, the home slot is reused. A tile is written before its entry, so a
+ * power cut never leaves an entry pointing at a half-written tile. A cache
+ * file with another tile size or slot count is started afresh.
+ */
+class thumb_cache
+{
+public:
+    thumb_cache(fs::FS &fs, const char *path, uint16_t tile_w, uint16_t tile_h, uint16_t slots = 512);
+    ~thumb_cache();
+
+    bool begin();
+    void end();
+
+    // Slot holding an up-to-date tile for the file, or -1
+    int find(const char *path, uint32_t size, uint32_t mtime);
+    // tile must hold tileWidth() * tileHeight() pixels
+    bool read(int slot, uint16_t *tile);
+    // Returns the slot used, or -1 on a write error
+    int store(const char *path, uint32_t size, uint32_t mtime, const uint16_t *tile);
+
+    uint16_t tileWidth();
+    uint16_t tileHeight();
+    uint16_t used();
+
+    thumb_cache_stats_t stats();
+    void resetStats();
+
+    static uint64_t hashPath(const char *path);
+
+private:
+    typedef struct {
+        uint64_t hash;
+        uint32_t size;
+        uint32_t mtime;
+    } entry_t;
+
+    bool create();
+    bool writeEntry(int slot);
+    int probe(uint64_t hash, bool *found);
+    uint32_t tileOffset(int slot);
+
+    fs::FS &_fs;
+    const char *_path;
+    uint16_t _tile_w, _tile_h, _slots;
+    uint32_t _tile_bytes;
+    uint32_t _tile_stride;
+    uint32_t _tile_base;
+    entry_t *_index;
+    File _file;
+    bool _open;
+    SemaphoreHandle_t _lock;
+
+    thumb_cache_stats_t _stats;
+};
+
+#endif
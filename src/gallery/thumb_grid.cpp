@@ -0,0 +1,484 @@
+#include <string.h>
+#include <strings.h>
+#include <algorithm>
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "../../pins_config.h"
+#include "../../jpeg_dec.h"
+#include "../mem/pipeline_arena.h"
+#include "thumb_grid.h"
+
+#define THUMB_GRID_STACK_SIZE (4 * 1024)
+#define THUMB_GRID_DONE_DEPTH (8)
+// Camera-sized images take far longer than a panel-sized frame; this only
+// catches a decoder that has stopped making progress
+#define THUMB_GRID_DECODE_MAX_US (20 * 1000 * 1000)
+#define THUMB_GRID_EMPTY_COLOR (0x2104)
+#define THUMB_GRID_FAILED_COLOR (0x5000)
+
+static const char *TAG = "thumb_grid";
+
+// The decoder callback carries no user context; only the grid task decodes
+static thumb_grid *s_active = NULL;
+
+static bool is_jpeg_name(const char *name)
+{
+    const char *ext = strrchr(name, '.');
+    return ext && (strcasecmp(ext, ".jpg") == 0 || strcasecmp(ext, ".jpeg") == 0);
+}
+
+thumb_grid::thumb_grid(fs::FS &fs, nv3041a_lcd &lcd, thumb_cache &cache, uint8_t cols, uint8_t rows)
+    : _fs(fs), _lcd(lcd), _cache(cache), _loader(fs), _scaler(cache.tileWidth(), cache.tileHeight(), 16)
+{
+    _cols = cols ? cols : 1;
+    _rows = rows ? rows : 1;
+    // Even gaps around and between the cells
+    uint32_t used_w = (uint32_t)_cols * cache.tileWidth();
+    uint32_t used_h = (uint32_t)_rows * cache.tileHeight();
+    _gap_x = used_w < LCD_H_RES ? (LCD_H_RES - used_w) / (_cols + 1) : 0;
+    _gap_y = used_h < LCD_V_RES ? (LCD_V_RES - used_h) / (_rows + 1) : 0;
+    _paint[0] = _paint[1] = NULL;
+    _back = 0;
+    _tile = NULL;
+    _page = -1;
+    _pending = 0;
+    _shown_at = 0;
+    _cold = false;
+    _making = false;
+    _task = NULL;
+    _lock = xSemaphoreCreateMutex();
+    _done = NULL;
+    resetStats();
+}
+
+thumb_grid::~thumb_grid()
+{
+    end();
+    if (_lock != NULL) {
+        vSemaphoreDelete(_lock);
+    }
+}
+
+int thumb_grid::loadDirectory(const char *dir)
+{
+    File root = _fs.open(dir);
+    if (!root || !root.isDirectory()) {
+        ESP_LOGW(TAG, "not a directory: %s", dir);
+        return 0;
+    }
+
+    size_t first = _entries.size();
+    File file = root.openNextFile();
+    while (file) {
+        if (!file.isDirectory() && is_jpeg_name(file.name())) {
+            entry_t entry;
+            entry.path = file.path();
+            entry.size = file.size();
+            entry.mtime = (uint32_t)file.getLastWrite();
+            entry.failed = false;
+            entry.known = false;
+            entry.thumb_offset = 0;
+            entry.thumb_length = 0;
+            _entries.push_back(entry);
+        }
+        file.close();
+        file = root.openNextFile();
+    }
+    root.close();
+
+    std::sort(_entries.begin() + first, _entries.end(), [](const entry_t &a, const entry_t &b) {
+        return a.path < b.path;
+    });
+    return _entries.size() - first;
+}
+
+int thumb_grid::loadCatalog(media_catalog &catalog)
+{
+    // The catalog is already in name order
+    media_entry_t m;
+    for (int i = 0; catalog.get(i, &m); i++) {
+        entry_t entry;
+        entry.path = m.path;
+        entry.size = m.size;
+        entry.mtime = m.mtime;
+        entry.failed = (m.flags & MEDIA_UNREADABLE) != 0;
+        entry.known = true;
+        entry.thumb_offset = m.thumb_offset;
+        entry.thumb_length = (m.flags & MEDIA_THUMB) ? m.thumb_length : 0;
+        _entries.push_back(entry);
+    }
+    return catalog.count();
+}
+
+int thumb_grid::count()
+{
+    return _entries.size();
+}
+
+bool thumb_grid::begin(UBaseType_t priority, BaseType_t core)
+{
+    size_t tile_bytes = (size_t)_cache.tileWidth() * _cache.tileHeight() * sizeof(uint16_t);
+    for (int i = 0; i < 2; i++) {
+        _paint[i] = (uint16_t *)pipeline_malloc_align(tile_bytes, ARENA_PSRAM);
+    }
+    _tile = (uint16_t *)pipeline_malloc_align(tile_bytes, ARENA_PSRAM);
+    if (_paint[0] == NULL || _paint[1] == NULL || _tile == NULL || !_scaler.begin()) {
+        ESP_LOGE(TAG, "no memory for tile buffers");
+        return false;
+    }
+    _done = xQueueCreate(THUMB_GRID_DONE_DEPTH, sizeof(done_t));
+    if (_lock == NULL || _done == NULL) {
+        return false;
+    }
+    return xTaskCreatePinnedToCore(taskEntry, "thumb_grid", THUMB_GRID_STACK_SIZE, this, priority, &_task, core) == pdPASS;
+}
+
+void thumb_grid::end()
+{
+    if (_task != NULL) {
+        xSemaphoreTake(_lock, portMAX_DELAY);
+        _todo.clear();
+        xSemaphoreGive(_lock);
+        // A thumbnail already being made is finished and stored; drain its result so the send cannot block
+        for (;;) {
+            xSemaphoreTake(_lock, portMAX_DELAY);
+            bool making = _making;
+            xSemaphoreGive(_lock);
+            if (!making) {
+                break;
+            }
+            done_t done;
+            while (xQueueReceive(_done, &done, 0) == pdTRUE) {
+            }
+            vTaskDelay(1);
+        }
+        vTaskDelete(_task);
+        _task = NULL;
+    }
+    if (_done != NULL) {
+        vQueueDelete(_done);
+        _done = NULL;
+    }
+    _scaler.end();
+    for (int i = 0; i < 2; i++) {
+        pipeline_free_align(_paint[i]);
+        _paint[i] = NULL;
+    }
+    pipeline_free_align(_tile);
+    _tile = NULL;
+}
+
+int thumb_grid::page()
+{
+    return _page;
+}
+
+int thumb_grid::pages()
+{
+    int cells = _cols * _rows;
+    return (_entries.size() + cells - 1) / cells;
+}
+
+const char *thumb_grid::path(int index)
+{
+    return index >= 0 && index < (int)_entries.size() ? _entries[index].path.c_str() : NULL;
+}
+
+bool thumb_grid::cellOf(int index, uint16_t *x, uint16_t *y)
+{
+    int cells = _cols * _rows;
+    if (_page < 0 || index < _page * cells || index >= (_page + 1) * cells) {
+        return false;
+    }
+    int cell = index - _page * cells;
+    *x = _gap_x + (cell % _cols) * (_cache.tileWidth() + _gap_x);
+    *y = _gap_y + (cell / _cols) * (_cache.tileHeight() + _gap_y);
+    return true;
+}
+
+int thumb_grid::hit(uint16_t x, uint16_t y)
+{
+    uint16_t tw = _cache.tileWidth(), th = _cache.tileHeight();
+    if (_page < 0 || x < _gap_x || y < _gap_y) {
+        return -1;
+    }
+    uint16_t col = (x - _gap_x) / (tw + _gap_x);
+    uint16_t row = (y - _gap_y) / (th + _gap_y);
+    if (col >= _cols || row >= _rows || (x - _gap_x) % (tw + _gap_x) >= tw || (y - _gap_y) % (th + _gap_y) >= th) {
+        return -1;
+    }
+    int index = _page * _cols * _rows + row * _cols + col;
+    return index < (int)_entries.size() ? index : -1;
+}
+
+// slot < 0 marks a file that has no thumbnail
+void thumb_grid::paint(int index, int slot)
+{
+    uint16_t x, y;
+    if (!cellOf(index, &x, &y)) {
+        return;
+    }
+    uint16_t tw = _cache.tileWidth(), th = _cache.tileHeight();
+    int64_t t = esp_timer_get_time();
+    // Transfers finish in order: with at most one queued, the other buffer is free
+    _lcd.flush(1);
+    uint16_t *tile = _paint[_back];
+    if (slot >= 0 && _cache.read(slot, tile)) {
+        _lcd.draw16bitbergbbitmap(x, y, tw, th, tile);
+        _back ^= 1;
+    } else {
+        _lcd.fillRect(x, y, tw, th, THUMB_GRID_FAILED_COLOR);
+    }
+    int64_t us = esp_timer_get_time() - t;
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    _stats.paint_us += us;
+    xSemaphoreGive(_lock);
+}
+
+void thumb_grid::show(int page)
+{
+    int cells = _cols * _rows;
+    if (page < 0 || page >= pages()) {
+        return;
+    }
+    _page = page;
+    _shown_at = esp_timer_get_time();
+    _pending = 0;
+    _waiting.assign(cells, false);
+
+    // Drop tiles finished for the last page; they are in the cache if wanted again
+    done_t done;
+    while (_done != NULL && xQueueReceive(_done, &done, 0) == pdTRUE) {
+    }
+
+    _lcd.fillScreen(0x0000);
+    int first = page * cells;
+    int last = std::min(first + cells, (int)_entries.size());
+    int hits = 0;
+    for (int i = first; i < last; i++) {
+        entry_t &e = _entries[i];
+        int slot = e.failed ? -1 : _cache.find(e.path.c_str(), e.size, e.mtime);
+        if (slot >= 0 || e.failed) {
+            paint(i, slot);
+            hits += slot >= 0 ? 1 : 0;
+        } else {
+            uint16_t x, y;
+            cellOf(i, &x, &y);
+            _lcd.fillRect(x, y, _cache.tileWidth(), _cache.tileHeight(), THUMB_GRID_EMPTY_COLOR);
+            _waiting[i - first] = true;
+            _pending++;
+        }
+    }
+    _cold = _pending > 0;
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    _stats.pages++;
+    _stats.hits += hits;
+    _stats.misses += _pending;
+    xSemaphoreGive(_lock);
+
+    if (_task != NULL) {
+        xSemaphoreTake(_lock, portMAX_DELAY);
+        _todo.clear();
+        // What is on screen first, then where the user is most likely to go
+        queuePage(page);
+        queuePage(page + 1);
+        queuePage(page - 1);
+        bool work = !_todo.empty();
+        xSemaphoreGive(_lock);
+        if (work) {
+            xTaskNotifyGive(_task);
+        }
+    }
+
+    if (_pending == 0) {
+        pageDone();
+    }
+}
+
+// Called with _lock held
+void thumb_grid::queuePage(int page)
+{
+    int cells = _cols * _rows;
+    if (page < 0 || page >= pages()) {
+        return;
+    }
+    int last = std::min((page + 1) * cells, (int)_entries.size());
+    for (int i = page * cells; i < last; i++) {
+        entry_t &e = _entries[i];
+        if (!e.failed && _cache.find(e.path.c_str(), e.size, e.mtime) < 0) {
+            _todo.push_back(i);
+        }
+    }
+}
+
+bool thumb_grid::update()
+{
+    done_t done;
+    while (_done != NULL && xQueueReceive(_done, &done, 0) == pdTRUE) {
+        // A cell can be made twice when its page is shown again while it is in flight
+        int cell = done.index - _page * _cols * _rows;
+        if (cell < 0 || cell >= (int)_waiting.size() || !_waiting[cell]) {
+            continue;
+        }
+        _waiting[cell] = false;
+        paint(done.index, done.slot);
+        if (--_pending == 0) {
+            pageDone();
+        }
+    }
+    return _page >= 0 && _pending == 0;
+}
+
+void thumb_grid::pageDone()
+{
+    _lcd.flush();
+    uint32_t full_ms = (uint32_t)((esp_timer_get_time() - _shown_at) / 1000);
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    _stats.last_full_ms = full_ms;
+    _stats.last_cold = _cold;
+    if (_cold) {
+        _stats.cold_ms = full_ms;
+    } else {
+        _stats.warm_ms = full_ms;
+    }
+    xSemaphoreGive(_lock);
+}
+
+void thumb_grid::taskEntry(void *arg)
+{
+    thumb_grid *self = (thumb_grid *)arg;
+
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        for (;;) {
+            xSemaphoreTake(self->_lock, portMAX_DELAY);
+            self->_making = !self->_todo.empty();
+            if (!self->_making) {
+                xSemaphoreGive(self->_lock);
+                break;
+            }
+            int index = self->_todo.front();
+            self->_todo.erase(self->_todo.begin());
+            xSemaphoreGive(self->_lock);
+
+            done_t done = {index, self->make(index)};
+            if (done.slot < 0) {
+                xSemaphoreTake(self->_lock, portMAX_DELAY);
+                self->_entries[index].failed = true;
+                xSemaphoreGive(self->_lock);
+            }
+            xQueueSend(self->_done, &done, portMAX_DELAY);
+        }
+    }
+}
+
+int thumb_grid::decodeCallback(jpeg_dec_io_t *jpeg_io, jpeg_dec_header_info_t *out_info)
+{
+    thumb_grid *self = s_active;
+    int y = jpeg_io->output_line - jpeg_io->cur_line;
+    if (y == 0 && !self->_scaler.start(out_info->width, out_info->height, SCALE_COVER, SCALE_AREA, tileCallback, self)) {
+        return 0;
+    }
+    return self->_scaler.push((const uint16_t *)jpeg_io->outbuf, y, jpeg_io->cur_line) ? 1 : 0;
+}
+
+int thumb_grid::tileCallback(void *ctx, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t *pixels)
+{
+    thumb_grid *self = (thumb_grid *)ctx;
+    uint16_t tw = self->_cache.tileWidth();
+    for (uint16_t row = 0; row < h; row++) {
+        memcpy(self->_tile + (size_t)(y + row) * tw + x, pixels + (size_t)row * w, w * sizeof(uint16_t));
+    }
+    return 1;
+}
+
+// Decode a whole JPEG down to one tile in _tile
+jpeg_dec_result_t thumb_grid::scale(uint8_t *jpeg, size_t len)
+{
+    memset(_tile, 0, (size_t)_cache.tileWidth() * _cache.tileHeight() * sizeof(uint16_t));
+    s_active = this;
+    jpeg_dec_limits_t limits = {};
+    limits.max_us = THUMB_GRID_DECODE_MAX_US;
+    jpeg_dec_result_t err = esp_jpeg_decoder_block_out(jpeg, len, decodeCallback, &limits);
+    s_active = NULL;
+    // The image ended short of the tile
+    return err == JPEG_DEC_OK && !_scaler.done() ? JPEG_DEC_ERR_DATA : err;
+}
+
+// Decode one file down to a tile and store it; the cache slot, or -1
+int thumb_grid::make(int index)
+{
+    const entry_t &e = _entries[index];
+    // Made meanwhile for another page
+    int slot = _cache.find(e.path.c_str(), e.size, e.mtime);
+    if (slot >= 0) {
+        return slot;
+    }
+
+    int64_t t = esp_timer_get_time();
+    uint8_t *jpeg = NULL;
+    size_t len = 0;
+    jpeg_thumb_info_t info;
+    // A camera file's own preview sits in its first few KB and decodes in a fraction of the time
+    bool ok;
+    if (e.known) {
+        len = e.thumb_length;
+        ok = len > 0 && _loader.loadRange(e.path.c_str(), e.thumb_offset, len, &jpeg) == SD_LOAD_OK &&
+             scale(jpeg, len) == JPEG_DEC_OK;
+    } else {
+        ok = _loader.loadThumbnail(e.path.c_str(), &jpeg, &len, &info) == SD_LOAD_OK && !info.progressive &&
+             scale(jpeg, len) == JPEG_DEC_OK;
+    }
+    pipeline_free_align(jpeg);
+    jpeg = NULL;
+    bool embedded = ok;
+
+    if (!ok) {
+        sd_load_err_t err = _loader.load(e.path.c_str(), &jpeg, &len);
+        if (err != SD_LOAD_OK) {
+            ESP_LOGW(TAG, "failed to load %s: %s", e.path.c_str(), sd_loader::errName(err));
+            madeOne(-1, false, esp_timer_get_time() - t);
+            return -1;
+        }
+        jpeg_dec_result_t derr = scale(jpeg, len);
+        pipeline_free_align(jpeg);
+        if (derr != JPEG_DEC_OK) {
+            ESP_LOGW(TAG, "failed to decode %s: %s", e.path.c_str(), jpeg_dec_result_name(derr));
+            madeOne(-1, false, esp_timer_get_time() - t);
+            return -1;
+        }
+    }
+
+    slot = _cache.store(e.path.c_str(), e.size, e.mtime, _tile);
+    madeOne(slot, embedded, esp_timer_get_time() - t);
+    return slot;
+}
+
+// Counts one make(): a thumbnail only counts as made, or embedded, once it is in the cache
+void thumb_grid::madeOne(int slot, bool embedded, int64_t us)
+{
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    _stats.make_us += us;
+    if (slot >= 0) {
+        _stats.made++;
+        _stats.embedded += embedded ? 1 : 0;
+    } else {
+        _stats.failed++;
+    }
+    xSemaphoreGive(_lock);
+}
+
+thumb_grid_stats_t thumb_grid::stats()
+{
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    thumb_grid_stats_t s = _stats;
+    xSemaphoreGive(_lock);
+    return s;
+}
+
+void thumb_grid::resetStats()
+{
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    memset(&_stats, 0, sizeof(_stats));
+    xSemaphoreGive(_lock);
+}
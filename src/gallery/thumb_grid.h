@@ -0,0 +1,129 @@
+#ifndef _THUMB_GRID_H
+#define _THUMB_GRID_H
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "FS.h"
+#include <ESP32_JPEG_Library.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/queue.h"
+#include "../../jpeg_dec.h"
+#include "../lcd/nv3041a_lcd.h"
+#include "../sd/sd_loader.h"
+#include "../gfx/strip_scaler.h"
+#include "thumb_cache.h"
+#include "media_catalog.h"
+
+typedef struct {
+    uint32_t pages;            // show() calls
+    uint32_t hits;             // visible cells painted straight from the cache
+    uint32_t misses;           // visible cells that had to wait for a decode
+    uint32_t made;             // thumbnails decoded and stored in the background
+    uint32_t embedded;         // of those, made from the file's own EXIF/JFIF preview
+    uint32_t failed;           // files that could not be read or decoded
+    uint32_t last_full_ms;     // show() until the last visible cell was painted
+    bool last_cold;            // whether that page needed any decode
+    uint32_t cold_ms;          // latest time-to-full-grid with decodes
+    uint32_t warm_ms;          // latest time-to-full-grid from the cache alone
+    uint64_t make_us;          // read + decode + scale + store, all thumbnails
+    uint64_t paint_us;         // cache reads and tile draws
+} thumb_grid_stats_t;
+
+/*
+ * Paged thumbnail grid over the JPEGs of a folder.
+ *
+ * Cells are sized by the tiles of the thumb_cache. show() paints every cell
+ * whose tile is cached by streaming it from the cache file to the panel, and
+ * puts a placeholder in the others. The misses are queued for a background
+ * task: the visible page first, in reading order, then the next page and the
+ * previous one. The task decodes the file's embedded preview when it has one,
+ * otherwise the whole image, through a strip_scaler sized to one tile, so no
+ * frame is ever held, and stores the tile. update(), called from loop(),
+ * paints tiles as they land. Tiles are keyed by path, size and mtime, so an
+ * edited file gets a new thumbnail.
+ */
+class thumb_grid
+{
+public:
+    thumb_grid(fs::FS &fs, nv3041a_lcd &lcd, thumb_cache &cache, uint8_t cols = 4, uint8_t rows = 3);
+    ~thumb_grid();
+
+    int loadDirectory(const char *dir);
+    // Files from a catalog instead of a directory listing; previews are then read from where it says
+    int loadCatalog(media_catalog &catalog);
+    int count();
+    bool begin(UBaseType_t priority = 1, BaseType_t core = 0);
+    // Stops the background task once the thumbnail in hand is stored, and frees the tile buffers
+    void end();
+
+    void show(int page);
+    // Paint finished tiles; true once every cell of the page is painted
+    bool update();
+
+    int page();
+    int pages();
+    // File index under a panel point, -1 for a gap or an empty cell
+    int hit(uint16_t x, uint16_t y);
+    const char *path(int index);
+
+    thumb_grid_stats_t stats();
+    void resetStats();
+
+private:
+    typedef struct {
+        std::string path;
+        uint32_t size;
+        uint32_t mtime;
+        bool failed;           // unreadable or undecodable; not tried again
+        bool known;            // from a catalog: thumb_* below are all there is to know
+        uint32_t thumb_offset;
+        uint32_t thumb_length; // 0: no embedded preview
+    } entry_t;
+
+    typedef struct {
+        int index;
+        int slot;              // -1 when the file failed
+    } done_t;
+
+    static void taskEntry(void *arg);
+    static int decodeCallback(jpeg_dec_io_t *jpeg_io, jpeg_dec_header_info_t *out_info);
+    static int tileCallback(void *ctx, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t *pixels);
+    bool cellOf(int index, uint16_t *x, uint16_t *y);
+    void paint(int index, int slot);
+    void queuePage(int page);
+    jpeg_dec_result_t scale(uint8_t *jpeg, size_t len);
+    int make(int index);
+    void madeOne(int slot, bool embedded, int64_t us);
+    void pageDone();
+
+    fs::FS &_fs;
+    nv3041a_lcd &_lcd;
+    thumb_cache &_cache;
+    sd_loader _loader;
+    strip_scaler _scaler;
+    uint8_t _cols, _rows;
+    uint16_t _gap_x, _gap_y;
+    std::vector<entry_t> _entries;
+
+    uint16_t *_paint[2];       // tile read buffers, alternated so one can be on the bus
+    uint8_t _back;
+    uint16_t *_tile;           // background task: tile being made
+
+    int _page;
+    int _pending;              // visible cells still waiting for a tile
+    std::vector<bool> _waiting; // per cell of the page
+    int64_t _shown_at;
+    bool _cold;
+
+    std::vector<int> _todo;    // indices to make, most wanted first
+    bool _making;              // the task has taken an index off _todo and not yet come back for another
+    TaskHandle_t _task;
+    SemaphoreHandle_t _lock;
+    QueueHandle_t _done;
+
+    thumb_grid_stats_t _stats;
+};
+
+#endif
@@ -0,0 +1,298 @@
+#include <string.h>
+#include <stdlib.h>
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "../../pins_config.h"
+#include "../mem/pipeline_arena.h"
+#include "transition.h"
+
+#define TRANSITION_FRAME_SIZE (LCD_H_RES * LCD_V_RES * sizeof(uint16_t))
+
+static const char *TAG = "transition";
+
+// The decoder callback carries no user context, so only one transition loads at a time
+static transition *s_active = NULL;
+
+static inline uint16_t swap16(uint16_t p)
+{
+    return (p >> 8) | (p << 8);
+}
+
+// a / 32 of `in` over `out`, all three channels at once in 32 bits; pixels in panel byte order
+static inline uint16_t mix565(uint16_t out, uint16_t in, uint32_t a)
+{
+    uint32_t o = swap16(out);
+    uint32_t i = swap16(in);
+    o = (o | (o << 16)) & 0x07E0F81F;
+    i = (i | (i << 16)) & 0x07E0F81F;
+    uint32_t r = ((o * (32 - a) + i * a + 0x02008010) >> 5) & 0x07E0F81F;
+    return swap16((uint16_t)(r | (r >> 16)));
+}
+
+transition::transition(nv3041a_lcd &lcd, uint16_t strip_lines)
+    : _lcd(lcd)
+{
+    _strip_lines = strip_lines ? strip_lines : 16;
+    _strips = (LCD_V_RES + _strip_lines - 1) / _strip_lines;
+    _frame[0] = _frame[1] = NULL;
+    _front = 0;
+    _strip[0] = _strip[1] = NULL;
+    _back = 0;
+    _diff = NULL;
+    _loaded = false;
+    resetStats();
+}
+
+transition::~transition()
+{
+    end();
+}
+
+bool transition::begin()
+{
+    if (_diff != NULL) {
+        return true;
+    }
+    for (int i = 0; i < 2; i++) {
+        _frame[i] = (uint16_t *)pipeline_malloc_align(TRANSITION_FRAME_SIZE, ARENA_PSRAM);
+        _strip[i] = (uint16_t *)pipeline_malloc_align((size_t)LCD_H_RES * _strip_lines * sizeof(uint16_t), ARENA_INTERNAL);
+        if (_frame[i] == NULL || _strip[i] == NULL) {
+            ESP_LOGE(TAG, "no memory for transition buffers");
+            end();
+            return false;
+        }
+        memset(_frame[i], 0, TRANSITION_FRAME_SIZE);
+    }
+    _diff = (uint16_t *)calloc((size_t)_strips * 2, sizeof(uint16_t));
+    if (_diff == NULL) {
+        end();
+        return false;
+    }
+    return true;
+}
+
+void transition::end()
+{
+    // run() leaves nothing on the bus, but a strip must not be freed under the DMA
+    _lcd.flush();
+    for (int i = 0; i < 2; i++) {
+        pipeline_free_align(_frame[i]);
+        pipeline_free_align(_strip[i]);
+        _frame[i] = NULL;
+        _strip[i] = NULL;
+    }
+    free(_diff);
+    _diff = NULL;
+    _front = 0;
+    _back = 0;
+    _loaded = false;
+}
+
+int transition::decodeCallback(jpeg_dec_io_t *jpeg_io, jpeg_dec_header_info_t *out_info)
+{
+    transition *self = s_active;
+    int y = jpeg_io->output_line - jpeg_io->cur_line;
+    int w = out_info->width > LCD_H_RES ? LCD_H_RES : out_info->width;
+    uint16_t *src = (uint16_t *)jpeg_io->outbuf;
+    uint16_t *frame = self->_frame[self->_front ^ 1];
+    for (int row = 0; row < jpeg_io->cur_line && y + row < LCD_V_RES; row++) {
+        memcpy(frame + (y + row) * LCD_H_RES, src + row * out_info->width, w * sizeof(uint16_t));
+    }
+    return 1;
+}
+
+jpeg_dec_result_t transition::load(uint8_t *jpeg, size_t len)
+{
+    if (_diff == NULL) {
+        return JPEG_DEC_ERR_NO_MEM;
+    }
+    memset(_frame[_front ^ 1], 0, TRANSITION_FRAME_SIZE);
+    s_active = this;
+    jpeg_dec_result_t err = esp_jpeg_decoder_block_out(jpeg, len, decodeCallback);
+    s_active = NULL;
+    if (err != JPEG_DEC_OK) {
+        ESP_LOGW(TAG, "decode failed: %s", jpeg_dec_result_name(err));
+    }
+    diffStrips();
+    _loaded = true;
+    return err;
+}
+
+// Rows the two images share need no blending and no bus time; most gallery
+// images agree at least in their letterbox bars
+void transition::diffStrips()
+{
+    const uint16_t *a = _frame[0];
+    const uint16_t *b = _frame[1];
+    for (uint16_t s = 0; s < _strips; s++) {
+        uint16_t y0 = s * _strip_lines;
+        uint16_t h = LCD_V_RES - y0 < _strip_lines ? LCD_V_RES - y0 : _strip_lines;
+        uint16_t first = h, end = 0;
+        for (uint16_t r = 0; r < h; r++) {
+            size_t off = (size_t)(y0 + r) * LCD_H_RES;
+            if (memcmp(a + off, b + off, LCD_H_RES * sizeof(uint16_t)) != 0) {
+                first = r < first ? r : first;
+                end = r + 1;
+            }
+        }
+        _diff[2 * s] = end ? first : 0;
+        _diff[2 * s + 1] = end;
+    }
+}
+
+// Screen state for eased progress p (0..1024): blend level, slide offset or wipe edge
+uint16_t transition::level(transition_kind_t kind, uint32_t p)
+{
+    switch (kind) {
+    case TRANSITION_CROSSFADE:
+        return (p * 32 + 512) >> 10;
+    case TRANSITION_SLIDE_LEFT:
+    case TRANSITION_SLIDE_RIGHT:
+    case TRANSITION_WIPE_RIGHT:
+        return (p * LCD_H_RES + 512) >> 10;
+    case TRANSITION_WIPE_DOWN:
+        return (p * LCD_V_RES + 512) >> 10;
+    default:
+        return p >= 1024 ? 1 : 0;
+    }
+}
+
+uint16_t *transition::nextStrip()
+{
+    // Transfers finish in order: with at most one queued, it is the other strip
+    _lcd.flush(1);
+    return _strip[_back];
+}
+
+void transition::send(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t *pixels)
+{
+    _lcd.draw16bitbergbbitmap(x, y, w, h, pixels);
+    _back ^= 1;
+    _stats.strips_sent++;
+    _stats.bytes += (uint32_t)w * h * 2;
+}
+
+// Send what changes between screen states prev and cur
+void transition::step(transition_kind_t kind, uint16_t prev, uint16_t cur)
+{
+    const uint16_t *out = _frame[_front];
+    const uint16_t *in = _frame[_front ^ 1];
+
+    for (uint16_t s = 0; s < _strips; s++) {
+        uint16_t y0 = s * _strip_lines;
+        uint16_t h = LCD_V_RES - y0 < _strip_lines ? LCD_V_RES - y0 : _strip_lines;
+        uint16_t d0 = y0 + _diff[2 * s], d1 = y0 + _diff[2 * s + 1];
+        uint16_t x = 0, w = LCD_H_RES;
+        uint16_t r0 = d0, r1 = d1;
+
+        if (kind == TRANSITION_SLIDE_LEFT || kind == TRANSITION_SLIDE_RIGHT) {
+            // Everything moves, even where the two images agree
+            r0 = y0;
+            r1 = y0 + h;
+        } else if (kind == TRANSITION_WIPE_DOWN) {
+            r0 = prev > d0 ? prev : d0;
+            r1 = cur < d1 ? cur : d1;
+        } else if (kind == TRANSITION_WIPE_RIGHT) {
+            x = prev;
+            w = cur - prev;
+        }
+        if (r1 <= r0 || w == 0) {
+            _stats.strips_skipped++;
+            continue;
+        }
+
+        uint16_t *strip = nextStrip();
+        int64_t t = esp_timer_get_time();
+        for (uint16_t y = r0; y < r1; y++) {
+            const uint16_t *o = out + (size_t)y * LCD_H_RES;
+            const uint16_t *i = in + (size_t)y * LCD_H_RES;
+            uint16_t *dst = strip + (size_t)(y - r0) * w;
+            switch (kind) {
+            case TRANSITION_CROSSFADE:
+                for (uint16_t k = 0; k < LCD_H_RES; k++) {
+                    dst[k] = mix565(o[k], i[k], cur);
+                }
+                break;
+            case TRANSITION_SLIDE_LEFT:
+                memcpy(dst, o + cur, (LCD_H_RES - cur) * sizeof(uint16_t));
+                memcpy(dst + LCD_H_RES - cur, i, cur * sizeof(uint16_t));
+                break;
+            case TRANSITION_SLIDE_RIGHT:
+                memcpy(dst, i + LCD_H_RES - cur, cur * sizeof(uint16_t));
+                memcpy(dst + cur, o, (LCD_H_RES - cur) * sizeof(uint16_t));
+                break;
+            default:
+                memcpy(dst, i + x, w * sizeof(uint16_t));
+                break;
+            }
+        }
+        _stats.compose_us += esp_timer_get_time() - t;
+        send(x, r0, w, r1 - r0, strip);
+    }
+}
+
+bool transition::run(transition_kind_t kind, uint32_t duration_ms, uint16_t fps)
+{
+    if (_diff == NULL || !_loaded) {
+        return false;
+    }
+    int64_t period = 1000000 / (fps ? fps : 30);
+    int64_t duration = (int64_t)duration_ms * 1000;
+    int64_t t0 = esp_timer_get_time();
+    uint32_t steps = 0;
+
+    if (kind == TRANSITION_CUT || duration <= 0) {
+        step(TRANSITION_CUT, 0, 1);
+        steps++;
+    } else {
+        uint16_t prev = 0;
+        for (int64_t slot = 1;; slot++) {
+            int64_t now = esp_timer_get_time() - t0;
+            uint32_t p = now >= duration ? 1024 : (uint32_t)(now * 1024 / duration);
+            // Smoothstep, so motion starts and settles gently
+            uint32_t eased = (uint32_t)((uint64_t)p * p * (3 * 1024 - 2 * p) >> 20);
+            uint16_t cur = level(kind, eased);
+            if (cur != prev) {
+                step(kind, prev, cur);
+                prev = cur;
+                steps++;
+            } else {
+                _stats.idle_steps++;
+            }
+            if (p >= 1024) {
+                break;
+            }
+            // A step that ran past its slot is late; the timeline is driven by the
+            // clock, so the next step simply lands further along
+            now = esp_timer_get_time() - t0;
+            if (now > slot * period) {
+                _stats.late_steps++;
+                slot = now / period;
+            } else if ((slot * period - now) >= 1000) {
+                vTaskDelay(pdMS_TO_TICKS((slot * period - now) / 1000));
+            }
+        }
+    }
+    _lcd.flush();
+    _front ^= 1;
+    _loaded = false;
+
+    uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+    _stats.transitions++;
+    _stats.steps += steps;
+    _stats.last_ms = us / 1000;
+    _stats.last_fps_x10 = us ? (uint32_t)((uint64_t)steps * 10000000 / us) : 0;
+    return true;
+}
+
+transition_stats_t transition::stats()
+{
+    return _stats;
+}
+
+void transition::resetStats()
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
@@ -0,0 +1,82 @@
+#ifndef _TRANSITION_H
+#define _TRANSITION_H
+#include <stdio.h>
+#include <ESP32_JPEG_Library.h>
+#include "../../jpeg_dec.h"
+#include "../lcd/nv3041a_lcd.h"
+
+typedef enum {
+    TRANSITION_CUT = 0,
+    TRANSITION_CROSSFADE,
+    TRANSITION_SLIDE_LEFT,  // the new image pushes the old one out to the left
+    TRANSITION_SLIDE_RIGHT,
+    TRANSITION_WIPE_DOWN,   // the new image is uncovered from the top
+    TRANSITION_WIPE_RIGHT,  // ... from the left
+} transition_kind_t;
+
+typedef struct {
+    uint32_t transitions;
+    uint32_t steps;          // frames sent to the panel
+    uint32_t late_steps;     // steps that overran their slot
+    uint32_t idle_steps;     // slots where nothing on screen would have changed
+    uint32_t strips_sent;
+    uint32_t strips_skipped; // strips with nothing to send in a step
+    uint64_t bytes;
+    uint64_t compose_us;     // blending and copying, bus waits excluded
+    uint32_t last_ms;        // duration of the last transition
+    uint32_t last_fps_x10;   // steps per second it achieved
+} transition_stats_t;
+
+/*
+ * Animated change between two decoded images.
+ *
+ * Both images are decoded once into PSRAM frames, the one on screen and the
+ * incoming one; internal RAM only holds two output strips. Each step of the
+ * timeline composes the strips the step changes (a fixed-point crossfade, a
+ * slide or a wipe edge) from the two frames and sends just those, as narrow
+ * as the change allows: a wipe sends the band its edge moved over, and rows
+ * that are the same in both images are never resent. Output strips alternate
+ * so one is composed while the other is on the bus. The first image fades in
+ * from black.
+ */
+class transition
+{
+public:
+    transition(nv3041a_lcd &lcd, uint16_t strip_lines = 16);
+    ~transition();
+
+    bool begin();
+    // Frees the frames and strips; begin() again before the next load()
+    void end();
+
+    // Decode the next image into the incoming frame, clipped to the panel
+    jpeg_dec_result_t load(uint8_t *jpeg, size_t len);
+    // Animate from the image on screen to the loaded one; returns when it is fully
+    // shown, false if nothing was loaded since the last run
+    bool run(transition_kind_t kind, uint32_t duration_ms = 500, uint16_t fps = 30);
+
+    transition_stats_t stats();
+    void resetStats();
+
+private:
+    static int decodeCallback(jpeg_dec_io_t *jpeg_io, jpeg_dec_header_info_t *out_info);
+    void diffStrips();
+    uint16_t level(transition_kind_t kind, uint32_t progress);
+    void step(transition_kind_t kind, uint16_t prev, uint16_t cur);
+    uint16_t *nextStrip();
+    void send(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t *pixels);
+
+    nv3041a_lcd &_lcd;
+    uint16_t _strip_lines;
+    uint16_t _strips;
+    uint16_t *_frame[2];     // PSRAM: [_front] is on screen, the other is incoming
+    uint8_t _front;
+    uint16_t *_strip[2];     // internal, DMA-capable
+    uint8_t _back;
+    uint16_t *_diff;         // per strip: first and end row that differ between the frames
+    bool _loaded;
+
+    transition_stats_t _stats;
+};
+
+#endif
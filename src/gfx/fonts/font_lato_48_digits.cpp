@@ -0,0 +1,556 @@
+// Generated by tools/font_pack from Lato-Regular.ttf at 48 px, characters 0x20..0x3a.
+// Lato: Copyright (c) 2010-2011 by tyPoland Lukasz Dziedzic, licensed under the SIL Open Font License 1.1.
+#include "../strip_font.h"
+
+static const uint8_t bitmap[] = {
+    0x0b, 0xff, 0xf5, 0x00, 0x0b, 0xff, 0xf5, 0x00, 0x0b, 0xff, 0xf5, 0x00, 0x0b, 0xff, 0xf5, 0x00,
+    0x0b, 0xff, 0xf5, 0x00, 0x0b, 0xff, 0xf5, 0x00, 0x0b, 0xff, 0xf5, 0x00, 0x0b, 0xff, 0xf5, 0x00,
+    0x0b, 0xff, 0xf5, 0x00, 0x0b, 0xff, 0xf5, 0x00, 0x0b, 0xff, 0xf5, 0x00, 0x0b, 0xff, 0xf5, 0x00,
+    0x0b, 0xff, 0xf5, 0x00, 0x0b, 0xff, 0xf5, 0x00, 0x0b, 0xff, 0xf5, 0x00, 0x0b, 0xff, 0xf4, 0x00,
+    0x0a, 0xff, 0xf4, 0x00, 0x09, 0xff, 0xf3, 0x00, 0x08, 0xff, 0xf2, 0x00, 0x07, 0xff, 0xf1, 0x00,
+    0x06, 0xff, 0xf0, 0x00, 0x04, 0xff, 0xd0, 0x00, 0x02, 0xaa, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x07, 0xef, 0xb2, 0x00, 0x5f, 0xff, 0xfc, 0x00, 0xaf, 0xff, 0xff, 0x20,
+    0xaf, 0xff, 0xff, 0x10, 0x5f, 0xff, 0xfb, 0x00, 0x06, 0xde, 0xa1, 0x00, 0x5f, 0xff, 0x60, 0x00,
+    0x5f, 0xff, 0x50, 0x5f, 0xff, 0x60, 0x00, 0x5f, 0xff, 0x50, 0x5f, 0xff, 0x60, 0x00, 0x5f, 0xff,
+    0x50, 0x5f, 0xff, 0x60, 0x00, 0x5f, 0xff, 0x50, 0x5f, 0xff, 0x60, 0x00, 0x5f, 0xff, 0x50, 0x5f,
+    0xff, 0x60, 0x00, 0x5f, 0xff, 0x50, 0x5f, 0xff, 0x60, 0x00, 0x5f, 0xff, 0x50, 0x5f, 0xff, 0x50,
+    0x00, 0x5f, 0xff, 0x50, 0x3f, 0xff, 0x30, 0x00, 0x3f, 0xff, 0x30, 0x2f, 0xff, 0x20, 0x00, 0x2f,
+    0xff, 0x20, 0x0f, 0xff, 0x00, 0x00, 0x0f, 0xff, 0x00, 0x0b, 0xfc, 0x00, 0x00, 0x0b, 0xfc, 0x00,
+    0x01, 0x62, 0x00, 0x00, 0x01, 0x62, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0xdf, 0xd0, 0x00, 0x00,
+    0x3f, 0xfc, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0xff, 0xa0, 0x00, 0x00, 0x6f, 0xff, 0x30,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x1f, 0xff, 0x70, 0x00, 0x00, 0x9f, 0xff, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x3f, 0xff, 0x40, 0x00, 0x00, 0xcf, 0xfc, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7f,
+    0xff, 0x10, 0x00, 0x00, 0xff, 0xf9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xaf, 0xfd, 0x00, 0x00,
+    0x03, 0xff, 0xf6, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xdf, 0xfa, 0x00, 0x00, 0x06, 0xff, 0xf2,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xff, 0xf7, 0x00, 0x00, 0x09, 0xff, 0xe0, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x04, 0xff, 0xf4, 0x00, 0x00, 0x0c, 0xff, 0xb0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07,
+    0xff, 0xf1, 0x00, 0x00, 0x0f, 0xff, 0x80, 0x00, 0x00, 0x00, 0xbf, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xf6, 0x04, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xf4, 0x07, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xd0,
+    0x02, 0x33, 0x33, 0x4f, 0xff, 0x83, 0x33, 0x33, 0xaf, 0xfe, 0x33, 0x32, 0x00, 0x00, 0x00, 0x00,
+    0x4f, 0xff, 0x40, 0x00, 0x00, 0xcf, 0xfb, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x6f, 0xff, 0x10,
+    0x00, 0x00, 0xef, 0xf8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x9f, 0xfe, 0x00, 0x00, 0x02, 0xff,
+    0xf6, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xcf, 0xfb, 0x00, 0x00, 0x05, 0xff, 0xf3, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xef, 0xf8, 0x00, 0x00, 0x08, 0xff, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x02, 0xff, 0xf6, 0x00, 0x00, 0x0a, 0xff, 0xd0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0xff, 0xf3,
+    0x00, 0x00, 0x0d, 0xff, 0xa0, 0x00, 0x00, 0x00, 0x13, 0x33, 0x39, 0xff, 0xf3, 0x33, 0x33, 0x3f,
+    0xff, 0x93, 0x33, 0x20, 0x00, 0x8f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xfb, 0x00, 0xaf, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfd, 0x00, 0x7f,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfb, 0x00, 0x00, 0x00, 0x2f, 0xff,
+    0x60, 0x00, 0x00, 0xaf, 0xfd, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5f, 0xff, 0x30, 0x00, 0x00,
+    0xdf, 0xfa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8f, 0xff, 0x00, 0x00, 0x01, 0xff, 0xf7, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xbf, 0xfc, 0x00, 0x00, 0x04, 0xff, 0xf4, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xef, 0xf9, 0x00, 0x00, 0x08, 0xff, 0xf1, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0xff,
+    0xf6, 0x00, 0x00, 0x0b, 0xff, 0xd0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0xff, 0xf3, 0x00, 0x00,
+    0x0e, 0xff, 0xa0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0xff, 0xe0, 0x00, 0x00, 0x2f, 0xff, 0x70,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x0b, 0xff, 0xb0, 0x00, 0x00, 0x4f, 0xff, 0x40, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x0e, 0xfd, 0x30, 0x00, 0x00, 0x1d, 0xff, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x2e, 0xf5, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x6f, 0xf4, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7f, 0xf3, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8f, 0xf2, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x9f, 0xf1, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5a, 0xce,
+    0xff, 0xfc, 0x96, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x6d, 0xff, 0xff, 0xff, 0xff, 0xff, 0xe8,
+    0x10, 0x00, 0x00, 0x00, 0x1a, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xd3, 0x00, 0x00, 0x00,
+    0xbf, 0xff, 0xff, 0xeb, 0xff, 0xed, 0xff, 0xff, 0xff, 0x50, 0x00, 0x07, 0xff, 0xff, 0xb3, 0x00,
+    0xff, 0xb0, 0x29, 0xff, 0xff, 0x30, 0x00, 0x1e, 0xff, 0xf8, 0x00, 0x00, 0xff, 0xa0, 0x00, 0x2a,
+    0xf6, 0x00, 0x00, 0x7f, 0xff, 0xb0, 0x00, 0x01, 0xff, 0x90, 0x00, 0x00, 0x00, 0x00, 0x00, 0xbf,
+    0xff, 0x50, 0x00, 0x02, 0xff, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0xdf, 0xff, 0x20, 0x00, 0x03,
+    0xff, 0x70, 0x00, 0x00, 0x00, 0x00, 0x00, 0xef, 0xff, 0x20, 0x00, 0x04, 0xff, 0x60, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xdf, 0xff, 0x50, 0x00, 0x05, 0xff, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0xbf,
+    0xff, 0xc0, 0x00, 0x06, 0xff, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7f, 0xff, 0xfa, 0x10, 0x07,
+    0xff, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1e, 0xff, 0xff, 0xd4, 0x08, 0xff, 0x20, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x06, 0xff, 0xff, 0xff, 0xdd, 0xff, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x7f, 0xff, 0xff, 0xff, 0xff, 0x72, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0xdf, 0xff, 0xff,
+    0xff, 0xff, 0xc7, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0xcf, 0xff, 0xff, 0xff, 0xff, 0xe7,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x7f, 0xff, 0xff, 0xff, 0xff, 0xc1, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x0f, 0xfd, 0xbf, 0xff, 0xff, 0xfc, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1f,
+    0xfa, 0x02, 0x9f, 0xff, 0xff, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2f, 0xf9, 0x00, 0x04, 0xef,
+    0xff, 0xe0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3f, 0xf8, 0x00, 0x00, 0x5f, 0xff, 0xf4, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x4f, 0xf7, 0x00, 0x00, 0x0d, 0xff, 0xf5, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5f,
+    0xf6, 0x00, 0x00, 0x0a, 0xff, 0xf6, 0x00, 0x00, 0x00, 0x00, 0x00, 0x6f, 0xf5, 0x00, 0x00, 0x0a,
+    0xff, 0xf5, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7f, 0xf4, 0x00, 0x00, 0x0c, 0xff, 0xf3, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x8f, 0xf3, 0x00, 0x00, 0x2f, 0xff, 0xe0, 0x02, 0xcb, 0x20, 0x00, 0x00, 0x9f,
+    0xf2, 0x00, 0x00, 0x9f, 0xff, 0xa0, 0x0b, 0xff, 0xe6, 0x00, 0x00, 0xaf, 0xf1, 0x00, 0x07, 0xff,
+    0xff, 0x30, 0x4f, 0xff, 0xff, 0xc4, 0x00, 0xbf, 0xf0, 0x03, 0xaf, 0xff, 0xf9, 0x00, 0x07, 0xff,
+    0xff, 0xff, 0xea, 0xef, 0xfa, 0xdf, 0xff, 0xff, 0xc0, 0x00, 0x00, 0x4d, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xfa, 0x10, 0x00, 0x00, 0x01, 0x8e, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe, 0x60,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x49, 0xce, 0xff, 0xfe, 0xda, 0x51, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x01, 0xff, 0x90, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0xff,
+    0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0xff, 0x70, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0xff, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x05, 0xff, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x86,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x17, 0xce, 0xfd, 0xa5, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x9e, 0xff, 0x40, 0x00, 0x00, 0x05, 0xef, 0xff, 0xff, 0xff, 0xc2, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0xff, 0xf8, 0x00, 0x00, 0x00, 0x5f, 0xff, 0xfe, 0xdf, 0xff,
+    0xfd, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3f, 0xff, 0xc0, 0x00, 0x00, 0x01, 0xef, 0xfd, 0x40,
+    0x01, 0x6f, 0xff, 0xa0, 0x00, 0x00, 0x00, 0x00, 0x01, 0xdf, 0xfe, 0x20, 0x00, 0x00, 0x08, 0xff,
+    0xe2, 0x00, 0x00, 0x06, 0xff, 0xf3, 0x00, 0x00, 0x00, 0x00, 0x0a, 0xff, 0xf5, 0x00, 0x00, 0x00,
+    0x0d, 0xff, 0x80, 0x00, 0x00, 0x00, 0xdf, 0xf8, 0x00, 0x00, 0x00, 0x00, 0x6f, 0xff, 0x90, 0x00,
+    0x00, 0x00, 0x1f, 0xff, 0x40, 0x00, 0x00, 0x00, 0x9f, 0xfc, 0x00, 0x00, 0x00, 0x03, 0xef, 0xfd,
+    0x10, 0x00, 0x00, 0x00, 0x3f, 0xff, 0x20, 0x00, 0x00, 0x00, 0x7f, 0xfd, 0x00, 0x00, 0x00, 0x1c,
+    0xff, 0xf3, 0x00, 0x00, 0x00, 0x00, 0x4f, 0xff, 0x20, 0x00, 0x00, 0x00, 0x6f, 0xfe, 0x00, 0x00,
+    0x00, 0x9f, 0xff, 0x60, 0x00, 0x00, 0x00, 0x00, 0x3f, 0xff, 0x20, 0x00, 0x00, 0x00, 0x7f, 0xfd,
+    0x00, 0x00, 0x05, 0xff, 0xfa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1f, 0xff, 0x40, 0x00, 0x00, 0x00,
+    0x9f, 0xfb, 0x00, 0x00, 0x2e, 0xff, 0xd1, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0d, 0xff, 0x90, 0x00,
+    0x00, 0x00, 0xdf, 0xf7, 0x00, 0x00, 0xcf, 0xff, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0xff,
+    0xf3, 0x00, 0x00, 0x07, 0xff, 0xf2, 0x00, 0x08, 0xff, 0xf7, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0xef, 0xfe, 0x61, 0x02, 0x8f, 0xff, 0x80, 0x00, 0x4f, 0xff, 0xb0, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x4e, 0xff, 0xff, 0xff, 0xff, 0xfb, 0x00, 0x01, 0xef, 0xfe, 0x10, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0xdf, 0xff, 0xff, 0xff, 0x90, 0x00, 0x0b, 0xff, 0xf4, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0xac, 0xdb, 0x83, 0x00, 0x00, 0x7f, 0xff,
+    0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03,
+    0xff, 0xfc, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x1d, 0xff, 0xe2, 0x00, 0x01, 0x7b, 0xef, 0xda, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xaf, 0xff, 0x50, 0x00, 0x4e, 0xff, 0xff, 0xff, 0xfc, 0x20, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x06, 0xff, 0xf9, 0x00, 0x04, 0xff, 0xff, 0xee, 0xff, 0xff, 0xd1, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2e, 0xff, 0xd1, 0x00, 0x1e, 0xff, 0xd5, 0x00, 0x17, 0xff,
+    0xfa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xcf, 0xff, 0x30, 0x00, 0x7f, 0xff, 0x20, 0x00,
+    0x00, 0x6f, 0xff, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0xff, 0xf6, 0x00, 0x00, 0xcf, 0xf9,
+    0x00, 0x00, 0x00, 0x0d, 0xff, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5f, 0xff, 0xa0, 0x00, 0x01,
+    0xff, 0xf5, 0x00, 0x00, 0x00, 0x09, 0xff, 0xc0, 0x00, 0x00, 0x00, 0x00, 0x02, 0xef, 0xfd, 0x10,
+    0x00, 0x02, 0xff, 0xf3, 0x00, 0x00, 0x00, 0x06, 0xff, 0xd0, 0x00, 0x00, 0x00, 0x00, 0x0c, 0xff,
+    0xf4, 0x00, 0x00, 0x03, 0xff, 0xf2, 0x00, 0x00, 0x00, 0x05, 0xff, 0xe0, 0x00, 0x00, 0x00, 0x00,
+    0x8f, 0xff, 0x70, 0x00, 0x00, 0x02, 0xff, 0xf3, 0x00, 0x00, 0x00, 0x06, 0xff, 0xd0, 0x00, 0x00,
+    0x00, 0x04, 0xff, 0xfb, 0x00, 0x00, 0x00, 0x01, 0xff, 0xf5, 0x00, 0x00, 0x00, 0x08, 0xff, 0xc0,
+    0x00, 0x00, 0x00, 0x1e, 0xff, 0xe2, 0x00, 0x00, 0x00, 0x00, 0xdf, 0xf9, 0x00, 0x00, 0x00, 0x0c,
+    0xff, 0x80, 0x00, 0x00, 0x00, 0xbf, 0xff, 0x40, 0x00, 0x00, 0x00, 0x00, 0x7f, 0xfe, 0x20, 0x00,
+    0x00, 0x5f, 0xff, 0x30, 0x00, 0x00, 0x07, 0xff, 0xf8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1e, 0xff,
+    0xd4, 0x00, 0x16, 0xff, 0xfa, 0x00, 0x00, 0x00, 0x3f, 0xff, 0xc0, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x04, 0xff, 0xff, 0xed, 0xff, 0xff, 0xd1, 0x00, 0x00, 0x01, 0xdf, 0xfe, 0x20, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x4e, 0xff, 0xff, 0xff, 0xfb, 0x10, 0x00, 0x00, 0x0a, 0xff, 0xe5, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x7c, 0xef, 0xda, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x27, 0xbd, 0xfe, 0xd9, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x19, 0xff, 0xff, 0xff, 0xff, 0xfc, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x01, 0xdf, 0xff, 0xff, 0xff, 0xff, 0xff, 0xe4, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x0c, 0xff, 0xff, 0xd8, 0x67, 0xaf, 0xff, 0xfe, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x6f, 0xff, 0xf7, 0x00, 0x00, 0x03, 0xdf, 0xff, 0xb0, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xdf, 0xff, 0x80, 0x00, 0x00, 0x00, 0x3e, 0xff, 0xf2, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x03, 0xff, 0xfe, 0x10, 0x00, 0x00, 0x00, 0x09, 0xff, 0xf6, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0xff, 0xfb, 0x00, 0x00, 0x00, 0x00, 0x02, 0xdc, 0x93, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0xff, 0xfa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0xff, 0xfb, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0xff, 0xfe, 0x10, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xdf, 0xff, 0x60, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7f, 0xff, 0xe2, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1e, 0xff, 0xfb, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0xff, 0xff,
+    0xa0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xcf,
+    0xff, 0xfa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5d,
+    0xff, 0xff, 0xff, 0xa0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1a,
+    0xff, 0xff, 0xef, 0xff, 0xf9, 0x00, 0x00, 0x00, 0x00, 0x09, 0xee, 0x90, 0x00, 0x00, 0x00, 0x01,
+    0xcf, 0xff, 0xe6, 0x1c, 0xff, 0xff, 0x90, 0x00, 0x00, 0x00, 0x0e, 0xff, 0x90, 0x00, 0x00, 0x00,
+    0x0b, 0xff, 0xfd, 0x20, 0x01, 0xcf, 0xff, 0xf9, 0x00, 0x00, 0x00, 0x2f, 0xff, 0x70, 0x00, 0x00,
+    0x00, 0x7f, 0xff, 0xe2, 0x00, 0x00, 0x1c, 0xff, 0xff, 0x90, 0x00, 0x00, 0x5f, 0xff, 0x40, 0x00,
+    0x00, 0x01, 0xff, 0xff, 0x50, 0x00, 0x00, 0x01, 0xcf, 0xff, 0xf9, 0x00, 0x00, 0x9f, 0xff, 0x10,
+    0x00, 0x00, 0x07, 0xff, 0xfd, 0x00, 0x00, 0x00, 0x00, 0x1c, 0xff, 0xff, 0x90, 0x01, 0xef, 0xfc,
+    0x00, 0x00, 0x00, 0x0c, 0xff, 0xf8, 0x00, 0x00, 0x00, 0x00, 0x01, 0xcf, 0xff, 0xf9, 0x06, 0xff,
+    0xf6, 0x00, 0x00, 0x00, 0x0e, 0xff, 0xf5, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1c, 0xff, 0xff, 0x9d,
+    0xff, 0xe1, 0x00, 0x00, 0x00, 0x0f, 0xff, 0xf5, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xcf, 0xff,
+    0xff, 0xff, 0x70, 0x00, 0x00, 0x00, 0x0e, 0xff, 0xf7, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1c,
+    0xff, 0xff, 0xfd, 0x00, 0x00, 0x00, 0x00, 0x0c, 0xff, 0xfc, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0xcf, 0xff, 0xfa, 0x00, 0x00, 0x00, 0x00, 0x08, 0xff, 0xff, 0x40, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x03, 0xef, 0xff, 0xff, 0x80, 0x00, 0x00, 0x00, 0x02, 0xff, 0xff, 0xe2, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x7f, 0xff, 0xff, 0xff, 0xf7, 0x00, 0x00, 0x00, 0x00, 0x8f, 0xff, 0xfe, 0x61, 0x00,
+    0x00, 0x01, 0x6d, 0xff, 0xff, 0x9c, 0xff, 0xff, 0x60, 0x00, 0x00, 0x00, 0x0b, 0xff, 0xff, 0xfe,
+    0xa9, 0x9a, 0xcf, 0xff, 0xff, 0xf6, 0x01, 0xdf, 0xff, 0xf5, 0x00, 0x00, 0x00, 0x01, 0xbf, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xfb, 0x30, 0x00, 0x2d, 0xff, 0xff, 0x40, 0x00, 0x00, 0x00, 0x06,
+    0xdf, 0xff, 0xff, 0xff, 0xff, 0xfc, 0x50, 0x00, 0x00, 0x03, 0xef, 0xff, 0xe3, 0x00, 0x00, 0x00,
+    0x00, 0x05, 0x9d, 0xef, 0xed, 0xa7, 0x30, 0x00, 0x00, 0x00, 0x00, 0x3c, 0xff, 0xfe, 0x30, 0x5f,
+    0xff, 0x60, 0x5f, 0xff, 0x60, 0x5f, 0xff, 0x60, 0x5f, 0xff, 0x60, 0x5f, 0xff, 0x60, 0x5f, 0xff,
+    0x60, 0x5f, 0xff, 0x60, 0x5f, 0xff, 0x50, 0x3f, 0xff, 0x30, 0x2f, 0xff, 0x20, 0x0f, 0xff, 0x00,
+    0x0b, 0xfc, 0x00, 0x01, 0x62, 0x00, 0x00, 0x00, 0x00, 0x44, 0x00, 0x00, 0x00, 0x00, 0xdf, 0x90,
+    0x00, 0x00, 0x07, 0xff, 0xf4, 0x00, 0x00, 0x1e, 0xff, 0xe1, 0x00, 0x00, 0x8f, 0xff, 0x70, 0x00,
+    0x01, 0xef, 0xfd, 0x00, 0x00, 0x08, 0xff, 0xf7, 0x00, 0x00, 0x0d, 0xff, 0xe1, 0x00, 0x00, 0x5f,
+    0xff, 0x90, 0x00, 0x00, 0xaf, 0xff, 0x30, 0x00, 0x00, 0xef, 0xfd, 0x00, 0x00, 0x04, 0xff, 0xf9,
+    0x00, 0x00, 0x08, 0xff, 0xf4, 0x00, 0x00, 0x0c, 0xff, 0xf1, 0x00, 0x00, 0x0f, 0xff, 0xc0, 0x00,
+    0x00, 0x3f, 0xff, 0x90, 0x00, 0x00, 0x5f, 0xff, 0x70, 0x00, 0x00, 0x7f, 0xff, 0x40, 0x00, 0x00,
+    0x9f, 0xff, 0x30, 0x00, 0x00, 0xaf, 0xff, 0x10, 0x00, 0x00, 0xbf, 0xff, 0x00, 0x00, 0x00, 0xbf,
+    0xff, 0x00, 0x00, 0x00, 0xcf, 0xfe, 0x00, 0x00, 0x00, 0xbf, 0xfe, 0x00, 0x00, 0x00, 0xbf, 0xff,
+    0x00, 0x00, 0x00, 0xaf, 0xff, 0x10, 0x00, 0x00, 0x9f, 0xff, 0x20, 0x00, 0x00, 0x8f, 0xff, 0x30,
+    0x00, 0x00, 0x6f, 0xff, 0x60, 0x00, 0x00, 0x4f, 0xff, 0x80, 0x00, 0x00, 0x1f, 0xff, 0xb0, 0x00,
+    0x00, 0x0e, 0xff, 0xe0, 0x00, 0x00, 0x0a, 0xff, 0xf3, 0x00, 0x00, 0x06, 0xff, 0xf7, 0x00, 0x00,
+    0x02, 0xff, 0xfb, 0x00, 0x00, 0x00, 0xcf, 0xff, 0x10, 0x00, 0x00, 0x7f, 0xff, 0x70, 0x00, 0x00,
+    0x2f, 0xff, 0xd0, 0x00, 0x00, 0x0a, 0xff, 0xf4, 0x00, 0x00, 0x04, 0xff, 0xfb, 0x00, 0x00, 0x00,
+    0xcf, 0xff, 0x30, 0x00, 0x00, 0x4f, 0xff, 0xb0, 0x00, 0x00, 0x0b, 0xff, 0xf3, 0x00, 0x00, 0x03,
+    0xff, 0xe2, 0x00, 0x00, 0x00, 0x8a, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x34, 0x00, 0x00,
+    0x00, 0x08, 0xfe, 0x10, 0x00, 0x00, 0x2f, 0xff, 0x80, 0x00, 0x00, 0x0d, 0xff, 0xf2, 0x00, 0x00,
+    0x05, 0xff, 0xf9, 0x00, 0x00, 0x00, 0xcf, 0xff, 0x20, 0x00, 0x00, 0x6f, 0xff, 0x90, 0x00, 0x00,
+    0x0e, 0xff, 0xe1, 0x00, 0x00, 0x08, 0xff, 0xf6, 0x00, 0x00, 0x02, 0xff, 0xfb, 0x00, 0x00, 0x00,
+    0xcf, 0xff, 0x10, 0x00, 0x00, 0x8f, 0xff, 0x60, 0x00, 0x00, 0x3f, 0xff, 0xa0, 0x00, 0x00, 0x0e,
+    0xff, 0xd0, 0x00, 0x00, 0x0b, 0xff, 0xf2, 0x00, 0x00, 0x08, 0xff, 0xf4, 0x00, 0x00, 0x05, 0xff,
+    0xf7, 0x00, 0x00, 0x03, 0xff, 0xf8, 0x00, 0x00, 0x01, 0xff, 0xfa, 0x00, 0x00, 0x00, 0xff, 0xfb,
+    0x00, 0x00, 0x00, 0xef, 0xfc, 0x00, 0x00, 0x00, 0xdf, 0xfd, 0x00, 0x00, 0x00, 0xdf, 0xfd, 0x00,
+    0x00, 0x00, 0xdf, 0xfd, 0x00, 0x00, 0x00, 0xef, 0xfc, 0x00, 0x00, 0x00, 0xef, 0xfc, 0x00, 0x00,
+    0x01, 0xff, 0xfb, 0x00, 0x00, 0x02, 0xff, 0xf9, 0x00, 0x00, 0x04, 0xff, 0xf8, 0x00, 0x00, 0x07,
+    0xff, 0xf5, 0x00, 0x00, 0x0a, 0xff, 0xf3, 0x00, 0x00, 0x0d, 0xff, 0xf0, 0x00, 0x00, 0x1f, 0xff,
+    0xb0, 0x00, 0x00, 0x6f, 0xff, 0x80, 0x00, 0x00, 0xaf, 0xff, 0x30, 0x00, 0x01, 0xef, 0xfd, 0x00,
+    0x00, 0x06, 0xff, 0xf9, 0x00, 0x00, 0x0b, 0xff, 0xf3, 0x00, 0x00, 0x3f, 0xff, 0xc0, 0x00, 0x00,
+    0x9f, 0xff, 0x50, 0x00, 0x02, 0xff, 0xfd, 0x00, 0x00, 0x0a, 0xff, 0xf5, 0x00, 0x00, 0x2f, 0xff,
+    0xc0, 0x00, 0x00, 0x1e, 0xff, 0x40, 0x00, 0x00, 0x01, 0xa9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x59, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8f, 0x90, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x8f, 0x90, 0x00, 0x00, 0x00, 0x07, 0x10, 0x00, 0x8f, 0x90, 0x00,
+    0x17, 0x00, 0x5f, 0xe6, 0x00, 0x8f, 0x90, 0x05, 0xdf, 0x60, 0x4d, 0xff, 0xc4, 0x7f, 0x93, 0xcf,
+    0xfd, 0x40, 0x00, 0x7e, 0xff, 0xbf, 0xbf, 0xfe, 0x81, 0x00, 0x00, 0x01, 0x9f, 0xff, 0xff, 0xa2,
+    0x00, 0x00, 0x00, 0x00, 0x3b, 0xff, 0xfc, 0x40, 0x00, 0x00, 0x00, 0x2a, 0xff, 0xef, 0xef, 0xfb,
+    0x20, 0x00, 0x07, 0xef, 0xf9, 0x7f, 0x88, 0xff, 0xf8, 0x10, 0x7f, 0xfc, 0x30, 0x7f, 0x90, 0x3b,
+    0xff, 0x90, 0x1c, 0x60, 0x00, 0x8f, 0x90, 0x00, 0x5d, 0x20, 0x00, 0x00, 0x00, 0x8f, 0x90, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x8f, 0x90, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8f, 0x90, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x11, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xdf, 0xf9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xdf,
+    0xf9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xdf, 0xf9, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xdf, 0xf9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xdf, 0xf9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xdf,
+    0xf9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xdf, 0xf9, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xdf, 0xf9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xdf, 0xf9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xdf,
+    0xf9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x9f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xf6, 0x9f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xf6, 0x9f, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xf6, 0x24, 0x44, 0x44, 0x44, 0x44, 0xef,
+    0xfb, 0x44, 0x44, 0x44, 0x44, 0x42, 0x00, 0x00, 0x00, 0x00, 0x00, 0xdf, 0xf9, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xdf, 0xf9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xdf, 0xf9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xdf,
+    0xf9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xdf, 0xf9, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xdf, 0xf9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xdf, 0xf9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xdf,
+    0xf9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xdf, 0xf9, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xdf, 0xf9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x9a,
+    0x50, 0x00, 0x4f, 0xff, 0xf6, 0x00, 0xaf, 0xff, 0xfd, 0x00, 0xaf, 0xff, 0xff, 0x00, 0x5f, 0xff,
+    0xff, 0x00, 0x07, 0xdf, 0xfd, 0x00, 0x00, 0x0c, 0xf9, 0x00, 0x00, 0x2f, 0xf3, 0x00, 0x00, 0xaf,
+    0xb0, 0x00, 0x05, 0xff, 0x30, 0x00, 0x3e, 0xf7, 0x00, 0x00, 0x6f, 0x80, 0x00, 0x00, 0x05, 0x00,
+    0x00, 0x00, 0x6a, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x20, 0x9f, 0xff, 0xff, 0xff, 0xff, 0xff, 0x40,
+    0x9f, 0xff, 0xff, 0xff, 0xff, 0xff, 0x40, 0x9f, 0xff, 0xff, 0xff, 0xff, 0xff, 0x40, 0x00, 0x00,
+    0x00, 0x00, 0x08, 0xef, 0xa1, 0x00, 0x7f, 0xff, 0xfa, 0x00, 0xcf, 0xff, 0xff, 0x00, 0xcf, 0xff,
+    0xff, 0x00, 0x7f, 0xff, 0xfa, 0x00, 0x08, 0xde, 0x91, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x02, 0xcf, 0xe1, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0xff, 0x90, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x3f, 0xff, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x9f,
+    0xfc, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xef, 0xf6, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x06, 0xff, 0xe1, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0xff, 0x90, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3f, 0xff, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x9f, 0xfd, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xef, 0xf7, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x06, 0xff, 0xf1, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0xff, 0xa0,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3f, 0xff, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x9f, 0xfd, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xef, 0xf7, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x05, 0xff, 0xf1, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0b, 0xff,
+    0xa0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2f, 0xff, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x8f, 0xfd, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xef, 0xf7, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0xff, 0xf2, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0b,
+    0xff, 0xb0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2f, 0xff, 0x50, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x8f, 0xfe, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xef, 0xf8, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0xff, 0xf2, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x0b, 0xff, 0xb0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2f, 0xff, 0x50, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x8f, 0xfe, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xdf, 0xf8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0xff, 0xf2, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x0b, 0xff, 0xb0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2f, 0xff, 0x60, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x8f, 0xfe, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xdf,
+    0xf9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0xff, 0xf3, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x0a, 0xff, 0xb0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1f, 0xfb, 0x20, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x28, 0xbe, 0xff, 0xdb, 0x71, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2a, 0xff, 0xff, 0xff, 0xff, 0xff, 0x91, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x05, 0xef, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfd, 0x30, 0x00, 0x00, 0x00, 0x00, 0x5f,
+    0xff, 0xff, 0xfc, 0xbb, 0xdf, 0xff, 0xff, 0xe2, 0x00, 0x00, 0x00, 0x02, 0xef, 0xff, 0xf9, 0x20,
+    0x00, 0x03, 0xbf, 0xff, 0xfd, 0x10, 0x00, 0x00, 0x0c, 0xff, 0xff, 0x50, 0x00, 0x00, 0x00, 0x08,
+    0xff, 0xff, 0x90, 0x00, 0x00, 0x5f, 0xff, 0xf7, 0x00, 0x00, 0x00, 0x00, 0x00, 0xaf, 0xff, 0xf2,
+    0x00, 0x00, 0xcf, 0xff, 0xc0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1e, 0xff, 0xf9, 0x00, 0x03, 0xff,
+    0xff, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0xff, 0xfe, 0x10, 0x08, 0xff, 0xfe, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x02, 0xff, 0xff, 0x50, 0x0c, 0xff, 0xfa, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xdf, 0xff, 0x90, 0x1f, 0xff, 0xf6, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x9f,
+    0xff, 0xd0, 0x3f, 0xff, 0xf3, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x6f, 0xff, 0xf0, 0x5f,
+    0xff, 0xf1, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4f, 0xff, 0xf3, 0x6f, 0xff, 0xf0, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3f, 0xff, 0xf4, 0x8f, 0xff, 0xe0, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x2f, 0xff, 0xf5, 0x8f, 0xff, 0xd0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x1f, 0xff, 0xf6, 0x8f, 0xff, 0xd0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1f, 0xff, 0xf6,
+    0x8f, 0xff, 0xd0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1f, 0xff, 0xf6, 0x8f, 0xff, 0xe0,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1f, 0xff, 0xf5, 0x7f, 0xff, 0xf0, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x3f, 0xff, 0xf4, 0x5f, 0xff, 0xf1, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x4f, 0xff, 0xf3, 0x3f, 0xff, 0xf3, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x6f, 0xff,
+    0xf1, 0x1f, 0xff, 0xf6, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x9f, 0xff, 0xd0, 0x0c, 0xff,
+    0xfa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xcf, 0xff, 0x90, 0x08, 0xff, 0xfe, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x02, 0xff, 0xff, 0x50, 0x03, 0xff, 0xff, 0x50, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x08, 0xff, 0xff, 0x10, 0x00, 0xcf, 0xff, 0xc0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1e, 0xff,
+    0xf9, 0x00, 0x00, 0x5f, 0xff, 0xf6, 0x00, 0x00, 0x00, 0x00, 0x00, 0xaf, 0xff, 0xf3, 0x00, 0x00,
+    0x0c, 0xff, 0xff, 0x50, 0x00, 0x00, 0x00, 0x08, 0xff, 0xff, 0x90, 0x00, 0x00, 0x03, 0xef, 0xff,
+    0xf9, 0x20, 0x00, 0x03, 0xbf, 0xff, 0xfd, 0x10, 0x00, 0x00, 0x00, 0x5f, 0xff, 0xff, 0xfc, 0xab,
+    0xdf, 0xff, 0xff, 0xe3, 0x00, 0x00, 0x00, 0x00, 0x05, 0xef, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfd,
+    0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2a, 0xff, 0xff, 0xff, 0xff, 0xff, 0x91, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x28, 0xbe, 0xff, 0xdb, 0x71, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x7f, 0xff, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0xff, 0xff, 0x80,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xbf, 0xff, 0xff, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x1c, 0xff, 0xff, 0xff, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0xdf, 0xff, 0xff, 0xff,
+    0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4e, 0xff, 0xff, 0xef, 0xff, 0x80, 0x00, 0x00, 0x00, 0x00,
+    0x05, 0xff, 0xff, 0xf7, 0xaf, 0xff, 0x80, 0x00, 0x00, 0x00, 0x00, 0x7f, 0xff, 0xfe, 0x50, 0xbf,
+    0xff, 0x80, 0x00, 0x00, 0x00, 0x09, 0xff, 0xff, 0xe3, 0x00, 0xbf, 0xff, 0x80, 0x00, 0x00, 0x00,
+    0x0c, 0xff, 0xfd, 0x20, 0x00, 0xbf, 0xff, 0x80, 0x00, 0x00, 0x00, 0x02, 0xef, 0xb1, 0x00, 0x00,
+    0xbf, 0xff, 0x80, 0x00, 0x00, 0x00, 0x00, 0x25, 0x00, 0x00, 0x00, 0xbf, 0xff, 0x80, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xbf, 0xff, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0xbf, 0xff, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xbf, 0xff, 0x80, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xbf, 0xff, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xbf, 0xff, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xbf, 0xff, 0x80,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xbf, 0xff, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xbf, 0xff, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xbf, 0xff,
+    0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xbf, 0xff, 0x80, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xbf, 0xff, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xbf,
+    0xff, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xbf, 0xff, 0x80, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xbf, 0xff, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xbf, 0xff, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xbf, 0xff, 0x80, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xbf, 0xff, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0xbf, 0xff, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xbf, 0xff, 0x80, 0x00,
+    0x00, 0x00, 0x00, 0x04, 0x44, 0x44, 0x44, 0xcf, 0xff, 0xa4, 0x44, 0x44, 0x41, 0x00, 0x2f, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xf5, 0x00, 0x2f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xf5, 0x00, 0x2f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xf5, 0x00, 0x00,
+    0x00, 0x01, 0x6a, 0xde, 0xfe, 0xc9, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x8e, 0xff, 0xff,
+    0xff, 0xff, 0xfd, 0x60, 0x00, 0x00, 0x00, 0x00, 0x2d, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfa,
+    0x00, 0x00, 0x00, 0x02, 0xdf, 0xff, 0xff, 0xeb, 0xbd, 0xff, 0xff, 0xff, 0x90, 0x00, 0x00, 0x0c,
+    0xff, 0xff, 0xb3, 0x00, 0x00, 0x18, 0xff, 0xff, 0xf5, 0x00, 0x00, 0x7f, 0xff, 0xf7, 0x00, 0x00,
+    0x00, 0x00, 0x3e, 0xff, 0xfd, 0x00, 0x00, 0xdf, 0xff, 0x90, 0x00, 0x00, 0x00, 0x00, 0x07, 0xff,
+    0xff, 0x40, 0x04, 0xff, 0xfe, 0x10, 0x00, 0x00, 0x00, 0x00, 0x01, 0xef, 0xff, 0x80, 0x08, 0xff,
+    0xfa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xbf, 0xff, 0xa0, 0x09, 0xff, 0xf4, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xaf, 0xff, 0xb0, 0x00, 0x02, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xaf,
+    0xff, 0xa0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xcf, 0xff, 0x90, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xff, 0xff, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x06, 0xff, 0xff, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0d, 0xff,
+    0xf9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7f, 0xff, 0xf2, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0xff, 0xff, 0x70, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x1d, 0xff, 0xfc, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xcf, 0xff, 0xd1,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0b, 0xff, 0xfe, 0x30, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xaf, 0xff, 0xe3, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0a,
+    0xff, 0xff, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x9f, 0xff, 0xf4, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0xff, 0xff, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x9f, 0xff, 0xf5, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0xff, 0xff,
+    0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x9f, 0xff, 0xf6, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x09, 0xff, 0xff, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x9f, 0xff, 0xf7, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0xff, 0xff, 0x70, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8f, 0xff, 0xf8, 0x00, 0x22, 0x22, 0x22, 0x22, 0x22,
+    0x22, 0x00, 0x08, 0xff, 0xff, 0xeb, 0xef, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xe2, 0x3f, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xf6, 0x7f, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xf7, 0x8f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xf7, 0x00, 0x00, 0x00, 0x00, 0x48, 0xcd, 0xfe, 0xdb, 0x72, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x5d, 0xff, 0xff, 0xff, 0xff, 0xff, 0xb2, 0x00, 0x00, 0x00, 0x00, 0x0a, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xfe, 0x40, 0x00, 0x00, 0x00, 0xaf, 0xff, 0xff, 0xfc, 0xbb, 0xef, 0xff, 0xff,
+    0xf3, 0x00, 0x00, 0x07, 0xff, 0xff, 0xd6, 0x10, 0x00, 0x04, 0xbf, 0xff, 0xfc, 0x00, 0x00, 0x2f,
+    0xff, 0xfc, 0x10, 0x00, 0x00, 0x00, 0x09, 0xff, 0xff, 0x50, 0x00, 0x8f, 0xff, 0xe1, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xdf, 0xff, 0xa0, 0x00, 0xef, 0xff, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8f,
+    0xff, 0xc0, 0x02, 0xff, 0xfe, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5f, 0xff, 0xd0, 0x02, 0x8b,
+    0xc6, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4f, 0xff, 0xd0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x6f, 0xff, 0xa0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xbf,
+    0xff, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0xff, 0xfe, 0x10, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x6f, 0xff, 0xf4, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+    0x24, 0x7d, 0xff, 0xfe, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x6f, 0xff, 0xff, 0xfd, 0x71,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x6f, 0xff, 0xff, 0xfa, 0x50, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x6f, 0xff, 0xff, 0xff, 0xfc, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x13,
+    0x45, 0x8c, 0xff, 0xff, 0xf5, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4d, 0xff,
+    0xff, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xcf, 0xff, 0xc0, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3f, 0xff, 0xf3, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x0d, 0xff, 0xf7, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0a,
+    0xff, 0xf9, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0xff, 0xfa, 0x18, 0xef,
+    0xa0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0a, 0xff, 0xf9, 0x3f, 0xff, 0xf3, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x0e, 0xff, 0xf7, 0x0c, 0xff, 0xfb, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5f,
+    0xff, 0xf4, 0x06, 0xff, 0xff, 0x50, 0x00, 0x00, 0x00, 0x00, 0x01, 0xdf, 0xff, 0xe0, 0x00, 0xdf,
+    0xff, 0xe4, 0x00, 0x00, 0x00, 0x00, 0x1b, 0xff, 0xff, 0x60, 0x00, 0x5f, 0xff, 0xff, 0x92, 0x00,
+    0x00, 0x16, 0xef, 0xff, 0xfc, 0x00, 0x00, 0x08, 0xff, 0xff, 0xff, 0xdb, 0xbc, 0xff, 0xff, 0xff,
+    0xd1, 0x00, 0x00, 0x00, 0x8f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfb, 0x20, 0x00, 0x00, 0x00,
+    0x04, 0xcf, 0xff, 0xff, 0xff, 0xff, 0xfd, 0x70, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x8c, 0xde,
+    0xfe, 0xc9, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0a, 0xff,
+    0xfa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x6f, 0xff, 0xfa, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0xff, 0xff, 0xfa, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1d, 0xff, 0xff, 0xfa, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x9f, 0xff, 0xff, 0xfa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x05, 0xff, 0xfc, 0xef, 0xfa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x2e, 0xff, 0xe3, 0xff, 0xfa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xcf, 0xff,
+    0x61, 0xff, 0xfa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0xff, 0xfa, 0x01, 0xff,
+    0xfa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4f, 0xff, 0xd1, 0x01, 0xff, 0xfa, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0xef, 0xff, 0x40, 0x01, 0xff, 0xfa, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x0b, 0xff, 0xf8, 0x00, 0x01, 0xff, 0xfa, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x8f, 0xff, 0xc0, 0x00, 0x01, 0xff, 0xfa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04,
+    0xff, 0xfe, 0x20, 0x00, 0x01, 0xff, 0xfa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1d, 0xff, 0xf6,
+    0x00, 0x00, 0x01, 0xff, 0xfa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xbf, 0xff, 0xa0, 0x00, 0x00,
+    0x01, 0xff, 0xfa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0xff, 0xfd, 0x10, 0x00, 0x00, 0x01, 0xff,
+    0xfa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3f, 0xff, 0xf4, 0x00, 0x00, 0x00, 0x01, 0xff, 0xfa, 0x00,
+    0x00, 0x00, 0x00, 0x01, 0xdf, 0xff, 0x80, 0x00, 0x00, 0x00, 0x01, 0xff, 0xfa, 0x00, 0x00, 0x00,
+    0x00, 0x0a, 0xff, 0xfc, 0x00, 0x00, 0x00, 0x00, 0x01, 0xff, 0xfa, 0x00, 0x00, 0x00, 0x00, 0x6f,
+    0xff, 0xe2, 0x00, 0x00, 0x00, 0x00, 0x01, 0xff, 0xfa, 0x00, 0x00, 0x00, 0x02, 0xef, 0xff, 0x60,
+    0x00, 0x00, 0x00, 0x00, 0x01, 0xff, 0xfa, 0x00, 0x00, 0x00, 0x0c, 0xff, 0xfd, 0x66, 0x66, 0x66,
+    0x66, 0x66, 0x67, 0xff, 0xfc, 0x66, 0x66, 0x50, 0x0e, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xd0, 0x0b, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xd0, 0x04, 0xef, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xa0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xff, 0xfa, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xff, 0xfa, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xff, 0xfa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x01, 0xff, 0xfa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x01, 0xff, 0xfa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0xff, 0xfa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xff,
+    0xfa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xff, 0xfa, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xff, 0xfa, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x0e, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xf7, 0x00, 0x00, 0x00, 0x1f, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xf7, 0x00, 0x00, 0x00, 0x4f, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xf5, 0x00, 0x00, 0x00, 0x7f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe, 0xa0, 0x00,
+    0x00, 0x00, 0x9f, 0xff, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xcf, 0xfd,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xef, 0xfb, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0xff, 0xf8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x04, 0xff, 0xf5, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0xff, 0xf3,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0a, 0xff, 0xf0, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0xff, 0xc0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x0f, 0xff, 0xa3, 0x57, 0x89, 0x87, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2f, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xfe, 0xa3, 0x00, 0x00, 0x00, 0x00, 0x5f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0x80, 0x00, 0x00, 0x00, 0x8f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfb, 0x00, 0x00,
+    0x00, 0x27, 0xbc, 0x85, 0x31, 0x01, 0x26, 0xcf, 0xff, 0xff, 0x90, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x05, 0xef, 0xff, 0xf3, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x4f, 0xff, 0xfa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0xff, 0xff, 0x10,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0xff, 0xff, 0x40, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xef, 0xff, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0xdf, 0xff, 0x70, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xcf, 0xff, 0x70,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xef, 0xff, 0x60, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x01, 0xff, 0xff, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x06, 0xff, 0xfe, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0d, 0xff, 0xfa, 0x00,
+    0x00, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8f, 0xff, 0xf3, 0x00, 0x02, 0xef, 0x81, 0x00,
+    0x00, 0x00, 0x00, 0x07, 0xff, 0xff, 0xa0, 0x00, 0x0c, 0xff, 0xfe, 0x82, 0x00, 0x00, 0x04, 0xbf,
+    0xff, 0xfd, 0x10, 0x00, 0x2e, 0xff, 0xff, 0xff, 0xec, 0xbc, 0xef, 0xff, 0xff, 0xe3, 0x00, 0x00,
+    0x02, 0xbf, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfc, 0x20, 0x00, 0x00, 0x00, 0x04, 0xcf, 0xff,
+    0xff, 0xff, 0xff, 0xfd, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x7b, 0xdf, 0xfd, 0xc9, 0x40,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xae, 0xff, 0xf3, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0xff, 0xff, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x9f, 0xff, 0xf9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0xff, 0xff,
+    0xb0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2e, 0xff, 0xfd, 0x10, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xcf, 0xff, 0xe3, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x08, 0xff, 0xff, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4f, 0xff, 0xf8, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xef, 0xff, 0xb0, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x0b, 0xff, 0xfd, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7f,
+    0xff, 0xe3, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0xff, 0xff, 0x50, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1d, 0xff, 0xf8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xaf, 0xff, 0xb3, 0x8c, 0xef, 0xec, 0x94, 0x00, 0x00, 0x00, 0x00, 0x05, 0xff, 0xfe,
+    0xbf, 0xff, 0xff, 0xff, 0xff, 0xc4, 0x00, 0x00, 0x00, 0x1e, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0x60, 0x00, 0x00, 0x8f, 0xff, 0xff, 0xfc, 0x86, 0x56, 0xae, 0xff, 0xff, 0xf6, 0x00,
+    0x01, 0xef, 0xff, 0xfd, 0x40, 0x00, 0x00, 0x01, 0x9f, 0xff, 0xff, 0x20, 0x07, 0xff, 0xff, 0xb1,
+    0x00, 0x00, 0x00, 0x00, 0x07, 0xff, 0xff, 0xa0, 0x0b, 0xff, 0xfe, 0x10, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0xaf, 0xff, 0xf1, 0x1f, 0xff, 0xf7, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2f, 0xff, 0xf6,
+    0x3f, 0xff, 0xf1, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0d, 0xff, 0xf9, 0x5f, 0xff, 0xd0, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0xff, 0xfa, 0x6f, 0xff, 0xb0, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x08, 0xff, 0xfb, 0x5f, 0xff, 0xc0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0xff, 0xfa,
+    0x3f, 0xff, 0xd0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0a, 0xff, 0xf9, 0x1f, 0xff, 0xf2, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x0e, 0xff, 0xf6, 0x0b, 0xff, 0xf7, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x6f, 0xff, 0xf1, 0x06, 0xff, 0xfe, 0x20, 0x00, 0x00, 0x00, 0x00, 0x01, 0xef, 0xff, 0xa0,
+    0x00, 0xdf, 0xff, 0xc1, 0x00, 0x00, 0x00, 0x00, 0x2c, 0xff, 0xff, 0x20, 0x00, 0x5f, 0xff, 0xfd,
+    0x50, 0x00, 0x00, 0x16, 0xef, 0xff, 0xf7, 0x00, 0x00, 0x08, 0xff, 0xff, 0xfe, 0xb9, 0xab, 0xff,
+    0xff, 0xff, 0x90, 0x00, 0x00, 0x00, 0x7f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xf8, 0x00, 0x00,
+    0x00, 0x00, 0x04, 0xcf, 0xff, 0xff, 0xff, 0xff, 0xfb, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03,
+    0x8c, 0xde, 0xed, 0xb7, 0x30, 0x00, 0x00, 0x00, 0x5f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0x00, 0x5f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0x00, 0x5f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0x2e,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfb, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x0b, 0xff, 0xf5, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x6f, 0xff, 0xd0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xdf,
+    0xff, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0xff, 0xfd, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0d, 0xff, 0xf6, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x6f, 0xff, 0xd0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xdf, 0xff, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0xff,
+    0xfd, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0d, 0xff, 0xf7, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x6f, 0xff, 0xe1, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xdf, 0xff, 0x70, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x06, 0xff, 0xfe, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0d, 0xff,
+    0xf7, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x6f, 0xff, 0xe1, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xdf, 0xff, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x06, 0xff, 0xfe, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x0d, 0xff, 0xf8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x6f, 0xff,
+    0xe1, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xdf, 0xff, 0x80, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0xff, 0xff, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x0d, 0xff, 0xf9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x6f, 0xff, 0xf2, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xdf, 0xff,
+    0x90, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0xff, 0xff, 0x20, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0d, 0xff, 0xfa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x6f, 0xff, 0xf2, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0xdf, 0xff, 0xa0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0xff, 0xff,
+    0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0d, 0xff, 0xfa, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x6f, 0xff, 0xf3, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xdf, 0xfe, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x03, 0x8c, 0xdf, 0xed, 0xb7, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0xcf, 0xff,
+    0xff, 0xff, 0xff, 0xfa, 0x20, 0x00, 0x00, 0x00, 0x00, 0x7f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xe5, 0x00, 0x00, 0x00, 0x07, 0xff, 0xff, 0xfb, 0x76, 0x68, 0xcf, 0xff, 0xff, 0x40, 0x00, 0x00,
+    0x3f, 0xff, 0xfc, 0x20, 0x00, 0x00, 0x04, 0xdf, 0xff, 0xe1, 0x00, 0x00, 0xcf, 0xff, 0xc1, 0x00,
+    0x00, 0x00, 0x00, 0x2e, 0xff, 0xf8, 0x00, 0x02, 0xff, 0xff, 0x40, 0x00, 0x00, 0x00, 0x00, 0x07,
+    0xff, 0xfd, 0x00, 0x05, 0xff, 0xfd, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0xff, 0xff, 0x20, 0x07,
+    0xff, 0xfb, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xef, 0xff, 0x40, 0x07, 0xff, 0xfb, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xef, 0xff, 0x40, 0x05, 0xff, 0xfd, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+    0xff, 0xff, 0x20, 0x02, 0xff, 0xff, 0x20, 0x00, 0x00, 0x00, 0x00, 0x05, 0xff, 0xfe, 0x00, 0x00,
+    0xbf, 0xff, 0xa0, 0x00, 0x00, 0x00, 0x00, 0x0c, 0xff, 0xf8, 0x00, 0x00, 0x3f, 0xff, 0xf7, 0x00,
+    0x00, 0x00, 0x00, 0xaf, 0xff, 0xe1, 0x00, 0x00, 0x06, 0xff, 0xff, 0xc5, 0x20, 0x12, 0x6d, 0xff,
+    0xfe, 0x30, 0x00, 0x00, 0x00, 0x4d, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xc2, 0x00, 0x00, 0x00,
+    0x00, 0x01, 0x9f, 0xff, 0xff, 0xff, 0xff, 0xf7, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5d, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xb3, 0x00, 0x00, 0x00, 0x1a, 0xff, 0xff, 0xfc, 0x97, 0x89, 0xdf, 0xff,
+    0xff, 0x80, 0x00, 0x00, 0xbf, 0xff, 0xf9, 0x20, 0x00, 0x00, 0x03, 0xbf, 0xff, 0xf8, 0x00, 0x07,
+    0xff, 0xff, 0x60, 0x00, 0x00, 0x00, 0x00, 0x09, 0xff, 0xff, 0x40, 0x1e, 0xff, 0xfa, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xdf, 0xff, 0xc0, 0x5f, 0xff, 0xf2, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x6f, 0xff, 0xf2, 0x9f, 0xff, 0xd0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1f, 0xff, 0xf5, 0xaf,
+    0xff, 0xc0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0f, 0xff, 0xf7, 0xaf, 0xff, 0xb0, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x0e, 0xff, 0xf7, 0x9f, 0xff, 0xd0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x1f, 0xff, 0xf5, 0x6f, 0xff, 0xf2, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5f, 0xff, 0xf3, 0x2f,
+    0xff, 0xfa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xcf, 0xff, 0xd0, 0x0b, 0xff, 0xff, 0x60, 0x00,
+    0x00, 0x00, 0x00, 0x09, 0xff, 0xff, 0x70, 0x02, 0xff, 0xff, 0xf9, 0x20, 0x00, 0x00, 0x03, 0xbf,
+    0xff, 0xfd, 0x00, 0x00, 0x5f, 0xff, 0xff, 0xfb, 0x87, 0x79, 0xcf, 0xff, 0xff, 0xe2, 0x00, 0x00,
+    0x05, 0xef, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfc, 0x20, 0x00, 0x00, 0x00, 0x19, 0xef, 0xff,
+    0xff, 0xff, 0xff, 0xfe, 0x70, 0x00, 0x00, 0x00, 0x00, 0x00, 0x16, 0x9c, 0xef, 0xed, 0xc9, 0x50,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x7b, 0xde, 0xed, 0xb7, 0x20, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x03, 0xbf, 0xff, 0xff, 0xff, 0xff, 0xf9, 0x20, 0x00, 0x00, 0x00, 0x00, 0x6f, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xe3, 0x00, 0x00, 0x00, 0x08, 0xff, 0xff, 0xfe, 0xba, 0xac, 0xff, 0xff,
+    0xff, 0x30, 0x00, 0x00, 0x5f, 0xff, 0xfe, 0x60, 0x00, 0x00, 0x18, 0xff, 0xff, 0xd1, 0x00, 0x01,
+    0xef, 0xff, 0xc1, 0x00, 0x00, 0x00, 0x00, 0x5f, 0xff, 0xf8, 0x00, 0x08, 0xff, 0xfe, 0x20, 0x00,
+    0x00, 0x00, 0x00, 0x07, 0xff, 0xfe, 0x10, 0x0d, 0xff, 0xf7, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xdf, 0xff, 0x50, 0x2f, 0xff, 0xf2, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8f, 0xff, 0x90, 0x5f,
+    0xff, 0xe0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5f, 0xff, 0xb0, 0x6f, 0xff, 0xd0, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x4f, 0xff, 0xc0, 0x6f, 0xff, 0xd0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x5f, 0xff, 0xd0, 0x5f, 0xff, 0xf1, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7f, 0xff, 0xc0, 0x3f,
+    0xff, 0xf4, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xcf, 0xff, 0xa0, 0x0d, 0xff, 0xfb, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x05, 0xff, 0xff, 0x70, 0x08, 0xff, 0xff, 0x60, 0x00, 0x00, 0x00, 0x00, 0x2e,
+    0xff, 0xff, 0x20, 0x01, 0xef, 0xff, 0xf7, 0x00, 0x00, 0x00, 0x05, 0xef, 0xff, 0xfc, 0x00, 0x00,
+    0x5f, 0xff, 0xff, 0xd9, 0x65, 0x68, 0xdf, 0xff, 0xff, 0xf5, 0x00, 0x00, 0x07, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xd0, 0x00, 0x00, 0x00, 0x4d, 0xff, 0xff, 0xff, 0xff, 0xf9, 0xdf,
+    0xff, 0x50, 0x00, 0x00, 0x00, 0x00, 0x59, 0xde, 0xfd, 0xb7, 0x28, 0xff, 0xfa, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5f, 0xff, 0xe2, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x02, 0xef, 0xff, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0xff, 0xfa,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x9f, 0xff, 0xe1, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x05, 0xff, 0xff, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x3e, 0xff, 0xfa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xdf, 0xff, 0xd1, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0a, 0xff, 0xff, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x7f, 0xff, 0xf9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0xff,
+    0xff, 0xd1, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1d, 0xff, 0xff, 0x30, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xbf, 0xff, 0xf8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x08, 0xff, 0xff, 0xc0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4f, 0xff, 0xfb,
+    0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0xef, 0xa1, 0x00, 0x8f,
+    0xff, 0xf9, 0x00, 0xdf, 0xff, 0xfe, 0x00, 0xcf, 0xff, 0xfe, 0x00, 0x7f, 0xff, 0xf9, 0x00, 0x08,
+    0xee, 0x91, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x09, 0xef, 0xa1, 0x00, 0x8f, 0xff, 0xf9, 0x00, 0xdf, 0xff, 0xfe, 0x00, 0xcf,
+    0xff, 0xfe, 0x00, 0x7f, 0xff, 0xf9, 0x00, 0x08, 0xee, 0x91, 0x00,
+};
+
+static const strip_glyph_t glyphs[] = {
+    {0, 0, 0, 0, 48, 9}, // ' '
+    {0, 7, 35, 5, 13, 16}, // '!'
+    {140, 13, 13, 3, 13, 19}, // '"'
+    {231, 26, 35, 1, 13, 28}, // '#'
+    {686, 24, 46, 2, 8, 28}, // '$'
+    {1238, 35, 35, 1, 13, 38}, // '%'
+    {1868, 33, 35, 1, 13, 34}, // '&'
+    {2463, 5, 13, 3, 13, 11}, // '''
+    {2502, 10, 46, 3, 10, 14}, // '('
+    {2732, 10, 46, 1, 10, 14}, // ')'
+    {2962, 15, 16, 2, 11, 19}, // '*'
+    {3090, 24, 25, 2, 19, 28}, // '+'
+    {3390, 7, 13, 2, 42, 10}, // ','
+    {3442, 13, 4, 2, 31, 17}, // '-'
+    {3470, 7, 7, 2, 41, 10}, // '.'
+    {3498, 20, 38, -1, 12, 18}, // '/'
+    {3878, 26, 35, 1, 13, 28}, // '0'
+    {4333, 22, 35, 4, 13, 28}, // '1'
+    {4718, 24, 35, 2, 13, 28}, // '2'
+    {5138, 24, 35, 2, 13, 28}, // '3'
+    {5558, 27, 35, 0, 13, 28}, // '4'
+    {6048, 23, 35, 2, 13, 28}, // '5'
+    {6468, 24, 35, 2, 13, 28}, // '6'
+    {6888, 25, 35, 2, 13, 28}, // '7'
+    {7343, 24, 35, 2, 13, 28}, // '8'
+    {7763, 23, 35, 3, 13, 28}, // '9'
+    {8183, 7, 25, 3, 23, 12}, // ':'
+};
+
+const strip_font_t font_lato_48_digits = {0x20, 0x3a, 59, 48, glyphs, bitmap};
@@ -0,0 +1,318 @@
+#include <string.h>
+#include <array>
+#include <utility>
+#include "esp_timer.h"
+#include "strip_blitter.h"
+#include "../mem/pipeline_arena.h"
+
+static inline uint16_t swap16(uint16_t p)
+{
+    return (p >> 8) | (p << 8);
+}
+
+// Source pixel readers; byte loads the compiler turns into one 16-bit load, swapped or not
+template <int S>
+struct blit_src;
+
+template <>
+struct blit_src<BLIT_SRC_RGB565_BE> {
+    static const int32_t bytes = 2;
+    static inline uint16_t get(const uint8_t *p)
+    {
+        return p[0] << 8 | p[1];
+    }
+};
+
+template <>
+struct blit_src<BLIT_SRC_RGB565_LE> {
+    static const int32_t bytes = 2;
+    static inline uint16_t get(const uint8_t *p)
+    {
+        return p[0] | p[1] << 8;
+    }
+};
+
+template <>
+struct blit_src<BLIT_SRC_RGB888> {
+    static const int32_t bytes = 3;
+    static inline uint16_t get(const uint8_t *p)
+    {
+        return (p[0] & 0xF8) << 8 | (p[1] & 0xFC) << 3 | p[2] >> 3;
+    }
+};
+
+template <int D>
+static inline uint16_t blit_put(uint16_t c)
+{
+    return D == BLIT_DST_RGB565_BE ? swap16(c) : c;
+}
+
+/*
+ * Output pixel (i, j) reads scaled source pixel (u, v) =
+ *   0: (i, j)    90: (j, -i)    180: (-i, -j)    270: (-j, i)
+ * from the one under (0, 0), so both steps are constants of the instance
+ * except for the row stride, which is fixed for the whole image.
+ */
+template <int S, int D, int R, int K>
+static void blit_rect(const uint8_t *src, uint32_t stride, uint16_t *dst, uint16_t w, uint16_t h)
+{
+    const int32_t px = K * blit_src<S>::bytes;
+    const int32_t row = K * (int32_t)stride;
+    const int32_t col_step = R == BLIT_ROT_0 ? px : (R == BLIT_ROT_90 ? -row : (R == BLIT_ROT_180 ? -px : row));
+    const int32_t row_step = R == BLIT_ROT_0 ? row : (R == BLIT_ROT_90 ? px : (R == BLIT_ROT_180 ? -row : -px));
+
+    for (uint16_t j = 0; j < h; j++, src += row_step, dst += w) {
+        const uint8_t *p = src;
+        for (uint16_t i = 0; i < w; i++, p += col_step) {
+            dst[i] = blit_put<D>(blit_src<S>::get(p));
+        }
+    }
+}
+
+// Table index of one combination, and the combination at an index
+#define BLIT_COMBOS (BLIT_SRC_MAX * BLIT_DST_MAX * BLIT_ROT_MAX * BLIT_SCALE_MAX)
+
+static constexpr size_t blit_index(int src, int dst, int rot, int scale)
+{
+    return ((src * BLIT_DST_MAX + dst) * BLIT_ROT_MAX + rot) * BLIT_SCALE_MAX + scale;
+}
+
+template <size_t I>
+struct blit_combo {
+    static const int src = I / (BLIT_DST_MAX * BLIT_ROT_MAX * BLIT_SCALE_MAX);
+    static const int dst = I / (BLIT_ROT_MAX * BLIT_SCALE_MAX) % BLIT_DST_MAX;
+    static const int rot = I / BLIT_SCALE_MAX % BLIT_ROT_MAX;
+    static const int k = 1 << (I % BLIT_SCALE_MAX);
+};
+
+template <size_t... I>
+static constexpr std::array<strip_blitter::blit_fn_t, sizeof...(I)> blit_table(std::index_sequence<I...>)
+{
+    return {{&blit_rect<blit_combo<I>::src, blit_combo<I>::dst, blit_combo<I>::rot, blit_combo<I>::k>...}};
+}
+
+static constexpr std::array<strip_blitter::blit_fn_t, BLIT_COMBOS> s_blit = blit_table(std::make_index_sequence<BLIT_COMBOS>());
+
+strip_blitter::strip_blitter(uint16_t panel_w, uint16_t panel_h, uint16_t out_lines)
+{
+    _panel_w = panel_w;
+    _panel_h = panel_h;
+    _out_lines = out_lines ? out_lines : 1;
+    _strip[0] = _strip[1] = NULL;
+    _back = 0;
+    _fn = NULL;
+    _generic = false;
+    _cb = NULL;
+    _ctx = NULL;
+    _stopped = true;
+    resetStats();
+}
+
+strip_blitter::~strip_blitter()
+{
+    end();
+}
+
+bool strip_blitter::begin()
+{
+    if (_strip[0] != NULL) {
+        return true;
+    }
+    // One side of an output rectangle is at most out_lines, the other at most the panel
+    size_t pixels = (size_t)(_panel_w > _panel_h ? _panel_w : _panel_h) * _out_lines;
+    _strip[0] = (uint16_t *)pipeline_malloc_align(pixels * sizeof(uint16_t), ARENA_INTERNAL);
+    _strip[1] = (uint16_t *)pipeline_malloc_align(pixels * sizeof(uint16_t), ARENA_INTERNAL);
+    if (_strip[0] == NULL || _strip[1] == NULL) {
+        end();
+        return false;
+    }
+    return true;
+}
+
+void strip_blitter::end()
+{
+    pipeline_free_align(_strip[0]);
+    pipeline_free_align(_strip[1]);
+    _strip[0] = _strip[1] = NULL;
+    _stopped = true;
+}
+
+void strip_blitter::outputSize(uint16_t src_w, uint16_t src_h, blit_rotate_t rot, blit_scale_t scale, uint16_t *w,
+                               uint16_t *h)
+{
+    uint16_t sw = src_w >> scale, sh = src_h >> scale;
+    bool turned = rot == BLIT_ROT_90 || rot == BLIT_ROT_270;
+    *w = turned ? sh : sw;
+    *h = turned ? sw : sh;
+}
+
+bool strip_blitter::start(uint16_t src_w, uint16_t src_h, blit_src_t src, blit_dst_t dst, blit_rotate_t rot,
+                          blit_scale_t scale, int16_t x, int16_t y, strip_cb_t cb, void *ctx)
+{
+    if (_strip[0] == NULL || cb == NULL || src >= BLIT_SRC_MAX || dst >= BLIT_DST_MAX || rot >= BLIT_ROT_MAX ||
+        scale >= BLIT_SCALE_MAX || (src_w >> scale) == 0 || (src_h >> scale) == 0) {
+        return false;
+    }
+    _src_w = src_w;
+    _src_h = src_h;
+    _w = src_w >> scale;
+    _h = src_h >> scale;
+    _x = x;
+    _y = y;
+    _src = src;
+    _dst = dst;
+    _rot = rot;
+    _scale = scale;
+    _fn = s_blit[blit_index(src, dst, rot, scale)];
+    _cb = cb;
+    _ctx = ctx;
+    _stopped = false;
+    _stats.frames++;
+    return true;
+}
+
+// Scaled source pixel shown at panel position (px, py)
+void strip_blitter::mapBack(int32_t px, int32_t py, int32_t *u, int32_t *v)
+{
+    int32_t rx = px - _x, ry = py - _y;
+    switch (_rot) {
+    case BLIT_ROT_0:
+        *u = rx;
+        *v = ry;
+        break;
+    case BLIT_ROT_90:
+        *u = ry;
+        *v = _h - 1 - rx;
+        break;
+    case BLIT_ROT_180:
+        *u = _w - 1 - rx;
+        *v = _h - 1 - ry;
+        break;
+    default:
+        *u = _w - 1 - ry;
+        *v = rx;
+        break;
+    }
+}
+
+bool strip_blitter::push(const void *rows, uint16_t y, uint16_t h)
+{
+    if (_stopped || rows == NULL) {
+        return false;
+    }
+    uint32_t k = 1u << _scale;
+    uint32_t bpp = _src == BLIT_SRC_RGB888 ? 3 : 2;
+    uint32_t stride = (uint32_t)_src_w * bpp;
+    _stats.src_pixels += (uint64_t)_src_w * h;
+
+    // Scaled rows are the source rows on the k grid, up to the last whole one
+    uint32_t v_first = ((uint32_t)y + k - 1) / k;
+    uint32_t v_end = ((uint32_t)y + h + k - 1) / k;
+    v_end = v_end > _h ? _h : v_end;
+    const uint8_t *base = (const uint8_t *)rows + (v_first * k - y) * stride;
+
+    for (uint32_t v0 = v_first; v0 < v_end && !_stopped; v0 += _out_lines) {
+        int32_t n = v_end - v0 < _out_lines ? v_end - v0 : _out_lines;
+        int32_t x0, y0, x1, y1;
+        // Where scaled rows [v0, v0 + n) land, as one rectangle, then clipped to the panel
+        if (_rot == BLIT_ROT_0 || _rot == BLIT_ROT_180) {
+            x0 = 0;
+            x1 = _w;
+            y0 = _rot == BLIT_ROT_0 ? v0 : _h - v0 - n;
+            y1 = y0 + n;
+        } else {
+            x0 = _rot == BLIT_ROT_270 ? v0 : _h - v0 - n;
+            x1 = x0 + n;
+            y0 = 0;
+            y1 = _w;
+        }
+        x0 = x0 + _x < 0 ? 0 : x0 + _x;
+        y0 = y0 + _y < 0 ? 0 : y0 + _y;
+        x1 = x1 + _x > _panel_w ? _panel_w : x1 + _x;
+        y1 = y1 + _y > _panel_h ? _panel_h : y1 + _y;
+        if (x0 >= x1 || y0 >= y1) {
+            continue;
+        }
+
+        int32_t u, v;
+        mapBack(x0, y0, &u, &v);
+        const uint8_t *src = base + (v - v_first) * k * stride + u * k * bpp;
+        uint16_t w = x1 - x0, rh = y1 - y0;
+        uint16_t *out = _strip[_back];
+        int64_t t = esp_timer_get_time();
+        if (_generic) {
+            generic(src, stride, out, w, rh);
+        } else {
+            _fn(src, stride, out, w, rh);
+        }
+        _stats.blit_us += esp_timer_get_time() - t;
+        _stats.out_pixels += (uint32_t)w * rh;
+        _stats.strips++;
+
+        int ok = _cb(_ctx, x0, y0, w, rh, out);
+        _back ^= 1;
+        if (!ok) {
+            _stopped = true;
+        }
+    }
+    return !_stopped;
+}
+
+// The same rectangle with every choice made per pixel
+void strip_blitter::generic(const uint8_t *src, uint32_t stride, uint16_t *dst, uint16_t w, uint16_t h)
+{
+    for (int32_t j = 0; j < h; j++) {
+        for (int32_t i = 0; i < w; i++) {
+            int32_t du, dv;
+            switch (_rot) {
+            case BLIT_ROT_0:
+                du = i;
+                dv = j;
+                break;
+            case BLIT_ROT_90:
+                du = j;
+                dv = -i;
+                break;
+            case BLIT_ROT_180:
+                du = -i;
+                dv = -j;
+                break;
+            default:
+                du = -j;
+                dv = i;
+                break;
+            }
+            int32_t k = 1 << _scale;
+            int32_t bpp = _src == BLIT_SRC_RGB888 ? 3 : 2;
+            const uint8_t *p = src + dv * k * (int32_t)stride + du * k * bpp;
+            uint16_t c;
+            switch (_src) {
+            case BLIT_SRC_RGB565_BE:
+                c = p[0] << 8 | p[1];
+                break;
+            case BLIT_SRC_RGB565_LE:
+                c = p[0] | p[1] << 8;
+                break;
+            default:
+                c = (p[0] & 0xF8) << 8 | (p[1] & 0xFC) << 3 | p[2] >> 3;
+                break;
+            }
+            dst[j * w + i] = _dst == BLIT_DST_RGB565_BE ? swap16(c) : c;
+        }
+    }
+}
+
+void strip_blitter::setGeneric(bool on)
+{
+    _generic = on;
+}
+
+strip_blit_stats_t strip_blitter::stats()
+{
+    return _stats;
+}
+
+void strip_blitter::resetStats()
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
@@ -0,0 +1,111 @@
+#ifndef _STRIP_BLITTER_H
+#define _STRIP_BLITTER_H
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum {
+    BLIT_SRC_RGB565_BE = 0, // JPEG_RAW_TYPE_RGB565_BE, what the decoder hands the panel
+    BLIT_SRC_RGB565_LE,
+    BLIT_SRC_RGB888,        // R, G, B bytes
+    BLIT_SRC_MAX,
+} blit_src_t;
+
+typedef enum {
+    BLIT_DST_RGB565_BE = 0, // panel byte order
+    BLIT_DST_RGB565_LE,
+    BLIT_DST_MAX,
+} blit_dst_t;
+
+typedef enum {
+    BLIT_ROT_0 = 0,
+    BLIT_ROT_90,  // clockwise
+    BLIT_ROT_180,
+    BLIT_ROT_270,
+    BLIT_ROT_MAX,
+} blit_rotate_t;
+
+typedef enum {
+    BLIT_SCALE_1 = 0,
+    BLIT_SCALE_2, // every second pixel of every second row
+    BLIT_SCALE_4,
+    BLIT_SCALE_MAX,
+} blit_scale_t;
+
+typedef struct {
+    uint32_t frames;
+    uint32_t strips;     // strips handed to the callback
+    uint64_t src_pixels; // pixels of the pushed rows
+    uint64_t out_pixels; // pixels written, after clipping
+    uint64_t blit_us;
+} strip_blit_stats_t;
+
+/*
+ * Format conversion, rotation and integer downscale between the decoder and
+ * the panel, clipped to the panel.
+ *
+ * Every combination of source format, destination format, rotation and
+ * scale is its own instance of one templated loop, in which the source steps
+ * and the pixel conversion are constants: the inner loop is a load, a
+ * conversion and a store with no branch. start() picks the instance once per
+ * image from a constexpr table. Strips are pushed top to bottom as the block
+ * decoder produces them; each one is clipped as a rectangle before the loop
+ * runs and leaves through the callback as a rectangle of panel pixels (a
+ * column band when rotated by 90 or 270 degrees).
+ *
+ * Scaling is point sampling, for previews and video; strip_scaler filters.
+ * setGeneric() routes the same work through a loop that decides format,
+ * rotation and scale per pixel, for comparison.
+ */
+class strip_blitter
+{
+public:
+    // (x, y) is the panel position of the first pixel; return 0 to stop the image
+    typedef int (*strip_cb_t)(void *ctx, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t *pixels);
+    // One specialised loop: source pixel of output (0, 0), source row stride in bytes, output rectangle
+    typedef void (*blit_fn_t)(const uint8_t *src, uint32_t stride, uint16_t *dst, uint16_t w, uint16_t h);
+
+    strip_blitter(uint16_t panel_w = 480, uint16_t panel_h = 272, uint16_t out_lines = 16);
+    ~strip_blitter();
+
+    bool begin();
+    void end();
+
+    // Size of the image once rotated and scaled
+    static void outputSize(uint16_t src_w, uint16_t src_h, blit_rotate_t rot, blit_scale_t scale, uint16_t *w, uint16_t *h);
+
+    // Set up one image placed with its top left corner at (x, y), which may be off the panel
+    bool start(uint16_t src_w, uint16_t src_h, blit_src_t src, blit_dst_t dst, blit_rotate_t rot, blit_scale_t scale,
+               int16_t x, int16_t y, strip_cb_t cb, void *ctx);
+    // Source rows [y, y + h), src_w pixels each. False once the callback has asked to stop
+    bool push(const void *rows, uint16_t y, uint16_t h);
+
+    void setGeneric(bool on);
+
+    strip_blit_stats_t stats();
+    void resetStats();
+
+private:
+    void mapBack(int32_t px, int32_t py, int32_t *u, int32_t *v);
+    void generic(const uint8_t *src, uint32_t stride, uint16_t *dst, uint16_t w, uint16_t h);
+
+    uint16_t _panel_w, _panel_h, _out_lines;
+    uint16_t *_strip[2];      // output rectangles, alternated so one can still be on the bus
+    uint8_t _back;
+
+    uint16_t _src_w, _src_h;
+    uint16_t _w, _h;          // scaled, not rotated
+    int16_t _x, _y;
+    blit_src_t _src;
+    blit_dst_t _dst;
+    blit_rotate_t _rot;
+    blit_scale_t _scale;
+    blit_fn_t _fn;
+    bool _generic;
+    strip_cb_t _cb;
+    void *_ctx;
+    bool _stopped;
+
+    strip_blit_stats_t _stats;
+};
+
+#endif
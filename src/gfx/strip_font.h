@@ -0,0 +1,32 @@
+#ifndef _STRIP_FONT_H
+#define _STRIP_FONT_H
+#include <stdint.h>
+
+/*
+ * Anti-aliased bitmap font for strip_renderer, made with tools/font_pack.
+ *
+ * Glyphs cover one contiguous character range. Each glyph bitmap is 4-bit
+ * coverage, high nibble first, every row padded to a whole byte.
+ */
+
+typedef struct {
+    uint32_t offset;   // into bitmap
+    uint8_t w, h;
+    int8_t x_off;      // from the pen position to the left edge
+    int8_t y_off;      // from the top of the line box to the top edge
+    uint8_t advance;
+} strip_glyph_t;
+
+typedef struct {
+    uint8_t first, last;
+    uint8_t height;    // line box height
+    uint8_t baseline;  // from the top of the line box
+    const strip_glyph_t *glyphs;
+    const uint8_t *bitmap;
+} strip_font_t;
+
+// Built-in fonts, see src/gfx/fonts/
+extern const strip_font_t font_lato_20;       // ' ' .. '~'
+extern const strip_font_t font_lato_48_digits; // ' ' .. ':', for clocks and values
+
+#endif
@@ -0,0 +1,450 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "esp_timer.h"
+#include "strip_renderer.h"
+
+static inline uint16_t panel_order(uint16_t color)
+{
+    return (color >> 8) | (color << 8);
+}
+
+// fg over bg with 8-bit alpha, all three channels at once in 32 bits
+static inline uint16_t blend565(uint16_t bg, uint16_t fg, uint8_t alpha)
+{
+    uint32_t a = (alpha + 4) >> 3;
+    uint32_t b = (bg | ((uint32_t)bg << 16)) & 0x07E0F81F;
+    uint32_t f = (fg | ((uint32_t)fg << 16)) & 0x07E0F81F;
+    uint32_t r = ((b * (32 - a) + f * a + 0x02008010) >> 5) & 0x07E0F81F;
+    return (uint16_t)(r | (r >> 16));
+}
+
+static inline void put(uint16_t *px, uint16_t color, uint8_t alpha)
+{
+    if (alpha >= 252) {
+        *px = panel_order(color);
+    } else if (alpha >= 4) {
+        *px = panel_order(blend565(panel_order(*px), color, alpha));
+    }
+}
+
+static inline uint8_t coverage(float c, uint8_t alpha)
+{
+    if (c <= 0.0f) {
+        return 0;
+    }
+    if (c >= 1.0f) {
+        return alpha;
+    }
+    return (uint8_t)(c * alpha + 0.5f);
+}
+
+strip_renderer::strip_renderer(uint16_t lines, uint8_t max_items)
+{
+    _lines = lines;
+    _max = max_items ? max_items : 1;
+    _count = 0;
+    _bands = (lines + STRIP_RENDER_BAND_LINES - 1) / STRIP_RENDER_BAND_LINES;
+    _items = NULL;
+    _band_items = NULL;
+    _band_count = NULL;
+    _active = NULL;
+    _row_spans = NULL;
+    _dirty = true;
+    resetStats();
+}
+
+strip_renderer::~strip_renderer()
+{
+    free(_items);
+    free(_band_items);
+    free(_band_count);
+    free(_active);
+    free(_row_spans);
+}
+
+bool strip_renderer::begin()
+{
+    _items = (item_t *)calloc(_max, sizeof(item_t));
+    _band_items = (uint8_t *)calloc((size_t)_bands * _max, 1);
+    _band_count = (uint8_t *)calloc(_bands, 1);
+    _active = (uint8_t *)calloc(_max, 1);
+    _row_spans = (span_t *)calloc(_max, sizeof(span_t));
+    return _items != NULL && _band_items != NULL && _band_count != NULL && _active != NULL && _row_spans != NULL;
+}
+
+void strip_renderer::clear()
+{
+    _count = 0;
+    _dirty = true;
+}
+
+int strip_renderer::add(const item_t &item)
+{
+    if (_items == NULL || _count >= _max || item.x1 <= item.x0 || item.y1 <= item.y0) {
+        return -1;
+    }
+    _items[_count] = item;
+    _items[_count].visible = true;
+    _dirty = true;
+    return _count++;
+}
+
+int strip_renderer::fillRect(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t color, uint8_t alpha)
+{
+    item_t it;
+    memset(&it, 0, sizeof(it));
+    it.kind = ITEM_RECT;
+    it.x0 = x;
+    it.y0 = y;
+    it.x1 = x + w;
+    it.y1 = y + h;
+    it.color = color;
+    it.alpha = alpha;
+    return add(it);
+}
+
+int strip_renderer::fillRoundRect(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t r, uint16_t color, uint8_t alpha)
+{
+    if (r > w / 2) {
+        r = w / 2;
+    }
+    if (r > h / 2) {
+        r = h / 2;
+    }
+    if (r == 0) {
+        return fillRect(x, y, w, h, color, alpha);
+    }
+    item_t it;
+    memset(&it, 0, sizeof(it));
+    it.kind = ITEM_ROUND_RECT;
+    it.x0 = x;
+    it.y0 = y;
+    it.x1 = x + w;
+    it.y1 = y + h;
+    it.color = color;
+    it.alpha = alpha;
+    it.round.r = r;
+    return add(it);
+}
+
+int strip_renderer::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color, uint8_t width, uint8_t alpha)
+{
+    item_t it;
+    memset(&it, 0, sizeof(it));
+    it.kind = ITEM_LINE;
+    it.color = color;
+    it.alpha = alpha;
+    // End points sit on pixel centres, so a 1-pixel horizontal line fills exactly one row
+    it.line.ax = x0 + 0.5f;
+    it.line.ay = y0 + 0.5f;
+    it.line.bx = x1 + 0.5f;
+    it.line.by = y1 + 0.5f;
+    it.line.half = (width ? width : 1) * 0.5f;
+    int16_t pad = (int16_t)ceilf(it.line.half + 0.5f);
+    it.x0 = (x0 < x1 ? x0 : x1) - pad + 1;
+    it.x1 = (x0 > x1 ? x0 : x1) + pad;
+    it.y0 = (y0 < y1 ? y0 : y1) - pad + 1;
+    it.y1 = (y0 > y1 ? y0 : y1) + pad;
+    return add(it);
+}
+
+int strip_renderer::drawText(int16_t x, int16_t y, const char *text, const strip_font_t *font, uint16_t color, uint8_t alpha)
+{
+    if (text == NULL || font == NULL) {
+        return -1;
+    }
+    item_t it;
+    memset(&it, 0, sizeof(it));
+    it.kind = ITEM_TEXT;
+    it.color = color;
+    it.alpha = alpha;
+    it.text.font = font;
+    it.text.pen = x;
+    it.text.top = y;
+    strncpy(it.text.str, text, STRIP_RENDER_TEXT_MAX - 1);
+    textBox(&it);
+    return add(it);
+}
+
+bool strip_renderer::setText(int id, const char *text)
+{
+    if (id < 0 || id >= _count || _items[id].kind != ITEM_TEXT || text == NULL) {
+        return false;
+    }
+    item_t *it = &_items[id];
+    if (strncmp(it->text.str, text, STRIP_RENDER_TEXT_MAX - 1) == 0) {
+        return true;
+    }
+    memset(it->text.str, 0, sizeof(it->text.str));
+    strncpy(it->text.str, text, STRIP_RENDER_TEXT_MAX - 1);
+    textBox(it);
+    _dirty = true;
+    return true;
+}
+
+void strip_renderer::setVisible(int id, bool visible)
+{
+    if (id >= 0 && id < _count && _items[id].visible != visible) {
+        _items[id].visible = visible;
+        _dirty = true;
+    }
+}
+
+uint16_t strip_renderer::textWidth(const strip_font_t *font, const char *text)
+{
+    uint16_t w = 0;
+    for (const uint8_t *c = (const uint8_t *)text; *c; c++) {
+        if (*c >= font->first && *c <= font->last) {
+            w += font->glyphs[*c - font->first].advance;
+        }
+    }
+    return w;
+}
+
+// Bounding box of the glyphs; an empty string keeps a one-pixel box so the item survives
+void strip_renderer::textBox(item_t *it)
+{
+    const strip_font_t *font = it->text.font;
+    int16_t pen = it->text.pen;
+    int16_t top = it->text.top;
+    it->x0 = pen;
+    it->x1 = pen + 1;
+    it->y0 = top;
+    it->y1 = top + font->height;
+
+    for (const uint8_t *c = (const uint8_t *)it->text.str; *c; c++) {
+        if (*c < font->first || *c > font->last) {
+            continue;
+        }
+        const strip_glyph_t &g = font->glyphs[*c - font->first];
+        if (g.w > 0) {
+            int16_t gx = pen + g.x_off;
+            int16_t gy = top + g.y_off;
+            it->x0 = gx < it->x0 ? gx : it->x0;
+            it->x1 = gx + g.w > it->x1 ? gx + g.w : it->x1;
+            it->y0 = gy < it->y0 ? gy : it->y0;
+            it->y1 = gy + g.h > it->y1 ? gy + g.h : it->y1;
+        }
+        pen += g.advance;
+    }
+}
+
+void strip_renderer::index()
+{
+    memset(_band_count, 0, _bands);
+    for (int i = 0; i < _count; i++) {
+        const item_t &it = _items[i];
+        if (!it.visible || it.y1 <= 0 || it.y0 >= _lines) {
+            continue;
+        }
+        int b0 = it.y0 < 0 ? 0 : it.y0 / STRIP_RENDER_BAND_LINES;
+        int b1 = (it.y1 > _lines ? _lines : it.y1) - 1;
+        b1 /= STRIP_RENDER_BAND_LINES;
+        for (int b = b0; b <= b1; b++) {
+            _band_items[b * _max + _band_count[b]++] = i;
+        }
+    }
+    _dirty = false;
+}
+
+// The pixels of `row` the item may touch, clipped to [clip0, clip1)
+bool strip_renderer::span(const item_t &it, int16_t row, int16_t clip0, int16_t clip1, span_t *out)
+{
+    int16_t x0 = it.x0 > clip0 ? it.x0 : clip0;
+    int16_t x1 = it.x1 < clip1 ? it.x1 : clip1;
+
+    if (it.kind == ITEM_ROUND_RECT) {
+        // Inside a corner band, skip the pixels that lie wholly outside the arc
+        float r = it.round.r;
+        float dy = 0.0f;
+        if (row < it.y0 + it.round.r) {
+            dy = (it.y0 + r) - (row + 0.5f);
+        } else if (row >= it.y1 - it.round.r) {
+            dy = (row + 0.5f) - (it.y1 - r);
+        }
+        if (dy > 0.0f) {
+            float s = sqrtf((r + 0.5f) * (r + 0.5f) - dy * dy);
+            int16_t inset = (int16_t)floorf(r - 0.5f - s) + 1;
+            if (inset > 0) {
+                x0 = it.x0 + inset > x0 ? it.x0 + inset : x0;
+                x1 = it.x1 - inset < x1 ? it.x1 - inset : x1;
+            }
+        }
+    } else if (it.kind == ITEM_LINE) {
+        // Where the line crosses this row, widened by the pen and a pixel of fringe
+        float dy = it.line.by - it.line.ay;
+        if (fabsf(dy) >= 1.0f) {
+            float dx = it.line.bx - it.line.ax;
+            float t = ((row + 0.5f) - it.line.ay) / dy;
+            t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+            float xc = it.line.ax + t * dx;
+            float hw = (it.line.half + 1.0f) * sqrtf(dx * dx + dy * dy) / fabsf(dy);
+            int16_t lx0 = (int16_t)floorf(xc - hw);
+            int16_t lx1 = (int16_t)ceilf(xc + hw);
+            x0 = lx0 > x0 ? lx0 : x0;
+            x1 = lx1 < x1 ? lx1 : x1;
+        }
+    }
+
+    if (x1 <= x0) {
+        return false;
+    }
+    out->x0 = x0;
+    out->x1 = x1;
+    return true;
+}
+
+void strip_renderer::paint(const item_t &it, uint16_t *line, int16_t line_x, int16_t row, int16_t px0, int16_t px1)
+{
+    uint16_t *dst = line + (px0 - line_x);
+
+    switch (it.kind) {
+    case ITEM_RECT:
+        if (it.alpha >= 252) {
+            uint16_t c = panel_order(it.color);
+            for (int x = px0; x < px1; x++) {
+                *dst++ = c;
+            }
+        } else {
+            for (int x = px0; x < px1; x++) {
+                put(dst++, it.color, it.alpha);
+            }
+        }
+        break;
+
+    case ITEM_ROUND_RECT: {
+        float r = it.round.r;
+        bool top = row < it.y0 + it.round.r;
+        bool bottom = row >= it.y1 - it.round.r;
+        float cy = top ? it.y0 + r : it.y1 - r;
+        for (int x = px0; x < px1; x++, dst++) {
+            bool left = x < it.x0 + it.round.r;
+            bool right = x >= it.x1 - it.round.r;
+            if ((top || bottom) && (left || right)) {
+                float dx = (x + 0.5f) - (left ? it.x0 + r : it.x1 - r);
+                float dy = (row + 0.5f) - cy;
+                put(dst, it.color, coverage(r + 0.5f - sqrtf(dx * dx + dy * dy), it.alpha));
+            } else {
+                put(dst, it.color, it.alpha);
+            }
+        }
+        break;
+    }
+
+    case ITEM_LINE: {
+        float ax = it.line.ax, ay = it.line.ay;
+        float dx = it.line.bx - ax, dy = it.line.by - ay;
+        float len2 = dx * dx + dy * dy;
+        float py = row + 0.5f;
+        for (int x = px0; x < px1; x++, dst++) {
+            float px = x + 0.5f;
+            float t = len2 > 0.0f ? ((px - ax) * dx + (py - ay) * dy) / len2 : 0.0f;
+            t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+            float ex = px - (ax + t * dx);
+            float ey = py - (ay + t * dy);
+            put(dst, it.color, coverage(it.line.half + 0.5f - sqrtf(ex * ex + ey * ey), it.alpha));
+        }
+        break;
+    }
+
+    case ITEM_TEXT: {
+        const strip_font_t *font = it.text.font;
+        int16_t pen = it.text.pen;
+        for (const uint8_t *c = (const uint8_t *)it.text.str; *c; c++) {
+            if (*c < font->first || *c > font->last) {
+                continue;
+            }
+            const strip_glyph_t &g = font->glyphs[*c - font->first];
+            int16_t gx = pen + g.x_off;
+            int16_t gy = row - (it.text.top + g.y_off);
+            pen += g.advance;
+            if (gy < 0 || gy >= g.h || gx >= px1 || gx + g.w <= px0) {
+                continue;
+            }
+            const uint8_t *bits = font->bitmap + g.offset + gy * ((g.w + 1) / 2);
+            int i0 = px0 > gx ? px0 - gx : 0;
+            int i1 = px1 < gx + g.w ? px1 - gx : g.w;
+            for (int i = i0; i < i1; i++) {
+                uint8_t nib = (i & 1) ? (bits[i >> 1] & 0x0F) : (bits[i >> 1] >> 4);
+                if (nib) {
+                    put(line + (gx + i - line_x), it.color, (uint8_t)((nib * 17 * it.alpha + 127) / 255));
+                }
+            }
+        }
+        break;
+    }
+    }
+}
+
+void strip_renderer::render(uint16_t *strip, int16_t x, int16_t y, uint16_t w, uint16_t h)
+{
+    if (_items == NULL || strip == NULL || w == 0 || h == 0) {
+        return;
+    }
+    int64_t start = esp_timer_get_time();
+    if (_dirty) {
+        index();
+    }
+    _stats.strips++;
+
+    // Items of the bands under the strip, once each, in drawing order
+    int y_end = y + h;
+    int n = 0;
+    if (y_end > 0 && y < _lines) {
+        uint32_t seen[8] = {0};
+        int b0 = y < 0 ? 0 : y / STRIP_RENDER_BAND_LINES;
+        int b1 = ((y_end > _lines ? _lines : y_end) - 1) / STRIP_RENDER_BAND_LINES;
+        for (int b = b0; b <= b1; b++) {
+            for (int k = 0; k < _band_count[b]; k++) {
+                uint8_t id = _band_items[b * _max + k];
+                const item_t &it = _items[id];
+                if ((seen[id >> 5] & (1u << (id & 31))) || it.y1 <= y || it.y0 >= y_end || it.x1 <= x || it.x0 >= x + w) {
+                    continue;
+                }
+                seen[id >> 5] |= 1u << (id & 31);
+                int j = n++;
+                while (j > 0 && _active[j - 1] > id) {
+                    _active[j] = _active[j - 1];
+                    j--;
+                }
+                _active[j] = id;
+            }
+        }
+    }
+    _stats.items_skipped += _count - n;
+    _stats.items_drawn += n;
+    if (n == 0) {
+        _stats.render_us += esp_timer_get_time() - start;
+        return;
+    }
+
+    for (int row = 0; row < h; row++) {
+        int16_t py = y + row;
+        int spans = 0;
+        for (int k = 0; k < n; k++) {
+            const item_t &it = _items[_active[k]];
+            if (py >= it.y0 && py < it.y1 && span(it, py, x, x + w, &_row_spans[spans])) {
+                _row_spans[spans++].item = _active[k];
+            }
+        }
+        uint16_t *line = strip + (size_t)row * w;
+        for (int k = 0; k < spans; k++) {
+            const span_t &s = _row_spans[k];
+            paint(_items[s.item], line, x, py, s.x0, s.x1);
+            _stats.pixels += s.x1 - s.x0;
+        }
+        _stats.spans += spans;
+    }
+    _stats.render_us += esp_timer_get_time() - start;
+}
+
+strip_render_stats_t strip_renderer::stats()
+{
+    return _stats;
+}
+
+void strip_renderer::resetStats()
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
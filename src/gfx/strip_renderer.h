@@ -0,0 +1,113 @@
+#ifndef _STRIP_RENDERER_H
+#define _STRIP_RENDERER_H
+#include <stdint.h>
+#include "strip_font.h"
+
+#define STRIP_RENDER_BAND_LINES (16)
+#define STRIP_RENDER_TEXT_MAX (48)
+
+typedef struct {
+    uint32_t strips;
+    uint32_t items_drawn;   // item/strip pairs composed
+    uint32_t items_skipped; // item/strip pairs never looked at, thanks to the band lists
+    uint32_t spans;
+    uint64_t pixels;        // pixels written or blended
+    uint64_t render_us;
+} strip_render_stats_t;
+
+/*
+ * Scanline 2D renderer that composes UI over decoded strips.
+ *
+ * The scene is a list of items (rects, rounded rects, anti-aliased lines and
+ * text) in panel coordinates, drawn in the order they were added. render() is
+ * called from the decoder callback with each strip's output block before it is
+ * flushed: it takes the items of the bands the strip covers, turns each into
+ * per-row spans clipped to the strip, and blends them straight into the block,
+ * so no frame buffer and no second pass over the panel are needed. Items are
+ * indexed by 16-line bands, so an item costs nothing in strips it does not
+ * touch. Pixels are RGB565 in panel byte order, like the decoder output;
+ * colors are given as plain RGB565.
+ */
+class strip_renderer
+{
+public:
+    strip_renderer(uint16_t lines = 272, uint8_t max_items = 32);
+    ~strip_renderer();
+
+    bool begin();
+    void clear();
+
+    // Each returns the item id, or -1 when the scene is full or the item is empty
+    int fillRect(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t color, uint8_t alpha = 255);
+    int fillRoundRect(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t r, uint16_t color, uint8_t alpha = 255);
+    int drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color, uint8_t width = 1, uint8_t alpha = 255);
+    // (x, y) is the top-left corner of the line box; the text is copied
+    int drawText(int16_t x, int16_t y, const char *text, const strip_font_t *font, uint16_t color, uint8_t alpha = 255);
+    // Replace the text of a text item, e.g. a clock; the box grows or shrinks with it
+    bool setText(int id, const char *text);
+    void setVisible(int id, bool visible);
+
+    static uint16_t textWidth(const strip_font_t *font, const char *text);
+
+    // Compose rows [y, y + h) into `strip`, whose first pixel is panel column x and which holds `w` pixels per row
+    void render(uint16_t *strip, int16_t x, int16_t y, uint16_t w, uint16_t h);
+
+    strip_render_stats_t stats();
+    void resetStats();
+
+private:
+    typedef enum {
+        ITEM_RECT,
+        ITEM_ROUND_RECT,
+        ITEM_LINE,
+        ITEM_TEXT,
+    } item_kind_t;
+
+    typedef struct {
+        item_kind_t kind;
+        bool visible;
+        int16_t x0, y0, x1, y1;  // bounding box, end excluded
+        uint16_t color;
+        uint8_t alpha;
+        union {
+            struct {
+                uint16_t r;
+            } round;
+            struct {
+                float ax, ay, bx, by; // segment end points at pixel centres
+                float half;           // half the width
+            } line;
+            struct {
+                const strip_font_t *font;
+                int16_t pen, top;     // pen start and top of the line box
+                char str[STRIP_RENDER_TEXT_MAX];
+            } text;
+        };
+    } item_t;
+
+    typedef struct {
+        uint8_t item;
+        int16_t x0, x1;
+    } span_t;
+
+    int add(const item_t &item);
+    void index();
+    void textBox(item_t *it);
+    bool span(const item_t &it, int16_t row, int16_t clip0, int16_t clip1, span_t *out);
+    void paint(const item_t &it, uint16_t *line, int16_t line_x, int16_t row, int16_t px0, int16_t px1);
+
+    uint16_t _lines;
+    uint8_t _max;
+    uint8_t _count;
+    uint8_t _bands;
+    item_t *_items;
+    uint8_t *_band_items;   // per band: item ids in drawing order
+    uint8_t *_band_count;
+    uint8_t *_active;       // items of the strip being rendered
+    span_t *_row_spans;     // span list of the row being composed
+    bool _dirty;
+
+    strip_render_stats_t _stats;
+};
+
+#endif
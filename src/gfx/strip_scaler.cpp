@@ -0,0 +1,409 @@
+#include <stdlib.h>
+#include <string.h>
+#include "esp_timer.h"
+#include "strip_scaler.h"
+#include "../mem/pipeline_arena.h"
+
+static inline uint16_t swap16(uint16_t p)
+{
+    return (p >> 8) | (p << 8);
+}
+
+// Channels are kept as 8.8 fixed point of the 5/6-bit values until the last step
+static inline uint16_t pack565(uint32_t r, uint32_t g, uint32_t b)
+{
+    r = (r + 128) >> 8;
+    g = (g + 128) >> 8;
+    b = (b + 128) >> 8;
+    r = r > 31 ? 31 : r;
+    g = g > 63 ? 63 : g;
+    b = b > 31 ? 31 : b;
+    return swap16((uint16_t)((r << 11) | (g << 5) | b));
+}
+
+strip_scaler::strip_scaler(uint16_t out_w, uint16_t out_h, uint16_t out_lines)
+{
+    _out_w = out_w;
+    _out_h = out_h;
+    _out_lines = out_lines ? out_lines : 1;
+    _cols = NULL;
+    _ring[0] = _ring[1] = NULL;
+    _acc = NULL;
+    _chan = NULL;
+    _strip[0] = _strip[1] = NULL;
+    _back = 0;
+    _cb = NULL;
+    _ctx = NULL;
+    _stopped = true;
+    _row = 0;
+    _dst_h = 0;
+    resetStats();
+}
+
+strip_scaler::~strip_scaler()
+{
+    end();
+}
+
+bool strip_scaler::begin()
+{
+    if (_cols != NULL) {
+        return true;
+    }
+    _cols = (column_t *)calloc(_out_w, sizeof(column_t));
+    _ring[0] = (uint16_t *)calloc((size_t)_out_w * 3, sizeof(uint16_t));
+    _ring[1] = (uint16_t *)calloc((size_t)_out_w * 3, sizeof(uint16_t));
+    _chan = (uint16_t *)calloc((size_t)_out_w * 3, sizeof(uint16_t));
+    _acc = (uint32_t *)calloc((size_t)_out_w * 3, sizeof(uint32_t));
+    _strip[0] = (uint16_t *)pipeline_malloc_align((size_t)_out_w * _out_lines * sizeof(uint16_t), ARENA_INTERNAL);
+    _strip[1] = (uint16_t *)pipeline_malloc_align((size_t)_out_w * _out_lines * sizeof(uint16_t), ARENA_INTERNAL);
+    if (_cols == NULL || _ring[0] == NULL || _ring[1] == NULL || _chan == NULL || _acc == NULL ||
+            _strip[0] == NULL || _strip[1] == NULL) {
+        end();
+        return false;
+    }
+    return true;
+}
+
+void strip_scaler::end()
+{
+    free(_cols);
+    free(_ring[0]);
+    free(_ring[1]);
+    free(_chan);
+    free(_acc);
+    pipeline_free_align(_strip[0]);
+    pipeline_free_align(_strip[1]);
+    _cols = NULL;
+    _ring[0] = _ring[1] = NULL;
+    _chan = NULL;
+    _acc = NULL;
+    _strip[0] = _strip[1] = NULL;
+    _stopped = true;
+}
+
+bool strip_scaler::start(uint16_t src_w, uint16_t src_h, scale_mode_t mode, scale_filter_t filter, strip_cb_t cb, void *ctx)
+{
+    if (_cols == NULL || cb == NULL || src_w == 0 || src_h == 0 || src_w > STRIP_SCALE_MAX_SRC || src_h > STRIP_SCALE_MAX_SRC) {
+        return false;
+    }
+    _src_w = src_w;
+    _src_h = src_h;
+    _crop_x = _crop_y = 0;
+    _crop_w = src_w;
+    _crop_h = src_h;
+
+    // Wider than the panel: width decides for fit, height for cover
+    bool wide = (uint32_t)src_w * _out_h >= (uint32_t)src_h * _out_w;
+    uint32_t dst_w = _out_w, dst_h = _out_h;
+    if (mode == SCALE_FIT) {
+        if (wide) {
+            dst_h = ((uint32_t)src_h * _out_w + src_w / 2) / src_w;
+        } else {
+            dst_w = ((uint32_t)src_w * _out_h + src_h / 2) / src_h;
+        }
+    } else if (wide) {
+        uint32_t w = ((uint32_t)src_h * _out_w + _out_h / 2) / _out_h;
+        _crop_w = w < 1 ? 1 : (w > src_w ? src_w : w);
+        _crop_x = (src_w - _crop_w) / 2;
+    } else {
+        uint32_t h = ((uint32_t)src_w * _out_h + _out_w / 2) / _out_w;
+        _crop_h = h < 1 ? 1 : (h > src_h ? src_h : h);
+        _crop_y = (src_h - _crop_h) / 2;
+    }
+    _dst_w = dst_w < 1 ? 1 : (dst_w > _out_w ? _out_w : dst_w);
+    _dst_h = dst_h < 1 ? 1 : (dst_h > _out_h ? _out_h : dst_h);
+    _dst_x = (_out_w - _dst_w) / 2;
+    _dst_y = (_out_h - _dst_h) / 2;
+
+    if (filter == SCALE_NEAREST) {
+        _xk = _yk = AXIS_NEAREST;
+    } else {
+        _xk = (filter == SCALE_AREA && _crop_w > _dst_w) ? AXIS_BOX : AXIS_LINEAR;
+        _yk = (filter == SCALE_AREA && _crop_h > _dst_h) ? AXIS_BOX : AXIS_LINEAR;
+    }
+    _fast_k = 0;
+    if (_xk == AXIS_BOX && _crop_w % _dst_w == 0 && _crop_w / _dst_w <= 32) {
+        _fast_k = _crop_w / _dst_w;
+    }
+    columns();
+
+    _cb = cb;
+    _ctx = ctx;
+    _stopped = false;
+    _row = 0;
+    _strip_rows = 0;
+    _ring_row[0] = _ring_row[1] = -1;
+    _box_start = 0;
+    memset(_acc, 0, (size_t)_dst_w * 3 * sizeof(uint32_t));
+    rowSetup();
+    _stats.frames++;
+    return true;
+}
+
+void strip_scaler::area(uint16_t *x, uint16_t *y, uint16_t *w, uint16_t *h)
+{
+    *x = _dst_x;
+    *y = _dst_y;
+    *w = _dst_w;
+    *h = _dst_h;
+}
+
+bool strip_scaler::done()
+{
+    return _row >= _dst_h;
+}
+
+// Source footprint of every output column, positions in 1/256 source pixels
+void strip_scaler::columns()
+{
+    for (uint32_t i = 0; i < _dst_w; i++) {
+        column_t &c = _cols[i];
+        memset(&c, 0, sizeof(c));
+        if (_xk == AXIS_NEAREST) {
+            c.x = _crop_x + (uint16_t)(((2 * i + 1) * _crop_w) / (2 * _dst_w));
+        } else if (_xk == AXIS_LINEAR) {
+            int32_t pos = (int32_t)(((2 * i + 1) * _crop_w * 256) / (2 * _dst_w)) - 128;
+            pos = pos < 0 ? 0 : pos;
+            uint32_t x0 = pos >> 8;
+            c.w1 = pos & 255;
+            if (x0 >= (uint32_t)_crop_w - 1) {
+                x0 = _crop_w - 1;
+                c.w1 = 0;
+            }
+            c.x = _crop_x + x0;
+        } else {
+            uint32_t b0 = i * _crop_w * 256 / _dst_w;
+            uint32_t b1 = (i + 1) * _crop_w * 256 / _dst_w;
+            uint32_t last = (b1 - 1) >> 8;
+            c.x = _crop_x + (b0 >> 8);
+            c.n = last - (b0 >> 8) + 1;
+            c.w0 = c.n == 1 ? b1 - b0 : 256 - (b0 & 255);
+            c.w1 = ((b1 - 1) & 255) + 1;
+            c.recip = (1u << 24) / (b1 - b0);
+        }
+    }
+}
+
+// What the next output row needs from the source
+void strip_scaler::rowSetup()
+{
+    uint32_t j = _row;
+    if (_yk == AXIS_NEAREST) {
+        _need0 = ((2 * j + 1) * _crop_h) / (2 * _dst_h);
+    } else if (_yk == AXIS_LINEAR) {
+        int32_t pos = (int32_t)(((2 * j + 1) * _crop_h * 256) / (2 * _dst_h)) - 128;
+        pos = pos < 0 ? 0 : pos;
+        _need0 = pos >> 8;
+        _frac = pos & 255;
+        if (_need0 >= _crop_h - 1) {
+            _need0 = _crop_h - 1;
+            _frac = 0;
+        }
+    } else {
+        _box_end = (j + 1) * _crop_h * 256 / _dst_h;
+    }
+}
+
+bool strip_scaler::push(const uint16_t *rows, uint16_t y, uint16_t h)
+{
+    if (_stopped || rows == NULL) {
+        return false;
+    }
+    int64_t start = esp_timer_get_time();
+    for (uint16_t r = 0; r < h && !_stopped && _row < _dst_h; r++) {
+        uint32_t sy = (uint32_t)y + r;
+        const uint16_t *src = rows + (size_t)r * _src_w;
+        _stats.src_rows++;
+        _stats.src_pixels += _src_w;
+        if (sy < _crop_y || sy >= (uint32_t)_crop_y + _crop_h) {
+            continue;
+        }
+        uint16_t cy = sy - _crop_y;
+        if (_yk == AXIS_NEAREST) {
+            nearestRow(cy, src);
+        } else if (_yk == AXIS_LINEAR) {
+            linearRows(cy, src);
+        } else {
+            boxRow(cy, src);
+        }
+    }
+    _stats.scale_us += esp_timer_get_time() - start;
+    return !_stopped;
+}
+
+// Reduce one source row to the output width, as 8.8 channels
+void strip_scaler::hpass(const uint16_t *src, uint16_t *out)
+{
+    _stats.hpass_rows++;
+    if (_xk == AXIS_LINEAR) {
+        for (uint16_t i = 0; i < _dst_w; i++, out += 3) {
+            const column_t &c = _cols[i];
+            uint16_t p0 = swap16(src[c.x]);
+            uint32_t r = p0 >> 11, g = (p0 >> 5) & 63, b = p0 & 31;
+            if (c.w1 == 0) {
+                out[0] = r << 8;
+                out[1] = g << 8;
+                out[2] = b << 8;
+            } else {
+                uint16_t p1 = swap16(src[c.x + 1]);
+                uint32_t w0 = 256 - c.w1;
+                out[0] = r * w0 + (p1 >> 11) * c.w1;
+                out[1] = g * w0 + ((p1 >> 5) & 63) * c.w1;
+                out[2] = b * w0 + (p1 & 31) * c.w1;
+            }
+        }
+        return;
+    }
+    if (_fast_k != 0) {
+        hpassFast(src, out);
+        return;
+    }
+    for (uint16_t i = 0; i < _dst_w; i++, out += 3) {
+        const column_t &c = _cols[i];
+        const uint16_t *p = src + c.x;
+        uint32_t r = 0, g = 0, b = 0;
+        for (uint16_t k = 0; k < c.n; k++) {
+            uint32_t w = k == 0 ? c.w0 : (k == c.n - 1 ? c.w1 : 256);
+            uint16_t px = swap16(p[k]);
+            r += (px >> 11) * w;
+            g += ((px >> 5) & 63) * w;
+            b += (px & 31) * w;
+        }
+        out[0] = (r * c.recip + 0x8000) >> 16;
+        out[1] = (g * c.recip + 0x8000) >> 16;
+        out[2] = (b * c.recip + 0x8000) >> 16;
+    }
+}
+
+// Exact k:1 shrink: spread each pixel as 0x07E0F81F so one add sums all three
+// channels; the gaps above red and green hold up to 32 pixels without carrying
+void strip_scaler::hpassFast(const uint16_t *src, uint16_t *out)
+{
+    uint16_t k = _fast_k;
+    uint32_t recip = _cols[0].recip;
+    const uint16_t *p = src + _crop_x;
+    for (uint16_t i = 0; i < _dst_w; i++, out += 3) {
+        uint32_t acc = 0;
+        for (uint16_t j = 0; j < k; j++) {
+            uint32_t px = swap16(*p++);
+            acc += (px | (px << 16)) & 0x07E0F81F;
+        }
+        out[0] = ((((acc >> 11) & 0x3FF) << 8) * recip + 0x8000) >> 16;
+        out[1] = (((acc >> 21) << 8) * recip + 0x8000) >> 16;
+        out[2] = (((acc & 0x7FF) << 8) * recip + 0x8000) >> 16;
+    }
+    _stats.fast_rows++;
+}
+
+void strip_scaler::toPixels(const uint16_t *chan, uint16_t *out)
+{
+    for (uint16_t i = 0; i < _dst_w; i++, chan += 3) {
+        out[i] = pack565(chan[0], chan[1], chan[2]);
+    }
+}
+
+bool strip_scaler::emitRow()
+{
+    _row++;
+    _strip_rows++;
+    _stats.out_rows++;
+    if (_strip_rows == _out_lines || _row == _dst_h) {
+        int ok = _cb(_ctx, _dst_x, _dst_y + _row - _strip_rows, _dst_w, _strip_rows, _strip[_back]);
+        _back ^= 1;
+        _strip_rows = 0;
+        if (!ok) {
+            _stopped = true;
+        }
+    }
+    if (_row < _dst_h) {
+        rowSetup();
+    }
+    return !_stopped;
+}
+
+void strip_scaler::nearestRow(uint16_t cy, const uint16_t *src)
+{
+    bool used = false;
+    while (_row < _dst_h && _need0 <= cy) {
+        uint16_t *out = _strip[_back] + (size_t)_strip_rows * _dst_w;
+        for (uint16_t i = 0; i < _dst_w; i++) {
+            out[i] = src[_cols[i].x];
+        }
+        used = true;
+        if (!emitRow()) {
+            break;
+        }
+    }
+    _stats.hpass_rows += used ? 1 : 0;
+}
+
+// Two-row ring: a source row is filtered once and kept while output rows still need it
+void strip_scaler::linearRows(uint16_t cy, const uint16_t *src)
+{
+    if (cy < _need0) {
+        return;
+    }
+    hpass(src, _ring[cy & 1]);
+    _ring_row[cy & 1] = cy;
+
+    while (_row < _dst_h && _need0 + (_frac ? 1 : 0) <= cy) {
+        const uint16_t *a = _ring[_need0 & 1];
+        uint16_t *out = _strip[_back] + (size_t)_strip_rows * _dst_w;
+        if (_frac == 0 || _ring_row[(_need0 + 1) & 1] != _need0 + 1) {
+            toPixels(a, out);
+        } else {
+            const uint16_t *b = _ring[(_need0 + 1) & 1];
+            uint32_t f1 = _frac, f0 = 256 - _frac;
+            for (uint16_t i = 0; i < _dst_w; i++, a += 3, b += 3) {
+                out[i] = pack565((a[0] * f0 + b[0] * f1) >> 8, (a[1] * f0 + b[1] * f1) >> 8, (a[2] * f0 + b[2] * f1) >> 8);
+            }
+        }
+        if (!emitRow()) {
+            break;
+        }
+    }
+}
+
+// Running sum over the rows an output row covers; a source row on a boundary is split
+void strip_scaler::boxRow(uint16_t cy, const uint16_t *src)
+{
+    hpass(src, _chan);
+    uint32_t lo = (uint32_t)cy * 256;
+    uint32_t hi = lo + 256;
+    uint32_t n = (uint32_t)_dst_w * 3;
+
+    while (lo < hi && _row < _dst_h) {
+        uint32_t end = hi < _box_end ? hi : _box_end;
+        uint32_t w = end - lo;
+        for (uint32_t k = 0; k < n; k++) {
+            _acc[k] += _chan[k] * w;
+        }
+        if (end < _box_end) {
+            break;
+        }
+        uint32_t recip = (1u << 24) / (_box_end - _box_start);
+        uint16_t *out = _strip[_back] + (size_t)_strip_rows * _dst_w;
+        const uint32_t *acc = _acc;
+        for (uint16_t i = 0; i < _dst_w; i++, acc += 3) {
+            out[i] = pack565(((acc[0] >> 8) * recip + 0x8000) >> 16, ((acc[1] >> 8) * recip + 0x8000) >> 16,
+                             ((acc[2] >> 8) * recip + 0x8000) >> 16);
+        }
+        memset(_acc, 0, n * sizeof(uint32_t));
+        lo = _box_end;
+        _box_start = _box_end;
+        if (!emitRow()) {
+            break;
+        }
+    }
+}
+
+strip_scale_stats_t strip_scaler::stats()
+{
+    return _stats;
+}
+
+void strip_scaler::resetStats()
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
@@ -0,0 +1,116 @@
+#ifndef _STRIP_SCALER_H
+#define _STRIP_SCALER_H
+#include <stdint.h>
+
+#define STRIP_SCALE_MAX_SRC (8192)
+
+typedef enum {
+    SCALE_FIT = 0, // whole image visible, letterboxed
+    SCALE_COVER,   // panel filled, the longer side cropped around the centre
+} scale_mode_t;
+
+typedef enum {
+    SCALE_NEAREST = 0, // point sampling, for video
+    SCALE_BILINEAR,
+    SCALE_AREA,        // box average over the source footprint; bilinear on an axis that is enlarged
+} scale_filter_t;
+
+typedef struct {
+    uint32_t frames;
+    uint32_t src_rows;      // source rows pushed
+    uint32_t hpass_rows;    // of those, rows the horizontal pass had to touch
+    uint32_t fast_rows;     // rows done by the packed integer-ratio path
+    uint32_t out_rows;
+    uint64_t src_pixels;    // pixels of the pushed rows
+    uint64_t scale_us;
+} strip_scale_stats_t;
+
+/*
+ * Streaming resampler between the decoder and the panel.
+ *
+ * Decoded strips of any size are pushed top to bottom as they come out of the
+ * block decoder and leave as panel-sized output strips through a callback, so
+ * the source image is never held in memory. The filter is separable: each
+ * needed source row is first reduced to the output width, then rows are
+ * combined vertically from a two-row ring (bilinear) or a running sum (area).
+ * An exact integer shrink of up to 32x takes a packed path that adds all three
+ * channels of a pixel in one 32-bit add. Pixels are RGB565 in panel byte order
+ * on both sides.
+ */
+class strip_scaler
+{
+public:
+    // (x, y) is the panel position of the first pixel; return 0 to stop the image
+    typedef int (*strip_cb_t)(void *ctx, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t *pixels);
+
+    strip_scaler(uint16_t out_w = 480, uint16_t out_h = 272, uint16_t out_lines = 16);
+    ~strip_scaler();
+
+    bool begin();
+    void end();
+
+    // Set up one image; false when the size is out of range
+    bool start(uint16_t src_w, uint16_t src_h, scale_mode_t mode, scale_filter_t filter, strip_cb_t cb, void *ctx);
+    // Where the image lands on the panel; anything outside is letterbox for the caller to fill
+    void area(uint16_t *x, uint16_t *y, uint16_t *w, uint16_t *h);
+    // Source rows [y, y + h), src_w pixels each. False once the callback has asked to stop
+    bool push(const uint16_t *rows, uint16_t y, uint16_t h);
+    // True once every output row of the image has gone to the callback
+    bool done();
+
+    strip_scale_stats_t stats();
+    void resetStats();
+
+private:
+    typedef enum {
+        AXIS_NEAREST,
+        AXIS_LINEAR,
+        AXIS_BOX,
+    } axis_kind_t;
+
+    typedef struct {
+        uint16_t x;        // first source pixel
+        uint16_t n;        // box: pixels covered
+        uint16_t w0, w1;   // linear: w1 is the weight of x + 1; box: weights of the first and last pixel
+        uint32_t recip;    // box: 2^24 / total weight
+    } column_t;
+
+    void columns();
+    void rowSetup();
+    void hpass(const uint16_t *src, uint16_t *out);
+    void hpassFast(const uint16_t *src, uint16_t *out);
+    void toPixels(const uint16_t *chan, uint16_t *out);
+    bool emitRow();
+    void nearestRow(uint16_t cy, const uint16_t *src);
+    void linearRows(uint16_t cy, const uint16_t *src);
+    void boxRow(uint16_t cy, const uint16_t *src);
+
+    uint16_t _out_w, _out_h, _out_lines;
+    column_t *_cols;
+    uint16_t *_ring[2];      // horizontally filtered rows, three 8.8 channels per pixel
+    int32_t _ring_row[2];
+    uint32_t *_acc;          // box: running vertical sum
+    uint16_t *_chan;         // box: scratch row of channels
+    uint16_t *_strip[2];     // output strips, alternated so one can still be on the bus
+    uint8_t _back;
+
+    uint16_t _src_w, _src_h;
+    uint16_t _crop_x, _crop_y, _crop_w, _crop_h;
+    uint16_t _dst_x, _dst_y, _dst_w, _dst_h;
+    axis_kind_t _xk, _yk;
+    uint16_t _fast_k;        // integer shrink factor for the packed path, 0 if none
+    strip_cb_t _cb;
+    void *_ctx;
+    bool _stopped;
+
+    uint16_t _row;           // next output row
+    uint16_t _strip_rows;    // rows in the current output strip
+    int32_t _need0;          // linear: first source row of the next output row
+    uint16_t _frac;          // linear: weight of the second row
+    uint32_t _box_start;     // box: span of the next output row, 1/256 source rows
+    uint32_t _box_end;
+
+    strip_scale_stats_t _stats;
+};
+
+#endif
@@ -150,6 +150,31 @@ static esp_err_t tx_color(nv3041a_panel_t *nv3041a, esp_lcd_panel_io_handle_t io
     return esp_lcd_panel_io_tx_color(io, lcd_cmd, param, param_size);
 }
 
+static esp_err_t set_window(nv3041a_panel_t *nv3041a, int x_start, int y_start, int x_end, int y_end)
+{
+    esp_lcd_panel_io_handle_t io = nv3041a->io;
+
+    x_start += nv3041a->x_gap;
+    x_end += nv3041a->x_gap;
+    y_start += nv3041a->y_gap;
+    y_end += nv3041a->y_gap;
+
+    // define an area of frame memory where MCU can access
+    ESP_RETURN_ON_ERROR(tx_param(nv3041a, io, LCD_CMD_CASET, (uint8_t[]) {
+        (x_start >> 8) & 0xFF,
+        x_start & 0xFF,
+        ((x_end - 1) >> 8) & 0xFF,
+        (x_end - 1) & 0xFF,
+    }, 4), TAG, "send command failed");
+    ESP_RETURN_ON_ERROR(tx_param(nv3041a, io, LCD_CMD_RASET, (uint8_t[]) {
+        (y_start >> 8) & 0xFF,
+        y_start & 0xFF,
+        ((y_end - 1) >> 8) & 0xFF,
+        (y_end - 1) & 0xFF,
+    }, 4), TAG, "send command failed");
+    return ESP_OK;
+}
+
 static esp_err_t panel_nv3041a_del(esp_lcd_panel_t *panel)
 {
     nv3041a_panel_t *nv3041a = __containerof(panel, nv3041a_panel_t, base);
@@ -370,24 +395,7 @@ static esp_err_t panel_nv3041a_draw_bitmap(esp_lcd_panel_t *panel, int x_start,
     assert((x_start < x_end) && (y_start < y_end) && "start position must be smaller than end position");
     esp_lcd_panel_io_handle_t io = nv3041a->io;
 
-    x_start += nv3041a->x_gap;
-    x_end += nv3041a->x_gap;
-    y_start += nv3041a->y_gap;
-    y_end += nv3041a->y_gap;
-
-    // define an area of frame memory where MCU can access
-    ESP_RETURN_ON_ERROR(tx_param(nv3041a, io, LCD_CMD_CASET, (uint8_t[]) {
-        (x_start >> 8) & 0xFF,
-        x_start & 0xFF,
-        ((x_end - 1) >> 8) & 0xFF,
-        (x_end - 1) & 0xFF,
-    }, 4), TAG, "send command failed");
-    ESP_RETURN_ON_ERROR(tx_param(nv3041a, io, LCD_CMD_RASET, (uint8_t[]) {
-        (y_start >> 8) & 0xFF,
-        y_start & 0xFF,
-        ((y_end - 1) >> 8) & 0xFF,
-        (y_end - 1) & 0xFF,
-    }, 4), TAG, "send command failed");
+    ESP_RETURN_ON_ERROR(set_window(nv3041a, x_start, y_start, x_end, y_end), TAG, "send command failed");
     // transfer frame buffer
     size_t len = (x_end - x_start) * (y_end - y_start) * nv3041a->fb_bits_per_pixel / 8;
     tx_color(nv3041a, io, LCD_CMD_RAMWR, color_data, len);
@@ -395,6 +403,20 @@ static esp_err_t panel_nv3041a_draw_bitmap(esp_lcd_panel_t *panel, int x_start,
     return ESP_OK;
 }
 
+esp_err_t esp_lcd_nv3041a_set_window(esp_lcd_panel_handle_t panel, int x_start, int y_start, int x_end, int y_end)
+{
+    ESP_RETURN_ON_FALSE(panel && x_start < x_end && y_start < y_end, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    nv3041a_panel_t *nv3041a = __containerof(panel, nv3041a_panel_t, base);
+    return set_window(nv3041a, x_start, y_start, x_end, y_end);
+}
+
+esp_err_t esp_lcd_nv3041a_tx_color(esp_lcd_panel_handle_t panel, const void *color_data, size_t len, bool first)
+{
+    ESP_RETURN_ON_FALSE(panel && color_data && len, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    nv3041a_panel_t *nv3041a = __containerof(panel, nv3041a_panel_t, base);
+    return tx_color(nv3041a, nv3041a->io, first ? LCD_CMD_RAMWR : LCD_CMD_RAMWRC, color_data, len);
+}
+
 static esp_err_t panel_nv3041a_invert_color(esp_lcd_panel_t *panel, bool invert_color_data)
 {
     nv3041a_panel_t *nv3041a = __containerof(panel, nv3041a_panel_t, base);
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #include "esp_lcd_panel_vendor.h"
 
@@ -54,6 +55,37 @@ typedef struct {
  */
 esp_err_t esp_lcd_new_panel_nv3041a(const esp_lcd_panel_io_handle_t io, const esp_lcd_panel_dev_config_t *panel_dev_config, esp_lcd_panel_handle_t *ret_panel);
 
+/**
+ * @brief Set the frame memory window written by `esp_lcd_nv3041a_tx_color()`
+ *
+ * @param[in] panel LCD panel handle returned by `esp_lcd_new_panel_nv3041a()`
+ * @param[in] x_start Start column, included
+ * @param[in] y_start Start row, included
+ * @param[in] x_end End column, excluded
+ * @param[in] y_end End row, excluded
+ * @return
+ *      - ESP_OK: Success
+ *      - Otherwise: Fail
+ */
+esp_err_t esp_lcd_nv3041a_set_window(esp_lcd_panel_handle_t panel, int x_start, int y_start, int x_end, int y_end);
+
+/**
+ * @brief Queue pixels into the current window
+ *
+ * @note  The first transfer after `esp_lcd_nv3041a_set_window()` starts at the window origin (RAMWR), later ones
+ *        continue where the previous one stopped (RAMWRC), so one window can be filled by repeating a small buffer.
+ *        The transfer is queued: `color_data` must stay unchanged until its color-done callback has run.
+ *
+ * @param[in] panel LCD panel handle returned by `esp_lcd_new_panel_nv3041a()`
+ * @param[in] color_data Pixels in panel byte order
+ * @param[in] len Length in bytes
+ * @param[in] first True for the first transfer into the window
+ * @return
+ *      - ESP_OK: Success
+ *      - Otherwise: Fail
+ */
+esp_err_t esp_lcd_nv3041a_tx_color(esp_lcd_panel_handle_t panel, const void *color_data, size_t len, bool first);
+
 /**
  * @brief LCD panel bus configuration structure
  *
@@ -1,27 +1,33 @@
+#include <string.h>
 #include "sdkconfig.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_err.h"
 #include "esp_log.h"
+#include "esp_heap_caps.h"
 #include "driver/spi_master.h"
 #include "esp_lcd_panel_io.h"
 #include "esp_lcd_panel_vendor.h"
 #include "esp_lcd_panel_ops.h"
 #include "esp_lcd_nv3041a.h"
 #include "nv3041a_lcd.h"
+#include "te_sync.h"
+#include "panel_scheduler.h"
+#include "../trace/pipeline_trace.h"
 #include "Arduino.h"
 
-#define LCD_HOST SPI2_HOST
 #define LCD_BIT_PER_PIXEL (16)
 
 #define LCD_H_RES 480
 #define LCD_V_RES 272
 
 static const char *TAG = "example";
-esp_lcd_panel_handle_t panel_handle = NULL;
+
+static uint8_t s_panels = 0;
 
 nv3041a_lcd::nv3041a_lcd(int8_t qspi_cs, int8_t qspi_clk, int8_t qspi_0,
-                         int8_t qspi_1, int8_t qspi_2, int8_t qspi_3, int8_t lcd_rst)
+                         int8_t qspi_1, int8_t qspi_2, int8_t qspi_3, int8_t lcd_rst,
+                         spi_host_device_t host)
 {
     _qspi_cs = qspi_cs;
     _qspi_clk = qspi_clk;
@@ -30,6 +36,19 @@ nv3041a_lcd::nv3041a_lcd(int8_t qspi_cs, int8_t qspi_clk, int8_t qspi_0,
     _qspi_2 = qspi_2;
     _qspi_3 = qspi_3;
     _lcd_rst = lcd_rst;
+    _host = host;
+    _io = NULL;
+    _panel = NULL;
+    _te = NULL;
+    _sched = NULL;
+    _sched_id = -1;
+    portMUX_INITIALIZE(&_mux);
+    _queued = 0;
+    _sent = 0;
+    _trace_id = s_panels++ & 3;
+    _drained = NULL;
+    _fill_buf = NULL;
+    _fill_valid = false;
 }
 
 void nv3041a_lcd::begin()
@@ -41,10 +60,20 @@ void nv3041a_lcd::begin()
                                                                   _qspi_3,
                                                                   LCD_H_RES * LCD_V_RES * LCD_BIT_PER_PIXEL / 8);
 
-    ESP_ERROR_CHECK(spi_bus_initialize(LCD_HOST, &buscfg, SPI_DMA_CH_AUTO));
+    // 同一 SPI 主机上的第二块屏幕会发现总线已初始化
+    esp_err_t err = spi_bus_initialize(_host, &buscfg, SPI_DMA_CH_AUTO);
+    if (err != ESP_ERR_INVALID_STATE) {
+        ESP_ERROR_CHECK(err);
+    }
+
+    // 填充用的图案缓冲区，只分配一次
+    _drained = xSemaphoreCreateBinary();
+    _fill_buf = (uint16_t *)heap_caps_malloc(LCD_FILL_BUF_PIXELS * sizeof(uint16_t), MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if (_drained == NULL || _fill_buf == NULL) {
+        ESP_LOGE(TAG, "no memory for the fill buffer");
+    }
 
-    esp_lcd_panel_io_handle_t io_handle = NULL;
-    const esp_lcd_panel_io_spi_config_t io_config = NV3041A_PANEL_IO_QSPI_CONFIG(_qspi_cs, NULL, NULL);
+    const esp_lcd_panel_io_spi_config_t io_config = NV3041A_PANEL_IO_QSPI_CONFIG(_qspi_cs, colorDone, this);
 
     nv3041a_vendor_config_t vendor_config = {
         .flags = {
@@ -53,7 +82,7 @@ void nv3041a_lcd::begin()
     };
 
     // 将 LCD 连接到 SPI 总线
-    esp_lcd_new_panel_io_spi((esp_lcd_spi_bus_handle_t)LCD_HOST, &io_config, &io_handle);
+    esp_lcd_new_panel_io_spi((esp_lcd_spi_bus_handle_t)_host, &io_config, &_io);
 
     const esp_lcd_panel_dev_config_t panel_config = {
         .reset_gpio_num = _lcd_rst,
@@ -62,17 +91,17 @@ void nv3041a_lcd::begin()
         .vendor_config = &vendor_config,
     };
 
-    esp_lcd_new_panel_nv3041a(io_handle, &panel_config, &panel_handle);
+    esp_lcd_new_panel_nv3041a(_io, &panel_config, &_panel);
 
-    esp_lcd_panel_reset(panel_handle);
-    esp_lcd_panel_init(panel_handle);
+    esp_lcd_panel_reset(_panel);
+    esp_lcd_panel_init(_panel);
     // 在打开屏幕或背光之前，用户可以将预定义的图案刷新到屏幕上
-    esp_lcd_panel_disp_on_off(panel_handle, true);
+    esp_lcd_panel_disp_on_off(_panel, true);
 }
 
 void nv3041a_lcd::lcd_draw_bitmap(uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end, uint16_t *color_data)
 {
-    esp_lcd_panel_draw_bitmap(panel_handle, x_start, y_start, x_end, y_end, color_data);
+    drawRegion(x_start, y_start, x_end, y_end, color_data);
 }
 
 void nv3041a_lcd::draw16bitbergbbitmap(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t *color_data)
@@ -82,15 +111,307 @@ void nv3041a_lcd::draw16bitbergbbitmap(uint16_t x, uint16_t y, uint16_t w, uint1
     uint16_t x_end = w + x;
     uint16_t y_end = h + y;
 
-    esp_lcd_panel_draw_bitmap(panel_handle, x_start, y_start, x_end, y_end, color_data);
+    if (_te != NULL) {
+        _te->waitStrip(y, h, (uint32_t)w * h * 2);
+    }
+    drawRegion(x_start, y_start, x_end, y_end, color_data);
+}
+
+void nv3041a_lcd::drawRegion(uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end, uint16_t *color_data)
+{
+    if (_sched != NULL) {
+        _sched->acquire(_sched_id, y_start, y_end - y_start, (uint32_t)(x_end - x_start) * (y_end - y_start) * 2);
+    }
+    portENTER_CRITICAL(&_mux);
+    _queued++;
+    _sent++;
+    portEXIT_CRITICAL(&_mux);
+    // The done interrupt can come before draw_bitmap returns
+    PIPELINE_TRACE_ASYNC_BEGIN(TRACE_LCD_DMA, traceSeq(_sent));
+    PIPELINE_TRACE_BEGIN(TRACE_LCD_TX, (uint32_t)(x_end - x_start) * (y_end - y_start) * 2 / 1024);
+    esp_err_t err = esp_lcd_panel_draw_bitmap(_panel, x_start, y_start, x_end, y_end, color_data);
+    PIPELINE_TRACE_END(TRACE_LCD_TX, 0);
+    if (err != ESP_OK) {
+        // Nothing was queued, so no done callback will hand the bus back
+        PIPELINE_TRACE_ASYNC_END(TRACE_LCD_DMA, traceSeq(_sent));
+        portENTER_CRITICAL(&_mux);
+        _queued--;
+        _sent--;
+        portEXIT_CRITICAL(&_mux);
+        if (_sched != NULL) {
+            _sched->onDone(_sched_id);
+        }
+    }
+}
+
+bool nv3041a_lcd::colorDone(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
+{
+    nv3041a_lcd *self = (nv3041a_lcd *)user_ctx;
+    BaseType_t woken = pdFALSE;
+
+    portENTER_CRITICAL_ISR(&self->_mux);
+    if (self->_queued > 0) {
+        // Transfers finish in order: this is the oldest one still queued
+        PIPELINE_TRACE_ASYNC_END(TRACE_LCD_DMA, self->traceSeq(self->_sent - self->_queued + 1));
+        self->_queued--;
+    }
+    portEXIT_CRITICAL_ISR(&self->_mux);
+    if (self->_drained != NULL) {
+        xSemaphoreGiveFromISR(self->_drained, &woken);
+    }
+
+    panel_scheduler *sched = self->_sched;
+    if (sched != NULL) {
+        sched->onDone(self->_sched_id);
+    }
+    return woken == pdTRUE;
+}
+
+static inline uint16_t panel_order(uint16_t color)
+{
+    return (color >> 8) | (color << 8);
+}
+
+// RGB565 blend of c0 and c1 at i / (n - 1), per channel
+static uint16_t lerp565(uint16_t c0, uint16_t c1, uint32_t i, uint32_t n)
+{
+    if (n <= 1) {
+        return c0;
+    }
+    uint32_t d = n - 1;
+    uint32_t r = ((c0 >> 11) * (d - i) + (c1 >> 11) * i + d / 2) / d;
+    uint32_t g = (((c0 >> 5) & 0x3F) * (d - i) + ((c1 >> 5) & 0x3F) * i + d / 2) / d;
+    uint32_t b = ((c0 & 0x1F) * (d - i) + (c1 & 0x1F) * i + d / 2) / d;
+    return (uint16_t)((r << 11) | (g << 5) | b);
 }
 
 void nv3041a_lcd::fillScreen(uint16_t color)
 {
-    uint16_t *color_data = (uint16_t *)heap_caps_malloc(480 * 272 * 2, MALLOC_CAP_INTERNAL);
-    memset(color_data, color, 480 * 272 * 2);
-    draw16bitbergbbitmap(0, 0, 480, 272, color_data);
-    free(color_data);
+    fillRect(0, 0, width(), height(), color);
+}
+
+void nv3041a_lcd::fillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color)
+{
+    fill_t f = {FILL_SOLID, LCD_PATTERN_HSTRIPES, color, color, 1};
+    fill(x, y, w, h, f);
+}
+
+void nv3041a_lcd::drawHLine(uint16_t x, uint16_t y, uint16_t w, uint16_t color)
+{
+    fillRect(x, y, w, 1, color);
+}
+
+void nv3041a_lcd::drawVLine(uint16_t x, uint16_t y, uint16_t h, uint16_t color)
+{
+    fillRect(x, y, 1, h, color);
+}
+
+void nv3041a_lcd::fillPattern(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t c0, uint16_t c1,
+                              lcd_pattern_t pattern, uint16_t cell)
+{
+    fill_t f = {FILL_PATTERN, pattern, c0, c1, (uint16_t)(cell ? cell : 1)};
+    fill(x, y, w, h, f);
+}
+
+void nv3041a_lcd::fillGradient(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t c0, uint16_t c1, bool vertical)
+{
+    fill_t f = {vertical ? FILL_VGRADIENT : FILL_HGRADIENT, LCD_PATTERN_HSTRIPES, c0, c1, 1};
+    fill(x, y, w, h, f);
+}
+
+void nv3041a_lcd::flush(uint32_t pending)
+{
+    waitQueued(pending);
+}
+
+// Rows after which the fill repeats, 0 if it never does
+uint16_t nv3041a_lcd::fillPeriod(const fill_t &f)
+{
+    switch (f.kind) {
+    case FILL_SOLID:
+    case FILL_HGRADIENT:
+        return 1;
+    case FILL_PATTERN:
+        return f.pattern == LCD_PATTERN_VSTRIPES ? 1 : 2 * f.cell;
+    default:
+        return 0;
+    }
+}
+
+// One row of the fill in panel byte order; y is the panel row, row the row within the rectangle
+void nv3041a_lcd::fillRow(const fill_t &f, uint16_t x, uint16_t w, uint16_t y, uint16_t row, uint16_t h, uint16_t *out)
+{
+    uint16_t c0 = panel_order(f.c0);
+    uint16_t c1 = panel_order(f.c1);
+
+    switch (f.kind) {
+    case FILL_SOLID:
+        for (int i = 0; i < w; i++) {
+            out[i] = c0;
+        }
+        break;
+    case FILL_PATTERN:
+        for (int i = 0; i < w; i++) {
+            int band;
+            if (f.pattern == LCD_PATTERN_HSTRIPES) {
+                band = y / f.cell;
+            } else if (f.pattern == LCD_PATTERN_VSTRIPES) {
+                band = (x + i) / f.cell;
+            } else {
+                band = y / f.cell + (x + i) / f.cell;
+            }
+            out[i] = (band & 1) ? c1 : c0;
+        }
+        break;
+    case FILL_HGRADIENT:
+        for (int i = 0; i < w; i++) {
+            out[i] = panel_order(lerp565(f.c0, f.c1, i, w));
+        }
+        break;
+    case FILL_VGRADIENT: {
+        uint16_t c = panel_order(lerp565(f.c0, f.c1, row, h));
+        for (int i = 0; i < w; i++) {
+            out[i] = c;
+        }
+        break;
+    }
+    }
+}
+
+void nv3041a_lcd::fill(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const fill_t &f)
+{
+    if (x >= width() || y >= height() || w == 0 || h == 0 || _fill_buf == NULL) {
+        return;
+    }
+    if (w > width() - x) {
+        w = width() - x;
+    }
+    if (h > height() - y) {
+        h = height() - y;
+    }
+    if (_te != NULL) {
+        _te->waitStrip(y, h, (uint32_t)w * h * 2);
+    }
+    if (esp_lcd_nv3041a_set_window(_panel, x, y, x + w, y + h) != ESP_OK) {
+        return;
+    }
+
+    uint32_t total = (uint32_t)w * h;
+    uint16_t period = fillPeriod(f);
+    uint16_t rows = period ? LCD_FILL_BUF_PIXELS / w / period * period : 0;
+
+    if (rows > 0) {
+        // Repeating fill: render whole periods once, then send the same buffer over and over
+        uint16_t phase = y % period;
+        bool cached = _fill_valid && _fill_last.kind == f.kind && _fill_last.pattern == f.pattern && _fill_last.c0 == f.c0 &&
+                      _fill_last.c1 == f.c1 && _fill_last.cell == f.cell && _fill_x == x && _fill_w == w && _fill_phase == phase;
+        if (!cached) {
+            waitQueued(0);
+            for (int r = 0; r < rows; r++) {
+                fillRow(f, x, w, y + r, r, h, _fill_buf + r * w);
+            }
+            _fill_last = f;
+            _fill_x = x;
+            _fill_w = w;
+            _fill_phase = phase;
+            _fill_valid = true;
+        }
+        uint32_t chunk = (uint32_t)rows * w;
+        for (uint32_t sent = 0; sent < total; sent += chunk) {
+            uint32_t n = total - sent < chunk ? total - sent : chunk;
+            queueColor(_fill_buf, n, sent == 0, y, sent + n == total ? h : 0);
+        }
+        return;
+    }
+
+    // Rows differ all the way down: render into the two halves in turn while the other one is on the bus
+    uint16_t half_rows = LCD_FILL_BUF_PIXELS / 2 / w;
+    waitQueued(0);
+    _fill_valid = false;
+    for (uint16_t r = 0, k = 0; r < h; r += half_rows, k ^= 1) {
+        uint16_t n = h - r < half_rows ? h - r : half_rows;
+        uint16_t *half = _fill_buf + k * (LCD_FILL_BUF_PIXELS / 2);
+        // Transfers finish in order: with at most one queued, it is the other half
+        waitQueued(1);
+        for (int i = 0; i < n; i++) {
+            fillRow(f, x, w, y + r + i, r + i, h, half + i * w);
+        }
+        queueColor(half, (uint32_t)n * w, r == 0, y, r + n == h ? h : 0);
+    }
+}
+
+void nv3041a_lcd::queueColor(const uint16_t *px, uint32_t count, bool first, uint16_t y, uint16_t h)
+{
+    if (_sched != NULL) {
+        _sched->acquire(_sched_id, y, h, count * 2);
+    }
+    portENTER_CRITICAL(&_mux);
+    _queued++;
+    _sent++;
+    portEXIT_CRITICAL(&_mux);
+    PIPELINE_TRACE_ASYNC_BEGIN(TRACE_LCD_DMA, traceSeq(_sent));
+    PIPELINE_TRACE_BEGIN(TRACE_LCD_TX, count * 2 / 1024);
+    esp_err_t err = esp_lcd_nv3041a_tx_color(_panel, px, count * 2, first);
+    PIPELINE_TRACE_END(TRACE_LCD_TX, 0);
+    if (err != ESP_OK) {
+        PIPELINE_TRACE_ASYNC_END(TRACE_LCD_DMA, traceSeq(_sent));
+        portENTER_CRITICAL(&_mux);
+        _queued--;
+        _sent--;
+        portEXIT_CRITICAL(&_mux);
+        if (_sched != NULL) {
+            _sched->onDone(_sched_id);
+        }
+    }
+}
+
+// Transfer number n in trace records: the panel in the top two bits
+uint16_t nv3041a_lcd::traceSeq(uint32_t n)
+{
+    return _trace_id << 14 | (n & 0x3FFF);
+}
+
+void nv3041a_lcd::waitQueued(uint32_t max)
+{
+    if (_queued <= max || _drained == NULL) {
+        return;
+    }
+    PIPELINE_TRACE_BEGIN(TRACE_LCD_WAIT, max);
+    while (_queued > max && _drained != NULL) {
+        xSemaphoreTake(_drained, pdMS_TO_TICKS(10));
+    }
+    PIPELINE_TRACE_END(TRACE_LCD_WAIT, max);
+}
+
+void nv3041a_lcd::setTeSync(te_sync *te)
+{
+    _te = te;
+}
+
+bool nv3041a_lcd::setScheduler(panel_scheduler *sched, uint8_t weight)
+{
+    if (sched == NULL) {
+        _sched = NULL;
+        return true;
+    }
+    int id = sched->addPanel(_host, height(), weight);
+    if (id < 0) {
+        ESP_LOGE(TAG, "no room in the panel scheduler");
+        return false;
+    }
+    _sched_id = id;
+    _sched = sched;
+    return true;
+}
+
+int nv3041a_lcd::schedulerId()
+{
+    return _sched_id;
+}
+
+esp_lcd_panel_handle_t nv3041a_lcd::panel()
+{
+    return _panel;
 }
 
 uint16_t nv3041a_lcd::width()
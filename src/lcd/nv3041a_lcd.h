@@ -1,22 +1,97 @@
 #ifndef _NV3041A_LCD_H
 #define _NV3041A_LCD_H
 #include <stdio.h>
+#include "driver/spi_common.h"
+#include "esp_lcd_panel_io.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+// Pattern buffer for fills: two halves of four full-width rows each, DMA-capable internal RAM
+#define LCD_FILL_BUF_PIXELS (2 * 4 * 480)
+
+typedef enum {
+    LCD_PATTERN_HSTRIPES = 0, // horizontal bands `cell` rows high
+    LCD_PATTERN_VSTRIPES,     // vertical bands `cell` columns wide
+    LCD_PATTERN_CHECKER,      // `cell` x `cell` squares
+} lcd_pattern_t;
+
+class te_sync;
+class panel_scheduler;
 
 class nv3041a_lcd
 {
 public:
+    // Panels on the same host share the clock and data lines and differ in qspi_cs
     nv3041a_lcd(int8_t qspi_cs, int8_t qspi_clk, int8_t qspi_0,
-                  int8_t qspi_1, int8_t qspi_2, int8_t qspi_3, int8_t lcd_rst);
+                  int8_t qspi_1, int8_t qspi_2, int8_t qspi_3, int8_t lcd_rst,
+                  spi_host_device_t host = SPI2_HOST);
 
     void begin();
     void lcd_draw_bitmap(uint16_t x_start, uint16_t y_start,
                          uint16_t x_end, uint16_t y_end, uint16_t *color_data);
     void draw16bitbergbbitmap(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t *color_data);
+    // Fills take RGB565 colors and are queued as repeated transfers of one small
+    // pattern buffer over a single address window; no frame-sized allocation
     void fillScreen(uint16_t color);
+    void fillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color);
+    void drawHLine(uint16_t x, uint16_t y, uint16_t w, uint16_t color);
+    void drawVLine(uint16_t x, uint16_t y, uint16_t h, uint16_t color);
+    // Two-color pattern, aligned to the panel origin so neighbouring fills line up
+    void fillPattern(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t c0, uint16_t c1,
+                     lcd_pattern_t pattern, uint16_t cell = 8);
+    // Linear gradient from c0 to c1, top to bottom when vertical, else left to right
+    void fillGradient(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t c0, uint16_t c1, bool vertical = true);
+    // Wait until at most `pending` queued transfers are still on the bus; 0 waits for all
+    void flush(uint32_t pending = 0);
+    // Pace draw16bitbergbbitmap() to the panel TE signal; NULL turns it off
+    void setTeSync(te_sync *te);
+    // Share the bus with other panels through `sched`; call before drawing
+    bool setScheduler(panel_scheduler *sched, uint8_t weight = 1);
+    int schedulerId();
+    esp_lcd_panel_handle_t panel();
     uint16_t width();
     uint16_t height();
 
 private:
+    typedef enum {
+        FILL_SOLID,
+        FILL_PATTERN,
+        FILL_HGRADIENT,
+        FILL_VGRADIENT,
+    } fill_kind_t;
+
+    typedef struct {
+        fill_kind_t kind;
+        lcd_pattern_t pattern;
+        uint16_t c0, c1;
+        uint16_t cell;
+    } fill_t;
+
+    static bool colorDone(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx);
+    void drawRegion(uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end, uint16_t *color_data);
+    void fill(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const fill_t &f);
+    void fillRow(const fill_t &f, uint16_t x, uint16_t w, uint16_t y, uint16_t row, uint16_t h, uint16_t *out);
+    uint16_t fillPeriod(const fill_t &f);
+    void queueColor(const uint16_t *px, uint32_t count, bool first, uint16_t y, uint16_t h);
+    void waitQueued(uint32_t max);
+    uint16_t traceSeq(uint32_t n);
+
     int8_t _qspi_cs, _qspi_clk, _qspi_0, _qspi_1, _qspi_2, _qspi_3, _lcd_rst;
+    spi_host_device_t _host;
+    esp_lcd_panel_io_handle_t _io;
+    esp_lcd_panel_handle_t _panel;
+    te_sync *_te;
+    panel_scheduler *_sched;
+    int _sched_id;
+
+    portMUX_TYPE _mux;
+    volatile uint32_t _queued;   // transfers handed to the panel IO and not yet done
+    uint32_t _sent;              // transfers handed to the panel IO so far; they finish in this order
+    uint8_t _trace_id;           // tells the panels apart in trace records
+    SemaphoreHandle_t _drained;  // given on every transfer done
+    uint16_t *_fill_buf;
+    fill_t _fill_last;           // what the buffer holds for a periodic fill
+    uint16_t _fill_x, _fill_w, _fill_phase;
+    bool _fill_valid;
 };
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,186 @@
+#include <string.h>
+#include "esp_timer.h"
+#include "panel_scheduler.h"
+
+panel_scheduler::panel_scheduler(uint8_t inflight)
+{
+    _max_inflight = inflight ? inflight : 1;
+    _count = 0;
+    memset(_panels, 0, sizeof(_panels));
+    _since_us = esp_timer_get_time();
+    portMUX_INITIALIZE(&_mux);
+}
+
+panel_scheduler::~panel_scheduler()
+{
+    for (int i = 0; i < _count; i++) {
+        vSemaphoreDelete(_panels[i].wake);
+    }
+}
+
+int panel_scheduler::addPanel(int host, uint16_t lines, uint8_t weight)
+{
+    if (_count >= PANEL_SCHED_MAX_PANELS) {
+        return -1;
+    }
+    SemaphoreHandle_t wake = xSemaphoreCreateBinary();
+    if (wake == NULL) {
+        return -1;
+    }
+
+    portENTER_CRITICAL(&_mux);
+    int id = _count;
+    panel_t *p = &_panels[id];
+    memset(p, 0, sizeof(*p));
+    p->host = host;
+    p->lines = lines;
+    p->weight = weight ? weight : 1;
+    p->wake = wake;
+    _count++;
+    portEXIT_CRITICAL(&_mux);
+    return id;
+}
+
+void panel_scheduler::setWeight(int panel, uint8_t weight)
+{
+    if (panel < 0 || panel >= _count) {
+        return;
+    }
+    portENTER_CRITICAL(&_mux);
+    _panels[panel].weight = weight ? weight : 1;
+    portEXIT_CRITICAL(&_mux);
+}
+
+uint8_t panel_scheduler::hostInflight(int host)
+{
+    uint8_t n = 0;
+    for (int i = 0; i < _count; i++) {
+        if (_panels[i].host == host) {
+            n += _panels[i].inflight;
+        }
+    }
+    return n;
+}
+
+void panel_scheduler::grant(panel_t *p, uint32_t bytes)
+{
+    p->inflight++;
+    p->vtime += bytes / p->weight;
+    p->stats.bytes += bytes;
+}
+
+uint32_t panel_scheduler::acquire(int panel, uint16_t y, uint16_t h, uint32_t bytes)
+{
+    if (panel < 0 || panel >= _count) {
+        return 0;
+    }
+    panel_t *p = &_panels[panel];
+    int64_t start = esp_timer_get_time();
+
+    portENTER_CRITICAL(&_mux);
+    // Back from idle: catch up with the panels that kept the bus busy meanwhile
+    if (p->inflight == 0) {
+        for (int i = 0; i < _count; i++) {
+            panel_t *o = &_panels[i];
+            if (o != p && o->host == p->host && (o->inflight || o->waiting) && o->vtime > p->vtime) {
+                p->vtime = o->vtime;
+            }
+        }
+    }
+    bool wait = hostInflight(p->host) >= _max_inflight;
+    if (wait) {
+        p->waiting = true;
+        p->want = bytes;
+    } else {
+        grant(p, bytes);
+    }
+    portEXIT_CRITICAL(&_mux);
+
+    // onDone() grants on our behalf before waking us
+    if (wait) {
+        xSemaphoreTake(p->wake, portMAX_DELAY);
+    }
+
+    uint32_t waited = (uint32_t)(esp_timer_get_time() - start);
+    portENTER_CRITICAL(&_mux);
+    p->stats.strips++;
+    if (y + h >= p->lines) {
+        p->stats.frames++;
+    }
+    if (wait) {
+        p->stats.waited++;
+        p->stats.wait_us += waited;
+        if (waited > p->stats.max_wait_us) {
+            p->stats.max_wait_us = waited;
+        }
+    }
+    portEXIT_CRITICAL(&_mux);
+    return waited;
+}
+
+void panel_scheduler::onDone(int panel)
+{
+    if (panel < 0 || panel >= _count) {
+        return;
+    }
+    panel_t *p = &_panels[panel];
+    panel_t *next = NULL;
+
+    portENTER_CRITICAL_ISR(&_mux);
+    if (p->inflight > 0) {
+        p->inflight--;
+    }
+    if (hostInflight(p->host) < _max_inflight) {
+        for (int i = 0; i < _count; i++) {
+            panel_t *o = &_panels[i];
+            if (o->host == p->host && o->waiting && (next == NULL || o->vtime < next->vtime)) {
+                next = o;
+            }
+        }
+        if (next != NULL) {
+            next->waiting = false;
+            grant(next, next->want);
+        }
+    }
+    portEXIT_CRITICAL_ISR(&_mux);
+
+    if (next != NULL) {
+        BaseType_t woken = pdFALSE;
+        xSemaphoreGiveFromISR(next->wake, &woken);
+        portYIELD_FROM_ISR(woken);
+    }
+}
+
+panel_sched_stats_t panel_scheduler::stats(int panel)
+{
+    panel_sched_stats_t s;
+    memset(&s, 0, sizeof(s));
+    if (panel < 0 || panel >= _count) {
+        return s;
+    }
+
+    uint64_t host_bytes = 0;
+    portENTER_CRITICAL(&_mux);
+    s = _panels[panel].stats;
+    for (int i = 0; i < _count; i++) {
+        if (_panels[i].host == _panels[panel].host) {
+            host_bytes += _panels[i].stats.bytes;
+        }
+    }
+    portEXIT_CRITICAL(&_mux);
+
+    int64_t elapsed = esp_timer_get_time() - _since_us;
+    s.fps_x10 = elapsed > 0 ? (uint32_t)((uint64_t)s.frames * 10000000 / elapsed) : 0;
+    s.share_permille = host_bytes ? (uint32_t)(s.bytes * 1000 / host_bytes) : 0;
+    return s;
+}
+
+void panel_scheduler::resetStats()
+{
+    portENTER_CRITICAL(&_mux);
+    for (int i = 0; i < _count; i++) {
+        memset(&_panels[i].stats, 0, sizeof(_panels[i].stats));
+    }
+    _since_us = esp_timer_get_time();
+    portEXIT_CRITICAL(&_mux);
+}
@@ -0,0 +1,74 @@
+#ifndef _PANEL_SCHEDULER_H
+#define _PANEL_SCHEDULER_H
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#define PANEL_SCHED_MAX_PANELS (4)
+
+typedef struct {
+    uint32_t strips;
+    uint32_t frames;          // strips that reached the bottom line
+    uint64_t bytes;
+    uint32_t fps_x10;         // frames per second since resetStats(), x10
+    uint32_t share_permille;  // this panel's share of the bytes sent on its bus
+    uint32_t waited;          // strips that had to wait for the bus
+    uint64_t wait_us;
+    uint32_t max_wait_us;
+} panel_sched_stats_t;
+
+/*
+ * Strip-level arbitration of panels sharing an SPI host.
+ *
+ * Each panel asks for the bus with acquire() before queueing a strip and gives
+ * it back from its transfer-done callback with onDone(). At most `inflight`
+ * strips per host are queued in the SPI driver at once; when the bus is full,
+ * the next grant goes to the waiting panel that has sent the fewest bytes for
+ * its weight, so a panel streaming full frames cannot starve one that updates
+ * a small area. A panel returning from idle is not given credit for the time it
+ * was idle. Panels on different hosts never wait on each other; the scheduler
+ * then only keeps their statistics.
+ */
+class panel_scheduler
+{
+public:
+    panel_scheduler(uint8_t inflight = 2);
+    ~panel_scheduler();
+
+    // Returns the panel id, or -1 when PANEL_SCHED_MAX_PANELS are registered
+    int addPanel(int host, uint16_t lines, uint8_t weight = 1);
+    void setWeight(int panel, uint8_t weight);
+
+    // Block until rows [y, y + h) holding `bytes` may be queued; returns the time waited
+    uint32_t acquire(int panel, uint16_t y, uint16_t h, uint32_t bytes);
+    // One strip of `panel` has left the bus; ISR-safe
+    void onDone(int panel);
+
+    panel_sched_stats_t stats(int panel);
+    void resetStats();
+
+private:
+    typedef struct {
+        int host;
+        uint16_t lines;
+        uint8_t weight;
+        uint8_t inflight;
+        bool waiting;
+        uint32_t want;
+        uint64_t vtime;        // bytes sent divided by weight
+        SemaphoreHandle_t wake;
+        panel_sched_stats_t stats;
+    } panel_t;
+
+    uint8_t hostInflight(int host);
+    void grant(panel_t *p, uint32_t bytes);
+
+    uint8_t _max_inflight;
+    uint8_t _count;
+    panel_t _panels[PANEL_SCHED_MAX_PANELS];
+    int64_t _since_us;
+
+    portMUX_TYPE _mux;
+};
+
+#endif
@@ -0,0 +1,298 @@
+#include <string.h>
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "te_sync.h"
+
+#define TE_SYNC_DEFAULT_BYTES_PER_MS (16000)
+// Kept clear of the scan line on top of the edge jitter: the time from waitStrip()
+// returning to the first byte on the bus, and rounding in the prediction
+#define TE_SYNC_GUARD_US (30)
+
+// Floor/ceil division that also rounds correctly for negative numerators
+static int64_t floorDiv(int64_t a, int64_t b)
+{
+    return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+static int64_t ceilDiv(int64_t a, int64_t b)
+{
+    return -floorDiv(-a, b);
+}
+
+te_sync::te_sync(uint16_t lines)
+{
+    _lines = lines ? lines : 1;
+    _bytes_per_ms = TE_SYNC_DEFAULT_BYTES_PER_MS;
+    _scan_delay_us = 0;
+    _pin = -1;
+    portMUX_INITIALIZE(&_mux);
+    _edge = xSemaphoreCreateBinary();
+    _last_edge_us = 0;
+    _edge_est_us = 0;
+    _period_us = 0;
+    _jitter_us = 0;
+    _edge_count = 0;
+    _snap_edge_us = 0;
+    _snap_period_us = 0;
+    _snap_jitter_us = 0;
+    _snap_count = 0;
+    _bus_free_us = 0;
+    _frame_target = -1;
+    _framing = false;
+    _pace_q8 = 0;
+    _pace_y = 0;
+    _pace_start_us = 0;
+    resetStats();
+}
+
+te_sync::~te_sync()
+{
+    if (_edge != NULL) {
+        vSemaphoreDelete(_edge);
+    }
+}
+
+void te_sync::onEdge(int64_t t_us)
+{
+    portENTER_CRITICAL_ISR(&_mux);
+    if (_last_edge_us != 0) {
+        uint32_t dt = (uint32_t)(t_us - _last_edge_us);
+        if (_period_us == 0) {
+            // Nothing is known about the jitter yet: start with some and let the edges correct it
+            _period_us = dt;
+            _jitter_us = dt / 64;
+        } else if (dt > _period_us * 3 / 2) {
+            // Keep the frame count in step with the panel across missed edges
+            uint32_t missed = (dt + _period_us / 2) / _period_us - 1;
+            _edge_count += missed;
+            _stats.missed += missed;
+        } else if (dt > _period_us / 2) {
+            _period_us += ((int32_t)dt - (int32_t)_period_us) / 8;
+            if (_stats.period_min_us == 0 || dt < _stats.period_min_us) {
+                _stats.period_min_us = dt;
+            }
+            if (dt > _stats.period_max_us) {
+                _stats.period_max_us = dt;
+            }
+        }
+    }
+    // Predictions start from a smoothed edge time, so the jitter of the last edge does not move them.
+    // How far edges land from where it put them is the margin to keep; follow a wider spread at once
+    if (_period_us != 0 && _edge_est_us != 0) {
+        int64_t expect = _edge_est_us + (t_us - _edge_est_us + _period_us / 2) / _period_us * _period_us;
+        int32_t err = (int32_t)(t_us - expect);
+        uint32_t dev = err < 0 ? -err : err;
+        _jitter_us = dev > _jitter_us ? dev : _jitter_us - (_jitter_us - dev + 255) / 256;
+        _edge_est_us = expect + err / 4;
+    } else {
+        _edge_est_us = t_us;
+    }
+    _last_edge_us = t_us;
+    _edge_count++;
+    _stats.edges++;
+    _stats.period_us = _period_us;
+    _stats.jitter_us = _jitter_us;
+    portEXIT_CRITICAL_ISR(&_mux);
+
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(_edge, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+void te_sync::setBusRate(uint32_t bytes_per_ms)
+{
+    _bytes_per_ms = bytes_per_ms ? bytes_per_ms : TE_SYNC_DEFAULT_BYTES_PER_MS;
+}
+
+void te_sync::setScanDelay(uint32_t delay_us)
+{
+    _scan_delay_us = delay_us;
+}
+
+bool te_sync::locked()
+{
+    return period() != 0;
+}
+
+uint32_t te_sync::period()
+{
+    portENTER_CRITICAL(&_mux);
+    uint32_t p = _period_us;
+    portEXIT_CRITICAL(&_mux);
+    return p;
+}
+
+int te_sync::scanLine(int64_t t_us)
+{
+    portENTER_CRITICAL(&_mux);
+    int64_t edge = _edge_est_us;
+    int64_t p = _period_us;
+    portEXIT_CRITICAL(&_mux);
+
+    if (p == 0 || _scan_delay_us >= p) {
+        return -1;
+    }
+    int64_t phase = t_us - edge - floorDiv(t_us - edge, p) * p;
+    if (phase < _scan_delay_us) {
+        return -1;
+    }
+    return (int)((phase - _scan_delay_us) * _lines / (p - _scan_delay_us));
+}
+
+bool te_sync::waitEdge(uint32_t timeout_ms)
+{
+    if (_edge == NULL) {
+        return false;
+    }
+    // Drop an edge that was signalled before the call
+    xSemaphoreTake(_edge, 0);
+    return xSemaphoreTake(_edge, pdMS_TO_TICKS(timeout_ms)) == pdTRUE;
+}
+
+void te_sync::beginFrame(bool from_top)
+{
+    _framing = true;
+    _frame_target = -1;
+    if (from_top && locked()) {
+        waitEdge(period() * 2 / 1000 + 1);
+    }
+}
+
+/*
+ * Where `row` of a strip sent at start_us lands relative to the scan, as
+ * a = (time the row is written - edge - scan delay) * lines - row * active time.
+ * Row r of pass k is scanned at edge + k * P + delay + r * active / lines, so
+ * the row is first shown by pass ceil(a / (P * lines)) after the last edge.
+ */
+int64_t te_sync::landing(int64_t start_us, uint32_t xfer_us, uint16_t y, uint16_t h, uint16_t row)
+{
+    int64_t active = (int64_t)_snap_period_us - _scan_delay_us;
+    int64_t landed = start_us + (int64_t)(row - y + 1) * xfer_us / h;
+    return (landed - _snap_edge_us - _scan_delay_us) * _lines - (int64_t)row * active;
+}
+
+void te_sync::sleepUntil(int64_t t_us)
+{
+    int64_t remain = t_us - esp_timer_get_time();
+    // Sleep whole ticks, spin the last stretch for microsecond accuracy
+    if (remain > 2000) {
+        vTaskDelay(pdMS_TO_TICKS(remain / 1000 - 1));
+    }
+    while (esp_timer_get_time() < t_us) {
+    }
+}
+
+int64_t te_sync::passDelay(int64_t start_us, uint32_t xfer_us, uint16_t y, uint16_t h, uint32_t margin_us, bool *fits)
+{
+    int64_t pass = (int64_t)_snap_period_us * _lines;
+    int64_t a0 = landing(start_us, xfer_us, y, h, y);
+    int64_t a1 = landing(start_us, xfer_us, y, h, y + h - 1);
+    int64_t lo = (a0 < a1 ? a0 : a1) - (int64_t)margin_us * _lines;
+    int64_t hi = (a0 < a1 ? a1 : a0) + (int64_t)margin_us * _lines;
+
+    // Longer than a scan pass over the rows: a crossing cannot be avoided
+    *fits = hi - lo < pass;
+    if (!*fits || ceilDiv(lo, pass) == ceilDiv(hi, pass)) {
+        return 0;
+    }
+    // Wait until all rows land in the next pass
+    return (ceilDiv(lo, pass) * pass - lo) / _lines + 1;
+}
+
+uint32_t te_sync::waitStrip(uint16_t y, uint16_t h, uint32_t bytes)
+{
+    int64_t now = esp_timer_get_time();
+    uint32_t xfer_us = (uint32_t)((uint64_t)bytes * 1000 / _bytes_per_ms);
+    // Transfers still queued on the bus push this one back
+    int64_t start = now > _bus_free_us ? now : _bus_free_us;
+
+    portENTER_CRITICAL(&_mux);
+    _snap_edge_us = _edge_est_us;
+    _snap_period_us = _period_us;
+    _snap_jitter_us = _jitter_us;
+    _snap_count = _edge_count;
+    if (h == 0 || _snap_period_us == 0 || _scan_delay_us >= _snap_period_us) {
+        _stats.strips++;
+        portEXIT_CRITICAL(&_mux);
+        _bus_free_us = start + xfer_us;
+        return 0;
+    }
+    portEXIT_CRITICAL(&_mux);
+
+    // Learn how fast the strips of an image arrive (decode + bus), in Q8 us per row
+    if (_framing && _frame_target >= 0 && y > _pace_y) {
+        uint32_t pace_q8 = (uint32_t)((start - _pace_start_us) * 256 / (y - _pace_y));
+        _pace_q8 = _pace_q8 == 0 ? pace_q8 : _pace_q8 + ((int32_t)pace_q8 - (int32_t)_pace_q8) / 8;
+    }
+    _pace_y = y;
+
+    int64_t p = _snap_period_us;
+    int64_t pass = p * _lines;
+    int64_t delay = 0;
+    // The edge a pass starts from and the one it ends at can each be off by the jitter
+    uint32_t margin = 2 * _snap_jitter_us + TE_SYNC_GUARD_US;
+    uint32_t late = 0;
+    bool fits;
+
+    if (_framing && _frame_target < 0 && _pace_q8 != 0 && y + h < _lines) {
+        // First strip of an image: start so that the rest of it, at the learnt pace, stays in one pass too.
+        // The pace is only an estimate, so keep 1/16 of a frame clear of the scan line on either side
+        uint16_t rows = _lines - y;
+        delay = passDelay(start, (uint32_t)(((uint64_t)_pace_q8 * rows) >> 8), y, rows, margin + _snap_period_us / 16, &fits);
+    }
+    delay += passDelay(start + delay, xfer_us, y, h, margin, &fits);
+
+    if (fits) {
+        int64_t frame = _snap_count + ceilDiv(landing(start + delay, xfer_us, y, h, y + h - 1), pass);
+        if (_framing && _frame_target >= 0 && frame < _frame_target) {
+            // Ahead of the pass the rest of the image went out in; hold back whole periods
+            delay += (_frame_target - frame) * p;
+            frame = _frame_target;
+        } else if (_framing && _frame_target >= 0 && frame > _frame_target) {
+            // Every pass the strip slips shows the rows above it without its own
+            late = (uint32_t)(frame - _frame_target);
+        }
+        if (_framing) {
+            _frame_target = frame;
+        }
+    }
+
+    start += delay;
+    // Measured from the actual send time, so the hold-back is not counted as decode time
+    _pace_start_us = start;
+    int64_t phase = start - _snap_edge_us - floorDiv(start - _snap_edge_us, p) * p;
+    _bus_free_us = start + xfer_us;
+
+    portENTER_CRITICAL(&_mux);
+    _stats.strips++;
+    _stats.unsafe += fits ? 0 : 1;
+    _stats.late += late;
+    _stats.phase_hist[phase * TE_PHASE_BINS / p]++;
+    if (delay > 0) {
+        _stats.delayed++;
+        _stats.wait_us += delay;
+    }
+    portEXIT_CRITICAL(&_mux);
+
+    if (delay > 0) {
+        sleepUntil(start);
+    }
+    return (uint32_t)delay;
+}
+
+te_stats_t te_sync::stats()
+{
+    portENTER_CRITICAL(&_mux);
+    te_stats_t s = _stats;
+    portEXIT_CRITICAL(&_mux);
+    return s;
+}
+
+void te_sync::resetStats()
+{
+    portENTER_CRITICAL(&_mux);
+    memset(&_stats, 0, sizeof(_stats));
+    _stats.period_us = _period_us;
+    _stats.jitter_us = _jitter_us;
+    portEXIT_CRITICAL(&_mux);
+}
@@ -0,0 +1,111 @@
+#ifndef _TE_SYNC_H
+#define _TE_SYNC_H
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#define TE_PHASE_BINS (8)
+
+typedef struct {
+    uint32_t edges;          // TE edges seen
+    uint32_t missed;         // gaps longer than 1.5 frame periods
+    uint32_t period_us;      // smoothed frame period
+    uint32_t period_min_us;
+    uint32_t period_max_us;
+    uint32_t jitter_us;      // recent distance of edges from their predicted time, kept clear of the scan line
+    uint32_t strips;
+    uint32_t delayed;        // strips held back so their rows land in one scan pass
+    uint64_t wait_us;
+    uint32_t unsafe;         // strips too tall to fit between two scan passes
+    uint32_t late;           // passes torn because strips fell behind the learnt pace
+    uint32_t phase_hist[TE_PHASE_BINS]; // frame phase at which strip writes started
+} te_stats_t;
+
+/*
+ * Flush scheduler synchronised to the panel TE (tearing effect) output.
+ *
+ * Each TE edge is timestamped; from the edge time and the measured frame period
+ * the scheduler knows which line the panel is scanning out at any moment. Before
+ * a strip is written, waitStrip() predicts when every row of the strip will land
+ * (from the bus rate and the transfers still queued) and delays the write until
+ * all of them are picked up by the same scan pass. Between beginFrame() calls
+ * the strips of one image are also kept in the same scan pass: the first strip
+ * is held back until the whole image, at the pace its strips have been
+ * arriving, can chase the beam down without being overtaken. beginFrame(true)
+ * simply starts from the top at TE.
+ *
+ * Predictions start from a smoothed edge time, and every strip keeps twice the
+ * measured edge jitter plus a small guard clear of the scan line on both
+ * sides, so a strip never straddles it. An image stays in
+ * one pass only while its strips keep the learnt pace, though: a strip that
+ * arrives later than that (a slow SD read, a busier core) lands a pass after
+ * the rows above it, and each pass shown torn that way is counted in `late`.
+ */
+class te_sync
+{
+public:
+    te_sync(uint16_t lines = 272);
+    ~te_sync();
+
+    // Attach to the panel TE pin (rising edge interrupt), see te_sync_gpio.cpp;
+    // call end() before destroying an attached instance
+    bool begin(int8_t te_pin);
+    void end();
+
+    // Record a TE edge; called from the GPIO ISR, or by a simulated panel on the host
+    void onEdge(int64_t t_us);
+
+    // Pixel bytes per millisecond the panel bus sustains (32 MHz QSPI: 16000)
+    void setBusRate(uint32_t bytes_per_ms);
+    // Time from the TE edge until line 0 is scanned out
+    void setScanDelay(uint32_t delay_us);
+
+    // True once two edges have given a frame period
+    bool locked();
+    uint32_t period();
+    // Line being scanned out at t_us, -1 before line 0 or when not locked
+    int scanLine(int64_t t_us);
+
+    bool waitEdge(uint32_t timeout_ms);
+    // Start of a new image; with from_top the first strip waits for the next TE edge
+    void beginFrame(bool from_top = false);
+    // Block until rows [y, y + h) holding `bytes` can be sent; returns the time waited
+    uint32_t waitStrip(uint16_t y, uint16_t h, uint32_t bytes);
+
+    te_stats_t stats();
+    void resetStats();
+
+private:
+    int64_t landing(int64_t start_us, uint32_t xfer_us, uint16_t y, uint16_t h, uint16_t row);
+    int64_t passDelay(int64_t start_us, uint32_t xfer_us, uint16_t y, uint16_t h, uint32_t margin_us, bool *fits);
+    void sleepUntil(int64_t t_us);
+
+    uint16_t _lines;
+    uint32_t _bytes_per_ms;
+    uint32_t _scan_delay_us;
+    int8_t _pin;
+
+    portMUX_TYPE _mux;
+    SemaphoreHandle_t _edge;
+    int64_t _last_edge_us;
+    int64_t _edge_est_us;     // smoothed time of the last edge, what predictions start from
+    uint32_t _period_us;
+    uint32_t _jitter_us;
+    uint32_t _edge_count;
+
+    // Snapshot of the edge state taken by waitStrip()
+    int64_t _snap_edge_us;
+    uint32_t _snap_period_us;
+    uint32_t _snap_jitter_us;
+    uint32_t _snap_count;
+
+    int64_t _bus_free_us;
+    int64_t _frame_target;
+    bool _framing;
+    uint32_t _pace_q8;
+    uint16_t _pace_y;
+    int64_t _pace_start_us;
+    te_stats_t _stats;
+};
+
+#endif
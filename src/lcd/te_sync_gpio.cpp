@@ -0,0 +1,56 @@
+#include "driver/gpio.h"
+#include "esp_err.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "te_sync.h"
+
+static const char *TAG = "te_sync";
+
+static void teIsr(void *arg)
+{
+    ((te_sync *)arg)->onEdge(esp_timer_get_time());
+}
+
+bool te_sync::begin(int8_t te_pin)
+{
+    if (te_pin < 0 || _edge == NULL) {
+        return false;
+    }
+
+    gpio_config_t conf = {};
+    conf.pin_bit_mask = 1ULL << te_pin;
+    conf.mode = GPIO_MODE_INPUT;
+    conf.pull_up_en = GPIO_PULLUP_DISABLE;
+    conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
+    conf.intr_type = GPIO_INTR_POSEDGE;
+    if (gpio_config(&conf) != ESP_OK) {
+        return false;
+    }
+
+    // ESP_ERR_INVALID_STATE: already installed, e.g. by attachInterrupt()
+    esp_err_t err = gpio_install_isr_service(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        ESP_LOGE(TAG, "gpio isr service: %s", esp_err_to_name(err));
+        return false;
+    }
+    if (gpio_isr_handler_add((gpio_num_t)te_pin, teIsr, this) != ESP_OK) {
+        return false;
+    }
+    _pin = te_pin;
+    return true;
+}
+
+void te_sync::end()
+{
+    if (_pin < 0) {
+        return;
+    }
+    gpio_isr_handler_remove((gpio_num_t)_pin);
+    gpio_set_intr_type((gpio_num_t)_pin, GPIO_INTR_DISABLE);
+    _pin = -1;
+
+    portENTER_CRITICAL(&_mux);
+    _last_edge_us = 0;
+    _period_us = 0;
+    portEXIT_CRITICAL(&_mux);
+}
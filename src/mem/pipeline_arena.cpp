@@ -0,0 +1,246 @@
+#include <string.h>
+#include <assert.h>
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "pipeline_arena.h"
+
+#define ARENA_GRANULE (16)
+#define ARENA_ROUND_UP(x) (((x) + ARENA_GRANULE - 1) & ~(size_t)(ARENA_GRANULE - 1))
+
+static const char *TAG = "arena";
+
+pipeline_arena pipeline_mem;
+
+pipeline_arena::pipeline_arena()
+{
+    memset(_region, 0, sizeof(_region));
+    _lock = NULL;
+}
+
+bool pipeline_arena::begin(size_t internal_size, size_t psram_size)
+{
+    static_assert(sizeof(block_t) <= ARENA_GRANULE, "block header must fit one granule");
+
+    if (started()) {
+        return true;
+    }
+    _lock = xSemaphoreCreateMutex();
+    if (_lock == NULL) {
+        return false;
+    }
+    if (!initRegion(&_region[ARENA_INTERNAL], internal_size, MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA) ||
+        !initRegion(&_region[ARENA_PSRAM], psram_size, MALLOC_CAP_SPIRAM)) {
+        end();
+        return false;
+    }
+    return true;
+}
+
+void pipeline_arena::end()
+{
+    for (int i = 0; i < ARENA_REGION_MAX; i++) {
+        heap_caps_free(_region[i].base);
+    }
+    memset(_region, 0, sizeof(_region));
+    if (_lock != NULL) {
+        vSemaphoreDelete(_lock);
+        _lock = NULL;
+    }
+}
+
+bool pipeline_arena::started()
+{
+    return _lock != NULL;
+}
+
+void *pipeline_arena::alloc(size_t size, arena_region_t region)
+{
+    region_t *r = &_region[region];
+    size_t need = ARENA_ROUND_UP(size) + ARENA_GRANULE;
+    void *ptr = NULL;
+
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    block_t *prev = NULL;
+    for (block_t *b = r->free_list; b != NULL; prev = b, b = b->next) {
+        if (b->size < need) {
+            continue;
+        }
+        block_t *next = b->next;
+        // Split unless the remainder could not hold a header plus one granule
+        if (b->size - need >= 2 * ARENA_GRANULE) {
+            block_t *rest = (block_t *)((uint8_t *)b + need);
+            rest->size = b->size - need;
+            rest->used = 0;
+            rest->next = next;
+            next = rest;
+            b->size = need;
+        }
+        if (prev != NULL) {
+            prev->next = next;
+        } else {
+            r->free_list = next;
+        }
+        b->used = 1;
+        b->next = NULL;
+        r->stats.used += b->size;
+        if (r->stats.used > r->stats.peak) {
+            r->stats.peak = r->stats.used;
+        }
+        r->stats.allocs++;
+        ptr = (uint8_t *)b + ARENA_GRANULE;
+        break;
+    }
+    if (ptr == NULL) {
+        r->stats.failed++;
+    }
+    updateFreeStats(r);
+    xSemaphoreGive(_lock);
+
+    if (ptr == NULL) {
+        ESP_LOGW(TAG, "region %d: no block for %u bytes, passing it to the heap", region, (unsigned)size);
+    }
+    return ptr;
+}
+
+void pipeline_arena::free(void *ptr)
+{
+    region_t *r = regionOf(ptr);
+    if (r == NULL) {
+        return;
+    }
+
+    block_t *b = (block_t *)((uint8_t *)ptr - ARENA_GRANULE);
+    assert(b->used && "double free in pipeline arena");
+
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    b->used = 0;
+    r->stats.used -= b->size;
+    r->stats.frees++;
+
+    // Keep the list in address order so neighbours can be merged
+    block_t *prev = NULL;
+    block_t *cur = r->free_list;
+    while (cur != NULL && cur < b) {
+        prev = cur;
+        cur = cur->next;
+    }
+    b->next = cur;
+    if (prev != NULL) {
+        prev->next = b;
+    } else {
+        r->free_list = b;
+    }
+    if (cur != NULL && (uint8_t *)b + b->size == (uint8_t *)cur) {
+        b->size += cur->size;
+        b->next = cur->next;
+    }
+    if (prev != NULL && (uint8_t *)prev + prev->size == (uint8_t *)b) {
+        prev->size += b->size;
+        prev->next = b->next;
+    }
+    updateFreeStats(r);
+    xSemaphoreGive(_lock);
+}
+
+bool pipeline_arena::owns(const void *ptr)
+{
+    return regionOf(ptr) != NULL;
+}
+
+arena_stats_t pipeline_arena::stats(arena_region_t region)
+{
+    return _region[region].stats;
+}
+
+void pipeline_arena::resetPeak()
+{
+    for (int i = 0; i < ARENA_REGION_MAX; i++) {
+        _region[i].stats.peak = _region[i].stats.used;
+    }
+}
+
+bool pipeline_arena::initRegion(region_t *r, size_t size, uint32_t caps)
+{
+    size = size & ~(size_t)(ARENA_GRANULE - 1);
+    if (size < 2 * ARENA_GRANULE) {
+        return true;
+    }
+    r->base = (uint8_t *)heap_caps_aligned_alloc(ARENA_GRANULE, size, caps);
+    if (r->base == NULL) {
+        ESP_LOGE(TAG, "failed to reserve %u bytes (caps 0x%x)", (unsigned)size, (unsigned)caps);
+        return false;
+    }
+    r->size = size;
+    r->free_list = (block_t *)r->base;
+    r->free_list->size = size;
+    r->free_list->used = 0;
+    r->free_list->next = NULL;
+    memset(&r->stats, 0, sizeof(r->stats));
+    r->stats.size = size;
+    updateFreeStats(r);
+    return true;
+}
+
+pipeline_arena::region_t *pipeline_arena::regionOf(const void *ptr)
+{
+    for (int i = 0; i < ARENA_REGION_MAX; i++) {
+        region_t *r = &_region[i];
+        if (r->base != NULL && (const uint8_t *)ptr >= r->base && (const uint8_t *)ptr < r->base + r->size) {
+            return r;
+        }
+    }
+    return NULL;
+}
+
+void pipeline_arena::updateFreeStats(region_t *r)
+{
+    size_t total = 0;
+    size_t largest = 0;
+    size_t count = 0;
+
+    for (block_t *b = r->free_list; b != NULL; b = b->next) {
+        total += b->size;
+        largest = b->size > largest ? b->size : largest;
+        count++;
+    }
+    r->stats.free_blocks = count;
+    r->stats.largest_free = largest;
+    r->stats.frag_permille = total ? (uint16_t)(1000 - (uint64_t)largest * 1000 / total) : 0;
+}
+
+void *pipeline_malloc_align(size_t size, arena_region_t region)
+{
+    void *ptr = NULL;
+    if (pipeline_mem.started()) {
+        ptr = pipeline_mem.alloc(size, region);
+        if (ptr != NULL) {
+            return ptr;
+        }
+        // A camera JPEG bigger than the PSRAM region, or the output strip of an image a few thousand
+        // pixels wide, is still worth serving from the heap; the region's failed count shows it happened
+    }
+
+    if (region == ARENA_PSRAM) {
+        ptr = heap_caps_aligned_alloc(ARENA_GRANULE, size, MALLOC_CAP_SPIRAM);
+    }
+    if (ptr == NULL) {
+        ptr = heap_caps_aligned_alloc(ARENA_GRANULE, size, region == ARENA_INTERNAL ? MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA : MALLOC_CAP_DEFAULT);
+    }
+    // Strips that wide only feed the resampler, which reads them with the CPU, so PSRAM will do
+    if (ptr == NULL && region == ARENA_INTERNAL) {
+        ptr = heap_caps_aligned_alloc(ARENA_GRANULE, size, MALLOC_CAP_SPIRAM);
+    }
+    return ptr;
+}
+
+void pipeline_free_align(void *ptr)
+{
+    if (ptr == NULL) {
+        return;
+    }
+    if (pipeline_mem.owns(ptr)) {
+        pipeline_mem.free(ptr);
+    } else {
+        heap_caps_free(ptr);
+    }
+}
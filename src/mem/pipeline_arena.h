@@ -0,0 +1,98 @@
+#ifndef _PIPELINE_ARENA_H
+#define _PIPELINE_ARENA_H
+#include <stdio.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+/*
+ * Region sizes the sketch reserves; host tools start pipeline_mem with the
+ * same ones so they run out where the device would. Internal RAM has to hold
+ * the largest set of buffers live at once: the decoder's output strip and the
+ * baseline decoder's planes (15 + 12 KB at 480 wide, 4:2:0), the resampler's
+ * two strips (30 KB), the SD staging chunk (16 KB) and two strips for the
+ * blitter, a transition or an R565 asset (30 KB). Past those budgets, such as
+ * a camera JPEG over 1 MB or a 4:2:0 image 3000 pixels or more across, whose
+ * 16-line output strip needs 94 KB, pipeline_malloc_align() falls back to the
+ * heap.
+ */
+#ifndef ARENA_INTERNAL_SIZE
+#define ARENA_INTERNAL_SIZE (112 * 1024)
+#endif
+#ifndef ARENA_PSRAM_SIZE
+#define ARENA_PSRAM_SIZE (1024 * 1024)
+#endif
+
+typedef enum {
+    ARENA_INTERNAL = 0, // DMA-capable internal SRAM: output strips, staging buffers
+    ARENA_PSRAM,        // file buffers, frames, caches
+    ARENA_REGION_MAX,
+} arena_region_t;
+
+typedef struct {
+    size_t size;              // region capacity
+    size_t used;              // bytes handed out, headers included
+    size_t peak;
+    size_t free_blocks;
+    size_t largest_free;
+    uint16_t frag_permille;   // 1000 * (1 - largest_free / free)
+    uint32_t allocs;
+    uint32_t frees;
+    uint32_t failed;          // requests the region could not serve, passed on to the heap
+} arena_stats_t;
+
+/*
+ * Fixed-size allocator for the decode pipeline.
+ *
+ * Each region is one block taken from the heap at startup and carved with an
+ * address-ordered first-fit free list that coalesces on free. Every block is
+ * aligned to the region granule (16 bytes), so strips and file buffers can go
+ * straight to the decoder and the DMA engines. Once begin() has run the heap is
+ * only touched for requests a region cannot serve, so the buffers every image
+ * needs cannot fragment it.
+ */
+class pipeline_arena
+{
+public:
+    pipeline_arena();
+
+    bool begin(size_t internal_size, size_t psram_size);
+    void end();
+    bool started();
+
+    void *alloc(size_t size, arena_region_t region);
+    void free(void *ptr);
+    bool owns(const void *ptr);
+
+    arena_stats_t stats(arena_region_t region);
+    void resetPeak();
+
+private:
+    typedef struct block_s {
+        uint32_t size;        // whole block, header included
+        uint32_t used;
+        struct block_s *next; // free list link, only valid while free
+    } block_t;
+
+    typedef struct {
+        uint8_t *base;
+        size_t size;
+        block_t *free_list;
+        arena_stats_t stats;
+    } region_t;
+
+    bool initRegion(region_t *r, size_t size, uint32_t caps);
+    region_t *regionOf(const void *ptr);
+    void updateFreeStats(region_t *r);
+
+    region_t _region[ARENA_REGION_MAX];
+    SemaphoreHandle_t _lock;
+};
+
+extern pipeline_arena pipeline_mem;
+
+// Pipeline buffers: served by pipeline_mem once it is started, by the heap before that or when a region is full
+void *pipeline_malloc_align(size_t size, arena_region_t region);
+void pipeline_free_align(void *ptr);
+
+#endif
@@ -0,0 +1,59 @@
+#include "sd_avi_reader.h"
+
+sd_avi_reader::sd_avi_reader(fs::FS &fs, sd_loader &loader)
+    : _fs(fs), _loader(loader)
+{
+    _size = 0;
+}
+
+sd_avi_reader::~sd_avi_reader()
+{
+    close();
+}
+
+sd_load_err_t sd_avi_reader::open(const char *path)
+{
+    close();
+    _file = _fs.open(path);
+    if (!_file) {
+        return SD_LOAD_ERR_OPEN;
+    }
+    if (_file.isDirectory()) {
+        close();
+        return SD_LOAD_ERR_IS_DIR;
+    }
+    _size = _file.size();
+    if (_size == 0) {
+        close();
+        return SD_LOAD_ERR_EMPTY;
+    }
+    _path = path;
+    return SD_LOAD_OK;
+}
+
+void sd_avi_reader::close()
+{
+    if (_file) {
+        _file.close();
+    }
+    _size = 0;
+}
+
+size_t sd_avi_reader::read(uint32_t offset, void *buf, size_t len)
+{
+    if (!_file || offset > _size) {
+        return 0;
+    }
+    len = len < _size - offset ? len : _size - offset;
+    return _loader.readAt(_file, offset, (uint8_t *)buf, len) == SD_LOAD_OK ? len : 0;
+}
+
+uint32_t sd_avi_reader::size()
+{
+    return _size;
+}
+
+const char *sd_avi_reader::name()
+{
+    return _path.c_str();
+}
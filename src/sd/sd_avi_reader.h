@@ -0,0 +1,34 @@
+#ifndef _SD_AVI_READER_H
+#define _SD_AVI_READER_H
+#include <string>
+#include "FS.h"
+#include "sd_loader.h"
+#include "../video/avi_demux.h"
+
+/*
+ * An AVI file on SD, kept open while it plays. Reads go through sd_loader,
+ * so frames headed for PSRAM are staged through its internal chunk like any
+ * other load.
+ */
+class sd_avi_reader : public avi_reader
+{
+public:
+    sd_avi_reader(fs::FS &fs, sd_loader &loader);
+    ~sd_avi_reader();
+
+    sd_load_err_t open(const char *path);
+    void close();
+
+    size_t read(uint32_t offset, void *buf, size_t len);
+    uint32_t size();
+    const char *name();
+
+private:
+    fs::FS &_fs;
+    sd_loader &_loader;
+    File _file;
+    std::string _path;
+    uint32_t _size;
+};
+
+#endif
@@ -0,0 +1,79 @@
+#include "esp_timer.h"
+#include "../mem/pipeline_arena.h"
+#include "sd_image_source.h"
+
+sd_image_source::sd_image_source(sd_loader &loader, const char *path)
+    : _loader(loader)
+{
+    _buf = NULL;
+    _cap = 0;
+    _load_err = SD_LOAD_OK;
+    setPath(path);
+}
+
+sd_image_source::~sd_image_source()
+{
+    pipeline_free_align(_buf);
+}
+
+void sd_image_source::setPath(const char *path)
+{
+    _path = path != NULL ? path : "";
+}
+
+image_source_err_t sd_image_source::acquire(const uint8_t **data, size_t *len)
+{
+    uint32_t t = (uint32_t)esp_timer_get_time();
+    image_source_err_t err = IMAGE_SOURCE_OK;
+
+    *data = NULL;
+    *len = 0;
+    if (_held) {
+        return acquired(IMAGE_SOURCE_ERR_BUSY, NULL, 0, t, 0);
+    }
+    _load_err = _loader.load(_path.c_str(), &_buf, &_cap, len);
+    switch (_load_err) {
+    case SD_LOAD_OK:
+        *data = _buf;
+        break;
+    case SD_LOAD_ERR_OPEN:
+    case SD_LOAD_ERR_IS_DIR:
+        err = IMAGE_SOURCE_ERR_OPEN;
+        break;
+    case SD_LOAD_ERR_EMPTY:
+        err = IMAGE_SOURCE_ERR_EMPTY;
+        break;
+    case SD_LOAD_ERR_NO_MEM:
+    case SD_LOAD_ERR_TOO_LARGE:
+        err = IMAGE_SOURCE_ERR_NO_MEM;
+        break;
+    default:
+        err = IMAGE_SOURCE_ERR_READ;
+        break;
+    }
+    return acquired(err, *data, *len, t, *len);
+}
+
+void sd_image_source::release()
+{
+    _held = false;
+}
+
+const char *sd_image_source::name()
+{
+    return _path.c_str();
+}
+
+void sd_image_source::trim()
+{
+    if (!_held) {
+        pipeline_free_align(_buf);
+        _buf = NULL;
+        _cap = 0;
+    }
+}
+
+sd_load_err_t sd_image_source::lastLoadError()
+{
+    return _load_err;
+}
@@ -0,0 +1,35 @@
+#ifndef _SD_IMAGE_SOURCE_H
+#define _SD_IMAGE_SOURCE_H
+#include <string>
+#include "sd_loader.h"
+#include "../decode/image_source.h"
+
+/*
+ * A JPEG file on SD, read whole through sd_loader on acquire(). The buffer
+ * is kept after release() and reused by the next acquire() when the image
+ * fits, so a slideshow over one source allocates once.
+ */
+class sd_image_source : public image_source
+{
+public:
+    sd_image_source(sd_loader &loader, const char *path = NULL);
+    ~sd_image_source();
+
+    void setPath(const char *path);
+    image_source_err_t acquire(const uint8_t **data, size_t *len);
+    void release();
+    const char *name();
+    // Frees the buffer kept for the next acquire()
+    void trim();
+
+    sd_load_err_t lastLoadError();
+
+private:
+    sd_loader &_loader;
+    std::string _path;
+    uint8_t *_buf;
+    size_t _cap;
+    sd_load_err_t _load_err;
+};
+
+#endif
@@ -0,0 +1,335 @@
+#include <string.h>
+#include "esp_memory_utils.h"
+#include "esp_timer.h"
+#include "../mem/pipeline_arena.h"
+#include "../trace/pipeline_trace.h"
+#include "sd_loader.h"
+
+#define SD_LOADER_SECTOR_SIZE (512)
+
+sd_loader::sd_loader(fs::FS &fs, size_t chunk_size)
+    : _fs(fs)
+{
+    _chunk = 0;
+    _staging = NULL;
+    setChunkSize(chunk_size);
+    setBus(20000, 1);
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+sd_loader::~sd_loader()
+{
+    pipeline_free_align(_staging);
+}
+
+void sd_loader::setChunkSize(size_t chunk_size)
+{
+    chunk_size = (chunk_size + SD_LOADER_SECTOR_SIZE - 1) & ~(size_t)(SD_LOADER_SECTOR_SIZE - 1);
+    if (chunk_size == 0) {
+        chunk_size = SD_LOADER_SECTOR_SIZE;
+    }
+    if (chunk_size != _chunk) {
+        pipeline_free_align(_staging);
+        _staging = NULL;
+        _chunk = chunk_size;
+    }
+}
+
+size_t sd_loader::chunkSize()
+{
+    return _chunk;
+}
+
+void sd_loader::setBus(uint32_t freq_khz, uint8_t width)
+{
+    _bus_bytes_per_sec = freq_khz * 1000 / 8 * width;
+}
+
+sd_load_err_t sd_loader::load(const char *path, uint8_t *buf, size_t buf_len, size_t *len)
+{
+    File file;
+    size_t size = 0;
+
+    sd_load_err_t err = open(path, file, &size);
+    if (err == SD_LOAD_OK && size > buf_len) {
+        err = SD_LOAD_ERR_TOO_LARGE;
+    }
+    if (err == SD_LOAD_OK) {
+        err = read(file, buf, size);
+    }
+    if (file) {
+        file.close();
+    }
+    *len = err == SD_LOAD_OK ? size : 0;
+    return err;
+}
+
+sd_load_err_t sd_loader::load(const char *path, uint8_t **buf, size_t *len)
+{
+    size_t cap = 0;
+
+    *buf = NULL;
+    return load(path, buf, &cap, len);
+}
+
+sd_load_err_t sd_loader::load(const char *path, uint8_t **buf, size_t *cap, size_t *len)
+{
+    File file;
+    size_t size = 0;
+    bool owned = false;
+
+    *len = 0;
+    sd_load_err_t err = open(path, file, &size);
+    if (err == SD_LOAD_OK && size > *cap) {
+        if (*buf != NULL) {
+            pipeline_free_align(*buf);
+        }
+        *buf = (uint8_t *)pipeline_malloc_align(size, ARENA_PSRAM);
+        *cap = *buf ? size : 0;
+        owned = true;
+        if (*buf == NULL) {
+            err = SD_LOAD_ERR_NO_MEM;
+        }
+    }
+    if (err == SD_LOAD_OK) {
+        err = read(file, *buf, size);
+    }
+    if (file) {
+        file.close();
+    }
+
+    if (err == SD_LOAD_OK) {
+        *len = size;
+    } else if (owned && *buf != NULL) {
+        // Don't hand a half-filled buffer we just allocated back to the caller
+        pipeline_free_align(*buf);
+        *buf = NULL;
+        *cap = 0;
+    }
+    return err;
+}
+
+sd_load_err_t sd_loader::loadThumbnail(const char *path, uint8_t **buf, size_t *len, jpeg_thumb_info_t *info)
+{
+    uint8_t *head = NULL;
+    jpeg_probe_t found;
+
+    *buf = NULL;
+    *len = 0;
+    sd_load_err_t err = readHeaders(path, false, &head, &found);
+    if (err != SD_LOAD_OK) {
+        pipeline_free_align(head);
+        return err;
+    }
+    // The thumbnail is a complete JPEG of its own; hand over just that
+    memmove(head, head + found.thumb.offset, found.thumb.length);
+    *buf = head;
+    *len = found.thumb.length;
+    if (info != NULL) {
+        *info = found.thumb;
+    }
+    return SD_LOAD_OK;
+}
+
+sd_load_err_t sd_loader::probe(const char *path, jpeg_probe_t *info)
+{
+    uint8_t *head = NULL;
+    sd_load_err_t err = readHeaders(path, true, &head, info);
+    pipeline_free_align(head);
+    return err;
+}
+
+sd_load_err_t sd_loader::loadRange(const char *path, uint32_t offset, size_t len, uint8_t **buf)
+{
+    File file;
+    size_t size = 0;
+
+    *buf = NULL;
+    sd_load_err_t err = open(path, file, &size);
+    if (err == SD_LOAD_OK && (len == 0 || offset > size || len > size - offset)) {
+        // The file is not what the caller remembers
+        err = SD_LOAD_ERR_READ;
+    }
+    if (err == SD_LOAD_OK) {
+        *buf = (uint8_t *)pipeline_malloc_align(len, ARENA_PSRAM);
+        err = *buf == NULL ? SD_LOAD_ERR_NO_MEM : SD_LOAD_OK;
+    }
+    if (err == SD_LOAD_OK && !file.seek(offset)) {
+        err = SD_LOAD_ERR_READ;
+    }
+    if (err == SD_LOAD_OK) {
+        err = read(file, *buf, len);
+    }
+    if (file) {
+        file.close();
+    }
+    if (err != SD_LOAD_OK) {
+        pipeline_free_align(*buf);
+        *buf = NULL;
+    }
+    return err;
+}
+
+sd_load_err_t sd_loader::readAt(File &file, uint32_t offset, uint8_t *buf, size_t len)
+{
+    memset(&_stats, 0, sizeof(_stats));
+    if (!file || !file.seek(offset)) {
+        return SD_LOAD_ERR_READ;
+    }
+    return read(file, buf, len);
+}
+
+// Read the start of a JPEG until the scanner has what it wants: the thumbnail, or
+// with `frame` the frame header. Reads 4 KB first and grows only when asked to
+sd_load_err_t sd_loader::readHeaders(const char *path, bool frame, uint8_t **head, jpeg_probe_t *found)
+{
+    File file;
+    size_t size = 0;
+    size_t have = 0;
+    size_t want = JPEG_THUMB_HEAD_SIZE;
+    uint32_t read_us = 0;
+    jpeg_thumb_result_t res = JPEG_THUMB_NEED_MORE;
+
+    memset(found, 0, sizeof(*found));
+    sd_load_err_t err = open(path, file, &size);
+    while (err == SD_LOAD_OK && res == JPEG_THUMB_NEED_MORE) {
+        want = want < size ? want : size;
+        if (want <= have || want > JPEG_THUMB_MAX_HEAD) {
+            // The file ends inside its headers, or they go on implausibly long
+            res = JPEG_THUMB_NONE;
+            break;
+        }
+        uint8_t *grown = (uint8_t *)pipeline_malloc_align(want, ARENA_PSRAM);
+        if (grown == NULL) {
+            err = SD_LOAD_ERR_NO_MEM;
+            break;
+        }
+        if (*head != NULL) {
+            memcpy(grown, *head, have);
+            pipeline_free_align(*head);
+        }
+        *head = grown;
+        err = read(file, *head + have, want - have);
+        read_us += _stats.read_us;
+        have = want;
+        if (err == SD_LOAD_OK) {
+            uint32_t need;
+            if (frame) {
+                res = jpeg_probe(*head, have, found);
+                need = found->need;
+            } else {
+                res = jpeg_thumb_find(*head, have, &found->thumb);
+                found->has_thumb = res == JPEG_THUMB_OK;
+                need = found->thumb.need;
+            }
+            // At least double, so a long run of segments costs few requests
+            want = need > 2 * have ? need : 2 * have;
+            want = want > JPEG_THUMB_MAX_HEAD && need <= JPEG_THUMB_MAX_HEAD ? JPEG_THUMB_MAX_HEAD : want;
+        }
+    }
+    if (file) {
+        file.close();
+    }
+    rate(have, read_us);
+
+    if (err == SD_LOAD_OK && res != JPEG_THUMB_OK) {
+        err = frame ? SD_LOAD_ERR_NOT_JPEG : SD_LOAD_ERR_NO_THUMBNAIL;
+    }
+    return err;
+}
+
+sd_load_stats_t sd_loader::lastStats()
+{
+    return _stats;
+}
+
+const char *sd_loader::errName(sd_load_err_t err)
+{
+    switch (err) {
+    case SD_LOAD_OK:
+        return "ok";
+    case SD_LOAD_ERR_OPEN:
+        return "open failed";
+    case SD_LOAD_ERR_IS_DIR:
+        return "is a directory";
+    case SD_LOAD_ERR_EMPTY:
+        return "empty file";
+    case SD_LOAD_ERR_TOO_LARGE:
+        return "buffer too small";
+    case SD_LOAD_ERR_NO_MEM:
+        return "out of memory";
+    case SD_LOAD_ERR_READ:
+        return "short read";
+    case SD_LOAD_ERR_NO_THUMBNAIL:
+        return "no embedded thumbnail";
+    case SD_LOAD_ERR_NOT_JPEG:
+        return "no JPEG frame header";
+    default:
+        return "unknown";
+    }
+}
+
+sd_load_err_t sd_loader::open(const char *path, File &file, size_t *len)
+{
+    uint32_t t = (uint32_t)esp_timer_get_time();
+
+    memset(&_stats, 0, sizeof(_stats));
+    file = _fs.open(path);
+    _stats.open_us = (uint32_t)esp_timer_get_time() - t;
+    if (!file) {
+        return SD_LOAD_ERR_OPEN;
+    }
+    if (file.isDirectory()) {
+        return SD_LOAD_ERR_IS_DIR;
+    }
+    *len = file.size();
+    if (*len == 0) {
+        return SD_LOAD_ERR_EMPTY;
+    }
+    return SD_LOAD_OK;
+}
+
+sd_load_err_t sd_loader::read(File &file, uint8_t *buf, size_t len)
+{
+    uint32_t t = (uint32_t)esp_timer_get_time();
+    bool direct = esp_ptr_dma_capable(buf) && ((uintptr_t)buf & 3) == 0;
+    size_t done = 0;
+
+    if (!direct && _staging == NULL) {
+        _staging = (uint8_t *)pipeline_malloc_align(_chunk, ARENA_INTERNAL);
+        if (_staging == NULL) {
+            return SD_LOAD_ERR_NO_MEM;
+        }
+    }
+
+    while (done < len) {
+        size_t want = len - done > _chunk ? _chunk : len - done;
+        uint8_t *dst = direct ? buf + done : _staging;
+        PIPELINE_TRACE_BEGIN(TRACE_SD_READ, want / 1024);
+        size_t got = file.read(dst, want);
+        PIPELINE_TRACE_END(TRACE_SD_READ, got / 1024);
+        _stats.reads++;
+        if (got != want) {
+            return SD_LOAD_ERR_READ;
+        }
+        if (!direct) {
+            memcpy(buf + done, _staging, got);
+        }
+        done += got;
+    }
+
+    rate(done, (uint32_t)esp_timer_get_time() - t);
+    return SD_LOAD_OK;
+}
+
+void sd_loader::rate(size_t bytes, uint32_t us)
+{
+    _stats.bytes = bytes;
+    _stats.read_us = us;
+    if (_stats.read_us > 0) {
+        _stats.bytes_per_sec = (uint32_t)((uint64_t)bytes * 1000000 / _stats.read_us);
+    }
+    if (_bus_bytes_per_sec > 0) {
+        _stats.bus_permille = (uint16_t)((uint64_t)_stats.bytes_per_sec * 1000 / _bus_bytes_per_sec);
+    }
+}
@@ -0,0 +1,84 @@
+#ifndef _SD_LOADER_H
+#define _SD_LOADER_H
+#include <stdio.h>
+#include "FS.h"
+#include "../decode/jpeg_thumb.h"
+
+typedef enum {
+    SD_LOAD_OK = 0,
+    SD_LOAD_ERR_OPEN,      // file missing or card not mounted
+    SD_LOAD_ERR_IS_DIR,
+    SD_LOAD_ERR_EMPTY,
+    SD_LOAD_ERR_TOO_LARGE, // file does not fit the caller's buffer
+    SD_LOAD_ERR_NO_MEM,
+    SD_LOAD_ERR_READ,      // short read, the buffer contents are not usable
+    SD_LOAD_ERR_NO_THUMBNAIL, // no usable embedded thumbnail; decode the image instead
+    SD_LOAD_ERR_NOT_JPEG,  // no frame header where a JPEG would have one
+} sd_load_err_t;
+
+typedef struct {
+    size_t bytes;
+    uint32_t reads;         // file.read() calls issued
+    uint32_t open_us;
+    uint32_t read_us;
+    uint32_t bytes_per_sec;
+    uint16_t bus_permille;  // throughput relative to the configured bus limit
+} sd_load_stats_t;
+
+/*
+ * Whole-file loader for the decoder input buffers.
+ *
+ * The file is opened once and read front to back in chunk-sized requests, so
+ * with a chunk that is a multiple of the card's cluster size every request
+ * covers whole clusters. Destinations in internal DMA-capable RAM are read into
+ * directly; PSRAM destinations go through one internal staging chunk, since the
+ * SDMMC driver would otherwise fall back to single-sector transfers.
+ *
+ * A load either fills the buffer completely or returns an error; a partially
+ * filled buffer is never reported as success.
+ */
+class sd_loader
+{
+public:
+    sd_loader(fs::FS &fs, size_t chunk_size = 16 * 1024);
+    ~sd_loader();
+
+    // Rounded up to a whole number of 512-byte sectors
+    void setChunkSize(size_t chunk_size);
+    size_t chunkSize();
+    // Used only for the bus_permille figure (SDMMC 1-bit @ 20 MHz by default)
+    void setBus(uint32_t freq_khz, uint8_t width);
+
+    // Into a caller buffer that must hold the whole file
+    sd_load_err_t load(const char *path, uint8_t *buf, size_t buf_len, size_t *len);
+    // Into a 16-byte aligned buffer allocated with pipeline_malloc_align(); *buf is NULL on error
+    sd_load_err_t load(const char *path, uint8_t **buf, size_t *len);
+    // Reuse *buf when it is large enough, otherwise replace it with a bigger one
+    sd_load_err_t load(const char *path, uint8_t **buf, size_t *cap, size_t *len);
+    // Only the embedded JPEG thumbnail, into a pipeline_malloc_align() buffer. Reads the
+    // first JPEG_THUMB_HEAD_SIZE bytes and more only if the headers go on further
+    sd_load_err_t loadThumbnail(const char *path, uint8_t **buf, size_t *len, jpeg_thumb_info_t *info = NULL);
+    // Frame header and embedded thumbnail of a JPEG, reading no further than the frame header
+    sd_load_err_t probe(const char *path, jpeg_probe_t *info);
+    // `len` bytes at `offset`, e.g. a thumbnail whose place is already known; *buf as for load()
+    sd_load_err_t loadRange(const char *path, uint32_t offset, size_t len, uint8_t **buf);
+    // `len` bytes at `offset` of a file the caller keeps open, e.g. one being streamed
+    sd_load_err_t readAt(File &file, uint32_t offset, uint8_t *buf, size_t len);
+
+    sd_load_stats_t lastStats();
+    static const char *errName(sd_load_err_t err);
+
+private:
+    sd_load_err_t open(const char *path, File &file, size_t *len);
+    sd_load_err_t read(File &file, uint8_t *buf, size_t len);
+    sd_load_err_t readHeaders(const char *path, bool frame, uint8_t **head, jpeg_probe_t *found);
+    void rate(size_t bytes, uint32_t us);
+
+    fs::FS &_fs;
+    size_t _chunk;
+    uint8_t *_staging;
+    uint32_t _bus_bytes_per_sec;
+    sd_load_stats_t _stats;
+};
+
+#endif
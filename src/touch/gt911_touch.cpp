@@ -4,8 +4,11 @@
 #include "esp_err.h"
 #include "esp_log.h"
 #include "driver/i2c.h"
+#include "esp_timer.h"
 #include "esp_lcd_touch_gt911.h"
 #include "gt911_touch.h"
+#include "../trace/pipeline_trace.h"
+#include "../../pins_config.h"
 
 #define CONFIG_LCD_HRES 270
 #define CONFIG_LCD_VRES 480
@@ -19,6 +22,7 @@ uint16_t touch_strength[1];
 uint8_t touch_cnt = 0;
 
 gt911_touch::gt911_touch(int8_t sda_pin, int8_t scl_pin, int8_t rst_pin, int8_t int_pin)
+    : _predictor(LCD_H_RES - 1, LCD_V_RES - 1) // predictions are clamped to the panel, inclusive
 {
     _sda = sda_pin;
     _scl = scl_pin;
@@ -66,8 +70,28 @@ void gt911_touch::begin()
 
 bool gt911_touch::getTouch(uint16_t *x, uint16_t *y)
 {
+    PIPELINE_TRACE_BEGIN(TRACE_TOUCH_READ, 0);
     esp_lcd_touch_read_data(tp);
+    PIPELINE_TRACE_END(TRACE_TOUCH_READ, 0);
     bool touchpad_pressed = esp_lcd_touch_get_coordinates(tp, x, y, touch_strength, &touch_cnt, 1);
 
     return touchpad_pressed;
 }
+
+bool gt911_touch::getPredictedTouch(uint16_t *x, uint16_t *y)
+{
+    uint16_t raw_x, raw_y;
+
+    if (!getTouch(&raw_x, &raw_y)) {
+        _predictor.release();
+        return false;
+    }
+    _predictor.update(raw_x, raw_y, (uint32_t)esp_timer_get_time());
+
+    return _predictor.predict(x, y);
+}
+
+void gt911_touch::addLatencySample(uint32_t latency_us)
+{
+    _predictor.addLatencySample(latency_us);
+}
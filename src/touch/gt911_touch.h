@@ -1,6 +1,7 @@
 #ifndef _GT911_TOUCH_H
 #define _GT911_TOUCH_H
 #include <stdio.h>
+#include "touch_predictor.h"
 
 class gt911_touch
 {
@@ -9,9 +10,14 @@ public:
 
     void begin();
     bool getTouch(uint16_t *x, uint16_t *y);
+    // Filtered touch position extrapolated by the display pipeline latency
+    bool getPredictedTouch(uint16_t *x, uint16_t *y);
+    // Time from getPredictedTouch() to the redraw it drove leaving the bus (lcd.flush() returned)
+    void addLatencySample(uint32_t latency_us);
 
 private:
     int8_t _sda, _scl, _rst, _int;
+    touch_predictor _predictor;
 };
 
 #endif
@@ -0,0 +1,132 @@
+#include "touch_predictor.h"
+
+#define TOUCH_PREDICTOR_ALPHA_DEFAULT (154) // 0.60
+#define TOUCH_PREDICTOR_BETA_DEFAULT (51)   // 0.20
+#define TOUCH_PREDICTOR_MAX_LEAD_US (80 * 1000)
+#define TOUCH_PREDICTOR_STALE_US (100 * 1000)
+
+touch_predictor::touch_predictor(uint16_t x_max, uint16_t y_max)
+{
+    _x_max = x_max;
+    _y_max = y_max;
+    _alpha_q8 = TOUCH_PREDICTOR_ALPHA_DEFAULT;
+    _beta_q8 = TOUCH_PREDICTOR_BETA_DEFAULT;
+    _max_lead_us = TOUCH_PREDICTOR_MAX_LEAD_US;
+    _latency_us = 0;
+    release();
+}
+
+void touch_predictor::setGains(uint16_t alpha_q8, uint16_t beta_q8)
+{
+    _alpha_q8 = alpha_q8 > 256 ? 256 : alpha_q8;
+    _beta_q8 = beta_q8 > 256 ? 256 : beta_q8;
+}
+
+void touch_predictor::setMaxLead(uint32_t max_lead_us)
+{
+    _max_lead_us = max_lead_us;
+}
+
+void touch_predictor::update(uint16_t x, uint16_t y, uint32_t t_us)
+{
+    int32_t mx = (int32_t)x << 8;
+    int32_t my = (int32_t)y << 8;
+    uint32_t dt_us = t_us - _last_t_us;
+
+    // First contact, or the sample stream stalled: restart from the measurement
+    if (!_tracking || dt_us > TOUCH_PREDICTOR_STALE_US) {
+        _x_q8 = mx;
+        _y_q8 = my;
+        _vx_q8 = 0;
+        _vy_q8 = 0;
+        _last_t_us = t_us;
+        _tracking = true;
+        return;
+    }
+
+    // Predict to the sample time
+    int32_t px = _x_q8 + (int32_t)(((int64_t)_vx_q8 * dt_us) / 1000);
+    int32_t py = _y_q8 + (int32_t)(((int64_t)_vy_q8 * dt_us) / 1000);
+
+    // Correct with the residual
+    int32_t rx = mx - px;
+    int32_t ry = my - py;
+    _x_q8 = px + ((rx * _alpha_q8) >> 8);
+    _y_q8 = py + ((ry * _alpha_q8) >> 8);
+    if (dt_us > 0) {
+        _vx_q8 += (int32_t)(((int64_t)rx * _beta_q8 * 1000 / 256) / dt_us);
+        _vy_q8 += (int32_t)(((int64_t)ry * _beta_q8 * 1000 / 256) / dt_us);
+    }
+    _last_t_us = t_us;
+}
+
+void touch_predictor::release()
+{
+    _tracking = false;
+    _last_t_us = 0;
+    _x_q8 = 0;
+    _y_q8 = 0;
+    _vx_q8 = 0;
+    _vy_q8 = 0;
+}
+
+bool touch_predictor::isTracking()
+{
+    return _tracking;
+}
+
+void touch_predictor::addLatencySample(uint32_t latency_us)
+{
+    if (_latency_us == 0) {
+        _latency_us = latency_us;
+    } else {
+        _latency_us = (uint32_t)((int32_t)_latency_us + ((int32_t)latency_us - (int32_t)_latency_us) / 8);
+    }
+}
+
+uint32_t touch_predictor::latency()
+{
+    return _latency_us;
+}
+
+bool touch_predictor::filtered(uint16_t *x, uint16_t *y)
+{
+    return predict(0, x, y);
+}
+
+bool touch_predictor::predict(uint16_t *x, uint16_t *y)
+{
+    return predict(_latency_us, x, y);
+}
+
+bool touch_predictor::predict(uint32_t lead_us, uint16_t *x, uint16_t *y)
+{
+    if (!_tracking) {
+        return false;
+    }
+    if (lead_us > _max_lead_us) {
+        lead_us = _max_lead_us;
+    }
+    *x = (uint16_t)extrapolate(_x_q8, _vx_q8, lead_us, _x_max);
+    *y = (uint16_t)extrapolate(_y_q8, _vy_q8, lead_us, _y_max);
+    return true;
+}
+
+void touch_predictor::velocity(int32_t *vx, int32_t *vy)
+{
+    // Q8 px/ms -> px/s
+    *vx = (_vx_q8 * 1000) >> 8;
+    *vy = (_vy_q8 * 1000) >> 8;
+}
+
+int32_t touch_predictor::extrapolate(int32_t pos_q8, int32_t vel_q8, uint32_t lead_us, uint16_t max)
+{
+    int32_t pos = pos_q8 + (int32_t)(((int64_t)vel_q8 * lead_us) / 1000);
+    pos = (pos + 128) >> 8;
+    if (pos < 0) {
+        pos = 0;
+    } else if (pos > max) {
+        pos = max;
+    }
+    return pos;
+}
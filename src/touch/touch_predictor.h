@@ -0,0 +1,51 @@
+#ifndef _TOUCH_PREDICTOR_H
+#define _TOUCH_PREDICTOR_H
+#include <stdint.h>
+
+/*
+ * Alpha-beta filter over timestamped touch samples.
+ *
+ * Positions are kept in Q8 pixels and velocities in Q8 pixels per millisecond,
+ * so the whole filter runs on integer arithmetic. predict() extrapolates the
+ * filtered position by the measured display pipeline latency (decode + flush),
+ * which lets a pan renderer draw where the finger will be, not where it was.
+ */
+class touch_predictor
+{
+public:
+    touch_predictor(uint16_t x_max = 0xFFFF, uint16_t y_max = 0xFFFF);
+
+    // Gains in Q8 (256 == 1.0)
+    void setGains(uint16_t alpha_q8, uint16_t beta_q8);
+    // Upper bound on how far ahead predict() may extrapolate
+    void setMaxLead(uint32_t max_lead_us);
+
+    void update(uint16_t x, uint16_t y, uint32_t t_us);
+    void release();
+    bool isTracking();
+
+    // Feed one end-to-end pipeline latency measurement (EWMA, 1/8 weight)
+    void addLatencySample(uint32_t latency_us);
+    uint32_t latency();
+
+    bool filtered(uint16_t *x, uint16_t *y);
+    bool predict(uint16_t *x, uint16_t *y);
+    bool predict(uint32_t lead_us, uint16_t *x, uint16_t *y);
+    // Velocity in pixels per second
+    void velocity(int32_t *vx, int32_t *vy);
+
+private:
+    int32_t extrapolate(int32_t pos_q8, int32_t vel_q8, uint32_t lead_us, uint16_t max);
+
+    uint16_t _x_max, _y_max;
+    uint16_t _alpha_q8, _beta_q8;
+    uint32_t _max_lead_us;
+    uint32_t _latency_us;
+
+    bool _tracking;
+    uint32_t _last_t_us;
+    int32_t _x_q8, _y_q8;
+    int32_t _vx_q8, _vy_q8;
+};
+
+#endif
@@ -0,0 +1,203 @@
+#include <string.h>
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "../mem/pipeline_arena.h"
+#include "pipeline_trace.h"
+#ifdef ESP_PLATFORM
+#include "freertos/FreeRTOS.h"
+#endif
+
+static const char *TAG = "pipeline_trace";
+
+pipeline_trace pipeline_tracer;
+
+static inline uint8_t trace_context()
+{
+#ifdef ESP_PLATFORM
+    return (xPortGetCoreID() & 1) << 3 | (xPortInIsrContext() ? 1 : 0) << 4;
+#else
+    return 0;
+#endif
+}
+
+// CRC-32 (IEEE 802.3, as zlib), continued from *crc
+static void crc32_update(uint32_t *crc, const uint8_t *p, size_t len)
+{
+    uint32_t c = ~*crc;
+    while (len--) {
+        c ^= *p++;
+        for (int k = 0; k < 8; k++) {
+            c = (c >> 1) ^ (0xEDB88320u & (0u - (c & 1)));
+        }
+    }
+    *crc = ~c;
+}
+
+pipeline_trace::pipeline_trace()
+{
+    _ring = NULL;
+    _mask = 0;
+    _head = 0;
+    _on = false;
+    _record_ns = 0;
+    _dump_bytes = 0;
+}
+
+bool pipeline_trace::begin(size_t events)
+{
+    size_t capacity = 16;
+    while (capacity < events) {
+        capacity <<= 1;
+    }
+    end();
+    // Written from every task and the transfer-done interrupt, read only by dump(): PSRAM is fine
+    _ring = (trace_record_t *)pipeline_malloc_align(capacity * sizeof(trace_record_t), ARENA_PSRAM);
+    if (_ring == NULL) {
+        ESP_LOGW(TAG, "no memory for %u events", (unsigned)capacity);
+        return false;
+    }
+    _mask = capacity - 1;
+
+    // Price one record so the overhead of a trace can be stated next to it
+    _on = true;
+    uint32_t t = (uint32_t)esp_timer_get_time();
+    for (int i = 0; i < 256; i++) {
+        record(TRACE_SD_READ, TRACE_INSTANT, 0);
+    }
+    _record_ns = ((uint32_t)esp_timer_get_time() - t) * 1000 / 256;
+    clear();
+    return true;
+}
+
+void pipeline_trace::end()
+{
+    _on = false;
+    pipeline_free_align(_ring);
+    _ring = NULL;
+    _mask = 0;
+    _head = 0;
+}
+
+void pipeline_trace::clear()
+{
+    _head = 0;
+    _dump_bytes = 0;
+}
+
+void pipeline_trace::setEnabled(bool on)
+{
+    _on = on && _ring != NULL;
+}
+
+bool pipeline_trace::enabled()
+{
+    return _on;
+}
+
+void pipeline_trace::record(trace_event_t event, trace_phase_t phase, uint32_t arg)
+{
+    if (!_on) {
+        return;
+    }
+    uint32_t i = __atomic_fetch_add(&_head, 1, __ATOMIC_RELAXED);
+    trace_record_t *r = &_ring[i & _mask];
+    r->us = (uint32_t)esp_timer_get_time();
+    r->arg = arg > 0xFFFF ? 0xFFFF : arg;
+    r->event = event;
+    r->flags = phase | trace_context();
+}
+
+size_t pipeline_trace::emit(trace_write_cb_t write, void *ctx, const void *data, size_t len, uint32_t *crc)
+{
+    if (crc != NULL) {
+        crc32_update(crc, (const uint8_t *)data, len);
+    }
+    return write((const uint8_t *)data, len, ctx);
+}
+
+size_t pipeline_trace::dump(trace_write_cb_t write, void *ctx)
+{
+    uint8_t hdr[16];
+    uint32_t crc = 0;
+    size_t out = 0;
+
+    _on = false;
+    if (_ring == NULL || write == NULL) {
+        return 0;
+    }
+    uint32_t head = _head;
+    uint32_t capacity = _mask + 1;
+    uint32_t count = head < capacity ? head : capacity;
+    uint32_t overwritten = head - count;
+
+    memcpy(hdr, PIPELINE_TRACE_MAGIC, 4);
+    hdr[4] = PIPELINE_TRACE_VERSION;
+    hdr[5] = sizeof(trace_record_t);
+    hdr[6] = TRACE_EVENT_MAX;
+    hdr[7] = 0;
+    for (int k = 0; k < 4; k++) {
+        hdr[8 + k] = count >> (8 * k);
+        hdr[12 + k] = overwritten >> (8 * k);
+    }
+    out += emit(write, ctx, hdr, sizeof(hdr), &crc);
+    for (int e = 0; e < TRACE_EVENT_MAX; e++) {
+        const char *name = eventName((trace_event_t)e);
+        uint8_t len = strlen(name);
+        out += emit(write, ctx, &len, 1, &crc);
+        out += emit(write, ctx, name, len, &crc);
+    }
+
+    // Oldest first: the ring may wrap once between the oldest record and the end of the buffer
+    uint32_t first = overwritten & _mask;
+    uint32_t tail = capacity - first < count ? capacity - first : count;
+    out += emit(write, ctx, _ring + first, tail * sizeof(trace_record_t), &crc);
+    out += emit(write, ctx, _ring, (count - tail) * sizeof(trace_record_t), &crc);
+
+    uint8_t sum[4];
+    for (int k = 0; k < 4; k++) {
+        sum[k] = crc >> (8 * k);
+    }
+    out += emit(write, ctx, sum, sizeof(sum), NULL);
+    _dump_bytes = out;
+    return out;
+}
+
+trace_stats_t pipeline_trace::stats()
+{
+    trace_stats_t s;
+    uint32_t head = _head;
+    uint32_t capacity = _ring != NULL ? _mask + 1 : 0;
+    uint32_t count = head < capacity ? head : capacity;
+
+    s.recorded = head;
+    s.overwritten = head - count;
+    s.capacity = capacity;
+    s.span_us = count > 1 ? _ring[(head - 1) & _mask].us - _ring[(head - count) & _mask].us : 0;
+    s.record_ns = _record_ns;
+    s.dump_bytes = _dump_bytes;
+    return s;
+}
+
+const char *pipeline_trace::eventName(trace_event_t event)
+{
+    switch (event) {
+    case TRACE_SD_READ:
+        return "sd_read";
+    case TRACE_JPEG_HEADER:
+        return "jpeg_dec_parse_header";
+    case TRACE_JPEG_PROCESS:
+        return "jpeg_dec_process";
+    case TRACE_JPEG_CALLBACK:
+        return "draw_callback";
+    case TRACE_LCD_TX:
+        return "tx_color";
+    case TRACE_LCD_DMA:
+        return "lcd_dma";
+    case TRACE_LCD_WAIT:
+        return "lcd_wait";
+    case TRACE_TOUCH_READ:
+        return "touch_read";
+    default:
+        return "unknown";
+    }
+}
@@ -0,0 +1,113 @@
+#ifndef _PIPELINE_TRACE_H
+#define _PIPELINE_TRACE_H
+#include <stdint.h>
+#include <stddef.h>
+
+// Build with -DPIPELINE_TRACE=1 (build_opt.h next to the sketch) to record; the hooks compile to nothing otherwise
+#ifndef PIPELINE_TRACE
+#define PIPELINE_TRACE 0
+#endif
+
+#define PIPELINE_TRACE_EVENTS (4096) // default ring capacity, rounded up to a power of two
+#define PIPELINE_TRACE_MAGIC "PTRC"
+#define PIPELINE_TRACE_VERSION (1)
+
+typedef enum {
+    TRACE_SD_READ = 0,   // one chunk read from the SD card; arg: KB
+    TRACE_JPEG_HEADER,   // jpeg_dec_parse_header(); arg: image width
+    TRACE_JPEG_PROCESS,  // one jpeg_dec_process() call; arg: strip index
+    TRACE_JPEG_CALLBACK, // the draw callback for one strip; arg: lines
+    TRACE_LCD_TX,        // esp_lcd_nv3041a_tx_color() queueing a transfer; arg: KB
+    TRACE_LCD_DMA,       // async, a transfer from tx_color() to its done interrupt; arg: panel << 14 | number
+    TRACE_LCD_WAIT,      // blocked until queued transfers drain; arg: transfers allowed to stay queued
+    TRACE_TOUCH_READ,    // one GT911 read over I2C
+    TRACE_EVENT_MAX,
+} trace_event_t;
+
+typedef enum {
+    TRACE_BEGIN = 0,
+    TRACE_END,
+    TRACE_ASYNC_BEGIN, // pairs with the TRACE_ASYNC_END of the same event and arg, from any context
+    TRACE_ASYNC_END,
+    TRACE_INSTANT,
+} trace_phase_t;
+
+// One ring slot, also the record layout of a dump (little-endian)
+typedef struct {
+    uint32_t us;    // esp_timer_get_time(), low 32 bits
+    uint16_t arg;   // per event, saturated
+    uint8_t event;  // trace_event_t
+    uint8_t flags;  // trace_phase_t | core << 3 | from an interrupt << 4
+} trace_record_t;
+
+typedef struct {
+    uint32_t recorded;    // since clear(), overwritten ones included
+    uint32_t overwritten; // lost to the ring wrapping
+    uint32_t capacity;
+    uint32_t span_us;     // oldest to newest record in the ring
+    uint16_t record_ns;   // cost of one record(), measured by begin()
+    uint32_t dump_bytes;  // size of the last dump
+} trace_stats_t;
+
+// Sink for dump(); returns the bytes it took
+typedef size_t (*trace_write_cb_t)(const uint8_t *data, size_t len, void *ctx);
+
+/*
+ * Timeline of the decode/flush pipeline for Chrome's trace viewer and
+ * Perfetto.
+ *
+ * The hooks below put begin/end records with microsecond timestamps into a
+ * fixed ring, overwriting the oldest once it is full. A slot is claimed with
+ * one atomic add, so tasks on both cores and interrupt handlers record
+ * without a lock. dump() stops recording and writes the ring, oldest first,
+ * as a compact binary block that tools/trace_json turns into trace JSON:
+ *
+ *   "PTRC", version, record size, event count, 0, records (u32),
+ *   overwritten (u32), one length-prefixed name per event, the records,
+ *   CRC-32 of everything before it
+ *
+ * With PIPELINE_TRACE off none of this is referenced and costs nothing.
+ */
+class pipeline_trace
+{
+public:
+    pipeline_trace();
+
+    bool begin(size_t events = PIPELINE_TRACE_EVENTS);
+    void end();
+    void clear();
+    void setEnabled(bool on);
+    bool enabled();
+
+    void record(trace_event_t event, trace_phase_t phase, uint32_t arg);
+    size_t dump(trace_write_cb_t write, void *ctx);
+
+    trace_stats_t stats();
+    static const char *eventName(trace_event_t event);
+
+private:
+    size_t emit(trace_write_cb_t write, void *ctx, const void *data, size_t len, uint32_t *crc);
+
+    trace_record_t *_ring;
+    uint32_t _mask;
+    volatile uint32_t _head;
+    volatile bool _on;
+    uint16_t _record_ns;
+    uint32_t _dump_bytes;
+};
+
+extern pipeline_trace pipeline_tracer;
+
+#if PIPELINE_TRACE
+#define PIPELINE_TRACE_BEGIN(event, arg) pipeline_tracer.record((event), TRACE_BEGIN, (arg))
+#define PIPELINE_TRACE_END(event, arg) pipeline_tracer.record((event), TRACE_END, (arg))
+#define PIPELINE_TRACE_ASYNC_BEGIN(event, arg) pipeline_tracer.record((event), TRACE_ASYNC_BEGIN, (arg))
+#define PIPELINE_TRACE_ASYNC_END(event, arg) pipeline_tracer.record((event), TRACE_ASYNC_END, (arg))
+#else
+#define PIPELINE_TRACE_BEGIN(event, arg) do { } while (0)
+#define PIPELINE_TRACE_END(event, arg) do { } while (0)
+#define PIPELINE_TRACE_ASYNC_BEGIN(event, arg) do { } while (0)
+#define PIPELINE_TRACE_ASYNC_END(event, arg) do { } while (0)
+#endif
+
+#endif
@@ -0,0 +1,497 @@
+#include <string.h>
+#include "esp_timer.h"
+#include "../mem/pipeline_arena.h"
+#include "avi_demux.h"
+
+#define AVI_FCC(a, b, c, d) ((uint32_t)(a) | (uint32_t)(b) << 8 | (uint32_t)(c) << 16 | (uint32_t)(d) << 24)
+#define FCC_RIFF AVI_FCC('R', 'I', 'F', 'F')
+#define FCC_AVI AVI_FCC('A', 'V', 'I', ' ')
+#define FCC_LIST AVI_FCC('L', 'I', 'S', 'T')
+#define FCC_HDRL AVI_FCC('h', 'd', 'r', 'l')
+#define FCC_AVIH AVI_FCC('a', 'v', 'i', 'h')
+#define FCC_STRL AVI_FCC('s', 't', 'r', 'l')
+#define FCC_STRH AVI_FCC('s', 't', 'r', 'h')
+#define FCC_STRF AVI_FCC('s', 't', 'r', 'f')
+#define FCC_VIDS AVI_FCC('v', 'i', 'd', 's')
+#define FCC_AUDS AVI_FCC('a', 'u', 'd', 's')
+#define FCC_MOVI AVI_FCC('m', 'o', 'v', 'i')
+#define FCC_IDX1 AVI_FCC('i', 'd', 'x', '1')
+
+#define AVI_INDEX_ENTRY (16)
+#define AVI_INDEX_BLOCK (256) // idx1 entries per read
+#define AVI_INDEX_GROW (1024) // first table size, doubled as it fills
+
+static uint16_t le16(const uint8_t *p)
+{
+    return p[0] | p[1] << 8;
+}
+
+static uint32_t le32(const uint8_t *p)
+{
+    return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+// MJPG, AVRn and the like all name a Motion JPEG variant the block decoder takes frame by frame
+static bool is_mjpeg(uint32_t fcc)
+{
+    uint32_t upper = fcc & ~0x20202020u;
+    return upper == AVI_FCC('M', 'J', 'P', 'G') || upper == AVI_FCC('J', 'P', 'E', 'G') ||
+           upper == AVI_FCC('A', 'V', 'R', 'N') || upper == AVI_FCC('D', 'M', 'B', '1');
+}
+
+avi_demux::avi_demux()
+{
+    _reader = NULL;
+    _video = NULL;
+    _audio = NULL;
+    _audio_pos = NULL;
+    close();
+    resetStats();
+}
+
+avi_demux::~avi_demux()
+{
+    close();
+}
+
+void avi_demux::close()
+{
+    pipeline_free_align(_video);
+    pipeline_free_align(_audio);
+    pipeline_free_align(_audio_pos);
+    _video = NULL;
+    _audio = NULL;
+    _audio_pos = NULL;
+    _video_cap = 0;
+    _audio_cap = 0;
+    _reader = NULL;
+    _video_stream = -1;
+    _audio_stream = -1;
+    memset(&_info, 0, sizeof(_info));
+}
+
+avi_err_t avi_demux::open(avi_reader &reader)
+{
+    uint32_t t = (uint32_t)esp_timer_get_time();
+    uint8_t head[12];
+
+    close();
+    _reader = &reader;
+    if (!readAt(0, head, sizeof(head)) || le32(head) != FCC_RIFF || le32(head + 8) != FCC_AVI) {
+        close();
+        return AVI_ERR_NOT_AVI;
+    }
+    uint32_t riff_end = le32(head + 4) + 8;
+    // A writer that never got to close the file leaves the size at 0
+    riff_end = riff_end <= 12 || riff_end > reader.size() ? reader.size() : riff_end;
+
+    uint32_t movi = 0, movi_end = 0, idx1 = 0, idx1_size = 0;
+    avi_err_t err = parseHeaders(riff_end, &movi, &movi_end, &idx1, &idx1_size);
+    if (err == AVI_OK) {
+        uint32_t ti = (uint32_t)esp_timer_get_time();
+        err = idx1 != 0 ? indexFromIdx1(movi, idx1, idx1_size) : AVI_ERR_NO_FRAMES;
+        _info.indexed = err == AVI_OK;
+        if (err != AVI_OK && err != AVI_ERR_NO_MEM) {
+            // No index, or one that does not point at our chunks: find them the slow way
+            _info.frames = _info.audio_chunks = 0;
+            _info.audio_bytes = 0;
+            _info.max_frame = 0;
+            err = indexFromMovi(movi, movi_end);
+        }
+        _stats.index_us = (uint32_t)esp_timer_get_time() - ti;
+    }
+    if (err == AVI_OK && _info.frames == 0) {
+        err = AVI_ERR_NO_FRAMES;
+    }
+    if (err != AVI_OK) {
+        close();
+        return err;
+    }
+    _info.has_audio = _info.audio_chunks > 0 && _info.block_align > 0;
+    _stats.open_us = (uint32_t)esp_timer_get_time() - t;
+    return AVI_OK;
+}
+
+avi_info_t avi_demux::info()
+{
+    return _info;
+}
+
+bool avi_demux::videoChunk(uint32_t frame, avi_chunk_t *chunk)
+{
+    if (frame >= _info.frames) {
+        return false;
+    }
+    *chunk = _video[frame];
+    return true;
+}
+
+bool avi_demux::audioChunk(uint32_t index, avi_chunk_t *chunk)
+{
+    if (index >= _info.audio_chunks) {
+        return false;
+    }
+    *chunk = _audio[index];
+    return true;
+}
+
+bool avi_demux::audioAt(uint64_t pos, uint32_t *index, uint32_t *skip)
+{
+    if (pos >= _info.audio_bytes) {
+        return false;
+    }
+    // Last chunk starting at or before pos
+    uint32_t lo = 0, hi = _info.audio_chunks;
+    while (hi - lo > 1) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (_audio_pos[mid] <= pos) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    *index = lo;
+    *skip = (uint32_t)(pos - _audio_pos[lo]);
+    return true;
+}
+
+size_t avi_demux::read(const avi_chunk_t &chunk, uint32_t skip, void *buf, size_t len)
+{
+    if (_reader == NULL || skip >= chunk.size) {
+        return 0;
+    }
+    len = len < chunk.size - skip ? len : chunk.size - skip;
+    size_t got = _reader->read(chunk.offset + skip, buf, len);
+    _stats.reads++;
+    _stats.bytes += got;
+    return got;
+}
+
+avi_demux_stats_t avi_demux::stats()
+{
+    return _stats;
+}
+
+void avi_demux::resetStats()
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+const char *avi_demux::errName(avi_err_t err)
+{
+    switch (err) {
+    case AVI_OK:
+        return "ok";
+    case AVI_ERR_READ:
+        return "read failed";
+    case AVI_ERR_NOT_AVI:
+        return "not an AVI file";
+    case AVI_ERR_NO_VIDEO:
+        return "no video stream";
+    case AVI_ERR_CODEC:
+        return "video is not Motion JPEG";
+    case AVI_ERR_NO_FRAMES:
+        return "no video frames";
+    case AVI_ERR_NO_MEM:
+        return "out of memory";
+    default:
+        return "unknown";
+    }
+}
+
+bool avi_demux::readAt(uint32_t offset, void *buf, size_t len)
+{
+    size_t got = _reader->read(offset, buf, len);
+    _stats.reads++;
+    _stats.bytes += got;
+    return got == len;
+}
+
+// Chunk header at offset, whose data must end by `end`
+bool avi_demux::chunkAt(uint32_t offset, uint32_t end, riff_chunk_t *chunk)
+{
+    uint8_t h[8];
+    chunk->id = 0;
+    chunk->size = 0;
+    if (offset > end || end - offset < 8 || !readAt(offset, h, sizeof(h))) {
+        return false;
+    }
+    chunk->id = le32(h);
+    chunk->offset = offset;
+    chunk->size = le32(h + 4);
+    return chunk->size <= end - offset - 8;
+}
+
+avi_err_t avi_demux::parseHeaders(uint32_t riff_end, uint32_t *movi, uint32_t *movi_end, uint32_t *idx1, uint32_t *idx1_size)
+{
+    riff_chunk_t c;
+    uint8_t buf[40];
+    bool hdrl = false;
+    int stream = 0;
+
+    for (uint32_t pos = 12; pos < riff_end; pos += 8 + c.size + (c.size & 1)) {
+        uint32_t type = 0;
+        bool whole = chunkAt(pos, riff_end, &c);
+        if (c.id == FCC_LIST && !readAt(pos + 8, &type, 4)) {
+            type = 0;
+        }
+        if (!whole || (type == FCC_MOVI && c.size <= 4)) {
+            // A recording cut short: its movi list runs to the end of the file and nothing follows
+            if (type == FCC_MOVI) {
+                *movi = pos + 8;
+                *movi_end = riff_end;
+            }
+            break;
+        }
+        if (c.id == FCC_LIST && type == FCC_HDRL) {
+            hdrl = true;
+            uint32_t end = pos + 8 + c.size;
+            riff_chunk_t h;
+            for (uint32_t p = pos + 12; chunkAt(p, end, &h); p += 8 + h.size + (h.size & 1)) {
+                uint32_t list = 0;
+                if (h.id == FCC_AVIH && h.size >= 40 && readAt(p + 8, buf, 40)) {
+                    _info.frame_us = le32(buf);
+                    _info.width = (uint16_t)le32(buf + 32);
+                    _info.height = (uint16_t)le32(buf + 36);
+                } else if (h.id == FCC_LIST && h.size >= 4 && readAt(p + 8, &list, 4) && list == FCC_STRL) {
+                    avi_err_t err = parseStream(p + 12, p + 8 + h.size, stream++);
+                    if (err != AVI_OK) {
+                        return err;
+                    }
+                }
+            }
+        } else if (c.id == FCC_LIST && type == FCC_MOVI) {
+            *movi = pos + 8;
+            *movi_end = pos + 8 + c.size;
+        } else if (c.id == FCC_IDX1) {
+            *idx1 = pos + 8;
+            *idx1_size = c.size;
+        }
+    }
+    if (!hdrl || *movi == 0) {
+        return AVI_ERR_NOT_AVI;
+    }
+    if (_video_stream < 0) {
+        return AVI_ERR_NO_VIDEO;
+    }
+    return AVI_OK;
+}
+
+// One strl list: the first video and the first audio stream are kept
+avi_err_t avi_demux::parseStream(uint32_t offset, uint32_t end, int stream)
+{
+    riff_chunk_t c;
+    uint8_t strh[36];
+    uint8_t strf[20];
+    uint32_t type = 0, handler = 0, scale = 0, rate = 0;
+
+    for (uint32_t p = offset; chunkAt(p, end, &c); p += 8 + c.size + (c.size & 1)) {
+        if (c.id == FCC_STRH && c.size >= sizeof(strh) && readAt(p + 8, strh, sizeof(strh))) {
+            type = le32(strh);
+            handler = le32(strh + 4);
+            scale = le32(strh + 20);
+            rate = le32(strh + 24);
+        } else if (c.id == FCC_STRF && type == FCC_VIDS && _video_stream < 0 && c.size >= 20 &&
+                   readAt(p + 8, strf, 20)) {
+            if (!is_mjpeg(le32(strf + 16)) && !is_mjpeg(handler)) {
+                return AVI_ERR_CODEC;
+            }
+            _video_stream = stream;
+            int32_t w = (int32_t)le32(strf + 4), h = (int32_t)le32(strf + 8);
+            _info.width = (uint16_t)(w < 0 ? -w : w);
+            _info.height = (uint16_t)(h < 0 ? -h : h);
+            if (scale != 0 && rate != 0) {
+                _info.frame_us = (uint32_t)((uint64_t)scale * 1000000 / rate);
+            }
+        } else if (c.id == FCC_STRF && type == FCC_AUDS && _audio_stream < 0 && c.size >= 16 &&
+                   readAt(p + 8, strf, 16)) {
+            _audio_stream = stream;
+            _info.audio_format = le16(strf);
+            _info.channels = le16(strf + 2);
+            _info.sample_rate = le32(strf + 4);
+            _info.block_align = le16(strf + 12);
+            _info.bits = le16(strf + 14);
+        }
+    }
+    return AVI_OK;
+}
+
+// "NNdc"/"NNdb" is video and "NNwb" audio of stream NN
+int avi_demux::streamOf(uint32_t id, bool *video)
+{
+    uint8_t a = id & 0xFF, b = (id >> 8) & 0xFF;
+    uint16_t kind = id >> 16;
+    if (a < '0' || a > '9' || b < '0' || b > '9') {
+        return -1;
+    }
+    if (kind == ('d' | 'c' << 8) || kind == ('d' | 'b' << 8)) {
+        *video = true;
+    } else if (kind == ('w' | 'b' << 8)) {
+        *video = false;
+    } else {
+        return -1;
+    }
+    return (a - '0') * 10 + (b - '0');
+}
+
+bool avi_demux::add(bool video, uint32_t offset, uint32_t size)
+{
+    uint32_t n = video ? _info.frames : _info.audio_chunks;
+    uint32_t &cap = video ? _video_cap : _audio_cap;
+    if (n == cap) {
+        uint32_t grown = cap ? cap * 2 : AVI_INDEX_GROW;
+        avi_chunk_t *t = (avi_chunk_t *)pipeline_malloc_align(grown * sizeof(avi_chunk_t), ARENA_PSRAM);
+        uint64_t *pos = video ? NULL : (uint64_t *)pipeline_malloc_align(grown * sizeof(uint64_t), ARENA_PSRAM);
+        if (t == NULL || (!video && pos == NULL)) {
+            pipeline_free_align(t);
+            pipeline_free_align(pos);
+            return false;
+        }
+        avi_chunk_t *&table = video ? _video : _audio;
+        if (n > 0) {
+            memcpy(t, table, n * sizeof(avi_chunk_t));
+        }
+        pipeline_free_align(table);
+        table = t;
+        if (!video) {
+            if (n > 0) {
+                memcpy(pos, _audio_pos, n * sizeof(uint64_t));
+            }
+            pipeline_free_align(_audio_pos);
+            _audio_pos = pos;
+        }
+        cap = grown;
+    }
+    if (video) {
+        _video[n].offset = offset;
+        _video[n].size = size;
+        _info.frames++;
+        _info.max_frame = size > _info.max_frame ? size : _info.max_frame;
+    } else {
+        _audio[n].offset = offset;
+        _audio[n].size = size;
+        _audio_pos[n] = _info.audio_bytes;
+        _info.audio_bytes += size;
+        _info.audio_chunks++;
+    }
+    return true;
+}
+
+avi_err_t avi_demux::indexFromIdx1(uint32_t movi, uint32_t idx1, uint32_t idx1_size)
+{
+    uint8_t *block = (uint8_t *)pipeline_malloc_align(AVI_INDEX_BLOCK * AVI_INDEX_ENTRY, ARENA_INTERNAL);
+    uint32_t entries = idx1_size / AVI_INDEX_ENTRY;
+    uint32_t file_size = _reader->size();
+    int64_t base = -1;
+    avi_err_t err = AVI_OK;
+
+    if (block == NULL) {
+        return AVI_ERR_NO_MEM;
+    }
+    for (uint32_t i = 0; i < entries && err == AVI_OK; i += AVI_INDEX_BLOCK) {
+        uint32_t n = entries - i < AVI_INDEX_BLOCK ? entries - i : AVI_INDEX_BLOCK;
+        if (!readAt(idx1 + i * AVI_INDEX_ENTRY, block, n * AVI_INDEX_ENTRY)) {
+            // A truncated index still holds the frames before the cut
+            break;
+        }
+        for (uint32_t k = 0; k < n; k++) {
+            const uint8_t *e = block + k * AVI_INDEX_ENTRY;
+            uint32_t id = le32(e);
+            uint32_t off = le32(e + 8);
+            uint32_t size = le32(e + 12);
+            bool video = false;
+            int stream = streamOf(id, &video);
+            if (stream < 0 || stream != (video ? _video_stream : _audio_stream)) {
+                continue;
+            }
+            if (base < 0) {
+                // Offsets are meant to count from the "movi" tag, but some writers use file offsets
+                uint32_t tag = 0;
+                if (readAt(movi + off, &tag, 4) && tag == id) {
+                    base = movi;
+                } else if (readAt(off, &tag, 4) && tag == id) {
+                    base = 0;
+                } else {
+                    err = AVI_ERR_NO_FRAMES;
+                    break;
+                }
+            }
+            uint64_t data = (uint64_t)base + off + 8;
+            if (data + size > file_size) {
+                continue;
+            }
+            if (!add(video, (uint32_t)data, size)) {
+                err = AVI_ERR_NO_MEM;
+                break;
+            }
+        }
+    }
+    pipeline_free_align(block);
+    return err == AVI_OK && _info.frames == 0 ? AVI_ERR_NO_FRAMES : err;
+}
+
+avi_err_t avi_demux::indexFromMovi(uint32_t movi, uint32_t movi_end)
+{
+    riff_chunk_t c;
+    uint32_t end = movi_end > _reader->size() ? _reader->size() : movi_end;
+    uint32_t pos = movi + 4;
+
+    // Stops at the first chunk that does not fit, which is where a recording cut short ends
+    while (chunkAt(pos, end, &c)) {
+        bool video = false;
+        int stream = streamOf(c.id, &video);
+        if (c.id == FCC_LIST) {
+            // "rec " groups: step inside
+            pos += 12;
+            continue;
+        }
+        if (stream >= 0 && stream == (video ? _video_stream : _audio_stream) && !add(video, pos + 8, c.size)) {
+            return AVI_ERR_NO_MEM;
+        }
+        pos += 8 + c.size + (c.size & 1);
+    }
+    return _info.frames > 0 ? AVI_OK : AVI_ERR_NO_FRAMES;
+}
+
+#ifdef __linux__
+file_avi_reader::file_avi_reader(const char *path)
+    : _path(path)
+{
+    _size = 0;
+    _f = fopen(path, "rb");
+    if (_f != NULL && fseek(_f, 0, SEEK_END) == 0) {
+        long end = ftell(_f);
+        _size = end > 0 && end <= 0xFFFFFFFFL ? (uint32_t)end : 0;
+    }
+}
+
+file_avi_reader::~file_avi_reader()
+{
+    if (_f != NULL) {
+        fclose(_f);
+    }
+}
+
+bool file_avi_reader::ok()
+{
+    return _f != NULL && _size > 0;
+}
+
+size_t file_avi_reader::read(uint32_t offset, void *buf, size_t len)
+{
+    if (_f == NULL || fseek(_f, offset, SEEK_SET) != 0) {
+        return 0;
+    }
+    return fread(buf, 1, len, _f);
+}
+
+uint32_t file_avi_reader::size()
+{
+    return _size;
+}
+
+const char *file_avi_reader::name()
+{
+    return _path.c_str();
+}
+#endif
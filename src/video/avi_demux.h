@@ -0,0 +1,139 @@
+#ifndef _AVI_DEMUX_H
+#define _AVI_DEMUX_H
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+typedef enum {
+    AVI_OK = 0,
+    AVI_ERR_READ,       // short read, or a chunk runs past the end of the file
+    AVI_ERR_NOT_AVI,    // no RIFF "AVI " header, or no hdrl/movi list
+    AVI_ERR_NO_VIDEO,   // no video stream
+    AVI_ERR_CODEC,      // video that is not Motion JPEG
+    AVI_ERR_NO_FRAMES,  // neither idx1 nor the movi list hold a frame
+    AVI_ERR_NO_MEM,
+} avi_err_t;
+
+typedef struct {
+    uint16_t width;
+    uint16_t height;
+    uint32_t frame_us;       // from the video stream's rate and scale
+    uint32_t frames;         // video chunks in the index, empty ones included
+    uint32_t max_frame;      // largest video chunk, bytes
+    bool has_audio;          // an audio stream with chunks in the index
+    uint16_t audio_format;   // WAVE_FORMAT tag: 1 is PCM
+    uint16_t channels;
+    uint16_t bits;
+    uint16_t block_align;    // bytes per sample frame
+    uint32_t sample_rate;
+    uint32_t audio_chunks;
+    uint64_t audio_bytes;
+    bool indexed;            // chunk positions came from idx1, not a scan of movi
+} avi_info_t;
+
+typedef struct {
+    uint32_t offset;         // of the chunk data in the file
+    uint32_t size;
+} avi_chunk_t;
+
+typedef struct {
+    uint32_t open_us;        // headers and index
+    uint32_t index_us;       // of that, reading idx1 or scanning movi
+    uint32_t reads;
+    uint64_t bytes;
+} avi_demux_stats_t;
+
+// Random access to the file; read() returns the bytes it got
+class avi_reader
+{
+public:
+    virtual ~avi_reader() {}
+
+    virtual size_t read(uint32_t offset, void *buf, size_t len) = 0;
+    virtual uint32_t size() = 0;
+    virtual const char *name() = 0;
+};
+
+/*
+ * AVI (RIFF) container with Motion JPEG video and optional PCM audio.
+ *
+ * open() reads the stream headers from hdrl and turns the idx1 index into
+ * two flat tables, one per stream, in PSRAM: frame N of the video is entry N
+ * and audio entries carry the byte position they start at, so seeking costs
+ * one lookup for the video and a binary search for the audio, with no reads.
+ * Files without idx1 (a recording cut short) are indexed by walking the movi
+ * list once instead. Chunks of the first video stream and the first audio
+ * stream ("00dc" and "01wb" in the usual layout) are used, the rest skipped. OpenDML
+ * (AVI 2.0) files over 1 GB are read as far as their first RIFF.
+ */
+class avi_demux
+{
+public:
+    avi_demux();
+    ~avi_demux();
+
+    avi_err_t open(avi_reader &reader);
+    void close();
+    avi_info_t info();
+
+    bool videoChunk(uint32_t frame, avi_chunk_t *chunk);
+    bool audioChunk(uint32_t index, avi_chunk_t *chunk);
+    // Audio chunk holding byte `pos` of the audio stream, and how far into it that byte is
+    bool audioAt(uint64_t pos, uint32_t *index, uint32_t *skip);
+    // The bytes of a chunk, or the part from `skip` on that fits `len`
+    size_t read(const avi_chunk_t &chunk, uint32_t skip, void *buf, size_t len);
+
+    avi_demux_stats_t stats();
+    void resetStats();
+    static const char *errName(avi_err_t err);
+
+private:
+    typedef struct {
+        uint32_t id;
+        uint32_t offset;     // chunk header position in the file
+        uint32_t size;
+    } riff_chunk_t;
+
+    bool readAt(uint32_t offset, void *buf, size_t len);
+    bool chunkAt(uint32_t offset, uint32_t end, riff_chunk_t *chunk);
+    avi_err_t parseHeaders(uint32_t riff_end, uint32_t *movi, uint32_t *movi_end, uint32_t *idx1, uint32_t *idx1_size);
+    avi_err_t parseStream(uint32_t offset, uint32_t end, int stream);
+    avi_err_t indexFromIdx1(uint32_t movi, uint32_t idx1, uint32_t idx1_size);
+    avi_err_t indexFromMovi(uint32_t movi, uint32_t movi_end);
+    int streamOf(uint32_t id, bool *video);
+    bool add(bool video, uint32_t offset, uint32_t size);
+
+    avi_reader *_reader;
+    avi_info_t _info;
+    int _video_stream;
+    int _audio_stream;
+    avi_chunk_t *_video;
+    avi_chunk_t *_audio;
+    uint64_t *_audio_pos;    // audio byte position of each audio chunk
+    uint32_t _video_cap, _audio_cap;
+
+    avi_demux_stats_t _stats;
+};
+
+#ifdef __linux__
+// Host builds: a file read through stdio
+class file_avi_reader : public avi_reader
+{
+public:
+    file_avi_reader(const char *path);
+    ~file_avi_reader();
+
+    bool ok();
+    size_t read(uint32_t offset, void *buf, size_t len);
+    uint32_t size();
+    const char *name();
+
+private:
+    std::string _path;
+    FILE *_f;
+    uint32_t _size;
+};
+#endif
+
+#endif
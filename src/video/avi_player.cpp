@@ -0,0 +1,298 @@
+#include <string.h>
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "../mem/pipeline_arena.h"
+#include "../decode/jpeg_dht.h"
+#include "avi_player.h"
+
+#define WAVE_FORMAT_PCM (1)
+
+// The decoder callback has no context: the player whose frame is being decoded
+static avi_player *s_player = NULL;
+
+avi_player::avi_player()
+{
+    _audio = NULL;
+    _audio_master = false;
+    _audio_done = true;
+    memset(&_limits, 0, sizeof(_limits));
+    _frame = NULL;
+    _pcm = NULL;
+    _pcm_len = _pcm_pos = 0;
+    _audio_chunk = _audio_skip = 0;
+    _audio_sent = 0;
+    _next = 0;
+    _base_us = _start_us = 0;
+    _draw = NULL;
+    _open = false;
+    memset(&_info, 0, sizeof(_info));
+    resetStats();
+}
+
+avi_player::~avi_player()
+{
+    close();
+}
+
+avi_err_t avi_player::open(avi_reader &reader, audio_sink *audio)
+{
+    close();
+    avi_err_t err = _demux.open(reader);
+    if (err != AVI_OK) {
+        return err;
+    }
+    _info = _demux.info();
+    _frame = (uint8_t *)pipeline_malloc_align(JPEG_DHT_DEFAULT_SIZE + _info.max_frame, ARENA_PSRAM);
+    if (_frame == NULL) {
+        close();
+        return AVI_ERR_NO_MEM;
+    }
+    // Audio the sink can play; anything else is skipped and the video runs on its own
+    if (audio != NULL && _info.has_audio && _info.audio_format == WAVE_FORMAT_PCM && _info.bits == 16 &&
+        _info.channels >= 1 && _info.channels <= 2 && _info.block_align == 2 * _info.channels) {
+        // Only the CPU touches it, i2s_channel_write() copies into the DMA buffers
+        _pcm = (uint8_t *)pipeline_malloc_align(AVI_PLAYER_PCM_BUFFER, ARENA_PSRAM);
+        _audio = _pcm != NULL ? audio : NULL;
+    }
+    _open = true;
+    seek(0);
+    _stats.seeks = 0;
+    return AVI_OK;
+}
+
+void avi_player::close()
+{
+    if (_audio != NULL) {
+        _audio->stop();
+    }
+    _audio = NULL;
+    _audio_master = false;
+    _audio_done = true;
+    pipeline_free_align(_frame);
+    pipeline_free_align(_pcm);
+    _frame = NULL;
+    _pcm = NULL;
+    _demux.close();
+    _open = false;
+}
+
+avi_info_t avi_player::info()
+{
+    return _info;
+}
+
+void avi_player::setLimits(const jpeg_dec_limits_t *limits)
+{
+    if (limits != NULL) {
+        _limits = *limits;
+    } else {
+        memset(&_limits, 0, sizeof(_limits));
+    }
+}
+
+bool avi_player::seek(uint32_t ms)
+{
+    if (!_open) {
+        return false;
+    }
+    int64_t t = esp_timer_get_time();
+    uint32_t frame = _info.frame_us ? (uint32_t)((uint64_t)ms * 1000 / _info.frame_us) : 0;
+    _next = frame < _info.frames ? frame : _info.frames - 1;
+    _base_us = frameUs(_next);
+
+    _pcm_len = _pcm_pos = 0;
+    _audio_sent = 0;
+    _audio_master = false;
+    _audio_done = true;
+    if (_audio != NULL) {
+        // Whole sample frames from the frame's time on
+        uint64_t pos = (uint64_t)_base_us * _info.sample_rate / 1000000 * _info.block_align;
+        _audio->stop();
+        if (_demux.audioAt(pos, &_audio_chunk, &_audio_skip) && _audio->start(_info.sample_rate, _info.channels)) {
+            _audio_master = true;
+            _audio_done = false;
+        }
+    }
+    _start_us = esp_timer_get_time();
+    _stats.seeks++;
+    _stats.last_seek_us = (uint32_t)(_start_us - t);
+    return true;
+}
+
+bool avi_player::update(draw_cb_t draw)
+{
+    if (!_open) {
+        return false;
+    }
+    feedAudio(0);
+    if (_audio_master && _audio_done && _audio->played() >= _audio_sent) {
+        // The audio is over; the rest of the video keeps time on its own
+        freeRun();
+    }
+    int64_t now = clockUs();
+
+    // Every frame is a keyframe: skip the ones the clock has already passed
+    while (_next + 1 < _info.frames && frameUs(_next + 1) <= now) {
+        _next++;
+        _stats.dropped++;
+    }
+    if (_next >= _info.frames) {
+        if (!_audio_master) {
+            return false;
+        }
+        // The last frame is up; let the audio play out
+        if (_audio_done) {
+            vTaskDelay(pdMS_TO_TICKS(1));
+        } else {
+            feedAudio(10);
+        }
+        return true;
+    }
+
+    int64_t ahead = frameUs(_next) - now;
+    if (ahead > AVI_PLAYER_ON_TIME_US) {
+        int64_t t = esp_timer_get_time();
+        uint32_t ms = ahead / 1000 > 10 ? 10 : (uint32_t)(ahead / 1000);
+        if (_audio_master && !_audio_done) {
+            // Blocks in the sink until it has room, which is the audio clock moving on
+            feedAudio(ms);
+        } else {
+            vTaskDelay(pdMS_TO_TICKS(ms ? ms : 1));
+        }
+        _stats.wait_us += esp_timer_get_time() - t;
+        return true;
+    }
+    _draw = draw;
+    showFrame(_next++);
+    return true;
+}
+
+uint32_t avi_player::positionMs()
+{
+    return _open ? (uint32_t)(clockUs() / 1000) : 0;
+}
+
+uint32_t avi_player::nextFrame()
+{
+    return _next;
+}
+
+bool avi_player::audioClock()
+{
+    return _audio_master;
+}
+
+avi_player_stats_t avi_player::stats()
+{
+    return _stats;
+}
+
+void avi_player::resetStats()
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+int avi_player::stripCallback(jpeg_dec_io_t *jpeg_io, jpeg_dec_header_info_t *out_info)
+{
+    avi_player *p = s_player;
+    // Keep the audio going through a long decode
+    p->feedAudio(0);
+    return p->_draw(jpeg_io, out_info);
+}
+
+int64_t avi_player::frameUs(uint32_t frame)
+{
+    return (int64_t)frame * _info.frame_us;
+}
+
+int64_t avi_player::clockUs()
+{
+    if (_audio_master) {
+        return _base_us + (int64_t)(_audio->played() * 1000000 / _audio->rate());
+    }
+    return _base_us + (esp_timer_get_time() - _start_us);
+}
+
+void avi_player::freeRun()
+{
+    _base_us = clockUs();
+    _start_us = esp_timer_get_time();
+    _audio_master = false;
+}
+
+void avi_player::feedAudio(uint32_t timeout_ms)
+{
+    if (!_audio_master || _audio_done) {
+        return;
+    }
+    uint8_t fb = _audio->frameBytes();
+    while (true) {
+        if (_pcm_len - _pcm_pos < fb) {
+            avi_chunk_t c;
+            if (!_demux.audioChunk(_audio_chunk, &c)) {
+                _audio_done = true;
+                return;
+            }
+            // Whole sample frames, so a write never leaves half of one behind
+            size_t want = c.size - _audio_skip;
+            want = want < AVI_PLAYER_PCM_BUFFER ? want : AVI_PLAYER_PCM_BUFFER - AVI_PLAYER_PCM_BUFFER % fb;
+            size_t got = _demux.read(c, _audio_skip, _pcm, want);
+            _audio_skip += got;
+            if (got == 0 || _audio_skip >= c.size) {
+                _audio_chunk++;
+                _audio_skip = 0;
+            }
+            _pcm_len = got - got % fb;
+            _pcm_pos = 0;
+            continue;
+        }
+        size_t n = _audio->write(_pcm + _pcm_pos, _pcm_len - _pcm_pos, timeout_ms);
+        _pcm_pos += n;
+        _audio_sent += n / fb;
+        _stats.audio_bytes += n;
+        if (_pcm_len - _pcm_pos >= fb) {
+            // The sink is full
+            return;
+        }
+        timeout_ms = 0;
+    }
+}
+
+void avi_player::showFrame(uint32_t frame)
+{
+    avi_chunk_t c;
+    if (!_demux.videoChunk(frame, &c) || c.size == 0) {
+        _stats.repeated++;
+        return;
+    }
+    int32_t drift = (int32_t)(clockUs() - frameUs(frame));
+    _stats.last_drift_us = drift;
+    int32_t mag = drift < 0 ? -drift : drift;
+    _stats.max_drift_us = mag > _stats.max_drift_us ? mag : _stats.max_drift_us;
+    _stats.drift_sum_us += mag;
+
+    int64_t t = esp_timer_get_time();
+    size_t len = _demux.read(c, 0, _frame + JPEG_DHT_DEFAULT_SIZE, c.size);
+    int64_t t1 = esp_timer_get_time();
+    _stats.read_us += t1 - t;
+    if (len != c.size) {
+        _stats.failed++;
+        _stats.last_error = JPEG_DEC_ERR_SOURCE;
+        return;
+    }
+
+    jpeg_dht_result_t dht;
+    uint8_t *jpeg = jpeg_dht_fix(_frame, &len, &dht);
+    _stats.dht_inserted += dht == JPEG_DHT_MISSING;
+    s_player = this;
+    jpeg_dec_result_t r = esp_jpeg_decoder_block_out(jpeg, (int)len, stripCallback, &_limits);
+    s_player = NULL;
+    _stats.decode_us += esp_timer_get_time() - t1;
+    if (r != JPEG_DEC_OK) {
+        _stats.failed++;
+        _stats.last_error = r;
+        return;
+    }
+    _stats.shown++;
+}
@@ -0,0 +1,105 @@
+#ifndef _AVI_PLAYER_H
+#define _AVI_PLAYER_H
+#include <stdio.h>
+#include <ESP32_JPEG_Library.h>
+#include "../../jpeg_dec.h"
+#include "../audio/audio_sink.h"
+#include "avi_demux.h"
+
+#define AVI_PLAYER_PCM_BUFFER (8 * 1024) // audio read from the file per request
+#define AVI_PLAYER_ON_TIME_US (1000)     // a frame this close to its time is shown rather than waited for
+
+typedef struct {
+    uint32_t shown;
+    uint32_t dropped;         // skipped because the clock had already reached the next one
+    uint32_t repeated;        // empty chunks, which leave the previous frame up
+    uint32_t failed;          // frames that could not be read or decoded
+    jpeg_dec_result_t last_error;
+    uint32_t dht_inserted;    // frames decoded with the default Huffman tables
+    int32_t last_drift_us;    // clock minus frame time when the last frame started drawing
+    int32_t max_drift_us;     // largest magnitude of those
+    uint64_t drift_sum_us;    // of the magnitudes over the shown frames, for the mean
+    uint64_t read_us;
+    uint64_t decode_us;       // decode and flush to the panel
+    uint64_t wait_us;         // ahead of time, waiting for the clock
+    uint64_t audio_bytes;     // PCM handed to the sink
+    uint32_t seeks;
+    uint32_t last_seek_us;
+} avi_player_stats_t;
+
+/*
+ * Motion JPEG AVI playback with audio as the master clock.
+ *
+ * update() is called from loop(). It keeps the audio sink topped up, and
+ * shows the frame whose time the clock has reached: the clock is the count
+ * of samples the sink has played. When decoding falls behind, frames whose
+ * successor is already due are dropped without being read, which MJPEG
+ * allows since every frame stands alone; a frame ahead of the clock waits.
+ * The sink is also fed between strips while a frame decodes, so the audio
+ * buffer only has to cover one strip rather than one frame. Without audio
+ * (no sink, no audio stream, or audio that is not 16-bit PCM) and after the
+ * audio has run out, video keeps time by esp_timer. Frames whose DHT segments
+ * were left out get the standard tables (src/decode/jpeg_dht.h).
+ *
+ * seek() is one index lookup for the frame and a binary search for the
+ * audio; the sink is restarted so no stale audio plays. The decoder callback
+ * carries no user context, so only one avi_player may play at a time.
+ */
+class avi_player
+{
+public:
+    typedef int (*draw_cb_t)(jpeg_dec_io_t *jpeg_io, jpeg_dec_header_info_t *out_info);
+
+    avi_player();
+    ~avi_player();
+
+    avi_err_t open(avi_reader &reader, audio_sink *audio = NULL);
+    void close();
+    avi_info_t info();
+    // Decoder choice and budget per frame; NULL for the defaults
+    void setLimits(const jpeg_dec_limits_t *limits);
+
+    // Frame at or before `ms`, and the audio from that frame's time on
+    bool seek(uint32_t ms);
+    // False once the video and the audio have both finished
+    bool update(draw_cb_t draw);
+    uint32_t positionMs();
+    uint32_t nextFrame();
+    // Whether the audio is keeping time at the moment
+    bool audioClock();
+
+    avi_player_stats_t stats();
+    void resetStats();
+
+private:
+    static int stripCallback(jpeg_dec_io_t *jpeg_io, jpeg_dec_header_info_t *out_info);
+    int64_t frameUs(uint32_t frame);
+    int64_t clockUs();
+    void freeRun();
+    void feedAudio(uint32_t timeout_ms);
+    void showFrame(uint32_t frame);
+
+    avi_demux _demux;
+    avi_info_t _info;
+    audio_sink *_audio;       // NULL when the video keeps its own time
+    bool _audio_master;
+    bool _audio_done;         // every audio chunk handed to the sink
+    jpeg_dec_limits_t _limits;
+
+    uint8_t *_frame;          // JPEG_DHT_DEFAULT_SIZE of headroom, then the largest video chunk
+    uint8_t *_pcm;
+    uint32_t _pcm_len, _pcm_pos;
+    uint32_t _audio_chunk;    // next audio to read from the file
+    uint32_t _audio_skip;
+    uint64_t _audio_sent;     // sample frames written since the sink started
+
+    uint32_t _next;
+    int64_t _base_us;         // media time at which the clock started
+    int64_t _start_us;        // esp_timer then, for video on its own
+    draw_cb_t _draw;
+    bool _open;
+
+    avi_player_stats_t _stats;
+};
+
+#endif
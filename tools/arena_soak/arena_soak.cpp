@@ -0,0 +1,327 @@
+/*
+ * arena_soak: host soak of pipeline_arena (src/mem/pipeline_arena.h) under the sketch's allocation pattern.
+ *
+ *   g++ -O2 -I../host -o arena_soak arena_soak.cpp ../host/esp_jpeg_host.cpp \
+ *       ../host/host_runtime.cpp ../host/host_fs.cpp ../../src/mem/pipeline_arena.cpp \
+ *       ../../src/decode/image_source.cpp ../../src/decode/baseline_jpeg.cpp \
+ *       ../../src/decode/baseline_idct.cpp ../../src/decode/jpeg_thumb.cpp \
+ *       ../../src/sd/sd_loader.cpp ../../src/trace/pipeline_trace.cpp \
+ *       ../../src/gfx/strip_scaler.cpp ../../src/gfx/strip_blitter.cpp -ljpeg -lpthread
+ *   ./arena_soak [--passes 200] /tmp/arena_soak
+ *
+ * Writes a playlist of JPEGs under the given directory: the panel size, camera
+ * sizes up to 1600x1200 in 4:2:0, 4:2:2 and 4:4:4, and a truncated file. The
+ * arena is started with the sketch's ARENA_INTERNAL_SIZE and ARENA_PSRAM_SIZE
+ * and the resampler is begun once and kept, as in setup(). Each image is then
+ * played the way the slideshow does it: the next file is read through
+ * sd_loader (PSRAM buffer, internal staging chunk) while the current one is
+ * still held, the current one is decoded through jpeg_dec.h (output strip,
+ * and on odd passes the baseline decoder's planes) into the resampler, or into
+ * the blitter begun and ended around it for panel-sized images as the blit
+ * test does, and freed. Every fifth decode is cancelled part way through.
+ *
+ * After each pass over the playlist the held file is released and both
+ * regions are compared with their state after the first pass: bytes in use,
+ * free blocks and the largest free block must all be back where they were.
+ * No arena request, load or decode may fail for lack of memory either (only
+ * the truncated file may fail to decode). The exit code is 1 otherwise.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+#include <jpeglib.h>
+#include "FS.h"
+#include "../../jpeg_dec.h"
+#include "../../src/sd/sd_loader.h"
+#include "../../src/gfx/strip_scaler.h"
+#include "../../src/gfx/strip_blitter.h"
+
+#define SOAK_PANEL_W (480)
+#define SOAK_PANEL_H (272)
+#define SOAK_CANCEL_EVERY (5)
+
+typedef struct {
+    int w, h;
+    int h_samp; // luma sampling factors: 2x2 is 4:2:0, 2x1 4:2:2, 1x1 4:4:4
+    int v_samp;
+    bool truncate;
+} soak_image_t;
+
+static const soak_image_t s_images[] = {
+    {480, 272, 2, 2, false},
+    {640, 480, 2, 2, false},
+    {320, 240, 1, 1, false},
+    {1024, 768, 2, 1, false},
+    {1600, 1200, 2, 2, false},
+    {480, 272, 1, 1, false},
+    {800, 600, 2, 2, true},
+    {1280, 720, 2, 2, false},
+};
+#define SOAK_IMAGES (int)(sizeof(s_images) / sizeof(s_images[0]))
+
+typedef struct {
+    struct jpeg_error_mgr pub;
+    jmp_buf jmp;
+} enc_err_t;
+
+static strip_scaler s_scaler(SOAK_PANEL_W, SOAK_PANEL_H);
+static strip_blitter s_blitter(SOAK_PANEL_W, SOAK_PANEL_H);
+static blit_rotate_t s_rot;
+static volatile bool s_cancel;
+static int s_cancel_at;
+
+static void enc_error_exit(j_common_ptr cinfo)
+{
+    longjmp(((enc_err_t *)cinfo->err)->jmp, 1);
+}
+
+static bool write_jpeg(const std::string &path, const soak_image_t &img)
+{
+    std::vector<uint8_t> rgb((size_t)img.w * img.h * 3);
+    for (int y = 0; y < img.h; y++) {
+        for (int x = 0; x < img.w; x++) {
+            uint8_t *p = &rgb[((size_t)y * img.w + x) * 3];
+            p[0] = (uint8_t)(x * 255 / img.w);
+            p[1] = (uint8_t)(y * 255 / img.h);
+            p[2] = (uint8_t)((x ^ y) & 0xff);
+        }
+    }
+
+    unsigned char *mem = NULL;
+    unsigned long mem_len = 0;
+    struct jpeg_compress_struct cinfo;
+    enc_err_t err;
+    cinfo.err = jpeg_std_error(&err.pub);
+    err.pub.error_exit = enc_error_exit;
+    if (setjmp(err.jmp)) {
+        jpeg_destroy_compress(&cinfo);
+        free(mem);
+        return false;
+    }
+    jpeg_create_compress(&cinfo);
+    jpeg_mem_dest(&cinfo, &mem, &mem_len);
+    cinfo.image_width = img.w;
+    cinfo.image_height = img.h;
+    cinfo.input_components = 3;
+    cinfo.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, 85, TRUE);
+    cinfo.comp_info[0].h_samp_factor = img.h_samp;
+    cinfo.comp_info[0].v_samp_factor = img.v_samp;
+    jpeg_start_compress(&cinfo, TRUE);
+    while (cinfo.next_scanline < cinfo.image_height) {
+        JSAMPROW row = &rgb[(size_t)cinfo.next_scanline * img.w * 3];
+        jpeg_write_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+
+    // A cut-off file, as left by a copy that did not finish
+    size_t len = img.truncate ? mem_len / 2 : mem_len;
+    FILE *f = fopen(path.c_str(), "wb");
+    bool ok = f != NULL && fwrite(mem, 1, len, f) == len;
+    if (f != NULL && fclose(f) != 0) {
+        ok = false;
+    }
+    free(mem);
+    return ok;
+}
+
+static int panelStripCallback(void *ctx, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t *pixels)
+{
+    (void)ctx;
+    (void)x;
+    (void)y;
+    (void)w;
+    (void)h;
+    (void)pixels;
+    return 1;
+}
+
+// As jpegDrawCallback and jpegBlitCallback in the sketch: panel-sized images go to the blitter, others are resampled
+static int soakDrawCallback(jpeg_dec_io_t *jpeg_io, jpeg_dec_header_info_t *out_info)
+{
+    uint16_t y = jpeg_io->output_line - jpeg_io->cur_line;
+    if (s_cancel_at > 0 && jpeg_io->output_line >= s_cancel_at) {
+        s_cancel = true;
+    }
+    if (out_info->width == SOAK_PANEL_W && out_info->height == SOAK_PANEL_H) {
+        if (y == 0) {
+            uint16_t w, h;
+            strip_blitter::outputSize(out_info->width, out_info->height, s_rot, BLIT_SCALE_2, &w, &h);
+            if (!s_blitter.start(out_info->width, out_info->height, BLIT_SRC_RGB565_BE, BLIT_DST_RGB565_BE, s_rot,
+                                 BLIT_SCALE_2, (SOAK_PANEL_W - w) / 2, (SOAK_PANEL_H - h) / 2, panelStripCallback, NULL)) {
+                return 0;
+            }
+        }
+        return s_blitter.push(jpeg_io->outbuf, y, jpeg_io->cur_line) ? 1 : 0;
+    }
+    if (y == 0 && !s_scaler.start(out_info->width, out_info->height, SCALE_FIT, SCALE_AREA, panelStripCallback, NULL)) {
+        return 0;
+    }
+    return s_scaler.push((uint16_t *)jpeg_io->outbuf, y, jpeg_io->cur_line) ? 1 : 0;
+}
+
+static bool same_free_list(const arena_stats_t &a, const arena_stats_t &b)
+{
+    return a.used == b.used && a.free_blocks == b.free_blocks && a.largest_free == b.largest_free;
+}
+
+static void print_region(const char *name, const arena_stats_t &s)
+{
+    printf("%-9s %7zu KB  peak %7zu  used %7zu  free blocks %zu  largest %zu  frag %u.%u%%  allocs %u  failed %u\n", name,
+           s.size / 1024, s.peak, s.used, s.free_blocks, s.largest_free, s.frag_permille / 10, s.frag_permille % 10,
+           (unsigned)s.allocs, (unsigned)s.failed);
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [--passes N] DIR\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+    int passes = 200;
+    const char *root = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--passes") == 0 && i + 1 < argc) {
+            passes = atoi(argv[++i]);
+        } else if (argv[i][0] == '-') {
+            usage(argv[0]);
+            return 2;
+        } else {
+            root = argv[i];
+        }
+    }
+    if (root == NULL || passes < 2) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    mkdir(root, 0755);
+    std::vector<std::string> playlist;
+    for (int i = 0; i < SOAK_IMAGES; i++) {
+        char name[64];
+        const soak_image_t &img = s_images[i];
+        snprintf(name, sizeof(name), "/soak_%02d_%dx%d%s.jpg", i, img.w, img.h, img.truncate ? "_cut" : "");
+        playlist.push_back(std::string(root) + name);
+        if (!write_jpeg(playlist.back(), img)) {
+            fprintf(stderr, "failed to write %s\n", playlist.back().c_str());
+            return 1;
+        }
+    }
+
+    // As setup(): the regions, then the buffers that stay for the whole run
+    if (!pipeline_mem.begin(ARENA_INTERNAL_SIZE, ARENA_PSRAM_SIZE)) {
+        fprintf(stderr, "arena failed to start\n");
+        return 1;
+    }
+    if (!s_scaler.begin()) {
+        fprintf(stderr, "resampler buffers failed\n");
+        return 1;
+    }
+    fs::FS fs;
+    sd_loader loader(fs);
+
+    arena_stats_t base[ARENA_REGION_MAX];
+    uint32_t decoded = 0, cancelled = 0, errors = 0, load_failed = 0, no_mem = 0;
+    int drifted = 0;
+    uint8_t *held = NULL;
+    size_t held_len = 0;
+
+    for (int pass = 0; pass < passes; pass++) {
+        jpeg_dec_limits_t limits = {};
+        limits.cancel = &s_cancel;
+        limits.backend = pass % 2 ? JPEG_DEC_BACKEND_BASELINE : JPEG_DEC_BACKEND_LIBRARY;
+
+        for (int i = 0; i <= SOAK_IMAGES; i++) {
+            // Read the next image while the current one is still held, as the slideshow prefetches
+            uint8_t *next = NULL;
+            size_t next_len = 0;
+            if (i < SOAK_IMAGES) {
+                sd_load_err_t err = loader.load(playlist[i].c_str(), &next, &next_len);
+                if (err != SD_LOAD_OK) {
+                    fprintf(stderr, "pass %d: failed to load %s: %s\n", pass, playlist[i].c_str(), sd_loader::errName(err));
+                    load_failed++;
+                }
+            }
+            if (held != NULL) {
+                const soak_image_t &img = s_images[i - 1];
+                int n = pass * SOAK_IMAGES + i;
+                bool blit = img.w == SOAK_PANEL_W && img.h == SOAK_PANEL_H;
+                s_cancel = false;
+                s_cancel_at = n % SOAK_CANCEL_EVERY == 0 && !img.truncate ? 64 : 0;
+                s_rot = (blit_rotate_t)(n % BLIT_ROT_MAX);
+                if (blit && !s_blitter.begin()) {
+                    fprintf(stderr, "pass %d: blitter buffers failed\n", pass);
+                    no_mem++;
+                }
+                jpeg_dec_result_t r = esp_jpeg_decoder_block_out(held, (int)held_len, soakDrawCallback, &limits);
+                if (blit) {
+                    s_blitter.end();
+                }
+                if (r == JPEG_DEC_OK) {
+                    decoded++;
+                } else if (r == JPEG_DEC_STOPPED) {
+                    cancelled++;
+                } else if (r == JPEG_DEC_ERR_NO_MEM) {
+                    fprintf(stderr, "pass %d: no memory to decode %s\n", pass, playlist[i - 1].c_str());
+                    no_mem++;
+                } else {
+                    errors++;
+                }
+                pipeline_free_align(held);
+            }
+            held = next;
+            held_len = next_len;
+        }
+
+        // End of the playlist: nothing but the long-lived buffers is left
+        arena_stats_t now[ARENA_REGION_MAX];
+        for (int r = 0; r < ARENA_REGION_MAX; r++) {
+            now[r] = pipeline_mem.stats((arena_region_t)r);
+        }
+        if (pass == 0) {
+            // The first pass also sets up sd_loader's staging chunk, which stays
+            memcpy(base, now, sizeof(base));
+            continue;
+        }
+        for (int r = 0; r < ARENA_REGION_MAX; r++) {
+            if (!same_free_list(now[r], base[r])) {
+                fprintf(stderr, "pass %d: %s region drifted: used %zu (was %zu), %zu free blocks (was %zu), largest %zu (was %zu)\n",
+                        pass, r == ARENA_INTERNAL ? "internal" : "psram", now[r].used, base[r].used, now[r].free_blocks,
+                        base[r].free_blocks, now[r].largest_free, base[r].largest_free);
+                drifted++;
+            }
+        }
+    }
+
+    arena_stats_t in = pipeline_mem.stats(ARENA_INTERNAL);
+    arena_stats_t ps = pipeline_mem.stats(ARENA_PSRAM);
+    printf("%d passes over %d images: %u decoded, %u cancelled, %u decode errors (expected %d), %u load failures\n", passes,
+           SOAK_IMAGES, (unsigned)decoded, (unsigned)cancelled, (unsigned)errors, passes, (unsigned)load_failed);
+    print_region("internal", in);
+    print_region("psram", ps);
+
+    int rc = 0;
+    if (drifted) {
+        fprintf(stderr, "free list did not return to its state after the first pass %d times\n", drifted);
+        rc = 1;
+    }
+    if (in.failed || ps.failed || load_failed || no_mem) {
+        fprintf(stderr, "arena requests failed: internal %u, psram %u; %u loads failed, %u decodes out of memory\n",
+                (unsigned)in.failed, (unsigned)ps.failed, (unsigned)load_failed, (unsigned)no_mem);
+        rc = 1;
+    }
+    if (errors != (uint32_t)passes) {
+        // Only the truncated file may fail to decode, once per pass
+        fprintf(stderr, "%u decode errors, expected %d\n", (unsigned)errors, passes);
+        rc = 1;
+    }
+    return rc;
+}
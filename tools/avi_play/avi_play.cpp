@@ -0,0 +1,546 @@
+/*
+ * avi_play: host run of the AVI/MJPEG player against a simulated I2S clock.
+ *
+ *   g++ -O2 -I../host -o avi_play avi_play.cpp ../host/esp_jpeg_host.cpp \
+ *       ../host/host_runtime.cpp ../host/host_audio_sink.cpp \
+ *       ../../src/mem/pipeline_arena.cpp ../../src/decode/image_source.cpp \
+ *       ../../src/decode/baseline_jpeg.cpp ../../src/decode/baseline_idct.cpp \
+ *       ../../src/decode/jpeg_dht.cpp ../../src/trace/pipeline_trace.cpp \
+ *       ../../src/audio/audio_sink.cpp ../../src/video/avi_demux.cpp \
+ *       ../../src/video/avi_player.cpp ../../src/gfx/strip_scaler.cpp -ljpeg -lpthread
+ *   ./avi_play --gen clip.avi --seconds 10 --fps 30 --no-dht 2
+ *   ./avi_play --gen small.avi --size 320x240
+ *   ./avi_play clip.avi
+ *   ./avi_play --ppm 500 --decode-us 50000 --seek-at 3000 --seek 8000 clip.avi
+ *
+ * --gen writes a test clip: moving frames encoded by libjpeg at 4:2:0, 480x272
+ * like the README's ffmpeg command unless --size says otherwise, a 16-bit
+ * stereo tone chunked one video frame at a time, and an idx1 index (--no-index
+ * leaves it out, so the player has to scan movi). --no-dht N strips the DHT
+ * segments from every Nth frame, as MJPEG cameras do; each stripped frame is
+ * checked to decode, once src/decode/jpeg_dht.h has put the default tables
+ * back, to the very same pixels as the original, with the in-tree decoder,
+ * which does not fall back to the standard tables itself.
+ *
+ * Playing runs in pipeline_mem started with the sketch's region sizes, with the
+ * internal buffers the sketch holds meanwhile: the SD staging chunk, and the
+ * resampler's strips unless the video is panel-sized, in which case the sketch
+ * releases them and frames go straight out; other sizes are resampled as on
+ * the device. A decode that runs out of internal RAM fails the frame.
+ * The audio goes to tools/host/host_audio_sink, which drains at the
+ * sample rate off the host clock, --ppm off nominal. --decode-us makes each
+ * frame take that long to draw, so the player has to drop frames to keep up.
+ * The report gives the A/V drift of the frames shown (clock minus frame time
+ * when drawing started), frames dropped, audio underruns and the seek time;
+ * the exit code is 1 if a frame failed or the drift went past --max-drift-ms,
+ * one frame interval unless given.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <setjmp.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <jpeglib.h>
+#include "esp_timer.h"
+#include "host_audio_sink.h"
+#include "../../jpeg_dec.h"
+#include "../../pins_config.h"
+#include "../../src/decode/jpeg_dht.h"
+#include "../../src/gfx/strip_scaler.h"
+#include "../../src/video/avi_demux.h"
+#include "../../src/video/avi_player.h"
+
+#define SD_STAGING_SIZE (16 * 1024) // sd_loader's default chunk, held while the file plays
+
+typedef struct {
+    struct jpeg_error_mgr pub;
+    jmp_buf jmp;
+} enc_err_t;
+
+static void enc_error_exit(j_common_ptr cinfo)
+{
+    longjmp(((enc_err_t *)cinfo->err)->jmp, 1);
+}
+
+// Default quality and no optimize_coding, so the tables libjpeg writes are the T.81 K.3 ones
+static bool encode(const std::vector<uint8_t> &rgb, int w, int h, std::vector<uint8_t> &out)
+{
+    struct jpeg_compress_struct cinfo;
+    enc_err_t err;
+    unsigned char *mem = NULL;
+    unsigned long mem_len = 0;
+
+    cinfo.err = jpeg_std_error(&err.pub);
+    err.pub.error_exit = enc_error_exit;
+    if (setjmp(err.jmp)) {
+        jpeg_destroy_compress(&cinfo);
+        free(mem);
+        return false;
+    }
+    jpeg_create_compress(&cinfo);
+    jpeg_mem_dest(&cinfo, &mem, &mem_len);
+    cinfo.image_width = w;
+    cinfo.image_height = h;
+    cinfo.input_components = 3;
+    cinfo.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, 80, TRUE);
+    jpeg_start_compress(&cinfo, TRUE);
+    while (cinfo.next_scanline < cinfo.image_height) {
+        JSAMPROW row = (JSAMPROW)&rgb[(size_t)cinfo.next_scanline * w * 3];
+        jpeg_write_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+    out.assign(mem, mem + mem_len);
+    free(mem);
+    return true;
+}
+
+// The frame with its DHT segments cut out; libjpeg writes no fill bytes between segments
+static std::vector<uint8_t> strip_dht(const std::vector<uint8_t> &jpeg)
+{
+    std::vector<uint8_t> out(jpeg.begin(), jpeg.begin() + 2);
+    size_t p = 2;
+    while (p + 4 <= jpeg.size() && jpeg[p] == 0xFF && jpeg[p + 1] != 0xDA) {
+        size_t seg = 2 + ((jpeg[p + 2] << 8) | jpeg[p + 3]);
+        if (jpeg[p + 1] != 0xC4) {
+            out.insert(out.end(), jpeg.begin() + p, jpeg.begin() + p + seg);
+        }
+        p += seg;
+    }
+    out.insert(out.end(), jpeg.begin() + p, jpeg.end());
+    return out;
+}
+
+static std::vector<uint8_t> s_pixels;
+
+static int checkDrawCallback(jpeg_dec_io_t *jpeg_io, jpeg_dec_header_info_t *out_info)
+{
+    int y = jpeg_io->output_line - jpeg_io->cur_line;
+    s_pixels.resize((size_t)out_info->width * out_info->height * 2);
+    memcpy(&s_pixels[(size_t)y * out_info->width * 2], jpeg_io->outbuf, (size_t)jpeg_io->cur_line * out_info->width * 2);
+    return 1;
+}
+
+static jpeg_dec_result_t decode(uint8_t *data, size_t len, std::vector<uint8_t> &pixels)
+{
+    jpeg_dec_limits_t limits = {};
+    limits.backend = JPEG_DEC_BACKEND_BASELINE;
+    s_pixels.clear();
+    jpeg_dec_result_t r = esp_jpeg_decoder_block_out(data, (int)len, checkDrawCallback, &limits);
+    pixels.swap(s_pixels);
+    return r;
+}
+
+// Stripped, then mended by jpeg_dht_fix(): the pixels must not change
+static bool check_dht(const std::vector<uint8_t> &jpeg, const std::vector<uint8_t> &stripped)
+{
+    std::vector<uint8_t> want, got;
+    std::vector<uint8_t> orig(jpeg);
+    if (decode(orig.data(), orig.size(), want) != JPEG_DEC_OK) {
+        return false;
+    }
+    uint8_t *buf = (uint8_t *)pipeline_malloc_align(JPEG_DHT_DEFAULT_SIZE + stripped.size(), ARENA_PSRAM);
+    memcpy(buf + JPEG_DHT_DEFAULT_SIZE, stripped.data(), stripped.size());
+    size_t len = stripped.size();
+    jpeg_dht_result_t dht;
+    uint8_t *fixed = jpeg_dht_fix(buf, &len, &dht);
+    jpeg_dec_result_t r = decode(fixed, len, got);
+    pipeline_free_align(buf);
+    return dht == JPEG_DHT_MISSING && r == JPEG_DEC_OK && got == want;
+}
+
+static void put16(std::vector<uint8_t> &out, uint16_t v)
+{
+    out.push_back(v & 0xFF);
+    out.push_back(v >> 8);
+}
+
+static void put32(std::vector<uint8_t> &out, uint32_t v)
+{
+    put16(out, v & 0xFFFF);
+    put16(out, v >> 16);
+}
+
+static void fourcc(std::vector<uint8_t> &out, const char *cc)
+{
+    out.insert(out.end(), cc, cc + 4);
+}
+
+static void set32(std::vector<uint8_t> &out, size_t at, uint32_t v)
+{
+    for (int i = 0; i < 4; i++) {
+        out[at + i] = (v >> (8 * i)) & 0xFF;
+    }
+}
+
+// Opens a LIST or RIFF; returns where its size goes, for close_list()
+static size_t open_list(std::vector<uint8_t> &out, const char *id, const char *type)
+{
+    fourcc(out, id);
+    size_t at = out.size();
+    put32(out, 0);
+    fourcc(out, type);
+    return at;
+}
+
+static void close_list(std::vector<uint8_t> &out, size_t at)
+{
+    set32(out, at, (uint32_t)(out.size() - at - 4));
+}
+
+static void chunk(std::vector<uint8_t> &out, const char *id, const uint8_t *data, size_t len)
+{
+    fourcc(out, id);
+    put32(out, (uint32_t)len);
+    out.insert(out.end(), data, data + len);
+    if (len & 1) {
+        out.push_back(0);
+    }
+}
+
+static int generate(const char *path, int w, int h, int seconds, int fps, int rate, int no_dht, bool index)
+{
+    const int channels = 2, block_align = 2 * channels;
+    const int frames = seconds * fps;
+    std::vector<uint8_t> rgb((size_t)w * h * 3);
+    std::vector<uint8_t> avi;
+    std::vector<uint8_t> idx;
+    size_t stripped = 0, checked_bad = 0, max_frame = 0;
+
+    size_t riff = open_list(avi, "RIFF", "AVI ");
+    size_t hdrl = open_list(avi, "LIST", "hdrl");
+    fourcc(avi, "avih");
+    put32(avi, 56);
+    size_t avih = avi.size();
+    put32(avi, 1000000 / fps);
+    put32(avi, 0);
+    put32(avi, 0);
+    put32(avi, index ? 0x10 : 0); // AVIF_HASINDEX
+    put32(avi, frames);
+    put32(avi, 0);
+    put32(avi, 2);
+    put32(avi, 0);
+    put32(avi, w);
+    put32(avi, h);
+    for (int i = 0; i < 4; i++) {
+        put32(avi, 0);
+    }
+
+    size_t strl = open_list(avi, "LIST", "strl");
+    fourcc(avi, "strh");
+    put32(avi, 56);
+    fourcc(avi, "vids");
+    fourcc(avi, "MJPG");
+    put32(avi, 0);
+    put32(avi, 0);
+    put32(avi, 0);
+    put32(avi, 1);       // scale
+    put32(avi, fps);     // rate
+    put32(avi, 0);
+    put32(avi, frames);
+    put32(avi, 0);
+    put32(avi, 0xFFFFFFFF);
+    put32(avi, 0);
+    put16(avi, 0);
+    put16(avi, 0);
+    put16(avi, w);
+    put16(avi, h);
+    fourcc(avi, "strf");
+    put32(avi, 40);
+    put32(avi, 40);
+    put32(avi, w);
+    put32(avi, h);
+    put16(avi, 1);
+    put16(avi, 24);
+    fourcc(avi, "MJPG");
+    put32(avi, w * h * 3);
+    for (int i = 0; i < 4; i++) {
+        put32(avi, 0);
+    }
+    close_list(avi, strl);
+
+    strl = open_list(avi, "LIST", "strl");
+    fourcc(avi, "strh");
+    put32(avi, 56);
+    fourcc(avi, "auds");
+    put32(avi, 0);
+    put32(avi, 0);
+    put32(avi, 0);
+    put32(avi, 0);
+    put32(avi, block_align);
+    put32(avi, rate * block_align);
+    put32(avi, 0);
+    put32(avi, (uint32_t)((uint64_t)frames * rate / fps));
+    put32(avi, 0);
+    put32(avi, 0xFFFFFFFF);
+    put32(avi, block_align);
+    for (int i = 0; i < 4; i++) {
+        put16(avi, 0);
+    }
+    fourcc(avi, "strf");
+    put32(avi, 18);
+    put16(avi, 1);       // WAVE_FORMAT_PCM
+    put16(avi, channels);
+    put32(avi, rate);
+    put32(avi, rate * block_align);
+    put16(avi, block_align);
+    put16(avi, 16);
+    put16(avi, 0);
+    close_list(avi, strl);
+    close_list(avi, hdrl);
+
+    size_t movi = open_list(avi, "LIST", "movi");
+    size_t movi_base = movi + 4; // idx1 offsets count from the "movi" type
+    uint64_t samples = 0;
+    std::vector<uint8_t> jpeg, pcm;
+    for (int f = 0; f < frames; f++) {
+        // A sweep across the frame, a box going round and a bar per second
+        int bx = (int)(w / 2 - 24 + cos(f * 0.1) * (w / 3)), by = (int)(h / 2 - 24 + sin(f * 0.1) * (h / 3));
+        for (int y = 0; y < h; y++) {
+            for (int x = 0; x < w; x++) {
+                uint8_t *p = &rgb[((size_t)y * w + x) * 3];
+                bool box = x >= bx && x < bx + 48 && y >= by && y < by + 48;
+                bool bar = y >= h - 12 && x < (f % fps + 1) * w / fps;
+                p[0] = box || bar ? 255 : (uint8_t)(x + f * 4);
+                p[1] = box || bar ? 255 : (uint8_t)(y * 255 / h);
+                p[2] = box || bar ? 255 : (uint8_t)(f * 255 / frames);
+            }
+        }
+        if (!encode(rgb, w, h, jpeg)) {
+            fprintf(stderr, "frame %d: encode failed\n", f);
+            return 1;
+        }
+        if (no_dht > 0 && f % no_dht == 0) {
+            std::vector<uint8_t> cut = strip_dht(jpeg);
+            checked_bad += !check_dht(jpeg, cut);
+            jpeg.swap(cut);
+            stripped++;
+        }
+        max_frame = jpeg.size() > max_frame ? jpeg.size() : max_frame;
+        fourcc(idx, "00dc");
+        put32(idx, 0x10); // AVIIF_KEYFRAME
+        put32(idx, (uint32_t)(avi.size() - movi_base));
+        put32(idx, (uint32_t)jpeg.size());
+        chunk(avi, "00dc", jpeg.data(), jpeg.size());
+
+        // The audio for this frame's interval: 440 Hz left, 660 Hz right
+        uint64_t until = (uint64_t)(f + 1) * rate / fps;
+        pcm.clear();
+        for (; samples < until; samples++) {
+            double t = (double)samples / rate;
+            put16(pcm, (uint16_t)(int16_t)(8000 * sin(2 * M_PI * 440 * t)));
+            put16(pcm, (uint16_t)(int16_t)(8000 * sin(2 * M_PI * 660 * t)));
+        }
+        fourcc(idx, "01wb");
+        put32(idx, 0);
+        put32(idx, (uint32_t)(avi.size() - movi_base));
+        put32(idx, (uint32_t)pcm.size());
+        chunk(avi, "01wb", pcm.data(), pcm.size());
+    }
+    close_list(avi, movi);
+    if (index) {
+        chunk(avi, "idx1", idx.data(), idx.size());
+    }
+    close_list(avi, riff);
+    set32(avi, avih + 28, (uint32_t)max_frame);
+
+    FILE *f = fopen(path, "wb");
+    if (f == NULL || fwrite(avi.data(), 1, avi.size(), f) != avi.size()) {
+        fprintf(stderr, "%s: write failed\n", path);
+        if (f != NULL) {
+            fclose(f);
+        }
+        return 1;
+    }
+    fclose(f);
+    printf("%s: %dx%d, %d frames at %d fps, %d Hz stereo, %zu bytes, %s\n", path, w, h, frames, fps, rate, avi.size(),
+           index ? "idx1" : "no index");
+    if (stripped) {
+        printf("dht: %zu frames stripped, %zu decoded differently with the default tables\n", stripped, checked_bad);
+    }
+    return checked_bad ? 1 : 0;
+}
+
+static uint32_t s_decode_us;
+static strip_scaler s_fit(LCD_H_RES, LCD_V_RES);
+
+static int scaledStripCallback(void *, uint16_t, uint16_t, uint16_t, uint16_t, uint16_t *)
+{
+    return 1;
+}
+
+// What the sketch's jpegDrawCallback does with the strip, less the panel
+static int playDrawCallback(jpeg_dec_io_t *jpeg_io, jpeg_dec_header_info_t *out_info)
+{
+    // A slower panel or decoder: this strip's share of the frame time
+    if (s_decode_us && out_info->height > 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds((uint64_t)s_decode_us * jpeg_io->cur_line / out_info->height));
+    }
+    if (out_info->width == LCD_H_RES && out_info->height == LCD_V_RES) {
+        return 1;
+    }
+    uint16_t y = jpeg_io->output_line - jpeg_io->cur_line;
+    if (y == 0 && !s_fit.start(out_info->width, out_info->height, SCALE_FIT, SCALE_AREA, scaledStripCallback, NULL)) {
+        return 0;
+    }
+    return s_fit.push((uint16_t *)jpeg_io->outbuf, y, jpeg_io->cur_line) ? 1 : 0;
+}
+
+static void usage()
+{
+    fprintf(stderr,
+            "usage: avi_play --gen OUT.avi [--size WxH] [--seconds N] [--fps N] [--rate HZ] [--no-dht N] [--no-index]\n"
+            "       avi_play [--ppm N] [--buffer-ms N] [--decode-us N] [--seek-at MS --seek MS]\n"
+            "                [--backend library|baseline] [--no-audio] [--max-drift-ms N] FILE.avi\n");
+}
+
+int main(int argc, char **argv)
+{
+    const char *gen = NULL, *path = NULL;
+    int width = LCD_H_RES, height = LCD_V_RES, seconds = 10, fps = 30, rate = 44100, no_dht = 0;
+    bool index = true, audio = true;
+    int32_t ppm = 0;
+    uint16_t buffer_ms = 100;
+    int64_t seek_at = -1;
+    uint32_t seek_ms = 0;
+    double max_drift_ms = -1;
+    jpeg_dec_limits_t limits = {};
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--gen") == 0 && i + 1 < argc) {
+            gen = argv[++i];
+        } else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%dx%d", &width, &height) != 2) {
+                usage();
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            fps = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+            rate = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--no-dht") == 0 && i + 1 < argc) {
+            no_dht = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--no-index") == 0) {
+            index = false;
+        } else if (strcmp(argv[i], "--ppm") == 0 && i + 1 < argc) {
+            ppm = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--buffer-ms") == 0 && i + 1 < argc) {
+            buffer_ms = (uint16_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--decode-us") == 0 && i + 1 < argc) {
+            s_decode_us = (uint32_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seek-at") == 0 && i + 1 < argc) {
+            seek_at = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seek") == 0 && i + 1 < argc) {
+            seek_ms = (uint32_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--backend") == 0 && i + 1 < argc) {
+            i++;
+            limits.backend = strcmp(argv[i], "baseline") == 0 ? JPEG_DEC_BACKEND_BASELINE : JPEG_DEC_BACKEND_LIBRARY;
+        } else if (strcmp(argv[i], "--no-audio") == 0) {
+            audio = false;
+        } else if (strcmp(argv[i], "--max-drift-ms") == 0 && i + 1 < argc) {
+            max_drift_ms = atof(argv[++i]);
+        } else if (argv[i][0] == '-') {
+            usage();
+            return 2;
+        } else {
+            path = argv[i];
+        }
+    }
+    if (gen != NULL) {
+        if (width < 48 || height < 48 || width > 4096 || height > 4096 || seconds <= 0 || fps <= 0 || rate <= 0) {
+            usage();
+            return 2;
+        }
+        return generate(gen, width, height, seconds, fps, rate, no_dht, index);
+    }
+    if (path == NULL) {
+        usage();
+        return 2;
+    }
+
+    file_avi_reader file(path);
+    if (!file.ok()) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return 1;
+    }
+    if (!pipeline_mem.begin(ARENA_INTERNAL_SIZE, ARENA_PSRAM_SIZE)) {
+        fprintf(stderr, "arena reservation failed\n");
+        return 1;
+    }
+    void *staging = pipeline_malloc_align(SD_STAGING_SIZE, ARENA_INTERNAL);
+    bool fit = s_fit.begin();
+    host_audio_sink sink(buffer_ms, ppm);
+    avi_player player;
+    avi_err_t err = player.open(file, audio ? &sink : NULL);
+    if (err != AVI_OK || staging == NULL || !fit) {
+        fprintf(stderr, "%s: %s\n", path, err != AVI_OK ? avi_demux::errName(err) : "no internal RAM for the sketch's buffers");
+        return 1;
+    }
+    player.setLimits(&limits);
+    avi_info_t info = player.info();
+    if (info.width == LCD_H_RES && info.height == LCD_V_RES) {
+        s_fit.end();
+    }
+    printf("%s: %ux%u, %u frames at %.3f ms, largest %u bytes, %s", path, info.width, info.height, info.frames,
+           info.frame_us / 1000.0, info.max_frame, info.indexed ? "idx1" : "movi scanned");
+    if (info.has_audio) {
+        printf(", audio %u Hz x%u %u-bit (format %u)", info.sample_rate, info.channels, info.bits, info.audio_format);
+    }
+    printf("\nclock: %s", player.audioClock() ? "audio" : "esp_timer");
+    if (player.audioClock()) {
+        printf(" (host sink, %+d ppm, %u ms buffer)", ppm, buffer_ms);
+    }
+    printf(", %s decoder\n", jpeg_dec_backend_name(limits.backend));
+
+    int64_t t0 = esp_timer_get_time();
+    bool seeked = false;
+    while (player.update(playDrawCallback)) {
+        if (seek_at >= 0 && !seeked && player.positionMs() >= seek_at) {
+            player.seek(seek_ms);
+            seeked = true;
+        }
+    }
+    double wall_s = (esp_timer_get_time() - t0) / 1e6;
+
+    avi_player_stats_t s = player.stats();
+    audio_sink_stats_t a = sink.stats();
+    uint32_t drawn = s.shown ? s.shown : 1;
+    printf("played %.2f s\n", wall_s);
+    printf("frames: %u shown, %u dropped, %u repeated, %u failed", s.shown, s.dropped, s.repeated, s.failed);
+    if (s.failed) {
+        printf(" (%s)", jpeg_dec_result_name(s.last_error));
+    }
+    printf(", %u with the default Huffman tables\n", s.dht_inserted);
+    printf("drift: mean %.2f ms, max %.2f ms, last %.2f ms\n", s.drift_sum_us / 1000.0 / drawn, s.max_drift_us / 1000.0,
+           s.last_drift_us / 1000.0);
+    printf("per frame: read %.0f us, decode %.0f us; waited %.2f s for the clock\n", (double)s.read_us / drawn,
+           (double)s.decode_us / drawn, s.wait_us / 1e6);
+    if (player.audioClock() || s.audio_bytes) {
+        printf("audio: %llu bytes in %u writes, %u underruns, %u ms silence\n", (unsigned long long)s.audio_bytes,
+               a.writes, a.underruns, a.silence_ms);
+    }
+    if (seeked) {
+        printf("seek: to %u ms in %u us\n", seek_ms, s.last_seek_us);
+    }
+    arena_stats_t in = pipeline_mem.stats(ARENA_INTERNAL);
+    printf("internal arena: peak %u of %u bytes, %u requests went to the heap\n", (unsigned)in.peak, (unsigned)in.size, in.failed);
+
+    if (max_drift_ms < 0) {
+        max_drift_ms = info.frame_us / 1000.0;
+    }
+    bool ok = s.failed == 0 && s.max_drift_us / 1000.0 <= max_drift_ms;
+    if (!ok) {
+        printf("FAIL: %s\n", s.failed ? "frames failed to decode" : "drift past --max-drift-ms");
+    }
+    player.close();
+    s_fit.end();
+    pipeline_free_align(staging);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,248 @@
+/*
+ * blit_bench: check and time the specialised strip blitters (src/gfx/strip_blitter.h).
+ *
+ *   g++ -O2 -I../host -o blit_bench blit_bench.cpp ../../src/gfx/strip_blitter.cpp \
+ *       ../../src/mem/pipeline_arena.cpp ../host/host_runtime.cpp -lpthread
+ *   ./blit_bench [--strip 16] [--frames 20]
+ *
+ * Every combination of source format, destination format, rotation and scale
+ * is run on synthetic images pushed a strip at a time, placed so that some are
+ * clipped on every side of the panel. The panel each one leaves behind has to
+ * match, byte for byte, a per-pixel reference that maps every source pixel
+ * forward, and the same image through the generic runtime-switched loop. The
+ * benchmark then reports output megapixels per second of the specialised and
+ * the generic loop for each combination. Returns non-zero if a check fails.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "../../src/gfx/strip_blitter.h"
+
+#define OUT_W (480)
+#define OUT_H (272)
+#define UNTOUCHED (0x5AA5)
+
+typedef struct {
+    uint16_t frame[OUT_W * OUT_H];
+    uint32_t strips;
+} canvas_t;
+
+static int draw(void *ctx, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t *pixels)
+{
+    canvas_t *c = (canvas_t *)ctx;
+    if (x + w > OUT_W || y + h > OUT_H) {
+        return 0;
+    }
+    for (uint16_t r = 0; r < h; r++) {
+        memcpy(c->frame + (y + r) * OUT_W + x, pixels + r * w, w * 2);
+    }
+    c->strips++;
+    return 1;
+}
+
+static void clear(canvas_t *c)
+{
+    for (int i = 0; i < OUT_W * OUT_H; i++) {
+        c->frame[i] = UNTOUCHED;
+    }
+    c->strips = 0;
+}
+
+static int bytes_per_pixel(blit_src_t src)
+{
+    return src == BLIT_SRC_RGB888 ? 3 : 2;
+}
+
+// Test image: every byte depends on the position, so a pixel taken from the wrong place shows
+static void source_image(std::vector<uint8_t> &img, int w, int h, blit_src_t src)
+{
+    int bpp = bytes_per_pixel(src);
+    img.resize((size_t)w * h * bpp);
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            uint32_t v = (uint32_t)(x * 2654435761u) ^ (uint32_t)(y * 40503u) ^ (uint32_t)(x + y * 7);
+            for (int b = 0; b < bpp; b++) {
+                img[((size_t)y * w + x) * bpp + b] = (uint8_t)(v >> (b * 8));
+            }
+        }
+    }
+}
+
+static uint16_t reference_pixel(const uint8_t *p, blit_src_t src, blit_dst_t dst)
+{
+    uint16_t c;
+    if (src == BLIT_SRC_RGB565_BE) {
+        c = p[0] << 8 | p[1];
+    } else if (src == BLIT_SRC_RGB565_LE) {
+        c = p[0] | p[1] << 8;
+    } else {
+        c = (p[0] & 0xF8) << 8 | (p[1] & 0xFC) << 3 | p[2] >> 3;
+    }
+    return dst == BLIT_DST_RGB565_BE ? (uint16_t)(c >> 8 | c << 8) : c;
+}
+
+// Forward map of every kept source pixel to the panel
+static void reference(canvas_t *c, const std::vector<uint8_t> &img, int w, int h, blit_src_t src, blit_dst_t dst,
+                      blit_rotate_t rot, blit_scale_t scale, int x, int y)
+{
+    clear(c);
+    int k = 1 << scale, bpp = bytes_per_pixel(src);
+    int sw = w >> scale, sh = h >> scale;
+    for (int v = 0; v < sh; v++) {
+        for (int u = 0; u < sw; u++) {
+            int px, py;
+            if (rot == BLIT_ROT_0) {
+                px = u;
+                py = v;
+            } else if (rot == BLIT_ROT_90) {
+                px = sh - 1 - v;
+                py = u;
+            } else if (rot == BLIT_ROT_180) {
+                px = sw - 1 - u;
+                py = sh - 1 - v;
+            } else {
+                px = v;
+                py = sw - 1 - u;
+            }
+            px += x;
+            py += y;
+            if (px < 0 || py < 0 || px >= OUT_W || py >= OUT_H) {
+                continue;
+            }
+            c->frame[py * OUT_W + px] = reference_pixel(&img[((size_t)v * k * w + u * k) * bpp], src, dst);
+        }
+    }
+}
+
+static bool blit(strip_blitter &b, canvas_t *c, const std::vector<uint8_t> &img, int w, int h, blit_src_t src,
+                 blit_dst_t dst, blit_rotate_t rot, blit_scale_t scale, int x, int y, int strip, bool generic)
+{
+    clear(c);
+    b.setGeneric(generic);
+    if (!b.start(w, h, src, dst, rot, scale, x, y, draw, c)) {
+        return false;
+    }
+    size_t stride = (size_t)w * bytes_per_pixel(src);
+    for (int r = 0; r < h; r += strip) {
+        if (!b.push(&img[r * stride], r, h - r < strip ? h - r : strip)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static const char *src_name[] = {"565be", "565le", "888"};
+static const char *dst_name[] = {"565be", "565le"};
+static const char *rot_name[] = {"0", "90", "180", "270"};
+
+int main(int argc, char **argv)
+{
+    int strip = 16;
+    int frames = 20;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--strip") == 0 && i + 1 < argc) {
+            strip = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: blit_bench [--strip 16] [--frames 20]\n");
+            return 2;
+        }
+    }
+    if (strip < 1 || frames < 1) {
+        fprintf(stderr, "bad arguments\n");
+        return 2;
+    }
+
+    strip_blitter b(OUT_W, OUT_H, 16);
+    if (!b.begin()) {
+        fprintf(stderr, "blitter: out of memory\n");
+        return 1;
+    }
+    canvas_t *want = (canvas_t *)malloc(sizeof(canvas_t));
+    canvas_t *fast = (canvas_t *)malloc(sizeof(canvas_t));
+    canvas_t *slow = (canvas_t *)malloc(sizeof(canvas_t));
+    int failures = 0;
+
+    // Size and placement: whole panel, clipped on every side, a corner, odd sizes off the scale grid
+    static const int cases[][4] = {
+        {480, 272, 0, 0}, {800, 480, -37, -21}, {123, 77, 400, 250}, {1001, 603, -300, 20}, {67, 301, -5, -40},
+    };
+    static const int heights[] = {1, 7, 16};
+    std::vector<uint8_t> img;
+    printf("checks, specialised and generic against the reference:\n");
+    for (int s = 0; s < BLIT_SRC_MAX; s++) {
+        for (int d = 0; d < BLIT_DST_MAX; d++) {
+            int bad = 0, runs = 0;
+            for (int r = 0; r < BLIT_ROT_MAX; r++) {
+                for (int k = 0; k < BLIT_SCALE_MAX; k++) {
+                    for (size_t n = 0; n < sizeof(cases) / sizeof(cases[0]); n++) {
+                        int w = cases[n][0], h = cases[n][1], x = cases[n][2], y = cases[n][3];
+                        source_image(img, w, h, (blit_src_t)s);
+                        reference(want, img, w, h, (blit_src_t)s, (blit_dst_t)d, (blit_rotate_t)r, (blit_scale_t)k, x, y);
+                        for (size_t t = 0; t < sizeof(heights) / sizeof(heights[0]); t++) {
+                            bool ok = blit(b, fast, img, w, h, (blit_src_t)s, (blit_dst_t)d, (blit_rotate_t)r,
+                                           (blit_scale_t)k, x, y, heights[t], false) &&
+                                      blit(b, slow, img, w, h, (blit_src_t)s, (blit_dst_t)d, (blit_rotate_t)r,
+                                           (blit_scale_t)k, x, y, heights[t], true) &&
+                                      memcmp(fast->frame, want->frame, sizeof(want->frame)) == 0 &&
+                                      memcmp(slow->frame, want->frame, sizeof(want->frame)) == 0;
+                            if (!ok && bad++ == 0) {
+                                printf("  %dx%d at %d,%d rotated %s scaled 1/%d, %d-row strips: differs\n", w, h, x,
+                                       y, rot_name[r], 1 << k, heights[t]);
+                            }
+                            runs++;
+                        }
+                    }
+                }
+            }
+            printf("  %-5s -> %-5s %s (%d of %d runs differ)\n", src_name[s], dst_name[d], bad ? "FAIL" : "ok", bad,
+                   runs);
+            failures += bad ? 1 : 0;
+        }
+    }
+
+    // Source sized so that the rotated, scaled image covers the panel exactly
+    printf("\noutput MP/s, specialised / generic, %d-row input strips:\n", strip);
+    printf("  %-14s %-5s", "", "scale");
+    for (int r = 0; r < BLIT_ROT_MAX; r++) {
+        printf(" %15s", rot_name[r]);
+    }
+    printf("\n");
+    double sum_fast = 0, sum_slow = 0;
+    for (int s = 0; s < BLIT_SRC_MAX; s++) {
+        for (int d = 0; d < BLIT_DST_MAX; d++) {
+            for (int k = 0; k < BLIT_SCALE_MAX; k++) {
+                printf("  %-5s -> %-5s  1/%d  ", src_name[s], dst_name[d], 1 << k);
+                for (int r = 0; r < BLIT_ROT_MAX; r++) {
+                    bool turned = r == BLIT_ROT_90 || r == BLIT_ROT_270;
+                    int w = (turned ? OUT_H : OUT_W) << k, h = (turned ? OUT_W : OUT_H) << k;
+                    source_image(img, w, h, (blit_src_t)s);
+                    double mps[2];
+                    for (int g = 0; g < 2; g++) {
+                        b.resetStats();
+                        for (int n = 0; n < frames; n++) {
+                            blit(b, fast, img, w, h, (blit_src_t)s, (blit_dst_t)d, (blit_rotate_t)r, (blit_scale_t)k, 0,
+                                 0, strip, g == 1);
+                        }
+                        strip_blit_stats_t st = b.stats();
+                        mps[g] = st.blit_us ? (double)st.out_pixels / st.blit_us : 0.0;
+                    }
+                    sum_fast += mps[0];
+                    sum_slow += mps[1];
+                    printf(" %7.1f/%-7.1f", mps[0], mps[1]);
+                }
+                printf("\n");
+            }
+        }
+    }
+    int combos = BLIT_SRC_MAX * BLIT_DST_MAX * BLIT_ROT_MAX * BLIT_SCALE_MAX;
+    printf("  mean over %d combinations: %.1f / %.1f MP/s, %.2fx\n", combos, sum_fast / combos, sum_slow / combos,
+           sum_slow > 0 ? sum_fast / sum_slow : 0.0);
+
+    free(want);
+    free(fast);
+    free(slow);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,126 @@
+/*
+ * font_pack: render a TrueType font into an anti-aliased strip_font_t (src/gfx/strip_font.h).
+ *
+ *   g++ -O2 -I/usr/include/freetype2 -o font_pack font_pack.cpp -lfreetype
+ *   ./font_pack [--notice "Lato: Copyright ..."] Lato-Regular.ttf 20 0x20 0x7e font_lato_20 font_lato_20.cpp
+ *
+ * Glyphs are hinted at the given pixel size, quantised to 4-bit coverage and
+ * written as a C++ source with the font constant `name`; add a matching extern
+ * to strip_font.h. The notice, if given, is copied into the header comment of
+ * the generated file, for fonts whose license asks for it.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <vector>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+typedef struct {
+    uint32_t offset;
+    int w, h;
+    int x_off, y_off;
+    int advance;
+} glyph_t;
+
+int main(int argc, char **argv)
+{
+    const char *notice = NULL;
+    int arg = 1;
+    if (arg + 1 < argc && strcmp(argv[arg], "--notice") == 0) {
+        notice = argv[arg + 1];
+        arg += 2;
+    }
+    if (argc - arg != 6) {
+        fprintf(stderr, "usage: font_pack [--notice TEXT] font.ttf size first last name out.cpp\n");
+        return 2;
+    }
+    const char *path = argv[arg];
+    int size = atoi(argv[arg + 1]);
+    int first = (int)strtol(argv[arg + 2], NULL, 0);
+    int last = (int)strtol(argv[arg + 3], NULL, 0);
+    const char *name = argv[arg + 4];
+    const char *out_path = argv[arg + 5];
+    if (size <= 0 || size > 200 || first < 0x20 || last > 0xFF || first > last) {
+        fprintf(stderr, "bad size or character range\n");
+        return 2;
+    }
+
+    FT_Library lib;
+    FT_Face face;
+    if (FT_Init_FreeType(&lib) != 0 || FT_New_Face(lib, path, 0, &face) != 0) {
+        fprintf(stderr, "%s: cannot load font\n", path);
+        return 1;
+    }
+    FT_Set_Pixel_Sizes(face, 0, size);
+    int ascender = (face->size->metrics.ascender + 63) >> 6;
+    int descender = (-face->size->metrics.descender + 63) >> 6;
+    int height = ascender + descender;
+
+    std::vector<glyph_t> glyphs;
+    std::vector<uint8_t> bitmap;
+    for (int c = first; c <= last; c++) {
+        glyph_t g = {};
+        g.offset = bitmap.size();
+        if (FT_Load_Char(face, c, FT_LOAD_RENDER | FT_LOAD_TARGET_LIGHT) == 0) {
+            FT_GlyphSlot slot = face->glyph;
+            const FT_Bitmap &bm = slot->bitmap;
+            g.w = bm.width;
+            g.h = bm.rows;
+            g.x_off = slot->bitmap_left;
+            g.y_off = ascender - slot->bitmap_top;
+            g.advance = (slot->advance.x + 32) >> 6;
+            for (int y = 0; y < g.h; y++) {
+                const uint8_t *row = bm.buffer + y * bm.pitch;
+                for (int x = 0; x < g.w; x += 2) {
+                    uint8_t hi = (row[x] * 15 + 127) / 255;
+                    uint8_t lo = x + 1 < g.w ? (row[x + 1] * 15 + 127) / 255 : 0;
+                    bitmap.push_back((hi << 4) | lo);
+                }
+            }
+        }
+        if (g.w > 255 || g.h > 255 || g.advance > 255 || g.x_off < -128 || g.x_off > 127 || g.y_off < -128 || g.y_off > 127) {
+            fprintf(stderr, "glyph 0x%02x does not fit the format at this size\n", c);
+            return 1;
+        }
+        glyphs.push_back(g);
+    }
+
+    FILE *f = fopen(out_path, "w");
+    if (f == NULL) {
+        fprintf(stderr, "%s: cannot write\n", out_path);
+        return 1;
+    }
+    const char *base = strrchr(path, '/');
+    fprintf(f, "// Generated by tools/font_pack from %s at %d px, characters 0x%02x..0x%02x.\n", base ? base + 1 : path, size, first, last);
+    if (notice != NULL) {
+        fprintf(f, "// %s\n", notice);
+    }
+    fprintf(f, "#include \"../strip_font.h\"\n\n");
+    fprintf(f, "static const uint8_t bitmap[] = {\n");
+    for (size_t i = 0; i < bitmap.size(); i++) {
+        fprintf(f, "%s0x%02x,%s", i % 16 == 0 ? "    " : "", bitmap[i], (i % 16 == 15 || i + 1 == bitmap.size()) ? "\n" : " ");
+    }
+    if (bitmap.empty()) {
+        fprintf(f, "    0x00,\n");
+    }
+    fprintf(f, "};\n\nstatic const strip_glyph_t glyphs[] = {\n");
+    for (size_t i = 0; i < glyphs.size(); i++) {
+        const glyph_t &g = glyphs[i];
+        int c = first + (int)i;
+        fprintf(f, "    {%u, %d, %d, %d, %d, %d}, // ", g.offset, g.w, g.h, g.x_off, g.y_off, g.advance);
+        if (c == '\\') {
+            fprintf(f, "backslash\n");
+        } else {
+            fprintf(f, "'%c'\n", c);
+        }
+    }
+    fprintf(f, "};\n\nconst strip_font_t %s = {0x%02x, 0x%02x, %d, %d, glyphs, bitmap};\n", name, first, last, height, ascender);
+    fclose(f);
+
+    printf("%s: %d glyphs, line height %d, baseline %d, %zu bitmap bytes\n", name, last - first + 1, height, ascender, bitmap.size());
+    FT_Done_Face(face);
+    FT_Done_FreeType(lib);
+    return 0;
+}
@@ -0,0 +1,9 @@
+/* Host stand-in: the Arduino timing calls used by the portable modules */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
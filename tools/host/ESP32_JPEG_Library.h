@@ -0,0 +1,77 @@
+/*
+ * Host stand-in for the ESP32_JPEG_Library block-decode API, backed by libjpeg.
+ *
+ * Only the subset used by jpeg_dec.h is provided. jpeg_dec_process() follows the
+ * block contract of the device library: each call writes one MCU row (8 or 16
+ * lines) into io->outbuf, sets io->cur_line and advances io->output_line.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    JPEG_ERR_OK = 0,
+    JPEG_ERR_FAIL = -1,
+    JPEG_ERR_MEM = -2,
+    JPEG_ERR_NO_MORE_DATA = -3,
+    JPEG_ERR_INVALID_PARAM = -4,
+    JPEG_ERR_BAD_DATA = -5,
+    JPEG_ERR_UNSUPPORT_FMT = -6,
+    JPEG_ERR_UNSUPPORT_STD = -7,
+} jpeg_error_t;
+
+typedef enum {
+    JPEG_RAW_TYPE_RGB565_LE = 0,
+    JPEG_RAW_TYPE_RGB565_BE = 1,
+    JPEG_RAW_TYPE_RGB888 = 2,
+} jpeg_raw_type_t;
+
+typedef struct {
+    jpeg_raw_type_t output_type;
+    int rotate;
+    int block_enable;
+} jpeg_dec_config_t;
+
+#define DEFAULT_JPEG_DEC_CONFIG() { \
+    .output_type = JPEG_RAW_TYPE_RGB565_BE, \
+    .rotate = 0, \
+    .block_enable = 0, \
+}
+
+typedef struct {
+    unsigned char *inbuf;
+    int inbuf_len;
+    int inbuf_remain;
+    unsigned char *outbuf;
+    int out_size;
+    int output_line;
+    int cur_line;
+    int output_height;
+} jpeg_dec_io_t;
+
+typedef struct {
+    int width;
+    int height;
+    int component_num;
+    uint8_t x_factory[3];
+    uint8_t y_factory[3];
+} jpeg_dec_header_info_t;
+
+typedef void *jpeg_dec_handle_t;
+
+jpeg_dec_handle_t *jpeg_dec_open(jpeg_dec_config_t *config);
+jpeg_error_t jpeg_dec_parse_header(jpeg_dec_handle_t *jpeg_dec, jpeg_dec_io_t *io, jpeg_dec_header_info_t *out_info);
+jpeg_error_t jpeg_dec_process(jpeg_dec_handle_t *jpeg_dec, jpeg_dec_io_t *io);
+jpeg_error_t jpeg_dec_close(jpeg_dec_handle_t *jpeg_dec);
+
+void *jpeg_malloc_align(int size, int aligned);
+void jpeg_free_align(void *data);
+
+#ifdef __cplusplus
+}
+#endif
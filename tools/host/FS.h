@@ -0,0 +1,64 @@
+/*
+ * Host stand-in for the Arduino FS/File classes, backed by stdio and dirent.
+ *
+ * Paths are host paths. setReadDelay() makes every read() sleep first, so a
+ * test can keep a load in flight while another thread changes things under it.
+ * Modes are fopen() modes; "r" and "r+" need the file to exist, "w" and "w+"
+ * create it.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+#include <memory>
+#include <string>
+
+namespace fs {
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+struct host_file_t;
+
+class File
+{
+public:
+    File();
+
+    operator bool() const;
+    size_t size();
+    size_t read(uint8_t *buf, size_t len);
+    size_t write(const uint8_t *buf, size_t len);
+    void flush();
+    bool seek(uint32_t pos, SeekMode mode = SeekSet);
+    size_t position();
+    time_t getLastWrite();
+    bool isDirectory();
+    const char *name();
+    const char *path();
+    File openNextFile();
+    void close();
+
+private:
+    friend class FS;
+    std::shared_ptr<host_file_t> _f;
+};
+
+class FS
+{
+public:
+    FS();
+
+    File open(const char *path, const char *mode = "r", bool create = false);
+    bool exists(const char *path);
+    bool remove(const char *path);
+    bool rename(const char *from, const char *to);
+    void setReadDelay(uint32_t us);
+
+private:
+    uint32_t _read_delay_us;
+};
+
+}
+
+using fs::File;
@@ -0,0 +1,171 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <vector>
+#include <jpeglib.h>
+#include "ESP32_JPEG_Library.h"
+
+typedef struct {
+    struct jpeg_error_mgr pub;
+    jmp_buf jmp;
+} host_err_t;
+
+typedef struct {
+    struct jpeg_decompress_struct cinfo;
+    host_err_t err;
+    jpeg_dec_config_t config;
+    bool created;
+    bool started;
+    bool corrupt;
+    int block_lines;
+    std::vector<uint8_t> row;
+} host_dec_t;
+
+static void host_error_exit(j_common_ptr cinfo)
+{
+    host_err_t *err = (host_err_t *)cinfo->err;
+    longjmp(err->jmp, 1);
+}
+
+static void host_output_message(j_common_ptr cinfo)
+{
+    (void)cinfo;
+}
+
+// libjpeg only warns about corrupt or truncated data and carries on; the device decoder fails instead
+static void host_emit_message(j_common_ptr cinfo, int msg_level)
+{
+    if (msg_level < 0) {
+        ((host_dec_t *)cinfo)->corrupt = true;
+    }
+}
+
+jpeg_dec_handle_t *jpeg_dec_open(jpeg_dec_config_t *config)
+{
+    if (config == NULL) {
+        return NULL;
+    }
+    host_dec_t *dec = new host_dec_t();
+    dec->config = *config;
+    dec->cinfo.err = jpeg_std_error(&dec->err.pub);
+    dec->err.pub.error_exit = host_error_exit;
+    dec->err.pub.output_message = host_output_message;
+    dec->err.pub.emit_message = host_emit_message;
+    jpeg_create_decompress(&dec->cinfo);
+    dec->created = true;
+    return (jpeg_dec_handle_t *)dec;
+}
+
+jpeg_error_t jpeg_dec_parse_header(jpeg_dec_handle_t *jpeg_dec, jpeg_dec_io_t *io, jpeg_dec_header_info_t *out_info)
+{
+    host_dec_t *dec = (host_dec_t *)jpeg_dec;
+    if (dec == NULL || io == NULL || out_info == NULL || io->inbuf == NULL || io->inbuf_len <= 0) {
+        return JPEG_ERR_INVALID_PARAM;
+    }
+    if (setjmp(dec->err.jmp)) {
+        return JPEG_ERR_BAD_DATA;
+    }
+
+    jpeg_mem_src(&dec->cinfo, io->inbuf, io->inbuf_len);
+    if (jpeg_read_header(&dec->cinfo, TRUE) != JPEG_HEADER_OK || dec->corrupt) {
+        return JPEG_ERR_BAD_DATA;
+    }
+    if (dec->cinfo.progressive_mode) {
+        return JPEG_ERR_UNSUPPORT_STD;
+    }
+    dec->cinfo.out_color_space = JCS_RGB;
+    dec->cinfo.dct_method = JDCT_ISLOW;
+
+    memset(out_info, 0, sizeof(*out_info));
+    out_info->width = dec->cinfo.image_width;
+    out_info->height = dec->cinfo.image_height;
+    out_info->component_num = dec->cinfo.num_components;
+    for (int c = 0; c < dec->cinfo.num_components && c < 3; c++) {
+        out_info->x_factory[c] = dec->cinfo.comp_info[c].h_samp_factor;
+        out_info->y_factory[c] = dec->cinfo.comp_info[c].v_samp_factor;
+    }
+
+    jpeg_start_decompress(&dec->cinfo);
+    dec->started = true;
+    dec->block_lines = dec->cinfo.max_v_samp_factor * 8;
+    dec->row.resize((size_t)dec->cinfo.output_width * 3);
+
+    io->output_line = 0;
+    io->cur_line = 0;
+    io->output_height = dec->cinfo.output_height;
+    io->inbuf_remain = (int)dec->cinfo.src->bytes_in_buffer;
+    return JPEG_ERR_OK;
+}
+
+jpeg_error_t jpeg_dec_process(jpeg_dec_handle_t *jpeg_dec, jpeg_dec_io_t *io)
+{
+    host_dec_t *dec = (host_dec_t *)jpeg_dec;
+    if (dec == NULL || io == NULL || io->outbuf == NULL || !dec->started) {
+        return JPEG_ERR_INVALID_PARAM;
+    }
+    if (io->output_line >= io->output_height) {
+        return JPEG_ERR_NO_MORE_DATA;
+    }
+    if (setjmp(dec->err.jmp)) {
+        return JPEG_ERR_BAD_DATA;
+    }
+
+    int width = dec->cinfo.output_width;
+    int bpp = dec->config.output_type == JPEG_RAW_TYPE_RGB888 ? 3 : 2;
+    int lines = 0;
+    while (lines < dec->block_lines && dec->cinfo.output_scanline < dec->cinfo.output_height) {
+        JSAMPROW row = dec->row.data();
+        if (jpeg_read_scanlines(&dec->cinfo, &row, 1) != 1 || dec->corrupt) {
+            return JPEG_ERR_BAD_DATA;
+        }
+        uint8_t *dst = io->outbuf + (size_t)lines * width * bpp;
+        for (int x = 0; x < width; x++) {
+            const uint8_t *p = &dec->row[x * 3];
+            if (bpp == 3) {
+                dst[x * 3 + 0] = p[0];
+                dst[x * 3 + 1] = p[1];
+                dst[x * 3 + 2] = p[2];
+                continue;
+            }
+            uint16_t px = ((p[0] & 0xF8) << 8) | ((p[1] & 0xFC) << 3) | (p[2] >> 3);
+            if (dec->config.output_type == JPEG_RAW_TYPE_RGB565_BE) {
+                dst[x * 2 + 0] = px >> 8;
+                dst[x * 2 + 1] = px & 0xFF;
+            } else {
+                dst[x * 2 + 0] = px & 0xFF;
+                dst[x * 2 + 1] = px >> 8;
+            }
+        }
+        lines++;
+    }
+
+    io->cur_line = lines;
+    io->output_line += lines;
+    io->inbuf_remain = (int)dec->cinfo.src->bytes_in_buffer;
+    return lines > 0 ? JPEG_ERR_OK : JPEG_ERR_NO_MORE_DATA;
+}
+
+jpeg_error_t jpeg_dec_close(jpeg_dec_handle_t *jpeg_dec)
+{
+    host_dec_t *dec = (host_dec_t *)jpeg_dec;
+    if (dec == NULL) {
+        return JPEG_ERR_INVALID_PARAM;
+    }
+    if (dec->created) {
+        jpeg_destroy_decompress(&dec->cinfo);
+    }
+    delete dec;
+    return JPEG_ERR_OK;
+}
+
+void *jpeg_malloc_align(int size, int aligned)
+{
+    size_t rounded = ((size_t)size + aligned - 1) / aligned * aligned;
+    return aligned_alloc(aligned, rounded ? rounded : aligned);
+}
+
+void jpeg_free_align(void *data)
+{
+    free(data);
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <stdint.h>
+
+// Handle types only: the panel IO itself is replaced by host_lcd.cpp
+typedef struct esp_lcd_panel_io_t *esp_lcd_panel_io_handle_t;
+typedef struct esp_lcd_panel_t *esp_lcd_panel_handle_t;
+typedef struct {
+    void *user_data;
+} esp_lcd_panel_io_event_data_t;
@@ -0,0 +1,25 @@
+/*
+ * Host stand-in: memory from heap_caps_malloc(MALLOC_CAP_SPIRAM) counts as
+ * external RAM, everything else as internal and DMA-capable, so code that
+ * picks a path by address (sd_loader's staging chunk) takes the device's one.
+ */
+#pragma once
+
+#include <stdbool.h>
+
+bool host_ptr_spiram(const void *p);
+
+static inline bool esp_ptr_dma_capable(const void *p)
+{
+    return p != 0 && !host_ptr_spiram(p);
+}
+
+static inline bool esp_ptr_external_ram(const void *p)
+{
+    return host_ptr_spiram(p);
+}
+
+static inline bool esp_ptr_internal(const void *p)
+{
+    return p != 0 && !host_ptr_spiram(p);
+}
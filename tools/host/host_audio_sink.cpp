@@ -0,0 +1,108 @@
+#include <chrono>
+#include <thread>
+#include "esp_timer.h"
+#include "host_audio_sink.h"
+
+host_audio_sink::host_audio_sink(uint16_t buffer_ms, int32_t ppm)
+{
+    _buffer_ms = buffer_ms;
+    _ppm = ppm;
+    _running = false;
+    _capacity = 0;
+    _written = 0;
+    _played = 0;
+    _at_us = 0;
+    _dry = false;
+    _dry_us = 0;
+}
+
+bool host_audio_sink::start(uint32_t rate, uint8_t channels)
+{
+    if (rate == 0 || channels < 1 || channels > 2) {
+        return false;
+    }
+    _rate = rate;
+    _frame_bytes = 2 * channels;
+    _capacity = rate * _buffer_ms / 1000;
+    _capacity = _capacity ? _capacity : 1;
+    _written = 0;
+    _played = 0;
+    _at_us = esp_timer_get_time();
+    _dry = false;
+    _running = true;
+    return true;
+}
+
+void host_audio_sink::stop()
+{
+    _running = false;
+}
+
+void host_audio_sink::advance(int64_t now_us)
+{
+    if (!_dry) {
+        _played += (double)(now_us - _at_us) * _rate * (1.0 + _ppm / 1e6) / 1e6;
+        if (_played >= _written) {
+            // Ran dry this long ago; silence goes out from then on
+            _dry_us = _written > 0 ? now_us - (int64_t)((_played - _written) * 1e6 / _rate) : now_us;
+            _played = (double)_written;
+            _dry = true;
+        }
+    }
+    _at_us = now_us;
+}
+
+size_t host_audio_sink::write(const void *pcm, size_t len, uint32_t timeout_ms)
+{
+    (void)pcm;
+    if (!_running || len < _frame_bytes) {
+        return 0;
+    }
+    int64_t t = esp_timer_get_time();
+    int64_t deadline = t + (int64_t)timeout_ms * 1000;
+    uint64_t frames = len / _frame_bytes;
+    uint64_t done = 0;
+
+    advance(t);
+    if (_dry) {
+        if (_written > 0) {
+            _stats.underruns++;
+            _stats.silence_ms += (uint32_t)((t - _dry_us) / 1000);
+        }
+        _dry = false;
+    }
+    while (true) {
+        uint64_t queued = _written - (uint64_t)_played;
+        uint64_t room = queued < _capacity ? _capacity - queued : 0;
+        uint64_t n = frames - done < room ? frames - done : room;
+        _written += n;
+        done += n;
+        int64_t now = esp_timer_get_time();
+        if (done == frames || now >= deadline) {
+            break;
+        }
+        // Until a hundredth of the buffer has drained, or the timeout
+        int64_t wait = (int64_t)(_capacity / 100 + 1) * 1000000 / _rate;
+        wait = now + wait < deadline ? wait : deadline - now;
+        std::this_thread::sleep_for(std::chrono::microseconds(wait));
+        advance(esp_timer_get_time());
+    }
+    _stats.written += done;
+    _stats.writes++;
+    _stats.blocked_us += (uint32_t)(esp_timer_get_time() - t);
+    return done * _frame_bytes;
+}
+
+uint64_t host_audio_sink::played()
+{
+    if (!_running) {
+        return 0;
+    }
+    advance(esp_timer_get_time());
+    return (uint64_t)_played;
+}
+
+const char *host_audio_sink::name()
+{
+    return "host";
+}
@@ -0,0 +1,38 @@
+/*
+ * Host stand-in for the I2S amplifier, used to measure A/V sync on Linux.
+ *
+ * There is no sound: a simulated DAC drains the buffer at the sample rate off
+ * esp_timer, optionally off by `ppm` to model a crystal that runs fast or
+ * slow. write() blocks while the buffer is full, as the DMA ring does on the
+ * device, and a write that finds it drained counts an underrun and the
+ * silence that went out.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "../../src/audio/audio_sink.h"
+
+class host_audio_sink : public audio_sink
+{
+public:
+    host_audio_sink(uint16_t buffer_ms = 100, int32_t ppm = 0);
+
+    bool start(uint32_t rate, uint8_t channels);
+    void stop();
+    size_t write(const void *pcm, size_t len, uint32_t timeout_ms);
+    uint64_t played();
+    const char *name();
+
+private:
+    void advance(int64_t now_us);
+
+    uint16_t _buffer_ms;
+    int32_t _ppm;
+    bool _running;
+    uint32_t _capacity;       // sample frames the buffer holds
+    uint64_t _written;        // sample frames
+    double _played;
+    int64_t _at_us;           // _played as of then
+    bool _dry;                // everything written has played
+    int64_t _dry_us;
+};
@@ -0,0 +1,24 @@
+/*
+ * Simulated time for host tools whose results must not depend on how busy the
+ * host is.
+ *
+ * After host_clock_start(), esp_timer_get_time(), millis() and micros() read a
+ * simulated clock that moves only when something spends time: the caller
+ * through host_clock_advance(), vTaskDelay() and delay() by the time they
+ * sleep, a semaphore take by the time it waits, and every esp_timer_get_time()
+ * call by 1 us, so loops spinning on the clock end. Each move runs the hook,
+ * which is how a simulated peripheral (host_panel) raises its interrupts on
+ * time. Meant for single-threaded simulations: the hook runs on the thread
+ * that moved the clock.
+ */
+#pragma once
+
+#include <stdint.h>
+
+typedef void (*host_clock_hook_t)(void *ctx, int64_t now_us);
+
+void host_clock_start(int64_t t_us);
+void host_clock_stop(void);
+bool host_clock_simulated(void);
+void host_clock_advance(int64_t us);
+void host_clock_set_hook(host_clock_hook_t hook, void *ctx);
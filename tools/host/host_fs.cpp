@@ -0,0 +1,198 @@
+/*
+ * Host implementation of the FS/File stand-in in FS.h.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <chrono>
+#include <thread>
+#include "FS.h"
+
+namespace fs {
+
+struct host_file_t {
+    FILE *fp;
+    DIR *dir;
+    std::string path;
+    std::string name;
+    uint32_t read_delay_us;
+
+    ~host_file_t()
+    {
+        if (fp != NULL) {
+            fclose(fp);
+        }
+        if (dir != NULL) {
+            closedir(dir);
+        }
+    }
+};
+
+static std::shared_ptr<host_file_t> open_path(const std::string &path, const char *mode, uint32_t read_delay_us)
+{
+    struct stat st;
+    if (mode[0] == 'w') {
+        FILE *fp = fopen(path.c_str(), strchr(mode, '+') ? "w+b" : "wb");
+        if (fp == NULL) {
+            return NULL;
+        }
+        fclose(fp);
+    }
+    if (stat(path.c_str(), &st) != 0) {
+        return NULL;
+    }
+    std::shared_ptr<host_file_t> f = std::make_shared<host_file_t>();
+    f->fp = NULL;
+    f->dir = NULL;
+    f->path = path;
+    size_t slash = path.find_last_of('/');
+    f->name = slash == std::string::npos ? path : path.substr(slash + 1);
+    f->read_delay_us = read_delay_us;
+    if (S_ISDIR(st.st_mode)) {
+        f->dir = opendir(path.c_str());
+        return f->dir != NULL ? f : NULL;
+    }
+    // Created above when the mode truncates, so only read or update from here
+    f->fp = fopen(path.c_str(), mode[0] == 'a' ? "ab" : mode[0] == 'w' || strchr(mode, '+') ? "r+b" : "rb");
+    return f->fp != NULL ? f : NULL;
+}
+
+File::File()
+{
+}
+
+File::operator bool() const
+{
+    return _f != NULL;
+}
+
+size_t File::size()
+{
+    struct stat st;
+    if (_f == NULL || stat(_f->path.c_str(), &st) != 0) {
+        return 0;
+    }
+    return st.st_size;
+}
+
+size_t File::read(uint8_t *buf, size_t len)
+{
+    if (_f == NULL || _f->fp == NULL) {
+        return 0;
+    }
+    if (_f->read_delay_us > 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(_f->read_delay_us));
+    }
+    return fread(buf, 1, len, _f->fp);
+}
+
+size_t File::write(const uint8_t *buf, size_t len)
+{
+    if (_f == NULL || _f->fp == NULL) {
+        return 0;
+    }
+    return fwrite(buf, 1, len, _f->fp);
+}
+
+void File::flush()
+{
+    if (_f != NULL && _f->fp != NULL) {
+        fflush(_f->fp);
+    }
+}
+
+bool File::seek(uint32_t pos, SeekMode mode)
+{
+    static const int whence[] = {SEEK_SET, SEEK_CUR, SEEK_END};
+    return _f != NULL && _f->fp != NULL && fseek(_f->fp, pos, whence[mode]) == 0;
+}
+
+size_t File::position()
+{
+    return _f != NULL && _f->fp != NULL ? ftell(_f->fp) : 0;
+}
+
+time_t File::getLastWrite()
+{
+    struct stat st;
+    if (_f == NULL || stat(_f->path.c_str(), &st) != 0) {
+        return 0;
+    }
+    return st.st_mtime;
+}
+
+bool File::isDirectory()
+{
+    return _f != NULL && _f->dir != NULL;
+}
+
+const char *File::name()
+{
+    return _f != NULL ? _f->name.c_str() : "";
+}
+
+const char *File::path()
+{
+    return _f != NULL ? _f->path.c_str() : "";
+}
+
+File File::openNextFile()
+{
+    File next;
+    if (_f == NULL || _f->dir == NULL) {
+        return next;
+    }
+    struct dirent *de;
+    while ((de = readdir(_f->dir)) != NULL) {
+        if (strcmp(de->d_name, ".") == 0 || strcmp(de->d_name, "..") == 0) {
+            continue;
+        }
+        next._f = open_path(_f->path + "/" + de->d_name, "r", _f->read_delay_us);
+        if (next) {
+            break;
+        }
+    }
+    return next;
+}
+
+void File::close()
+{
+    _f = NULL;
+}
+
+FS::FS()
+{
+    _read_delay_us = 0;
+}
+
+File FS::open(const char *path, const char *mode, bool create)
+{
+    (void)create;
+    File file;
+    file._f = open_path(path, mode, _read_delay_us);
+    return file;
+}
+
+bool FS::exists(const char *path)
+{
+    struct stat st;
+    return stat(path, &st) == 0;
+}
+
+bool FS::remove(const char *path)
+{
+    return ::remove(path) == 0;
+}
+
+bool FS::rename(const char *from, const char *to)
+{
+    return ::rename(from, to) == 0;
+}
+
+void FS::setReadDelay(uint32_t us)
+{
+    _read_delay_us = us;
+}
+
+}
@@ -0,0 +1,137 @@
+/*
+ * Host implementation of the nv3041a_lcd stand-in in host_lcd.h.
+ */
+#include <map>
+#include <mutex>
+#include <vector>
+#include "host_lcd.h"
+
+#define HOST_LCD_H_RES (480)
+#define HOST_LCD_V_RES (272)
+
+typedef struct {
+    std::vector<uint16_t> frame;
+    uint32_t draws;
+} host_lcd_t;
+
+static std::mutex s_lock;
+static std::map<const nv3041a_lcd *, host_lcd_t> s_lcds;
+
+static host_lcd_t &lcd_of(const nv3041a_lcd *lcd)
+{
+    host_lcd_t &l = s_lcds[lcd];
+    if (l.frame.empty()) {
+        l.frame.assign((size_t)HOST_LCD_H_RES * HOST_LCD_V_RES, 0);
+        l.draws = 0;
+    }
+    return l;
+}
+
+static inline uint16_t panel_order(uint16_t color)
+{
+    return (color >> 8) | (color << 8);
+}
+
+// Clipped to the panel, as the controller ignores writes outside its window
+static void put(const nv3041a_lcd *lcd, uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *px,
+                uint16_t color)
+{
+    std::lock_guard<std::mutex> g(s_lock);
+    host_lcd_t &l = lcd_of(lcd);
+    for (uint32_t row = 0; row < h && y + row < HOST_LCD_V_RES; row++) {
+        uint16_t *out = &l.frame[(size_t)(y + row) * HOST_LCD_H_RES];
+        for (uint32_t col = 0; col < w && x + col < HOST_LCD_H_RES; col++) {
+            out[x + col] = px != NULL ? px[row * w + col] : color;
+        }
+    }
+    l.draws += px != NULL ? 1 : 0;
+}
+
+nv3041a_lcd::nv3041a_lcd(int8_t qspi_cs, int8_t qspi_clk, int8_t qspi_0,
+                         int8_t qspi_1, int8_t qspi_2, int8_t qspi_3, int8_t lcd_rst,
+                         spi_host_device_t host)
+{
+    _qspi_cs = qspi_cs;
+    _qspi_clk = qspi_clk;
+    _qspi_0 = qspi_0;
+    _qspi_1 = qspi_1;
+    _qspi_2 = qspi_2;
+    _qspi_3 = qspi_3;
+    _lcd_rst = lcd_rst;
+    _host = host;
+    _io = NULL;
+    _panel = NULL;
+    _te = NULL;
+    _sched = NULL;
+    _sched_id = -1;
+    portMUX_INITIALIZE(&_mux);
+    _queued = 0;
+    _sent = 0;
+    _trace_id = 0;
+    _drained = NULL;
+    _fill_buf = NULL;
+    _fill_valid = false;
+}
+
+void nv3041a_lcd::begin()
+{
+    std::lock_guard<std::mutex> g(s_lock);
+    lcd_of(this);
+}
+
+void nv3041a_lcd::lcd_draw_bitmap(uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end, uint16_t *color_data)
+{
+    put(this, x_start, y_start, x_end - x_start, y_end - y_start, color_data, 0);
+}
+
+void nv3041a_lcd::draw16bitbergbbitmap(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t *color_data)
+{
+    put(this, x, y, w, h, color_data, 0);
+}
+
+void nv3041a_lcd::fillScreen(uint16_t color)
+{
+    fillRect(0, 0, width(), height(), color);
+}
+
+void nv3041a_lcd::fillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color)
+{
+    put(this, x, y, w, h, NULL, panel_order(color));
+}
+
+void nv3041a_lcd::drawHLine(uint16_t x, uint16_t y, uint16_t w, uint16_t color)
+{
+    fillRect(x, y, w, 1, color);
+}
+
+void nv3041a_lcd::drawVLine(uint16_t x, uint16_t y, uint16_t h, uint16_t color)
+{
+    fillRect(x, y, 1, h, color);
+}
+
+void nv3041a_lcd::flush(uint32_t pending)
+{
+    (void)pending;
+}
+
+uint16_t nv3041a_lcd::width()
+{
+    return HOST_LCD_H_RES;
+}
+
+uint16_t nv3041a_lcd::height()
+{
+    return HOST_LCD_V_RES;
+}
+
+const uint16_t *host_lcd_frame(nv3041a_lcd &lcd)
+{
+    std::lock_guard<std::mutex> g(s_lock);
+    return lcd_of(&lcd).frame.data();
+}
+
+uint32_t host_lcd_draws(nv3041a_lcd &lcd)
+{
+    std::lock_guard<std::mutex> g(s_lock);
+    return lcd_of(&lcd).draws;
+}
@@ -0,0 +1,18 @@
+/*
+ * Host stand-in for the nv3041a_lcd panel driver.
+ *
+ * host_lcd.cpp implements the drawing calls of src/lcd/nv3041a_lcd.h on an
+ * in-memory frame instead of the QSPI bus: every draw and fill lands at once,
+ * so flush() never waits. TE pacing and the bus scheduler are not modelled;
+ * te_sim and panel_sched_check cover those. A check reads back what was drawn
+ * with host_lcd_frame().
+ */
+#pragma once
+
+#include <stdint.h>
+#include "../../src/lcd/nv3041a_lcd.h"
+
+// What `lcd` shows, width() x height() pixels row by row, in panel byte order
+const uint16_t *host_lcd_frame(nv3041a_lcd &lcd);
+// Bitmap draws so far, fills not counted
+uint32_t host_lcd_draws(nv3041a_lcd &lcd);
@@ -0,0 +1,160 @@
+#include <stdlib.h>
+#include "esp_timer.h"
+#include "host_clock.h"
+#include "host_panel.h"
+
+host_panel::host_panel(uint16_t lines, uint32_t period_us, uint32_t scan_delay_us, uint32_t bytes_per_ms)
+{
+    _lines = lines;
+    _period_us = period_us;
+    _scan_delay_us = scan_delay_us < period_us ? scan_delay_us : 0;
+    _bytes_per_ms = bytes_per_ms;
+    _jitter_us = 0;
+    _seed = 1;
+    _cb = NULL;
+    _ctx = NULL;
+    _nominal_us = 0;
+    _edge_us = -1;
+    _rows.resize(lines);
+    _last_write_us = 0;
+}
+
+host_panel::~host_panel()
+{
+    stop();
+}
+
+void host_panel::setJitter(uint32_t jitter_us, uint32_t seed)
+{
+    _jitter_us = jitter_us < _period_us / 2 ? jitter_us : _period_us / 2;
+    _seed = seed ? seed : 1;
+}
+
+void host_panel::start(te_cb_t cb, void *ctx)
+{
+    _cb = cb;
+    _ctx = ctx;
+    _nominal_us = esp_timer_get_time();
+    _edge_us = nextEdge();
+    host_clock_set_hook(onClock, this);
+}
+
+void host_panel::stop()
+{
+    if (_edge_us >= 0) {
+        host_clock_set_hook(NULL, NULL);
+        _edge_us = -1;
+    }
+}
+
+int64_t host_panel::nextEdge()
+{
+    _nominal_us += _period_us;
+    if (_jitter_us == 0) {
+        return _nominal_us;
+    }
+    _seed = _seed * 1103515245u + 12345u;
+    return _nominal_us + (int64_t)((_seed >> 8) % (2 * _jitter_us + 1)) - _jitter_us;
+}
+
+void host_panel::onClock(void *ctx, int64_t now_us)
+{
+    host_panel *p = (host_panel *)ctx;
+    while (p->_edge_us >= 0 && p->_edge_us <= now_us) {
+        int64_t edge = p->_edge_us;
+        p->_edges.push_back(edge);
+        p->_edge_us = p->nextEdge();
+        if (p->_cb != NULL) {
+            p->_cb(p->_ctx, edge);
+        }
+    }
+}
+
+void host_panel::write(uint16_t y, uint16_t h, uint32_t bytes, uint32_t image)
+{
+    int64_t start = esp_timer_get_time();
+    int64_t xfer_us = (int64_t)bytes * 1000 / _bytes_per_ms;
+    for (uint16_t r = 0; r < h && y + r < _lines; r++) {
+        _rows[y + r].push_back({start + (int64_t)(r + 1) * xfer_us / h, image});
+    }
+    _writes.push_back({start, xfer_us, y, h});
+    _last_write_us = start + xfer_us;
+    host_clock_advance(xfer_us);
+}
+
+// First pass that scans `row` at or after t_us, -1 past the recorded edges
+int64_t host_panel::passOf(uint16_t row, int64_t t_us)
+{
+    size_t lo = 0;
+    size_t hi = _edges.size() > 0 ? _edges.size() - 1 : 0;
+    while (lo < hi) {
+        size_t n = (lo + hi) / 2;
+        int64_t scan = _edges[n] + _scan_delay_us + (int64_t)row * (_edges[n + 1] - _edges[n] - _scan_delay_us) / _lines;
+        if (scan >= t_us) {
+            hi = n;
+        } else {
+            lo = n + 1;
+        }
+    }
+    return lo + 1 < _edges.size() ? (int64_t)lo : -1;
+}
+
+void host_panel::scanReport(uint32_t *passes, uint32_t *torn, uint32_t *crossed)
+{
+    *passes = 0;
+    *torn = 0;
+
+    if (crossed != NULL) {
+        *crossed = 0;
+        for (const write_t &w : _writes) {
+            int64_t first = passOf(w.y, w.start_us + w.xfer_us / w.h);
+            bool split = false;
+            for (uint16_t r = 1; r < w.h && w.y + r < _lines && first > 0; r++) {
+                int64_t pass = passOf(w.y + r, w.start_us + (int64_t)(r + 1) * w.xfer_us / w.h);
+                split = split || (pass >= 0 && pass != first);
+            }
+            *crossed += split ? 1 : 0;
+        }
+    }
+
+    // Only passes between the first complete image and the last write are meaningful
+    int64_t first_full = 0;
+    for (const std::vector<landing_t> &row : _rows) {
+        if (row.empty()) {
+            return;
+        }
+        first_full = row[0].t_us > first_full ? row[0].t_us : first_full;
+    }
+
+    std::vector<size_t> cursor(_lines, 0);
+    for (size_t n = 0; n + 1 < _edges.size(); n++) {
+        int64_t active = _edges[n + 1] - _edges[n] - _scan_delay_us;
+        int64_t first_scan = _edges[n] + _scan_delay_us;
+        if (first_scan < first_full) {
+            continue;
+        }
+        if (first_scan > _last_write_us) {
+            break;
+        }
+
+        uint32_t shown = 0;
+        bool mixed = false;
+        for (uint16_t r = 0; r < _lines; r++) {
+            int64_t scan = first_scan + (int64_t)r * active / _lines;
+            const std::vector<landing_t> &row = _rows[r];
+            size_t &i = cursor[r];
+            while (i + 1 < row.size() && row[i + 1].t_us <= scan) {
+                i++;
+            }
+            if (r == 0) {
+                shown = row[i].image;
+            } else if (row[i].image != shown) {
+                mixed = true;
+            }
+        }
+        (*passes)++;
+        if (mixed) {
+            (*torn)++;
+        }
+    }
+}
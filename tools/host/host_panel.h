@@ -0,0 +1,72 @@
+/*
+ * Host stand-in for the panel scan-out, used to exercise the TE scheduler.
+ *
+ * The panel runs on the simulated clock (host_clock.h), so a run gives the
+ * same result every time. It raises TE every period (plus optional jitter,
+ * from a fixed seed) as soon as the clock passes the edge and reports the
+ * edge time through a callback, as the GPIO ISR does on the device. write()
+ * models a blocking bus transfer at a fixed byte rate, spending the transfer
+ * time on the clock, and records when each row landed; scanReport() then
+ * replays the scan-out pass by pass and counts the passes that showed rows of
+ * more than one image, i.e. visible tears.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+class host_panel
+{
+public:
+    typedef void (*te_cb_t)(void *ctx, int64_t t_us);
+
+    host_panel(uint16_t lines, uint32_t period_us, uint32_t scan_delay_us, uint32_t bytes_per_ms);
+    ~host_panel();
+
+    void setJitter(uint32_t jitter_us, uint32_t seed = 1);
+    // Needs host_clock_start() first; takes the clock's hook until stop()
+    void start(te_cb_t cb, void *ctx);
+    void stop();
+
+    // Blocking write of rows [y, y + h) belonging to image `image`
+    void write(uint16_t y, uint16_t h, uint32_t bytes, uint32_t image);
+
+    // Passes scanned while images were being written, and how many of them were torn;
+    // crossed counts the writes whose rows were first shown by different passes,
+    // i.e. the scan line ran through the strip while it was on the bus
+    void scanReport(uint32_t *passes, uint32_t *torn, uint32_t *crossed = NULL);
+
+private:
+    typedef struct {
+        int64_t t_us;
+        uint32_t image;
+    } landing_t;
+
+    typedef struct {
+        int64_t start_us;
+        int64_t xfer_us;
+        uint16_t y;
+        uint16_t h;
+    } write_t;
+
+    static void onClock(void *ctx, int64_t now_us);
+    int64_t nextEdge();
+    int64_t passOf(uint16_t row, int64_t t_us);
+
+    uint16_t _lines;
+    uint32_t _period_us;
+    uint32_t _scan_delay_us;
+    uint32_t _bytes_per_ms;
+    uint32_t _jitter_us;
+    uint32_t _seed;
+
+    te_cb_t _cb;
+    void *_ctx;
+    int64_t _nominal_us;
+    int64_t _edge_us;
+
+    std::vector<int64_t> _edges;
+    std::vector<std::vector<landing_t>> _rows;
+    std::vector<write_t> _writes;
+    int64_t _last_write_us;
+};
@@ -0,0 +1,388 @@
+/*
+ * Host implementations of the ESP-IDF/FreeRTOS calls used by the portable modules.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <thread>
+#include <map>
+#include <deque>
+#include <vector>
+#include "freertos/semphr.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "esp_heap_caps.h"
+#include "esp_memory_utils.h"
+#include "esp_timer.h"
+#include "Arduino.h"
+#include "host_clock.h"
+
+// Simulated clock, see host_clock.h
+static bool s_sim;
+static int64_t s_sim_us;
+static host_clock_hook_t s_sim_hook;
+static void *s_sim_ctx;
+static bool s_sim_in_hook;
+
+void host_clock_start(int64_t t_us)
+{
+    s_sim_us = t_us;
+    s_sim = true;
+}
+
+void host_clock_stop(void)
+{
+    s_sim = false;
+    s_sim_hook = NULL;
+}
+
+bool host_clock_simulated(void)
+{
+    return s_sim;
+}
+
+void host_clock_advance(int64_t us)
+{
+    if (us > 0) {
+        s_sim_us += us;
+    }
+    // A hook that reads the clock must not run itself again
+    if (s_sim_hook != NULL && !s_sim_in_hook) {
+        s_sim_in_hook = true;
+        s_sim_hook(s_sim_ctx, s_sim_us);
+        s_sim_in_hook = false;
+    }
+}
+
+void host_clock_set_hook(host_clock_hook_t hook, void *ctx)
+{
+    s_sim_hook = hook;
+    s_sim_ctx = ctx;
+}
+
+typedef struct {
+    std::mutex m;
+    std::condition_variable cv;
+    bool is_mutex;
+    int count;
+} host_sem_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    host_sem_t *s = new host_sem_t();
+    s->is_mutex = true;
+    s->count = 1;
+    return s;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    host_sem_t *s = new host_sem_t();
+    s->is_mutex = false;
+    s->count = 0;
+    return s;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks)
+{
+    host_sem_t *s = (host_sem_t *)sem;
+    if (s_sim) {
+        // Wait in simulated time, 1 us at a time, so the hook can give the semaphore
+        for (int64_t waited = 0;; waited++) {
+            {
+                std::lock_guard<std::mutex> lock(s->m);
+                if (s->count > 0) {
+                    s->count--;
+                    return pdTRUE;
+                }
+            }
+            if (ticks != portMAX_DELAY && waited >= (int64_t)ticks * 1000) {
+                return pdFALSE;
+            }
+            host_clock_advance(1);
+        }
+    }
+    std::unique_lock<std::mutex> lock(s->m);
+    auto ready = [s] { return s->count > 0; };
+    if (ticks == portMAX_DELAY) {
+        s->cv.wait(lock, ready);
+    } else if (!s->cv.wait_for(lock, std::chrono::milliseconds(ticks), ready)) {
+        return pdFALSE;
+    }
+    s->count--;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    host_sem_t *s = (host_sem_t *)sem;
+    {
+        std::lock_guard<std::mutex> lock(s->m);
+        if (s->count > 0) {
+            return pdFALSE;
+        }
+        s->count = 1;
+    }
+    s->cv.notify_one();
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t sem, BaseType_t *woken)
+{
+    if (woken != NULL) {
+        *woken = pdFALSE;
+    }
+    return xSemaphoreGive(sem);
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem)
+{
+    delete (host_sem_t *)sem;
+}
+
+typedef struct {
+    std::mutex m;
+    std::condition_variable cv;
+    size_t length;
+    size_t item_size;
+    std::deque<std::vector<uint8_t>> items;
+} host_queue_t;
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    host_queue_t *q = new host_queue_t();
+    q->length = length;
+    q->item_size = item_size;
+    return q;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks)
+{
+    host_queue_t *q = (host_queue_t *)queue;
+    {
+        std::unique_lock<std::mutex> lock(q->m);
+        auto room = [q] { return q->items.size() < q->length; };
+        if (ticks == portMAX_DELAY) {
+            q->cv.wait(lock, room);
+        } else if (!q->cv.wait_for(lock, std::chrono::milliseconds(ticks), room)) {
+            return pdFALSE;
+        }
+        const uint8_t *p = (const uint8_t *)item;
+        q->items.emplace_back(p, p + q->item_size);
+    }
+    q->cv.notify_all();
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks)
+{
+    host_queue_t *q = (host_queue_t *)queue;
+    {
+        std::unique_lock<std::mutex> lock(q->m);
+        auto ready = [q] { return !q->items.empty(); };
+        if (ticks == portMAX_DELAY) {
+            q->cv.wait(lock, ready);
+        } else if (!q->cv.wait_for(lock, std::chrono::milliseconds(ticks), ready)) {
+            return pdFALSE;
+        }
+        memcpy(item, q->items.front().data(), q->item_size);
+        q->items.pop_front();
+    }
+    q->cv.notify_all();
+    return pdTRUE;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    delete (host_queue_t *)queue;
+}
+
+typedef struct {
+    TaskFunction_t fn;
+    void *arg;
+    std::mutex m;
+    std::condition_variable cv;
+    uint32_t notified;
+    bool deleted;
+    std::thread thread;
+} host_task_t;
+
+// Thrown inside a task's thread to unwind it when the task is deleted
+struct host_task_exit {
+};
+
+static thread_local host_task_t *s_current_task = NULL;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *handle, BaseType_t core)
+{
+    (void)name;
+    (void)stack;
+    (void)priority;
+    (void)core;
+    // Freed by vTaskDelete(); tasks that are never deleted run until the process exits
+    host_task_t *task = new host_task_t();
+    task->fn = fn;
+    task->arg = arg;
+    task->notified = 0;
+    task->deleted = false;
+    if (handle != NULL) {
+        *handle = task;
+    }
+    task->thread = std::thread([task] {
+        s_current_task = task;
+        try {
+            task->fn(task->arg);
+        } catch (const host_task_exit &) {
+        }
+    });
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t handle)
+{
+    host_task_t *task = (host_task_t *)handle;
+    if (task == NULL || task == s_current_task) {
+        // The thread object stays behind; detach so the process can exit past it
+        s_current_task->thread.detach();
+        throw host_task_exit();
+    }
+    {
+        std::lock_guard<std::mutex> lock(task->m);
+        task->deleted = true;
+    }
+    task->cv.notify_one();
+    task->thread.join();
+    delete task;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t handle)
+{
+    host_task_t *task = (host_task_t *)handle;
+    {
+        std::lock_guard<std::mutex> lock(task->m);
+        task->notified++;
+    }
+    task->cv.notify_one();
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks)
+{
+    host_task_t *task = s_current_task;
+    std::unique_lock<std::mutex> lock(task->m);
+    auto ready = [task] { return task->notified > 0 || task->deleted; };
+    if (ticks == portMAX_DELAY) {
+        task->cv.wait(lock, ready);
+    } else if (!task->cv.wait_for(lock, std::chrono::milliseconds(ticks), ready)) {
+        return 0;
+    }
+    if (task->deleted) {
+        throw host_task_exit();
+    }
+    uint32_t value = task->notified;
+    task->notified = clear ? 0 : value - 1;
+    return value;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    if (s_sim) {
+        host_clock_advance((int64_t)ticks * 1000);
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+// Blocks taken with MALLOC_CAP_SPIRAM, by start address, for esp_ptr_external_ram()
+static std::mutex s_spiram_lock;
+static std::map<uintptr_t, size_t> s_spiram;
+
+static void *trackCaps(void *ptr, size_t size, uint32_t caps)
+{
+    if (ptr != NULL && (caps & MALLOC_CAP_SPIRAM)) {
+        std::lock_guard<std::mutex> g(s_spiram_lock);
+        s_spiram[(uintptr_t)ptr] = size;
+    }
+    return ptr;
+}
+
+bool host_ptr_spiram(const void *p)
+{
+    std::lock_guard<std::mutex> g(s_spiram_lock);
+    auto it = s_spiram.upper_bound((uintptr_t)p);
+    if (it == s_spiram.begin()) {
+        return false;
+    }
+    --it;
+    return (uintptr_t)p < it->first + it->second;
+}
+
+void *heap_caps_malloc(size_t size, uint32_t caps)
+{
+    return trackCaps(malloc(size), size, caps);
+}
+
+void *heap_caps_aligned_alloc(size_t alignment, size_t size, uint32_t caps)
+{
+    size_t rounded = (size + alignment - 1) / alignment * alignment;
+    return trackCaps(aligned_alloc(alignment, rounded ? rounded : alignment), size, caps);
+}
+
+void heap_caps_free(void *ptr)
+{
+    if (ptr != NULL) {
+        std::lock_guard<std::mutex> g(s_spiram_lock);
+        s_spiram.erase((uintptr_t)ptr);
+    }
+    free(ptr);
+}
+
+size_t heap_caps_get_free_size(uint32_t caps)
+{
+    (void)caps;
+    return 0;
+}
+
+size_t heap_caps_get_minimum_free_size(uint32_t caps)
+{
+    (void)caps;
+    return 0;
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps)
+{
+    (void)caps;
+    return 0;
+}
+
+int64_t esp_timer_get_time(void)
+{
+    if (s_sim) {
+        host_clock_advance(1);
+        return s_sim_us;
+    }
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+unsigned long millis(void)
+{
+    return (unsigned long)(esp_timer_get_time() / 1000);
+}
+
+unsigned long micros(void)
+{
+    return (unsigned long)esp_timer_get_time();
+}
+
+void delay(unsigned long ms)
+{
+    if (s_sim) {
+        host_clock_advance((int64_t)ms * 1000);
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
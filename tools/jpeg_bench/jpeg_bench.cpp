@@ -0,0 +1,621 @@
+/*
+ * jpeg_bench: host benchmark and conformance run of the chunked decode path.
+ *
+ *   g++ -O2 -I../host -o jpeg_bench jpeg_bench.cpp ../host/esp_jpeg_host.cpp \
+ *       ../host/host_runtime.cpp ../../src/mem/pipeline_arena.cpp \
+ *       ../../src/decode/image_source.cpp ../../src/decode/baseline_jpeg.cpp \
+ *       ../../src/decode/baseline_idct.cpp ../../src/trace/pipeline_trace.cpp -ljpeg
+ *   ./jpeg_bench --gen corpus ../../img_480_272.jpg
+ *   ./jpeg_bench --json result.json --baseline previous.json corpus
+ *   ./jpeg_bench --backend baseline --json baseline.json corpus
+ *
+ * Each image is mmap()ed and goes through the image_source overload of
+ * esp_jpeg_decoder_block_out() from jpeg_dec.h, exactly as a flash asset does
+ * on the device, with the ESP32_JPEG API provided by the host stand-in in
+ * tools/host. The tool reports MPixel/s from the best of --runs decodes, the
+ * per-strip latency distribution and the PSNR of the RGB565 output against
+ * the other decoder: the in-tree baseline decoder when the library backend is
+ * measured (the host library is libjpeg as well, so libjpeg would only check
+ * the strip plumbing) and libjpeg when the baseline backend is. The two agree
+ * exactly on 4:4:4 (99 dB) and differ by the chroma upsampling otherwise;
+ * images the baseline decoder does not take are scored against libjpeg.
+ *
+ * With --baseline, throughput is compared as the geometric mean over all
+ * images, each timed against a plain libjpeg decode of the same image run in
+ * between, so a host that is busier than last time does not read as a
+ * regression; single images still move by 20-30% between runs on a loaded
+ * machine, while the mean stays within a few percent, well inside the default
+ * --tolerance of 10%. Any image that lost more than 0.5 dB against the same
+ * reference is a quality regression. Either sets the exit code to 1.
+ * Built with -DPIPELINE_TRACE=1, --trace OUT records the header, process
+ * and callback spans of every decode into a dump for tools/trace_json.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <dirent.h>
+#include <errno.h>
+#include <setjmp.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <jpeglib.h>
+#include "esp_timer.h"
+#include "../../jpeg_dec.h"
+
+#define BENCH_PSNR_CAP (99.0)
+#define BENCH_PSNR_DROP_DB (0.5)
+
+typedef struct {
+    std::string name;
+    int width;
+    int height;
+    size_t bytes;
+    double mpix_s;
+    double total_us;
+    double spread_pct;     // median run over the best one, the timing noise of this image
+    double calib_us;       // best plain libjpeg decode of the image, interleaved with the runs
+    int strips;
+    double strip_p50_us;
+    double strip_p90_us;
+    double strip_p99_us;
+    double strip_max_us;
+    double first_strip_us;
+    double psnr_db;
+    const char *reference; // decoder the PSNR is measured against
+} result_t;
+
+typedef struct {
+    struct jpeg_error_mgr pub;
+    jmp_buf jmp;
+} ref_err_t;
+
+// State shared with the draw callback
+static std::vector<uint16_t> s_frame;
+static int s_frame_w;
+static std::vector<double> s_strip_us;
+static int64_t s_last_us;
+
+static int benchDrawCallback(jpeg_dec_io_t *jpeg_io, jpeg_dec_header_info_t *out_info)
+{
+    int64_t now = esp_timer_get_time();
+    s_strip_us.push_back((double)(now - s_last_us));
+
+    int y = jpeg_io->output_line - jpeg_io->cur_line;
+    memcpy(&s_frame[(size_t)y * s_frame_w], jpeg_io->outbuf, (size_t)jpeg_io->cur_line * out_info->width * 2);
+
+    // Exclude the copy above from the next strip's latency
+    s_last_us = esp_timer_get_time();
+    return 1;
+}
+
+static void ref_error_exit(j_common_ptr cinfo)
+{
+    longjmp(((ref_err_t *)cinfo->err)->jmp, 1);
+}
+
+static bool read_file(const std::string &path, std::vector<uint8_t> &data)
+{
+    FILE *f = fopen(path.c_str(), "rb");
+    if (f == NULL) {
+        return false;
+    }
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    data.resize(len > 0 ? len : 0);
+    bool ok = len > 0 && fread(data.data(), 1, len, f) == (size_t)len;
+    fclose(f);
+    return ok;
+}
+
+static bool ref_decode(const uint8_t *data, size_t len, int *w, int *h, std::vector<uint8_t> &rgb)
+{
+    struct jpeg_decompress_struct cinfo;
+    ref_err_t err;
+
+    cinfo.err = jpeg_std_error(&err.pub);
+    err.pub.error_exit = ref_error_exit;
+    if (setjmp(err.jmp)) {
+        jpeg_destroy_decompress(&cinfo);
+        return false;
+    }
+    jpeg_create_decompress(&cinfo);
+    jpeg_mem_src(&cinfo, data, len);
+    jpeg_read_header(&cinfo, TRUE);
+    cinfo.out_color_space = JCS_RGB;
+    cinfo.dct_method = JDCT_ISLOW;
+    jpeg_start_decompress(&cinfo);
+    *w = cinfo.output_width;
+    *h = cinfo.output_height;
+    rgb.resize((size_t)*w * *h * 3);
+    while (cinfo.output_scanline < cinfo.output_height) {
+        JSAMPROW row = &rgb[(size_t)cinfo.output_scanline * *w * 3];
+        jpeg_read_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    return true;
+}
+
+static bool ref_encode(const std::vector<uint8_t> &rgb, int w, int h, int quality, int subsampling, int restart_rows, std::vector<uint8_t> &out)
+{
+    struct jpeg_compress_struct cinfo;
+    ref_err_t err;
+    unsigned char *mem = NULL;
+    unsigned long mem_len = 0;
+
+    cinfo.err = jpeg_std_error(&err.pub);
+    err.pub.error_exit = ref_error_exit;
+    if (setjmp(err.jmp)) {
+        jpeg_destroy_compress(&cinfo);
+        free(mem);
+        return false;
+    }
+    jpeg_create_compress(&cinfo);
+    jpeg_mem_dest(&cinfo, &mem, &mem_len);
+    cinfo.image_width = w;
+    cinfo.image_height = h;
+    cinfo.input_components = 3;
+    cinfo.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, quality, TRUE);
+    cinfo.restart_in_rows = restart_rows;
+    cinfo.comp_info[0].h_samp_factor = subsampling == 444 ? 1 : 2;
+    cinfo.comp_info[0].v_samp_factor = subsampling == 420 ? 2 : 1;
+    jpeg_start_compress(&cinfo, TRUE);
+    while (cinfo.next_scanline < cinfo.image_height) {
+        JSAMPROW row = (JSAMPROW)&rgb[(size_t)cinfo.next_scanline * w * 3];
+        jpeg_write_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+    out.assign(mem, mem + mem_len);
+    free(mem);
+    return true;
+}
+
+static void resize_bilinear(const std::vector<uint8_t> &src, int sw, int sh, std::vector<uint8_t> &dst, int dw, int dh)
+{
+    dst.resize((size_t)dw * dh * 3);
+    for (int y = 0; y < dh; y++) {
+        double fy = (y + 0.5) * sh / dh - 0.5;
+        int y0 = fy < 0 ? 0 : (int)fy;
+        int y1 = y0 + 1 < sh ? y0 + 1 : sh - 1;
+        double wy = fy - y0 < 0 ? 0 : fy - y0;
+        for (int x = 0; x < dw; x++) {
+            double fx = (x + 0.5) * sw / dw - 0.5;
+            int x0 = fx < 0 ? 0 : (int)fx;
+            int x1 = x0 + 1 < sw ? x0 + 1 : sw - 1;
+            double wx = fx - x0 < 0 ? 0 : fx - x0;
+            for (int c = 0; c < 3; c++) {
+                double a = src[((size_t)y0 * sw + x0) * 3 + c] * (1 - wx) + src[((size_t)y0 * sw + x1) * 3 + c] * wx;
+                double b = src[((size_t)y1 * sw + x0) * 3 + c] * (1 - wx) + src[((size_t)y1 * sw + x1) * 3 + c] * wx;
+                dst[((size_t)y * dw + x) * 3 + c] = (uint8_t)lround(a * (1 - wy) + b * wy);
+            }
+        }
+    }
+}
+
+static int generate_corpus(const char *dir, const char *seed_path)
+{
+    static const int sizes[][2] = {{480, 272}, {320, 240}, {481, 271}, {800, 480}, {1280, 720}};
+    static const int subsamplings[] = {444, 422, 420};
+    static const int qualities[] = {50, 85, 95};
+    static const int restarts[] = {0, 1};
+
+    std::vector<uint8_t> seed, rgb;
+    int sw, sh;
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST) {
+        fprintf(stderr, "%s: cannot create directory\n", dir);
+        return 1;
+    }
+    if (!read_file(seed_path, seed) || !ref_decode(seed.data(), seed.size(), &sw, &sh, rgb)) {
+        fprintf(stderr, "%s: cannot decode seed image\n", seed_path);
+        return 1;
+    }
+
+    int count = 0;
+    for (auto &size : sizes) {
+        std::vector<uint8_t> scaled;
+        resize_bilinear(rgb, sw, sh, scaled, size[0], size[1]);
+        for (int ss : subsamplings) {
+            for (int q : qualities) {
+                for (int rst : restarts) {
+                    std::vector<uint8_t> jpeg;
+                    char path[512];
+                    snprintf(path, sizeof(path), "%s/%dx%d_s%d_q%d_r%d.jpg", dir, size[0], size[1], ss, q, rst);
+                    FILE *f = fopen(path, "wb");
+                    if (!ref_encode(scaled, size[0], size[1], q, ss, rst, jpeg) || f == NULL ||
+                        fwrite(jpeg.data(), 1, jpeg.size(), f) != jpeg.size()) {
+                        fprintf(stderr, "%s: cannot write\n", path);
+                        if (f) {
+                            fclose(f);
+                        }
+                        return 1;
+                    }
+                    fclose(f);
+                    count++;
+                }
+            }
+        }
+    }
+    printf("wrote %d images to %s\n", count, dir);
+    return 0;
+}
+
+static double percentile(std::vector<double> v, double p)
+{
+    if (v.empty()) {
+        return 0;
+    }
+    std::sort(v.begin(), v.end());
+    size_t i = (size_t)ceil(p * v.size()) - 1;
+    return v[i < v.size() ? i : v.size() - 1];
+}
+
+// Reference pixels in panel byte order, quantised the way the decoder output is
+static void rgb_to_565(const std::vector<uint8_t> &rgb, std::vector<uint16_t> &out)
+{
+    out.resize(rgb.size() / 3);
+    for (size_t i = 0; i < out.size(); i++) {
+        uint16_t px = (uint16_t)((rgb[i * 3] >> 3) << 11 | (rgb[i * 3 + 1] >> 2) << 5 | rgb[i * 3 + 2] >> 3);
+        out[i] = (uint16_t)(px >> 8 | (px & 0xFF) << 8);
+    }
+}
+
+static double psnr_565(const std::vector<uint16_t> &frame, const std::vector<uint16_t> &ref)
+{
+    double se = 0;
+    for (size_t i = 0; i < frame.size(); i++) {
+        // Output is panel byte order (RGB565 big-endian)
+        uint16_t a = (uint16_t)((frame[i] & 0xFF) << 8 | frame[i] >> 8);
+        uint16_t b = (uint16_t)((ref[i] & 0xFF) << 8 | ref[i] >> 8);
+        int out[3] = {(a >> 11) & 0x1F, (a >> 5) & 0x3F, a & 0x1F};
+        int exp[3] = {(b >> 11) & 0x1F, (b >> 5) & 0x3F, b & 0x1F};
+        int scale[3] = {255 / 31, 255 / 63, 255 / 31};
+        for (int c = 0; c < 3; c++) {
+            double d = (double)(out[c] - exp[c]) * scale[c];
+            se += d * d;
+        }
+    }
+    double mse = frame.empty() ? 0 : se / ((double)frame.size() * 3);
+    return mse == 0 ? BENCH_PSNR_CAP : fmin(BENCH_PSNR_CAP, 10 * log10(255.0 * 255.0 / mse));
+}
+
+/*
+ * The PSNR reference is the decoder not under test: the in-tree baseline decoder
+ * for the library backend (the host library is libjpeg too, so comparing it with
+ * libjpeg would only check the strip plumbing), libjpeg for the baseline one.
+ * Images the baseline decoder does not support fall back to libjpeg.
+ */
+static const char *reference_decode(const std::vector<uint8_t> &jpeg, jpeg_dec_backend_t backend, int w, int h,
+                                    std::vector<uint16_t> &ref)
+{
+    if (backend != JPEG_DEC_BACKEND_BASELINE) {
+        jpeg_dec_limits_t limits = {};
+        limits.backend = JPEG_DEC_BACKEND_BASELINE;
+        s_frame.assign((size_t)w * h, 0);
+        s_frame_w = w;
+        if (esp_jpeg_decoder_block_out((unsigned char *)jpeg.data(), (int)jpeg.size(), benchDrawCallback, &limits) == JPEG_DEC_OK) {
+            ref = s_frame;
+            return "baseline";
+        }
+    }
+    std::vector<uint8_t> rgb;
+    int rw, rh;
+    if (!ref_decode(jpeg.data(), jpeg.size(), &rw, &rh, rgb)) {
+        return NULL;
+    }
+    rgb_to_565(rgb, ref);
+    return "libjpeg";
+}
+
+static bool bench_one(const std::string &path, int runs, jpeg_dec_backend_t backend, result_t &r)
+{
+    std::vector<uint8_t> jpeg, rgb;
+    std::vector<uint16_t> ref;
+    int rw, rh;
+    // Mapped, not read: the decoder takes the file in place, as it takes flash on the device
+    mmap_image_source source(path.c_str());
+    const uint8_t *data;
+    size_t len;
+    if (source.acquire(&data, &len) != IMAGE_SOURCE_OK) {
+        return false;
+    }
+    jpeg.assign(data, data + len);
+    source.release();
+    if (!ref_decode(jpeg.data(), jpeg.size(), &rw, &rh, rgb)) {
+        return false;
+    }
+    r.reference = reference_decode(jpeg, backend, rw, rh, ref);
+
+    jpeg_dec_limits_t limits = {};
+    limits.backend = backend;
+    std::vector<double> totals;
+    std::vector<double> calib;
+    std::vector<double> strips;
+    double first = 0;
+    s_frame.assign((size_t)rw * rh, 0);
+    s_frame_w = rw;
+    for (int i = 0; i < runs; i++) {
+        s_strip_us.clear();
+        int64_t t = esp_timer_get_time();
+        s_last_us = t;
+        esp_jpeg_decoder_block_out(source, benchDrawCallback, &limits);
+        totals.push_back((double)(esp_timer_get_time() - t));
+        if (!s_strip_us.empty()) {
+            // The first strip also pays for mapping, header parse and buffer setup
+            first += s_strip_us[0];
+            strips.insert(strips.end(), s_strip_us.begin() + 1, s_strip_us.end());
+        }
+        // Plain libjpeg decode of the same image right after, as a yardstick for how fast the host is right now
+        t = esp_timer_get_time();
+        ref_decode(jpeg.data(), jpeg.size(), &rw, &rh, rgb);
+        calib.push_back((double)(esp_timer_get_time() - t));
+    }
+
+    size_t slash = path.find_last_of('/');
+    r.name = slash == std::string::npos ? path : path.substr(slash + 1);
+    r.width = rw;
+    r.height = rh;
+    r.bytes = len;
+    // Best of the runs: host scheduling only ever adds time, so the minimum is the stable figure
+    r.total_us = *std::min_element(totals.begin(), totals.end());
+    r.calib_us = *std::min_element(calib.begin(), calib.end());
+    r.spread_pct = r.total_us > 0 ? 100.0 * (percentile(totals, 0.5) - r.total_us) / r.total_us : 0;
+    r.mpix_s = r.total_us > 0 ? (double)rw * rh / r.total_us : 0;
+    r.strips = (int)s_strip_us.size();
+    r.strip_p50_us = percentile(strips, 0.50);
+    r.strip_p90_us = percentile(strips, 0.90);
+    r.strip_p99_us = percentile(strips, 0.99);
+    r.strip_max_us = percentile(strips, 1.0);
+    r.first_strip_us = first / runs;
+    r.psnr_db = r.reference != NULL ? psnr_565(s_frame, ref) : 0;
+    return true;
+}
+
+static void collect(const char *arg, std::vector<std::string> &paths)
+{
+    DIR *dir = opendir(arg);
+    if (dir == NULL) {
+        paths.push_back(arg);
+        return;
+    }
+    std::vector<std::string> found;
+    for (struct dirent *e = readdir(dir); e != NULL; e = readdir(dir)) {
+        std::string name = e->d_name;
+        if (name.size() > 4 && (name.compare(name.size() - 4, 4, ".jpg") == 0 || name.compare(name.size() - 4, 4, ".JPG") == 0)) {
+            found.push_back(std::string(arg) + "/" + name);
+        }
+    }
+    closedir(dir);
+    std::sort(found.begin(), found.end());
+    paths.insert(paths.end(), found.begin(), found.end());
+}
+
+static bool json_number(const char *line, const char *key, double *value)
+{
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "\"%s\": ", key);
+    const char *p = strstr(line, pattern);
+    return p != NULL && sscanf(p + strlen(pattern), "%lf", value) == 1;
+}
+
+static bool json_string(const char *line, const char *key, std::string &value)
+{
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "\"%s\": \"", key);
+    const char *p = strstr(line, pattern);
+    if (p == NULL) {
+        return false;
+    }
+    p += strlen(pattern);
+    const char *end = strchr(p, '"');
+    if (end == NULL) {
+        return false;
+    }
+    value.assign(p, end - p);
+    return true;
+}
+
+// Results are written one image per line, so the baseline can be read back line by line
+static bool load_baseline(const char *path, std::vector<result_t> &out)
+{
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        return false;
+    }
+    char line[1024];
+    while (fgets(line, sizeof(line), f)) {
+        result_t r = {};
+        std::string reference;
+        if (json_string(line, "name", r.name) && json_number(line, "mpix_s", &r.mpix_s) && json_number(line, "psnr_db", &r.psnr_db)) {
+            // Results from before the yardstick and the independent reference lack these
+            json_number(line, "calib_us", &r.calib_us);
+            json_number(line, "total_us", &r.total_us);
+            r.reference = json_string(line, "reference", reference) && reference == "baseline" ? "baseline" : "libjpeg";
+            out.push_back(r);
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+static bool write_json(const char *path, const std::vector<result_t> &results)
+{
+    FILE *f = fopen(path, "w");
+    if (f == NULL) {
+        return false;
+    }
+    fprintf(f, "{\n  \"tool\": \"jpeg_bench\",\n  \"images\": [\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        const result_t &r = results[i];
+        fprintf(f, "    {\"name\": \"%s\", \"width\": %d, \"height\": %d, \"bytes\": %zu, \"mpix_s\": %.3f, \"total_us\": %.1f, "
+                "\"strips\": %d, \"strip_p50_us\": %.1f, \"strip_p90_us\": %.1f, \"strip_p99_us\": %.1f, \"strip_max_us\": %.1f, "
+                "\"first_strip_us\": %.1f, \"spread_pct\": %.1f, \"calib_us\": %.1f, \"psnr_db\": %.2f, \"reference\": \"%s\"}%s\n",
+                r.name.c_str(), r.width, r.height, r.bytes, r.mpix_s, r.total_us, r.strips, r.strip_p50_us, r.strip_p90_us,
+                r.strip_p99_us, r.strip_max_us, r.first_strip_us, r.spread_pct, r.calib_us, r.psnr_db,
+                r.reference ? r.reference : "none", i + 1 < results.size() ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    fclose(f);
+    return true;
+}
+
+static size_t write_trace(const uint8_t *data, size_t len, void *ctx)
+{
+    return fwrite(data, 1, len, (FILE *)ctx);
+}
+
+static void usage()
+{
+    fprintf(stderr,
+            "usage: jpeg_bench --gen DIR SEED.jpg\n"
+            "       jpeg_bench [--runs N] [--json OUT] [--baseline PREV] [--tolerance PCT]\n"
+            "                  [--backend library|baseline] [--trace OUT] image-or-dir...\n");
+}
+
+int main(int argc, char **argv)
+{
+    int runs = 10;
+    double tolerance = 10.0;
+    const char *json = NULL;
+    const char *baseline = NULL;
+    const char *trace = NULL;
+    jpeg_dec_backend_t backend = JPEG_DEC_BACKEND_LIBRARY;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--gen") == 0 && i + 2 < argc) {
+            return generate_corpus(argv[i + 1], argv[i + 2]);
+        } else if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+            runs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json = argv[++i];
+        } else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            baseline = argv[++i];
+        } else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+            tolerance = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--backend") == 0 && i + 1 < argc) {
+            i++;
+            backend = strcmp(argv[i], "baseline") == 0 ? JPEG_DEC_BACKEND_BASELINE : JPEG_DEC_BACKEND_LIBRARY;
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace = argv[++i];
+        } else if (argv[i][0] == '-') {
+            usage();
+            return 2;
+        } else {
+            collect(argv[i], paths);
+        }
+    }
+    if (paths.empty() || runs <= 0) {
+        usage();
+        return 2;
+    }
+
+    // Same regions as setup(), so the output strip and the baseline planes come from where they would on the device
+    if (!pipeline_mem.begin(ARENA_INTERNAL_SIZE, ARENA_PSRAM_SIZE)) {
+        fprintf(stderr, "arena reservation failed\n");
+        return 1;
+    }
+    if (trace != NULL && (!PIPELINE_TRACE || !pipeline_tracer.begin(1 << 16))) {
+        fprintf(stderr, "--trace needs a build with -DPIPELINE_TRACE=1\n");
+        return 2;
+    }
+    pipeline_tracer.setEnabled(trace != NULL);
+
+    std::vector<result_t> results;
+    int failed = 0;
+    printf("%-28s %9s %8s %8s %8s %8s %8s %7s %s\n", "image", "MPix/s", "p50_us", "p90_us", "p99_us", "max_us", "first_us", "psnr", "ref");
+    for (const std::string &path : paths) {
+        result_t r;
+        if (!bench_one(path, runs, backend, r)) {
+            fprintf(stderr, "%s: unreadable\n", path.c_str());
+            failed++;
+            continue;
+        }
+        printf("%-28s %9.2f %8.0f %8.0f %8.0f %8.0f %8.0f %7.2f %s\n", r.name.c_str(), r.mpix_s, r.strip_p50_us, r.strip_p90_us,
+               r.strip_p99_us, r.strip_max_us, r.first_strip_us, r.psnr_db, r.reference ? r.reference : "-");
+        results.push_back(r);
+    }
+
+    arena_stats_t in = pipeline_mem.stats(ARENA_INTERNAL);
+    printf("internal arena: peak %u of %u bytes, %u requests went to the heap\n", (unsigned)in.peak, (unsigned)in.size,
+           (unsigned)in.failed);
+
+    if (trace != NULL) {
+        FILE *f = fopen(trace, "wb");
+        size_t bytes = f != NULL ? pipeline_tracer.dump(write_trace, f) : 0;
+        if (f == NULL || fclose(f) != 0 || bytes == 0) {
+            fprintf(stderr, "%s: cannot write\n", trace);
+            return 1;
+        }
+        trace_stats_t ts = pipeline_tracer.stats();
+        printf("trace: %u records (%u overwritten), %u ns each, %u bytes to %s\n", ts.recorded, ts.overwritten, ts.record_ns,
+               (unsigned)bytes, trace);
+    }
+
+    if (json != NULL && !write_json(json, results)) {
+        fprintf(stderr, "%s: cannot write\n", json);
+        return 1;
+    }
+
+    int regressions = 0;
+    if (baseline != NULL) {
+        std::vector<result_t> prev;
+        if (!load_baseline(baseline, prev)) {
+            fprintf(stderr, "%s: cannot read baseline\n", baseline);
+            return 1;
+        }
+        // Throughput is judged on the geometric mean over all images: single small images
+        // move by more than any useful tolerance from one run to the next
+        double log_sum = 0;
+        int matched = 0;
+        const result_t *worst = NULL;
+        double worst_ratio = 0;
+        for (const result_t &r : results) {
+            for (const result_t &p : prev) {
+                if (p.name != r.name) {
+                    continue;
+                }
+                if (p.mpix_s > 0 && r.mpix_s > 0) {
+                    // Against the libjpeg yardstick where both runs have it, so a busier or slower host cancels out
+                    double ratio = r.mpix_s / p.mpix_s;
+                    if (p.calib_us > 0 && p.total_us > 0 && r.calib_us > 0) {
+                        ratio = (r.calib_us / r.total_us) / (p.calib_us / p.total_us);
+                    }
+                    log_sum += log(ratio);
+                    matched++;
+                    if (worst == NULL || ratio < worst_ratio) {
+                        worst = &r;
+                        worst_ratio = ratio;
+                    }
+                }
+                // Scores against different references do not compare
+                bool same_ref = r.reference != NULL && strcmp(r.reference, p.reference) == 0;
+                if (same_ref && r.psnr_db < p.psnr_db - BENCH_PSNR_DROP_DB) {
+                    printf("REGRESSION %s: quality (%.2f -> %.2f dB)\n", r.name.c_str(), p.psnr_db, r.psnr_db);
+                    regressions++;
+                }
+            }
+        }
+        if (matched > 0) {
+            double geo = exp(log_sum / matched);
+            std::vector<double> spread;
+            for (const result_t &r : results) {
+                spread.push_back(r.spread_pct);
+            }
+            printf("throughput %.1f%% of baseline over %d images (geometric mean; worst %s at %.1f%%), run-to-run noise p50 %.1f%%\n",
+                   100.0 * geo, matched, worst->name.c_str(), 100.0 * worst_ratio, percentile(spread, 0.5));
+            if (geo < 1.0 - tolerance / 100.0) {
+                printf("REGRESSION throughput: %.1f%% below baseline, tolerance %.1f%%\n", 100.0 * (1.0 - geo), tolerance);
+                regressions++;
+            }
+        }
+        printf("%d regression(s) against %s\n", regressions, baseline);
+    }
+    return (failed || regressions) ? 1 : 0;
+}
@@ -0,0 +1,396 @@
+/*
+ * jpeg_fuzz: mutation fuzzing of the bounded decode loop in jpeg_dec.h.
+ *
+ *   g++ -O1 -g -fsanitize=address,undefined -I../host -o jpeg_fuzz jpeg_fuzz.cpp \
+ *       ../host/esp_jpeg_host.cpp ../host/host_runtime.cpp ../../src/mem/pipeline_arena.cpp \
+ *       ../../src/decode/baseline_jpeg.cpp ../../src/decode/baseline_idct.cpp -ljpeg
+ *   ./jpeg_fuzz [--iterations 20000] [--seed 1] [--budget-ms 50 | --default-limits] [--limit-ms 100]
+ *               [--save DIR] [--backend library|baseline] a.jpg b.jpg
+ *   ./jpeg_fuzz --replay DIR
+ *
+ * Every seed is mutated (truncation, bit flips, byte runs, inserted/deleted/
+ * duplicated ranges, stomped markers, edited SOF fields) and each result is run
+ * through esp_jpeg_decoder_block_out() with --budget-ms as its time budget. The
+ * run fails if any input takes longer than --limit-ms, hangs (a watchdog timer
+ * aborts the process), or hands the callback lines outside the image. --save
+ * keeps the generated corpus, and the failing input as crash.jpg, so a run can
+ * be replayed later with --replay. --backend baseline fuzzes the in-tree
+ * decoder instead of the library stand-in. --default-limits passes no time
+ * budget, as most callers do, so the budget the decoder derives from the
+ * (mutated) header is what bounds the loop; --limit-ms then defaults to
+ * JPEG_DEC_DEFAULT_CEILING_US plus 500 ms.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/time.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "esp_timer.h"
+#include "../../jpeg_dec.h"
+
+#define FUZZ_RESULT_COUNT (JPEG_DEC_ERR_SOURCE + 1)
+
+// Decoder under test
+static jpeg_dec_backend_t s_backend = JPEG_DEC_BACKEND_LIBRARY;
+
+// Callback state
+static int s_height;
+static int s_bad_lines;
+
+// Watchdog state
+static const char *s_save_dir = NULL;
+static const std::vector<uint8_t> *s_current = NULL;
+static long s_current_id;
+
+static int fuzzDrawCallback(jpeg_dec_io_t *jpeg_io, jpeg_dec_header_info_t *out_info)
+{
+    int y = jpeg_io->output_line - jpeg_io->cur_line;
+    if (y < 0 || jpeg_io->cur_line <= 0 || jpeg_io->output_line > out_info->height || out_info->height != s_height) {
+        s_bad_lines++;
+    }
+    return 1;
+}
+
+static void save_file(const std::string &path, const std::vector<uint8_t> &data)
+{
+    FILE *f = fopen(path.c_str(), "wb");
+    if (f != NULL) {
+        fwrite(data.data(), 1, data.size(), f);
+        fclose(f);
+    }
+}
+
+static void watchdog(int sig)
+{
+    (void)sig;
+    fprintf(stderr, "\nHANG: input %ld did not finish\n", s_current_id);
+    if (s_save_dir != NULL && s_current != NULL) {
+        save_file(std::string(s_save_dir) + "/crash.jpg", *s_current);
+    }
+    _exit(1);
+}
+
+static bool read_file(const std::string &path, std::vector<uint8_t> &data)
+{
+    FILE *f = fopen(path.c_str(), "rb");
+    if (f == NULL) {
+        return false;
+    }
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    data.resize(len > 0 ? len : 0);
+    bool ok = len > 0 && fread(data.data(), 1, len, f) == (size_t)len;
+    fclose(f);
+    return ok;
+}
+
+static uint32_t rnd(uint32_t n)
+{
+    return n ? (uint32_t)(rand() % n) : 0;
+}
+
+// Offset of the first SOFn payload, or 0
+static size_t find_sof(const std::vector<uint8_t> &d)
+{
+    for (size_t i = 2; i + 10 < d.size(); i++) {
+        if (d[i] == 0xFF && d[i + 1] >= 0xC0 && d[i + 1] <= 0xCF && d[i + 1] != 0xC4 && d[i + 1] != 0xC8 && d[i + 1] != 0xCC) {
+            return i + 4;
+        }
+    }
+    return 0;
+}
+
+static void mutate(std::vector<uint8_t> &d)
+{
+    static const uint16_t dims[] = {0, 1, 7, 8, 9, 15, 16, 17, 255, 4096, 32767, 65535};
+    size_t n = d.size();
+
+    switch (rnd(8)) {
+    case 0: // truncate
+        d.resize(2 + rnd(n - 2));
+        break;
+    case 1: // bit flips
+        for (uint32_t k = 1 + rnd(8); k > 0; k--) {
+            d[rnd(n)] ^= 1 << rnd(8);
+        }
+        break;
+    case 2: { // run of one byte value
+        size_t at = rnd(n);
+        size_t len = std::min<size_t>(1 + rnd(64), n - at);
+        memset(&d[at], rnd(2) ? 0xFF : rnd(256), len);
+        break;
+    }
+    case 3: { // insert random bytes
+        std::vector<uint8_t> junk(1 + rnd(32));
+        for (uint8_t &b : junk) {
+            b = rnd(256);
+        }
+        d.insert(d.begin() + rnd(n), junk.begin(), junk.end());
+        break;
+    }
+    case 4: { // delete a range
+        size_t at = 2 + rnd(n - 2);
+        d.erase(d.begin() + at, d.begin() + std::min(n, at + 1 + rnd(256)));
+        break;
+    }
+    case 5: { // duplicate a range
+        size_t at = rnd(n);
+        size_t len = std::min<size_t>(1 + rnd(512), n - at);
+        std::vector<uint8_t> copy(d.begin() + at, d.begin() + at + len);
+        d.insert(d.begin() + rnd(n), copy.begin(), copy.end());
+        break;
+    }
+    case 6: { // stomp a marker
+        std::vector<size_t> markers;
+        for (size_t i = 0; i + 1 < n; i++) {
+            if (d[i] == 0xFF && d[i + 1] != 0x00 && d[i + 1] != 0xFF) {
+                markers.push_back(i + 1);
+            }
+        }
+        if (!markers.empty()) {
+            d[markers[rnd(markers.size())]] = 0xC0 + rnd(64);
+        }
+        break;
+    }
+    default: { // edit SOF: precision, height, width, component count or sampling factors
+        size_t sof = find_sof(d);
+        if (sof == 0) {
+            d[rnd(n)] ^= 0xFF;
+            break;
+        }
+        uint16_t v = dims[rnd(sizeof(dims) / sizeof(dims[0]))];
+        switch (rnd(5)) {
+        case 0:
+            d[sof] = rnd(2) ? 12 : rnd(256);
+            break;
+        case 1:
+            d[sof + 1] = v >> 8;
+            d[sof + 2] = v & 0xFF;
+            break;
+        case 2:
+            d[sof + 3] = v >> 8;
+            d[sof + 4] = v & 0xFF;
+            break;
+        case 3:
+            d[sof + 5] = rnd(6);
+            break;
+        default:
+            if (sof + 7 < n) {
+                d[sof + 7] = (rnd(5) << 4) | rnd(5);
+            }
+            break;
+        }
+        break;
+    }
+    }
+}
+
+typedef struct {
+    uint32_t runs;
+    uint32_t results[FUZZ_RESULT_COUNT];
+    uint32_t over_limit;
+    uint32_t bad_lines;
+    uint32_t max_us;
+    uint64_t total_us;
+    long slowest;
+} fuzz_stats_t;
+
+static bool run_one(const std::vector<uint8_t> &data, long id, uint32_t budget_us, uint32_t limit_us, fuzz_stats_t &st)
+{
+    // The decoder wants a 16-byte aligned input buffer, as on the device
+    unsigned char *in = (unsigned char *)jpeg_malloc_align(data.size(), 16);
+    memcpy(in, data.data(), data.size());
+
+    jpeg_dec_limits_t limits = {};
+    limits.max_us = budget_us;
+    limits.backend = s_backend;
+    jpeg_dec_report_t report;
+
+    s_current = &data;
+    s_current_id = id;
+    s_bad_lines = 0;
+    s_height = -1;
+
+    // Re-armed per input; fires only if the decode loop itself never returns
+    struct itimerval wd = {};
+    wd.it_value.tv_sec = limit_us / 1000000 * 10 + 1;
+    setitimer(ITIMER_REAL, &wd, NULL);
+
+    // Learn the height the header reports so the callback can check its lines
+    jpeg_dec_handle_t *probe_dec = NULL;
+    jpeg_dec_config_t config = DEFAULT_JPEG_DEC_CONFIG();
+    jpeg_dec_io_t probe_io = {};
+    jpeg_dec_header_info_t probe_info = {};
+    bool baseline = s_backend == JPEG_DEC_BACKEND_BASELINE;
+    probe_dec = baseline ? baseline_jpeg_open(&config) : jpeg_dec_open(&config);
+    probe_io.inbuf = in;
+    probe_io.inbuf_len = data.size();
+    if (probe_dec != NULL && (baseline ? baseline_jpeg_parse_header(probe_dec, &probe_io, &probe_info)
+                                       : jpeg_dec_parse_header(probe_dec, &probe_io, &probe_info)) == JPEG_ERR_OK) {
+        s_height = probe_info.height;
+    }
+    if (probe_dec != NULL) {
+        if (baseline) {
+            baseline_jpeg_close(probe_dec);
+        } else {
+            jpeg_dec_close(probe_dec);
+        }
+    }
+
+    int64_t t = esp_timer_get_time();
+    jpeg_dec_result_t result = esp_jpeg_decoder_block_out(in, data.size(), fuzzDrawCallback, &limits, &report);
+    uint32_t us = (uint32_t)(esp_timer_get_time() - t);
+
+    struct itimerval off = {};
+    setitimer(ITIMER_REAL, &off, NULL);
+    jpeg_free_align(in);
+
+    st.runs++;
+    st.results[result < FUZZ_RESULT_COUNT ? result : JPEG_DEC_ERR_ARG]++;
+    st.total_us += us;
+    if (us > st.max_us) {
+        st.max_us = us;
+        st.slowest = id;
+    }
+    bool ok = true;
+    if (us > limit_us) {
+        fprintf(stderr, "SLOW: input %ld took %u us (%s)\n", id, us, jpeg_dec_result_name(result));
+        st.over_limit++;
+        ok = false;
+    }
+    if (s_bad_lines) {
+        fprintf(stderr, "BAD LINES: input %ld handed %d out-of-range strips to the callback\n", id, s_bad_lines);
+        st.bad_lines++;
+        ok = false;
+    }
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    long iterations = 20000;
+    unsigned seed = 1;
+    uint32_t budget_ms = 50;
+    uint32_t limit_ms = 0;
+    bool default_limits = false;
+    const char *replay = NULL;
+    std::vector<std::string> seeds;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--budget-ms") == 0 && i + 1 < argc) {
+            budget_ms = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--default-limits") == 0) {
+            default_limits = true;
+        } else if (strcmp(argv[i], "--limit-ms") == 0 && i + 1 < argc) {
+            limit_ms = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--save") == 0 && i + 1 < argc) {
+            s_save_dir = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replay = argv[++i];
+        } else if (strcmp(argv[i], "--backend") == 0 && i + 1 < argc) {
+            i++;
+            s_backend = strcmp(argv[i], "baseline") == 0 ? JPEG_DEC_BACKEND_BASELINE : JPEG_DEC_BACKEND_LIBRARY;
+        } else if (argv[i][0] == '-') {
+            seeds.clear();
+            break;
+        } else {
+            seeds.push_back(argv[i]);
+        }
+    }
+    if (default_limits) {
+        // The decoder picks the budget, up to its ceiling
+        budget_ms = 0;
+        limit_ms = limit_ms ? limit_ms : JPEG_DEC_DEFAULT_CEILING_US / 1000 + 500;
+    } else {
+        limit_ms = limit_ms ? limit_ms : 100;
+    }
+    if ((seeds.empty() && replay == NULL) || iterations <= 0 || (budget_ms == 0 && !default_limits) || limit_ms < budget_ms) {
+        fprintf(stderr, "usage: jpeg_fuzz [--iterations N] [--seed S] [--budget-ms MS | --default-limits] [--limit-ms MS]\n"
+                        "                 [--save DIR] [--backend library|baseline] seed.jpg...\n"
+                        "       jpeg_fuzz [--budget-ms MS | --default-limits] [--limit-ms MS] [--backend library|baseline] --replay DIR\n");
+        return 2;
+    }
+
+    signal(SIGALRM, watchdog);
+    fuzz_stats_t st = {};
+    uint32_t budget_us = budget_ms * 1000;
+    uint32_t limit_us = limit_ms * 1000;
+    int failures = 0;
+
+    if (replay != NULL) {
+        std::vector<std::string> files;
+        DIR *dir = opendir(replay);
+        if (dir == NULL) {
+            fprintf(stderr, "%s: cannot open\n", replay);
+            return 1;
+        }
+        for (struct dirent *e = readdir(dir); e != NULL; e = readdir(dir)) {
+            if (e->d_name[0] != '.') {
+                files.push_back(std::string(replay) + "/" + e->d_name);
+            }
+        }
+        closedir(dir);
+        std::sort(files.begin(), files.end());
+        for (size_t i = 0; i < files.size(); i++) {
+            std::vector<uint8_t> data;
+            if (read_file(files[i], data) && !run_one(data, (long)i, budget_us, limit_us, st)) {
+                fprintf(stderr, "  %s\n", files[i].c_str());
+                failures++;
+            }
+        }
+    } else {
+        std::vector<std::vector<uint8_t>> inputs;
+        for (const std::string &path : seeds) {
+            std::vector<uint8_t> data;
+            if (!read_file(path, data) || data.size() < 4) {
+                fprintf(stderr, "%s: cannot read\n", path.c_str());
+                return 1;
+            }
+            inputs.push_back(data);
+        }
+
+        srand(seed);
+        for (long i = 0; i < iterations; i++) {
+            std::vector<uint8_t> data = inputs[i % inputs.size()];
+            for (uint32_t k = 1 + rnd(3); k > 0 && data.size() > 4; k--) {
+                mutate(data);
+            }
+            if (s_save_dir != NULL) {
+                char name[64];
+                snprintf(name, sizeof(name), "/fuzz_%06ld.jpg", i);
+                save_file(std::string(s_save_dir) + name, data);
+            }
+            if (!run_one(data, i, budget_us, limit_us, st)) {
+                if (s_save_dir != NULL) {
+                    save_file(std::string(s_save_dir) + "/crash.jpg", data);
+                }
+                failures++;
+            }
+        }
+    }
+
+    if (default_limits) {
+        printf("%u inputs, default budget, limit %u ms: max %.2f ms (input %ld), mean %.3f ms\n", st.runs, limit_ms,
+               st.max_us / 1000.0, st.slowest, st.runs ? st.total_us / 1000.0 / st.runs : 0.0);
+    } else {
+        printf("%u inputs, budget %u ms, limit %u ms: max %.2f ms (input %ld), mean %.3f ms\n", st.runs, budget_ms, limit_ms,
+               st.max_us / 1000.0, st.slowest, st.runs ? st.total_us / 1000.0 / st.runs : 0.0);
+    }
+    for (int r = 0; r < FUZZ_RESULT_COUNT; r++) {
+        if (st.results[r]) {
+            printf("  %-26s %u\n", jpeg_dec_result_name((jpeg_dec_result_t)r), st.results[r]);
+        }
+    }
+    printf("%u over the time limit, %u with out-of-range strips\n", st.over_limit, st.bad_lines);
+    return failures ? 1 : 0;
+}
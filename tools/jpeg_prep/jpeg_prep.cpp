@@ -0,0 +1,533 @@
+/*
+ * jpeg_prep: re-encode images into the JPEG profile the panel pipeline decodes fastest.
+ *
+ *   g++ -O2 -o jpeg_prep jpeg_prep.cpp -ljpeg
+ *   ./jpeg_prep -o out/ --subsampling 420 --restart 2 a.jpg b.ppm
+ *
+ * Every input (JPEG or binary PPM) is scaled and cropped (or letterboxed) to the
+ * panel size and written as a baseline, non-progressive JPEG without JFIF/EXIF
+ * or any other APPn/COM segments. An EXIF Orientation is applied to the pixels
+ * first, since the tag that would have told a viewer to do so is dropped. For
+ * each asset it prints a predicted device decode cost from a linear model and
+ * the decode time measured on this host.
+ *
+ * Outputs are named after the inputs, <name>.jpg in the -o directory. Nothing
+ * is written if an output would replace one of the inputs (e.g. a.jpg into its
+ * own directory) or if two inputs map to the same output (a.jpg and a.ppm).
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#include <string>
+#include <vector>
+#include <setjmp.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <jpeglib.h>
+
+typedef struct {
+    int width;
+    int height;
+    std::vector<uint8_t> rgb;
+} image_t;
+
+typedef struct {
+    int width = 480;
+    int height = 272;
+    bool cover = true;
+    int subsampling = 420;
+    int restart_rows = 0;
+    int quality = 85;
+    bool optimize = true;
+    int runs = 20;
+    // Device cost model: us per 8x8 block, per entropy-coded KB and per output pixel
+    double us_per_block = 1.6;
+    double us_per_kb = 95.0;
+    double us_per_px = 0.045;
+    std::string out_dir = ".";
+} options_t;
+
+typedef struct {
+    struct jpeg_error_mgr pub;
+    jmp_buf jmp;
+} jpeg_err_t;
+
+static void jpeg_error_exit(j_common_ptr cinfo)
+{
+    jpeg_err_t *err = (jpeg_err_t *)cinfo->err;
+    (*cinfo->err->output_message)(cinfo);
+    longjmp(err->jmp, 1);
+}
+
+static double now_ms()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static bool read_file(const char *path, std::vector<uint8_t> &data)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        return false;
+    }
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    data.resize(len > 0 ? len : 0);
+    bool ok = len > 0 && fread(data.data(), 1, len, f) == (size_t)len;
+    fclose(f);
+    return ok;
+}
+
+// Decode with libjpeg; min_w/min_h let the IDCT pre-shrink huge sources
+static bool decode_jpeg(const std::vector<uint8_t> &data, image_t &img, int min_w, int min_h)
+{
+    struct jpeg_decompress_struct cinfo;
+    jpeg_err_t jerr;
+
+    cinfo.err = jpeg_std_error(&jerr.pub);
+    jerr.pub.error_exit = jpeg_error_exit;
+    if (setjmp(jerr.jmp)) {
+        jpeg_destroy_decompress(&cinfo);
+        return false;
+    }
+    jpeg_create_decompress(&cinfo);
+    jpeg_mem_src(&cinfo, data.data(), data.size());
+    jpeg_read_header(&cinfo, TRUE);
+    cinfo.out_color_space = JCS_RGB;
+
+    if (min_w > 0 && min_h > 0) {
+        cinfo.scale_num = 1;
+        cinfo.scale_denom = 8;
+        while (cinfo.scale_denom > 1 &&
+               ((long)cinfo.image_width * cinfo.scale_num / cinfo.scale_denom < min_w ||
+                (long)cinfo.image_height * cinfo.scale_num / cinfo.scale_denom < min_h)) {
+            cinfo.scale_denom >>= 1;
+        }
+    }
+
+    jpeg_start_decompress(&cinfo);
+    img.width = cinfo.output_width;
+    img.height = cinfo.output_height;
+    img.rgb.resize((size_t)img.width * img.height * 3);
+    while (cinfo.output_scanline < cinfo.output_height) {
+        JSAMPROW row = &img.rgb[(size_t)cinfo.output_scanline * img.width * 3];
+        jpeg_read_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    return true;
+}
+
+// EXIF Orientation (1..8) from the APP1 segment, 1 when there is none
+static int exif_orientation(const std::vector<uint8_t> &data)
+{
+    size_t pos = 2;
+    while (pos + 4 <= data.size() && data[pos] == 0xFF) {
+        uint8_t marker = data[pos + 1];
+        size_t len = (data[pos + 2] << 8) | data[pos + 3];
+        if (marker == 0xDA || marker == 0xD9 || len < 2 || pos + 2 + len > data.size()) {
+            break;
+        }
+        const uint8_t *seg = &data[pos + 4];
+        size_t seg_len = len - 2;
+        if (marker == 0xE1 && seg_len >= 14 && memcmp(seg, "Exif\0\0", 6) == 0) {
+            const uint8_t *tiff = seg + 6;
+            size_t tiff_len = seg_len - 6;
+            bool le = tiff[0] == 'I' && tiff[1] == 'I';
+            if (!le && !(tiff[0] == 'M' && tiff[1] == 'M')) {
+                return 1;
+            }
+            auto u16 = [&](size_t o) -> uint32_t {
+                return le ? tiff[o] | (tiff[o + 1] << 8) : (tiff[o] << 8) | tiff[o + 1];
+            };
+            auto u32 = [&](size_t o) -> uint32_t {
+                return le ? u16(o) | (u16(o + 2) << 16) : (u16(o) << 16) | u16(o + 2);
+            };
+            size_t ifd = u32(4);
+            if (ifd + 2 > tiff_len) {
+                return 1;
+            }
+            uint32_t entries = u16(ifd);
+            for (uint32_t i = 0; i < entries && ifd + 2 + (i + 1) * 12 <= tiff_len; i++) {
+                size_t e = ifd + 2 + i * 12;
+                // Tag 0x0112, type SHORT, one value held in the entry itself
+                if (u16(e) == 0x0112 && u16(e + 2) == 3) {
+                    uint32_t o = u16(e + 8);
+                    return o >= 1 && o <= 8 ? (int)o : 1;
+                }
+            }
+            return 1;
+        }
+        pos += 2 + len;
+    }
+    return 1;
+}
+
+// Turn the pixels upright as the EXIF Orientation says; 5..8 swap width and height
+static void apply_orientation(image_t &img, int orientation)
+{
+    if (orientation <= 1 || orientation > 8) {
+        return;
+    }
+    int w = img.width, h = img.height;
+    bool swap = orientation >= 5;
+    image_t out;
+    out.width = swap ? h : w;
+    out.height = swap ? w : h;
+    out.rgb.resize(img.rgb.size());
+    for (int y = 0; y < out.height; y++) {
+        for (int x = 0; x < out.width; x++) {
+            int sx, sy;
+            switch (orientation) {
+            case 2: sx = w - 1 - x; sy = y; break;             // mirrored
+            case 3: sx = w - 1 - x; sy = h - 1 - y; break;     // rotated 180
+            case 4: sx = x; sy = h - 1 - y; break;             // flipped
+            case 5: sx = y; sy = x; break;                     // transposed
+            case 6: sx = y; sy = h - 1 - x; break;             // shown rotated 90 clockwise
+            case 7: sx = w - 1 - y; sy = h - 1 - x; break;     // transversed
+            default: sx = w - 1 - y; sy = x; break;            // 8: shown rotated 90 counter-clockwise
+            }
+            memcpy(&out.rgb[((size_t)y * out.width + x) * 3], &img.rgb[((size_t)sy * w + sx) * 3], 3);
+        }
+    }
+    img = out;
+}
+
+static bool decode_ppm(const std::vector<uint8_t> &data, image_t &img)
+{
+    int w, h, maxval, n = 0;
+    if (data.size() < 3 || sscanf((const char *)data.data(), "P6 %d %d %d%n", &w, &h, &maxval, &n) != 3 || maxval != 255) {
+        return false;
+    }
+    size_t offset = n + 1;
+    if (w <= 0 || h <= 0 || data.size() < offset + (size_t)w * h * 3) {
+        return false;
+    }
+    img.width = w;
+    img.height = h;
+    img.rgb.assign(data.begin() + offset, data.begin() + offset + (size_t)w * h * 3);
+    return true;
+}
+
+// Area-weighted resample of the (sx, sy, sw, sh) source window into dst
+static void resample_area(const image_t &src, double sx, double sy, double sw, double sh, image_t &dst, int dx, int dy, int dw, int dh)
+{
+    double fx = sw / dw;
+    double fy = sh / dh;
+
+    for (int y = 0; y < dh; y++) {
+        double y0 = sy + y * fy;
+        double y1 = y0 + fy;
+        for (int x = 0; x < dw; x++) {
+            double x0 = sx + x * fx;
+            double x1 = x0 + fx;
+            double acc[3] = {0, 0, 0};
+            double wsum = 0;
+            // Upscaling degenerates to a one-pixel footprint; fine for panel-sized output
+            for (int iy = (int)floor(y0); iy < (int)ceil(y1); iy++) {
+                double wy = fmin(y1, iy + 1.0) - fmax(y0, (double)iy);
+                int cy = iy < 0 ? 0 : (iy >= src.height ? src.height - 1 : iy);
+                for (int ix = (int)floor(x0); ix < (int)ceil(x1); ix++) {
+                    double wx = fmin(x1, ix + 1.0) - fmax(x0, (double)ix);
+                    int cx = ix < 0 ? 0 : (ix >= src.width ? src.width - 1 : ix);
+                    const uint8_t *p = &src.rgb[((size_t)cy * src.width + cx) * 3];
+                    double w = wx * wy;
+                    acc[0] += p[0] * w;
+                    acc[1] += p[1] * w;
+                    acc[2] += p[2] * w;
+                    wsum += w;
+                }
+            }
+            uint8_t *q = &dst.rgb[((size_t)(dy + y) * dst.width + dx + x) * 3];
+            for (int c = 0; c < 3; c++) {
+                q[c] = (uint8_t)lround(wsum > 0 ? acc[c] / wsum : 0);
+            }
+        }
+    }
+}
+
+static void fit_to_panel(const image_t &src, const options_t &opt, image_t &dst)
+{
+    dst.width = opt.width;
+    dst.height = opt.height;
+    dst.rgb.assign((size_t)dst.width * dst.height * 3, 0);
+
+    double scale_w = (double)opt.width / src.width;
+    double scale_h = (double)opt.height / src.height;
+
+    if (opt.cover) {
+        // Fill the panel, crop the overflow symmetrically
+        double scale = fmax(scale_w, scale_h);
+        double sw = opt.width / scale;
+        double sh = opt.height / scale;
+        resample_area(src, (src.width - sw) / 2, (src.height - sh) / 2, sw, sh, dst, 0, 0, opt.width, opt.height);
+    } else {
+        // Fit inside the panel, letterbox with black
+        double scale = fmin(scale_w, scale_h);
+        int dw = (int)lround(src.width * scale);
+        int dh = (int)lround(src.height * scale);
+        dw = dw < 1 ? 1 : (dw > opt.width ? opt.width : dw);
+        dh = dh < 1 ? 1 : (dh > opt.height ? opt.height : dh);
+        resample_area(src, 0, 0, src.width, src.height, dst, (opt.width - dw) / 2, (opt.height - dh) / 2, dw, dh);
+    }
+}
+
+static bool encode_jpeg(const image_t &img, const options_t &opt, std::vector<uint8_t> &out)
+{
+    struct jpeg_compress_struct cinfo;
+    jpeg_err_t jerr;
+    unsigned char *mem = NULL;
+    unsigned long mem_len = 0;
+
+    cinfo.err = jpeg_std_error(&jerr.pub);
+    jerr.pub.error_exit = jpeg_error_exit;
+    if (setjmp(jerr.jmp)) {
+        jpeg_destroy_compress(&cinfo);
+        free(mem);
+        return false;
+    }
+    jpeg_create_compress(&cinfo);
+    jpeg_mem_dest(&cinfo, &mem, &mem_len);
+
+    cinfo.image_width = img.width;
+    cinfo.image_height = img.height;
+    cinfo.input_components = 3;
+    cinfo.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, opt.quality, TRUE);
+    cinfo.optimize_coding = opt.optimize ? TRUE : FALSE;
+    cinfo.restart_in_rows = opt.restart_rows;
+    // No JFIF APP0; nothing else is written since we never call jpeg_write_marker()
+    cinfo.write_JFIF_header = FALSE;
+    cinfo.write_Adobe_marker = FALSE;
+
+    cinfo.comp_info[0].h_samp_factor = opt.subsampling == 444 ? 1 : 2;
+    cinfo.comp_info[0].v_samp_factor = opt.subsampling == 420 ? 2 : 1;
+    for (int c = 1; c < 3; c++) {
+        cinfo.comp_info[c].h_samp_factor = 1;
+        cinfo.comp_info[c].v_samp_factor = 1;
+    }
+
+    jpeg_start_compress(&cinfo, TRUE);
+    while (cinfo.next_scanline < cinfo.image_height) {
+        JSAMPROW row = (JSAMPROW)&img.rgb[(size_t)cinfo.next_scanline * img.width * 3];
+        jpeg_write_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+
+    out.assign(mem, mem + mem_len);
+    free(mem);
+    return true;
+}
+
+static double predict_device_ms(const std::vector<uint8_t> &jpeg, const options_t &opt)
+{
+    int mcu_w = opt.subsampling == 444 ? 8 : 16;
+    int mcu_h = opt.subsampling == 420 ? 16 : 8;
+    int blocks_per_mcu = opt.subsampling == 444 ? 3 : (opt.subsampling == 422 ? 4 : 6);
+    long mcus = (long)((opt.width + mcu_w - 1) / mcu_w) * ((opt.height + mcu_h - 1) / mcu_h);
+    double blocks = (double)mcus * blocks_per_mcu;
+    double px = (double)opt.width * opt.height;
+
+    return (blocks * opt.us_per_block + jpeg.size() / 1024.0 * opt.us_per_kb + px * opt.us_per_px) / 1000.0;
+}
+
+static double measure_host_ms(const std::vector<uint8_t> &jpeg, int runs)
+{
+    image_t img;
+    double best = 1e9;
+    for (int i = 0; i < runs; i++) {
+        double t = now_ms();
+        if (!decode_jpeg(jpeg, img, 0, 0)) {
+            return -1;
+        }
+        t = now_ms() - t;
+        best = t < best ? t : best;
+    }
+    return best;
+}
+
+static std::string output_path(const options_t &opt, const char *input)
+{
+    std::string name = input;
+    size_t slash = name.find_last_of('/');
+    if (slash != std::string::npos) {
+        name = name.substr(slash + 1);
+    }
+    size_t dot = name.find_last_of('.');
+    if (dot != std::string::npos) {
+        name = name.substr(0, dot);
+    }
+    return opt.out_dir + "/" + name + ".jpg";
+}
+
+// Absolute form of a path whose directory exists, so two spellings of one file compare equal
+static std::string canonical_path(const std::string &path)
+{
+    char buf[PATH_MAX];
+    if (realpath(path.c_str(), buf) != NULL) {
+        return buf;
+    }
+    size_t slash = path.find_last_of('/');
+    std::string dir = slash == std::string::npos ? "." : path.substr(0, slash);
+    std::string base = slash == std::string::npos ? path : path.substr(slash + 1);
+    if (realpath(dir.empty() ? "/" : dir.c_str(), buf) == NULL) {
+        return path;
+    }
+    return std::string(buf) + "/" + base;
+}
+
+// Reports outputs that would overwrite an input or each other; true if there are none
+static bool check_outputs(const options_t &opt, const std::vector<const char *> &inputs)
+{
+    std::vector<std::string> in_paths, out_paths;
+    for (const char *input : inputs) {
+        in_paths.push_back(canonical_path(input));
+        out_paths.push_back(canonical_path(output_path(opt, input)));
+    }
+
+    bool ok = true;
+    for (size_t i = 0; i < inputs.size(); i++) {
+        for (size_t j = 0; j < inputs.size(); j++) {
+            if (out_paths[i] == in_paths[j]) {
+                fprintf(stderr, "%s: output %s would overwrite input %s; pick another -o directory\n", inputs[i],
+                        output_path(opt, inputs[i]).c_str(), inputs[j]);
+                ok = false;
+            }
+            if (j < i && out_paths[i] == out_paths[j]) {
+                fprintf(stderr, "%s: output %s is also written for %s\n", inputs[i], output_path(opt, inputs[i]).c_str(), inputs[j]);
+                ok = false;
+            }
+        }
+    }
+    return ok;
+}
+
+static void usage()
+{
+    fprintf(stderr,
+            "usage: jpeg_prep [options] input...\n"
+            "  -o DIR               output directory (default .)\n"
+            "  --size WxH           panel size (default 480x272)\n"
+            "  --fit                letterbox instead of cover-crop\n"
+            "  --subsampling N      444, 422 or 420 (default 420)\n"
+            "  --restart ROWS       restart marker every ROWS MCU rows, 0 = none\n"
+            "  --quality Q          1..100 (default 85)\n"
+            "  --no-optimize        keep the standard Huffman tables\n"
+            "  --runs N             host decode repetitions (default 20)\n"
+            "  --model B,K,P        device model: us/block, us/KB, us/pixel\n");
+}
+
+int main(int argc, char **argv)
+{
+    options_t opt;
+    std::vector<const char *> inputs;
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        const char *v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(a, "-o") == 0 && v) {
+            opt.out_dir = v;
+            i++;
+        } else if (strcmp(a, "--size") == 0 && v) {
+            if (sscanf(v, "%dx%d", &opt.width, &opt.height) != 2 || opt.width <= 0 || opt.height <= 0) {
+                usage();
+                return 2;
+            }
+            i++;
+        } else if (strcmp(a, "--fit") == 0) {
+            opt.cover = false;
+        } else if (strcmp(a, "--subsampling") == 0 && v) {
+            opt.subsampling = atoi(v);
+            if (opt.subsampling != 444 && opt.subsampling != 422 && opt.subsampling != 420) {
+                usage();
+                return 2;
+            }
+            i++;
+        } else if (strcmp(a, "--restart") == 0 && v) {
+            opt.restart_rows = atoi(v);
+            i++;
+        } else if (strcmp(a, "--quality") == 0 && v) {
+            opt.quality = atoi(v);
+            i++;
+        } else if (strcmp(a, "--no-optimize") == 0) {
+            opt.optimize = false;
+        } else if (strcmp(a, "--runs") == 0 && v) {
+            opt.runs = atoi(v) > 0 ? atoi(v) : 1;
+            i++;
+        } else if (strcmp(a, "--model") == 0 && v) {
+            if (sscanf(v, "%lf,%lf,%lf", &opt.us_per_block, &opt.us_per_kb, &opt.us_per_px) != 3) {
+                usage();
+                return 2;
+            }
+            i++;
+        } else if (a[0] == '-') {
+            usage();
+            return 2;
+        } else {
+            inputs.push_back(a);
+        }
+    }
+    if (inputs.empty()) {
+        usage();
+        return 2;
+    }
+    if (!check_outputs(opt, inputs)) {
+        return 2;
+    }
+
+    printf("%-32s %9s %9s %10s %10s %10s\n", "asset", "in_bytes", "out_bytes", "host_in_ms", "host_ms", "device_ms");
+    int failed = 0;
+    for (const char *input : inputs) {
+        std::vector<uint8_t> data, jpeg;
+        image_t src, panel;
+
+        if (!read_file(input, data)) {
+            fprintf(stderr, "%s: cannot read\n", input);
+            failed++;
+            continue;
+        }
+        bool is_jpeg = data.size() >= 2 && data[0] == 0xFF && data[1] == 0xD8;
+        int orientation = is_jpeg ? exif_orientation(data) : 1;
+        // The IDCT pre-shrink works on the stored image, which is on its side for 5..8
+        int min_w = orientation >= 5 ? opt.height : opt.width;
+        int min_h = orientation >= 5 ? opt.width : opt.height;
+        if (!(is_jpeg ? decode_jpeg(data, src, min_w, min_h) : decode_ppm(data, src))) {
+            fprintf(stderr, "%s: unsupported or corrupt image\n", input);
+            failed++;
+            continue;
+        }
+        apply_orientation(src, orientation);
+
+        fit_to_panel(src, opt, panel);
+        if (!encode_jpeg(panel, opt, jpeg)) {
+            fprintf(stderr, "%s: encode failed\n", input);
+            failed++;
+            continue;
+        }
+
+        std::string out = output_path(opt, input);
+        FILE *f = fopen(out.c_str(), "wb");
+        if (f == NULL || fwrite(jpeg.data(), 1, jpeg.size(), f) != jpeg.size()) {
+            fprintf(stderr, "%s: cannot write\n", out.c_str());
+            if (f) {
+                fclose(f);
+            }
+            failed++;
+            continue;
+        }
+        fclose(f);
+
+        double host_in = is_jpeg ? measure_host_ms(data, opt.runs) : 0;
+        double host_out = measure_host_ms(jpeg, opt.runs);
+        printf("%-32s %9zu %9zu %10.2f %10.2f %10.1f\n", out.c_str(), data.size(), jpeg.size(), host_in, host_out, predict_device_ms(jpeg, opt));
+    }
+    return failed ? 1 : 0;
+}
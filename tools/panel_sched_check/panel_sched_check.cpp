@@ -0,0 +1,204 @@
+/*
+ * panel_sched_check: host check of the shared-bus panel scheduler (src/lcd/panel_scheduler.h).
+ *
+ *   g++ -O2 -I../host -o panel_sched_check panel_sched_check.cpp \
+ *       ../../src/lcd/panel_scheduler.cpp ../host/host_runtime.cpp -lpthread
+ *   ./panel_sched_check [--ms 1500] [--rate 16000] [--tolerance 3]
+ *
+ * Two panels on one host stream strips as fast as acquire() lets them, the way
+ * nv3041a_lcd does, while a bus thread plays the SPI driver: it sends the
+ * queued strips in order, taking --rate bytes per millisecond, and calls
+ * onDone() for each. Each case checks that every panel got the share of the
+ * bytes its weight entitles it to, within --tolerance percentage points:
+ * equal weights, 3:1, and 1:1 between a panel sending full-width strips and
+ * one updating a small area, which must not be starved. A last case puts the
+ * panels on different hosts, where each must keep its own bus at least 75%
+ * busy rather than sharing one. The exit code is 1 if a case fails.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include "../../src/lcd/panel_scheduler.h"
+
+#define CHECK_LINES (272)
+#define CHECK_STRIP (16)
+
+typedef struct {
+    int panel;
+    uint32_t bytes;
+} queued_t;
+
+// The SPI driver of one host: strips leave in the order they were queued
+class sim_bus
+{
+public:
+    sim_bus(panel_scheduler &sched, uint32_t bytes_per_ms) : _sched(sched), _rate(bytes_per_ms), _stop(false)
+    {
+        _thread = std::thread([this] { run(); });
+    }
+
+    ~sim_bus()
+    {
+        {
+            std::lock_guard<std::mutex> g(_m);
+            _stop = true;
+        }
+        _cv.notify_all();
+        _thread.join();
+    }
+
+    void queue(int panel, uint32_t bytes)
+    {
+        {
+            std::lock_guard<std::mutex> g(_m);
+            _q.push_back({panel, bytes});
+        }
+        _cv.notify_all();
+    }
+
+private:
+    void run()
+    {
+        for (;;) {
+            queued_t t;
+            {
+                std::unique_lock<std::mutex> g(_m);
+                _cv.wait(g, [this] { return _stop || !_q.empty(); });
+                if (_q.empty()) {
+                    return;
+                }
+                t = _q.front();
+                _q.pop_front();
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds((uint64_t)t.bytes * 1000 / _rate));
+            _sched.onDone(t.panel);
+        }
+    }
+
+    panel_scheduler &_sched;
+    uint32_t _rate;
+    bool _stop;
+    std::deque<queued_t> _q;
+    std::mutex _m;
+    std::condition_variable _cv;
+    std::thread _thread;
+};
+
+typedef struct {
+    const char *name;
+    uint8_t weight[2];
+    uint16_t width[2]; // strip width in pixels: 480 streams frames, less updates an area
+    bool same_host;
+} sched_case_t;
+
+static bool run_case(const sched_case_t &c, uint32_t ms, uint32_t rate, double tolerance)
+{
+    panel_scheduler sched(2);
+    int id[2];
+    for (int i = 0; i < 2; i++) {
+        id[i] = sched.addPanel(c.same_host ? 1 : i + 1, CHECK_LINES, c.weight[i]);
+    }
+    // One driver queue per host
+    sim_bus bus0(sched, rate);
+    sim_bus bus1(sched, rate);
+
+    std::atomic<bool> stop(false);
+    std::thread producer[2];
+    for (int i = 0; i < 2; i++) {
+        producer[i] = std::thread([&, i] {
+            sim_bus &bus = c.same_host || i == 0 ? bus0 : bus1;
+            uint32_t bytes = (uint32_t)c.width[i] * CHECK_STRIP * 2;
+            uint16_t y = 0;
+            while (!stop) {
+                sched.acquire(id[i], y, CHECK_STRIP, bytes);
+                bus.queue(id[i], bytes);
+                y = y + CHECK_STRIP >= CHECK_LINES ? 0 : y + CHECK_STRIP;
+            }
+        });
+    }
+    // Let both panels get going before measuring
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    sched.resetStats();
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    panel_sched_stats_t s[2] = {sched.stats(id[0]), sched.stats(id[1])};
+    stop = true;
+    for (int i = 0; i < 2; i++) {
+        producer[i].join();
+    }
+
+    bool ok = true;
+    printf("%-22s", c.name);
+    for (int i = 0; i < 2; i++) {
+        printf("  panel %d: weight %u, %4u strips, %5.1f%% of bytes", i, c.weight[i], s[i].strips,
+               s[i].share_permille / 10.0);
+    }
+    if (c.same_host) {
+        double want = 100.0 * c.weight[0] / (c.weight[0] + c.weight[1]);
+        double got = s[0].share_permille / 10.0;
+        printf("  (want %.1f%%)\n", want);
+        if (fabs(got - want) > tolerance) {
+            fprintf(stderr, "%s: panel 0 got %.1f%% of the bus, expected %.1f%%\n", c.name, got, want);
+            ok = false;
+        }
+    } else {
+        printf("\n");
+        for (int i = 0; i < 2; i++) {
+            double busy = (double)s[i].bytes / ((double)rate * ms);
+            if (busy < 0.75) {
+                fprintf(stderr, "%s: panel %d kept its bus only %.0f%% busy\n", c.name, i, 100 * busy);
+                ok = false;
+            }
+        }
+    }
+    return ok;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [--ms MS] [--rate BYTES_PER_MS] [--tolerance PERCENT]\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t ms = 1500;
+    uint32_t rate = 16000;
+    double tolerance = 3.0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--ms") == 0 && i + 1 < argc) {
+            ms = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+            rate = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+            tolerance = atof(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (ms == 0 || rate == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    static const sched_case_t cases[] = {
+        {"equal weights", {1, 1}, {480, 480}, true},
+        {"weights 3:1", {3, 1}, {480, 480}, true},
+        {"full frame vs area", {1, 1}, {480, 96}, true},
+        {"separate hosts", {1, 1}, {480, 480}, false},
+    };
+    int failed = 0;
+    for (const sched_case_t &c : cases) {
+        if (!run_case(c, ms, rate, tolerance)) {
+            failed++;
+        }
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,318 @@
+/*
+ * rgb565_pack: convert UI graphics into the ".r565" asset format (src/asset/rgb565_asset.h).
+ *
+ *   g++ -O2 -o rgb565_pack rgb565_pack.cpp ../../src/asset/rgb565_asset.cpp -ljpeg
+ *   ./rgb565_pack [--raw] [--strip-height 16] [--runs 50] icon.ppm icon.r565
+ *
+ * Input is JPEG or binary PPM. After writing the asset the tool decodes it with
+ * the device strip decoder and compares size and host decode time with a
+ * JPEG (quality 85, 4:2:0) of the same pixels decoded by libjpeg.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <vector>
+#include <setjmp.h>
+#include <jpeglib.h>
+#include "../../src/asset/rgb565_asset.h"
+
+typedef struct {
+    int width;
+    int height;
+    std::vector<uint8_t> rgb;
+} image_t;
+
+typedef struct {
+    struct jpeg_error_mgr pub;
+    jmp_buf jmp;
+} jpeg_err_t;
+
+static void jpeg_error_exit(j_common_ptr cinfo)
+{
+    jpeg_err_t *err = (jpeg_err_t *)cinfo->err;
+    (*cinfo->err->output_message)(cinfo);
+    longjmp(err->jmp, 1);
+}
+
+static double now_ms()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static bool read_file(const char *path, std::vector<uint8_t> &data)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        return false;
+    }
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    data.resize(len > 0 ? len : 0);
+    bool ok = len > 0 && fread(data.data(), 1, len, f) == (size_t)len;
+    fclose(f);
+    return ok;
+}
+
+static bool decode_jpeg(const std::vector<uint8_t> &data, image_t &img)
+{
+    struct jpeg_decompress_struct cinfo;
+    jpeg_err_t jerr;
+
+    cinfo.err = jpeg_std_error(&jerr.pub);
+    jerr.pub.error_exit = jpeg_error_exit;
+    if (setjmp(jerr.jmp)) {
+        jpeg_destroy_decompress(&cinfo);
+        return false;
+    }
+    jpeg_create_decompress(&cinfo);
+    jpeg_mem_src(&cinfo, data.data(), data.size());
+    jpeg_read_header(&cinfo, TRUE);
+    cinfo.out_color_space = JCS_RGB;
+    jpeg_start_decompress(&cinfo);
+    img.width = cinfo.output_width;
+    img.height = cinfo.output_height;
+    img.rgb.resize((size_t)img.width * img.height * 3);
+    while (cinfo.output_scanline < cinfo.output_height) {
+        JSAMPROW row = &img.rgb[(size_t)cinfo.output_scanline * img.width * 3];
+        jpeg_read_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    return true;
+}
+
+static bool decode_ppm(const std::vector<uint8_t> &data, image_t &img)
+{
+    int w, h, maxval, n = 0;
+    if (data.size() < 3 || sscanf((const char *)data.data(), "P6 %d %d %d%n", &w, &h, &maxval, &n) != 3 || maxval != 255) {
+        return false;
+    }
+    size_t offset = n + 1;
+    if (w <= 0 || h <= 0 || data.size() < offset + (size_t)w * h * 3) {
+        return false;
+    }
+    img.width = w;
+    img.height = h;
+    img.rgb.assign(data.begin() + offset, data.begin() + offset + (size_t)w * h * 3);
+    return true;
+}
+
+static bool encode_jpeg(const image_t &img, std::vector<uint8_t> &out)
+{
+    struct jpeg_compress_struct cinfo;
+    jpeg_err_t jerr;
+    unsigned char *mem = NULL;
+    unsigned long mem_len = 0;
+
+    cinfo.err = jpeg_std_error(&jerr.pub);
+    jerr.pub.error_exit = jpeg_error_exit;
+    if (setjmp(jerr.jmp)) {
+        jpeg_destroy_compress(&cinfo);
+        free(mem);
+        return false;
+    }
+    jpeg_create_compress(&cinfo);
+    jpeg_mem_dest(&cinfo, &mem, &mem_len);
+    cinfo.image_width = img.width;
+    cinfo.image_height = img.height;
+    cinfo.input_components = 3;
+    cinfo.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, 85, TRUE);
+    cinfo.write_JFIF_header = FALSE;
+    jpeg_start_compress(&cinfo, TRUE);
+    while (cinfo.next_scanline < cinfo.image_height) {
+        JSAMPROW row = (JSAMPROW)&img.rgb[(size_t)cinfo.next_scanline * img.width * 3];
+        jpeg_write_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+    out.assign(mem, mem + mem_len);
+    free(mem);
+    return true;
+}
+
+static void put16(std::vector<uint8_t> &v, uint16_t x)
+{
+    v.push_back(x & 0xFF);
+    v.push_back(x >> 8);
+}
+
+static void put_pixel(std::vector<uint8_t> &v, uint16_t px)
+{
+    // Panel byte order: high byte first
+    v.push_back(px >> 8);
+    v.push_back(px & 0xFF);
+}
+
+static void rle_strip(const uint16_t *px, size_t n, std::vector<uint8_t> &out)
+{
+    size_t i = 0;
+    while (i < n) {
+        size_t run = 1;
+        while (i + run < n && run < 128 && px[i + run] == px[i]) {
+            run++;
+        }
+        if (run >= 2) {
+            out.push_back(0x80 | (run - 1));
+            put_pixel(out, px[i]);
+            i += run;
+            continue;
+        }
+        // Literal until the next run of 3 or more, where a run packet starts paying off
+        size_t lit = 1;
+        while (i + lit < n && lit < 128) {
+            if (i + lit + 2 < n && px[i + lit] == px[i + lit + 1] && px[i + lit] == px[i + lit + 2]) {
+                break;
+            }
+            lit++;
+        }
+        out.push_back(lit - 1);
+        for (size_t k = 0; k < lit; k++) {
+            put_pixel(out, px[i + k]);
+        }
+        i += lit;
+    }
+}
+
+static std::vector<uint8_t> pack(const image_t &img, int strip_h, rgb565_codec_t codec)
+{
+    std::vector<uint16_t> px((size_t)img.width * img.height);
+    for (size_t i = 0; i < px.size(); i++) {
+        const uint8_t *p = &img.rgb[i * 3];
+        px[i] = ((p[0] & 0xF8) << 8) | ((p[1] & 0xFC) << 3) | (p[2] >> 3);
+    }
+
+    int strips = (img.height + strip_h - 1) / strip_h;
+    std::vector<uint8_t> out;
+    out.insert(out.end(), RGB565_ASSET_MAGIC, RGB565_ASSET_MAGIC + 4);
+    out.push_back(RGB565_ASSET_VERSION);
+    out.push_back(codec);
+    put16(out, img.width);
+    put16(out, img.height);
+    put16(out, strip_h);
+    put16(out, strips);
+    put16(out, 0);
+    size_t table = out.size();
+    out.resize(table + (strips + 1) * 4);
+
+    std::vector<uint8_t> body;
+    for (int s = 0; s <= strips; s++) {
+        uint32_t off = table + (strips + 1) * 4 + body.size();
+        for (int b = 0; b < 4; b++) {
+            out[table + s * 4 + b] = (off >> (8 * b)) & 0xFF;
+        }
+        if (s == strips) {
+            break;
+        }
+        int rows = img.height - s * strip_h < strip_h ? img.height - s * strip_h : strip_h;
+        const uint16_t *p = &px[(size_t)s * strip_h * img.width];
+        size_t n = (size_t)rows * img.width;
+        if (codec == RGB565_CODEC_RLE) {
+            rle_strip(p, n, body);
+        } else {
+            for (size_t k = 0; k < n; k++) {
+                put_pixel(body, p[k]);
+            }
+        }
+    }
+    out.insert(out.end(), body.begin(), body.end());
+    return out;
+}
+
+static int count_strip(void *ctx, uint16_t, uint16_t, uint16_t, uint16_t *)
+{
+    (*(int *)ctx)++;
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    int strip_h = 16;
+    int runs = 50;
+    rgb565_codec_t codec = RGB565_CODEC_RLE;
+    const char *in = NULL;
+    const char *out = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--raw") == 0) {
+            codec = RGB565_CODEC_RAW;
+        } else if (strcmp(argv[i], "--strip-height") == 0 && i + 1 < argc) {
+            strip_h = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+            runs = atoi(argv[++i]);
+        } else if (in == NULL) {
+            in = argv[i];
+        } else {
+            out = argv[i];
+        }
+    }
+    if (in == NULL || out == NULL || strip_h <= 0 || strip_h > 0xFFFF || runs <= 0) {
+        fprintf(stderr, "usage: rgb565_pack [--raw] [--strip-height N] [--runs N] input output.r565\n");
+        return 2;
+    }
+
+    std::vector<uint8_t> data;
+    image_t img;
+    if (!read_file(in, data)) {
+        fprintf(stderr, "%s: cannot read\n", in);
+        return 1;
+    }
+    bool is_jpeg = data.size() >= 2 && data[0] == 0xFF && data[1] == 0xD8;
+    if (!(is_jpeg ? decode_jpeg(data, img) : decode_ppm(data, img)) || img.width > 0xFFFF || img.height > 0xFFFF) {
+        fprintf(stderr, "%s: unsupported or corrupt image\n", in);
+        return 1;
+    }
+
+    std::vector<uint8_t> asset_data = pack(img, strip_h, codec);
+    FILE *f = fopen(out, "wb");
+    if (f == NULL || fwrite(asset_data.data(), 1, asset_data.size(), f) != asset_data.size()) {
+        fprintf(stderr, "%s: cannot write\n", out);
+        return 1;
+    }
+    fclose(f);
+
+    // Round-trip through the device decoder
+    rgb565_asset asset;
+    if (!asset.open(asset_data.data(), asset_data.size())) {
+        fprintf(stderr, "%s: written asset does not validate\n", out);
+        return 1;
+    }
+    std::vector<uint16_t> strip((size_t)img.width * strip_h);
+    double asset_ms = 1e9;
+    for (int r = 0; r < runs; r++) {
+        int strips = 0;
+        double t = now_ms();
+        bool ok = asset.decode(strip.data(), count_strip, &strips);
+        t = now_ms() - t;
+        if (!ok || strips != asset.stripCount()) {
+            fprintf(stderr, "%s: decode failed\n", out);
+            return 1;
+        }
+        asset_ms = t < asset_ms ? t : asset_ms;
+    }
+
+    std::vector<uint8_t> jpeg;
+    double jpeg_ms = 1e9;
+    if (encode_jpeg(img, jpeg)) {
+        for (int r = 0; r < runs; r++) {
+            image_t tmp;
+            double t = now_ms();
+            decode_jpeg(jpeg, tmp);
+            t = now_ms() - t;
+            jpeg_ms = t < jpeg_ms ? t : jpeg_ms;
+        }
+    }
+
+    printf("%s: %dx%d, %d strips of %d rows, %s\n", out, img.width, img.height, asset.stripCount(), strip_h, codec == RGB565_CODEC_RLE ? "rle" : "raw");
+    printf("  %-10s %10s %12s\n", "format", "bytes", "host_dec_ms");
+    printf("  %-10s %10zu %12.3f\n", "r565", asset_data.size(), asset_ms);
+    printf("  %-10s %10zu %12s\n", "raw565", (size_t)img.width * img.height * 2, "-");
+    printf("  %-10s %10zu %12.3f\n", "jpeg q85", jpeg.size(), jpeg_ms);
+    return 0;
+}
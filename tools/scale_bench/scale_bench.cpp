@@ -0,0 +1,321 @@
+/*
+ * scale_bench: check and time the streaming resampler (src/gfx/strip_scaler.h).
+ *
+ *   g++ -O2 -I../host -o scale_bench scale_bench.cpp ../../src/gfx/strip_scaler.cpp \
+ *       ../../src/mem/pipeline_arena.cpp ../host/host_runtime.cpp -lpthread
+ *   ./scale_bench [--strip 16] [--frames 3]
+ *
+ * The checks push synthetic images through the scaler the way the block decoder
+ * does, a strip at a time, and compare every output pixel with a floating point
+ * reference of the same filter (one step per channel allowed). They also
+ * require solid images to stay exact, a 480x272 image to pass through bilinear
+ * untouched, and the output not to depend on the strip height. The benchmark
+ * then reports source megapixels per second for common camera resolutions in
+ * each filter mode. Returns non-zero if a check fails.
+ *
+ * The arena is started with the sketch's sizes and the benchmark takes its
+ * input strips from the internal region, as jpeg_dec.h does, while holding the
+ * SD loader's 16 KB staging chunk. That leaves room for a 16-line strip up to
+ * 2110 pixels wide, so 4:2:0 sources wider than that (5 MP and up; 4:2:2 and
+ * 4:4:4 go to 4220) get theirs from the heap, internal RAM or else PSRAM, and
+ * are flagged in the table. The host does not show what PSRAM costs there.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include "../../src/gfx/strip_scaler.h"
+#include "../../src/mem/pipeline_arena.h"
+
+#define OUT_W (480)
+#define OUT_H (272)
+
+typedef struct {
+    uint16_t frame[OUT_W * OUT_H];
+    uint32_t strips;
+    uint32_t rows;
+} canvas_t;
+
+static int draw(void *ctx, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t *pixels)
+{
+    canvas_t *c = (canvas_t *)ctx;
+    for (uint16_t r = 0; r < h; r++) {
+        memcpy(c->frame + (y + r) * OUT_W + x, pixels + r * w, w * 2);
+    }
+    c->strips++;
+    c->rows += h;
+    return 1;
+}
+
+static inline uint16_t swap16(uint16_t p)
+{
+    return (p >> 8) | (p << 8);
+}
+
+// Test image: smooth ramps with a fine texture so that every filter has something to average
+static uint16_t source_pixel(int x, int y, int w, int h, int seed)
+{
+    uint32_t r = (uint32_t)x * 31 / (w > 1 ? w - 1 : 1);
+    uint32_t g = (uint32_t)y * 63 / (h > 1 ? h - 1 : 1);
+    uint32_t b = ((x * 7 + y * 13 + seed) ^ (x >> 2)) & 31;
+    return swap16((uint16_t)((r << 11) | (g << 5) | b));
+}
+
+static void source_rows(uint16_t *buf, int y, int rows, int w, int h, int seed)
+{
+    for (int r = 0; r < rows; r++) {
+        for (int x = 0; x < w; x++) {
+            buf[(size_t)r * w + x] = source_pixel(x, y + r, w, h, seed);
+        }
+    }
+}
+
+// src, when given, holds strip rows of w pixels, as the decoder's output strip does
+static bool scale(strip_scaler &s, canvas_t *c, int w, int h, scale_mode_t mode, scale_filter_t filter, int strip, int seed,
+                  uint16_t *src = NULL)
+{
+    memset(c, 0, sizeof(*c));
+    if (!s.start(w, h, mode, filter, draw, c)) {
+        return false;
+    }
+    std::vector<uint16_t> buf;
+    if (src == NULL) {
+        buf.resize((size_t)w * strip);
+        src = buf.data();
+    }
+    for (int y = 0; y < h; y += strip) {
+        int rows = h - y < strip ? h - y : strip;
+        source_rows(src, y, rows, w, h, seed);
+        s.push(src, y, rows);
+    }
+    return s.done();
+}
+
+static float channel(uint16_t p, int ch)
+{
+    p = swap16(p);
+    return ch == 0 ? (p >> 11) : (ch == 1 ? ((p >> 5) & 63) : (p & 31));
+}
+
+// Floating point reference of one output pixel; footprints follow the scaler's geometry
+static float reference(int w, int h, int cw, int ch_, int cx, int cy, int dw, int dh, scale_filter_t filter,
+                       int i, int j, int ch, int seed)
+{
+    bool box_x = filter == SCALE_AREA && cw > dw;
+    bool box_y = filter == SCALE_AREA && ch_ > dh;
+    float sum = 0.0f;
+    if (box_x && box_y) {
+        float x0 = (float)i * cw / dw, x1 = (float)(i + 1) * cw / dw;
+        float y0 = (float)j * ch_ / dh, y1 = (float)(j + 1) * ch_ / dh;
+        for (int y = (int)y0; y < (int)ceilf(y1); y++) {
+            float wy = fminf(y1, y + 1) - fmaxf(y0, y);
+            for (int x = (int)x0; x < (int)ceilf(x1); x++) {
+                float wx = fminf(x1, x + 1) - fmaxf(x0, x);
+                sum += wx * wy * channel(source_pixel(cx + x, cy + y, w, h, seed), ch);
+            }
+        }
+        return sum / ((x1 - x0) * (y1 - y0));
+    }
+    // Bilinear on both axes
+    float sx = (i + 0.5f) * cw / dw - 0.5f;
+    float sy = (j + 0.5f) * ch_ / dh - 0.5f;
+    sx = fminf(fmaxf(sx, 0.0f), cw - 1);
+    sy = fminf(fmaxf(sy, 0.0f), ch_ - 1);
+    int x0 = (int)sx, y0 = (int)sy;
+    int x1 = x0 + 1 < cw ? x0 + 1 : x0;
+    int y1 = y0 + 1 < ch_ ? y0 + 1 : y0;
+    float fx = sx - x0, fy = sy - y0;
+    float a = channel(source_pixel(cx + x0, cy + y0, w, h, seed), ch);
+    float b = channel(source_pixel(cx + x1, cy + y0, w, h, seed), ch);
+    float c = channel(source_pixel(cx + x0, cy + y1, w, h, seed), ch);
+    float d = channel(source_pixel(cx + x1, cy + y1, w, h, seed), ch);
+    return (a * (1 - fx) + b * fx) * (1 - fy) + (c * (1 - fx) + d * fx) * fy;
+}
+
+static int check_reference(strip_scaler &s, canvas_t *c, int w, int h, scale_mode_t mode, scale_filter_t filter)
+{
+    if (!scale(s, c, w, h, mode, filter, 16, 7)) {
+        printf("  %dx%d: scaler did not finish\n", w, h);
+        return 1;
+    }
+    uint16_t dx, dy, dw, dh;
+    s.area(&dx, &dy, &dw, &dh);
+    // Recover the crop the same way the scaler picks it
+    int cw = w, chh = h, cx = 0, cy = 0;
+    if (mode == SCALE_COVER) {
+        if ((uint32_t)w * OUT_H >= (uint32_t)h * OUT_W) {
+            cw = (h * OUT_W + OUT_H / 2) / OUT_H;
+            cx = (w - cw) / 2;
+        } else {
+            chh = (w * OUT_H + OUT_W / 2) / OUT_W;
+            cy = (h - chh) / 2;
+        }
+    }
+    int bad = 0;
+    for (int j = 0; j < dh; j++) {
+        for (int i = 0; i < dw; i++) {
+            uint16_t p = c->frame[(dy + j) * OUT_W + dx + i];
+            for (int ch = 0; ch < 3; ch++) {
+                float want = reference(w, h, cw, chh, cx, cy, dw, dh, filter, i, j, ch, 7);
+                if (fabsf(channel(p, ch) - want) > 1.0f) {
+                    if (bad++ < 3) {
+                        printf("  %dx%d: pixel %d,%d channel %d is %.0f, want %.2f\n", w, h, i, j, ch, channel(p, ch), want);
+                    }
+                }
+            }
+        }
+    }
+    return bad;
+}
+
+static int check_solid(strip_scaler &s, canvas_t *c, int w, int h, scale_filter_t filter)
+{
+    static const uint16_t colors[] = {0x0000, 0xFFFF, 0xF800, 0x07E0, 0x001F, 0x8410, 0x7BEF};
+    int bad = 0;
+    for (size_t k = 0; k < sizeof(colors) / sizeof(colors[0]); k++) {
+        memset(c, 0, sizeof(*c));
+        s.start(w, h, SCALE_FIT, filter, draw, c);
+        std::vector<uint16_t> buf((size_t)w * 16, swap16(colors[k]));
+        for (int y = 0; y < h; y += 16) {
+            s.push(buf.data(), y, h - y < 16 ? h - y : 16);
+        }
+        uint16_t dx, dy, dw, dh;
+        s.area(&dx, &dy, &dw, &dh);
+        for (int j = 0; j < dh; j++) {
+            for (int i = 0; i < dw; i++) {
+                bad += c->frame[(dy + j) * OUT_W + dx + i] != swap16(colors[k]);
+            }
+        }
+    }
+    return bad;
+}
+
+static const char *filter_name(scale_filter_t f)
+{
+    return f == SCALE_NEAREST ? "nearest" : (f == SCALE_BILINEAR ? "bilinear" : "area");
+}
+
+int main(int argc, char **argv)
+{
+    int strip = 16;
+    int frames = 3;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--strip") == 0 && i + 1 < argc) {
+            strip = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: scale_bench [--strip 16] [--frames 3]\n");
+            return 2;
+        }
+    }
+    if (strip < 1 || frames < 1) {
+        fprintf(stderr, "bad arguments\n");
+        return 2;
+    }
+
+    // Same regions as setup(), so the scaler's strips come from where they would on the device
+    if (!pipeline_mem.begin(ARENA_INTERNAL_SIZE, ARENA_PSRAM_SIZE)) {
+        fprintf(stderr, "arena reservation failed\n");
+        return 1;
+    }
+    strip_scaler s(OUT_W, OUT_H, 16);
+    if (!s.begin()) {
+        fprintf(stderr, "scaler: out of memory\n");
+        return 1;
+    }
+    canvas_t *c = (canvas_t *)malloc(sizeof(canvas_t));
+    canvas_t *c2 = (canvas_t *)malloc(sizeof(canvas_t));
+    int failures = 0;
+
+    static const int sizes[][2] = {{480, 272}, {960, 544}, {1000, 700}, {640, 480}, {300, 400}, {123, 77}, {1920, 1080}, {2000, 200}};
+    static const scale_filter_t filters[] = {SCALE_NEAREST, SCALE_BILINEAR, SCALE_AREA};
+    static const scale_mode_t modes[] = {SCALE_FIT, SCALE_COVER};
+    printf("checks:\n");
+    for (size_t m = 0; m < 2; m++) {
+        for (size_t f = 1; f < 3; f++) {
+            int bad = 0;
+            for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+                bad += check_reference(s, c, sizes[k][0], sizes[k][1], modes[m], filters[f]);
+            }
+            printf("  %-8s %-5s vs reference: %s (%d channel errors)\n", filter_name(filters[f]),
+                   modes[m] == SCALE_FIT ? "fit" : "cover", bad ? "FAIL" : "ok", bad);
+            failures += bad ? 1 : 0;
+        }
+    }
+    for (size_t f = 0; f < 3; f++) {
+        int bad = check_solid(s, c, 1000, 700, filters[f]) + check_solid(s, c, 1920, 1080, filters[f]) + check_solid(s, c, 200, 150, filters[f]);
+        printf("  %-8s solid colors: %s\n", filter_name(filters[f]), bad ? "FAIL" : "ok");
+        failures += bad ? 1 : 0;
+    }
+    scale(s, c, OUT_W, OUT_H, SCALE_FIT, SCALE_BILINEAR, 16, 3);
+    bool identity = true;
+    for (int y = 0; y < OUT_H && identity; y++) {
+        for (int x = 0; x < OUT_W; x++) {
+            if (c->frame[y * OUT_W + x] != source_pixel(x, y, OUT_W, OUT_H, 3)) {
+                identity = false;
+                break;
+            }
+        }
+    }
+    printf("  bilinear 480x272 passes through: %s\n", identity ? "ok" : "FAIL");
+    failures += identity ? 0 : 1;
+    for (size_t f = 0; f < 3; f++) {
+        bool same = true;
+        scale(s, c, 1333, 999, SCALE_COVER, filters[f], 16, 5);
+        static const int heights[] = {1, 8, 13, 999};
+        for (size_t k = 0; k < 4; k++) {
+            scale(s, c2, 1333, 999, SCALE_COVER, filters[f], heights[k], 5);
+            same = same && memcmp(c->frame, c2->frame, sizeof(c->frame)) == 0;
+        }
+        printf("  %-8s independent of strip height: %s\n", filter_name(filters[f]), same ? "ok" : "FAIL");
+        failures += same ? 0 : 1;
+    }
+
+    static const struct {
+        const char *name;
+        int w, h;
+    } cameras[] = {
+        {"VGA", 640, 480}, {"720p", 1280, 720}, {"2 MP", 1600, 1200}, {"1080p", 1920, 1080},
+        {"5 MP", 2592, 1944}, {"8 MP", 3264, 2448}, {"12 MP", 4000, 3000},
+    };
+    // While a photo decodes the SD loader holds its staging chunk; what is left of the internal
+    // region bounds the output strip, and wider images take theirs from PSRAM
+    void *staging = pipeline_malloc_align(16 * 1024, ARENA_INTERNAL);
+    arena_stats_t in = pipeline_mem.stats(ARENA_INTERNAL);
+    size_t room = in.largest_free > 16 ? in.largest_free - 16 : 0;
+    printf("\ninternal arena: %u of %u bytes free with the scaler and SD staging held; output strips fit up to\n"
+           "%u px wide for 4:2:0 (16 lines) and %u px for 4:2:2 and 4:4:4 (8 lines)\n",
+           (unsigned)in.largest_free, (unsigned)in.size, (unsigned)(room / 32), (unsigned)(room / 16));
+
+    printf("\nsource MP/s, %d-row input strips, fit to %dx%d:\n", strip, OUT_W, OUT_H);
+    printf("  %-6s %-10s %10s %10s %10s\n", "", "size", "nearest", "bilinear", "area");
+    for (size_t k = 0; k < sizeof(cameras) / sizeof(cameras[0]); k++) {
+        int w = cameras[k].w, h = cameras[k].h;
+        uint16_t *src = (uint16_t *)pipeline_malloc_align((size_t)w * strip * sizeof(uint16_t), ARENA_INTERNAL);
+        if (src == NULL) {
+            fprintf(stderr, "%dx%d: no memory for the input strip\n", w, h);
+            failures++;
+            continue;
+        }
+        printf("  %-6s %4dx%-5d", cameras[k].name, w, h);
+        for (size_t f = 0; f < 3; f++) {
+            s.resetStats();
+            for (int n = 0; n < frames; n++) {
+                scale(s, c, w, h, SCALE_FIT, filters[f], strip, n, src);
+            }
+            strip_scale_stats_t st = s.stats();
+            double mps = st.scale_us ? (double)st.src_pixels / st.scale_us : 0.0;
+            printf(" %9.1f%s", mps, st.fast_rows ? "*" : " ");
+        }
+        printf("%s\n", pipeline_mem.owns(src) ? "" : "  strip outside the arena");
+        pipeline_free_align(src);
+    }
+    printf("  * packed integer-ratio path\n");
+    pipeline_free_align(staging);
+
+    free(c);
+    free(c2);
+    return failures ? 1 : 0;
+}
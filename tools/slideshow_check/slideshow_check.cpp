@@ -0,0 +1,245 @@
+/*
+ * slideshow_check: host run of the slideshow prefetch against playlist changes.
+ *
+ *   g++ -O1 -g -fsanitize=address,undefined -I../host -o slideshow_check slideshow_check.cpp \
+ *       ../host/esp_jpeg_host.cpp ../host/host_runtime.cpp ../host/host_fs.cpp \
+ *       ../../src/mem/pipeline_arena.cpp ../../src/decode/image_source.cpp \
+ *       ../../src/decode/baseline_jpeg.cpp ../../src/decode/baseline_idct.cpp \
+ *       ../../src/decode/jpeg_thumb.cpp ../../src/sd/sd_loader.cpp \
+ *       ../../src/trace/pipeline_trace.cpp ../../src/gallery/slideshow.cpp -ljpeg -lpthread
+ *   ./slideshow_check --rounds 200 --read-delay-us 20000 /tmp/slideshow_check
+ *
+ * Writes two directories of small JPEGs under the given path, each image a
+ * different width so the draw callback can tell which one went out. The
+ * slideshow's SD task runs on a thread and tools/host/host_fs delays every
+ * read, so the prefetch of the next image is still in flight when each round
+ * calls clear() and loadDirectory() for the other directory, adds a missing
+ * file, or appends enough files to make _entries reallocate. Every
+ * image shown is checked against the entry at current(); a stale prefetch
+ * surviving clear() shows up as a wrong width, and a load reading the
+ * playlist while it is reallocated is caught by the address sanitizer.
+ * The exit code is 1 on any mismatch.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+#include <jpeglib.h>
+#include "esp_timer.h"
+#include "../../src/gallery/slideshow.h"
+
+#define CHECK_SET_SIZE (8)
+#define CHECK_IMAGE_H (16)
+
+typedef struct {
+    struct jpeg_error_mgr pub;
+    jmp_buf jmp;
+} enc_err_t;
+
+static int s_drawn_width;
+
+static int checkDrawCallback(jpeg_dec_io_t *jpeg_io, jpeg_dec_header_info_t *out_info)
+{
+    (void)jpeg_io;
+    s_drawn_width = out_info->width;
+    return 1;
+}
+
+static void enc_error_exit(j_common_ptr cinfo)
+{
+    longjmp(((enc_err_t *)cinfo->err)->jmp, 1);
+}
+
+// Image `id` is 16 * (id + 1) pixels wide
+static int id_width(int id)
+{
+    return 16 * (id + 1);
+}
+
+static bool write_jpeg(const std::string &path, int id)
+{
+    int w = id_width(id);
+    std::vector<uint8_t> rgb((size_t)w * CHECK_IMAGE_H * 3);
+    for (size_t i = 0; i < rgb.size(); i++) {
+        rgb[i] = (uint8_t)(i * 7 + id * 31);
+    }
+
+    FILE *f = fopen(path.c_str(), "wb");
+    if (f == NULL) {
+        return false;
+    }
+    struct jpeg_compress_struct cinfo;
+    enc_err_t err;
+    cinfo.err = jpeg_std_error(&err.pub);
+    err.pub.error_exit = enc_error_exit;
+    if (setjmp(err.jmp)) {
+        jpeg_destroy_compress(&cinfo);
+        fclose(f);
+        return false;
+    }
+    jpeg_create_compress(&cinfo);
+    jpeg_stdio_dest(&cinfo, f);
+    cinfo.image_width = w;
+    cinfo.image_height = CHECK_IMAGE_H;
+    cinfo.input_components = 3;
+    cinfo.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, 80, TRUE);
+    jpeg_start_compress(&cinfo, TRUE);
+    while (cinfo.next_scanline < cinfo.image_height) {
+        JSAMPROW row = &rgb[(size_t)cinfo.next_scanline * w * 3];
+        jpeg_write_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+    return fclose(f) == 0;
+}
+
+static std::string image_path(const std::string &dir, int id)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "/img_%02d.jpg", id);
+    return dir + name;
+}
+
+static bool make_set(const std::string &dir, int first_id)
+{
+    mkdir(dir.c_str(), 0755);
+    for (int i = 0; i < CHECK_SET_SIZE; i++) {
+        if (!write_jpeg(image_path(dir, first_id + i), first_id + i)) {
+            fprintf(stderr, "failed to write %s\n", image_path(dir, first_id + i).c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [--rounds N] [--read-delay-us US] DIR\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+    int rounds = 200;
+    uint32_t read_delay_us = 20000;
+    const char *root = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc) {
+            rounds = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--read-delay-us") == 0 && i + 1 < argc) {
+            read_delay_us = strtoul(argv[++i], NULL, 10);
+        } else if (argv[i][0] == '-') {
+            usage(argv[0]);
+            return 2;
+        } else {
+            root = argv[i];
+        }
+    }
+    if (root == NULL) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    mkdir(root, 0755);
+    std::string dir[2] = {std::string(root) + "/a", std::string(root) + "/b"};
+    if (!make_set(dir[0], 0) || !make_set(dir[1], CHECK_SET_SIZE)) {
+        return 1;
+    }
+
+    fs::FS sd;
+    sd.setReadDelay(read_delay_us);
+    slideshow show(sd);
+    if (!show.begin()) {
+        fprintf(stderr, "slideshow task failed to start\n");
+        return 1;
+    }
+
+    // The playlist as the slideshow should see it: ids, -1 for a missing file
+    std::vector<int> model;
+    int set = 0;
+    show.loadDirectory(dir[set].c_str());
+    for (int i = 0; i < CHECK_SET_SIZE; i++) {
+        model.push_back(set * CHECK_SET_SIZE + i);
+    }
+
+    int shown = 0;
+    int mismatches = 0;
+    int failed_expected = 0;
+    int clears = 0;
+    int appends = 0;
+    int64_t max_clear_us = 0;
+
+    for (int round = 0; round < rounds; round++) {
+        s_drawn_width = 0;
+        bool ok = show.showNext(checkDrawCallback);
+        int index = show.current();
+        int expect = index >= 0 && index < (int)model.size() ? model[index] : -2;
+        if (expect == -1) {
+            failed_expected++;
+            if (ok) {
+                fprintf(stderr, "round %d: missing file at %d reported as shown\n", round, index);
+                mismatches++;
+            }
+        } else if (!ok || s_drawn_width != id_width(expect)) {
+            fprintf(stderr, "round %d: index %d drew width %d, expected image %d (width %d)\n",
+                    round, index, s_drawn_width, expect, expect >= 0 ? id_width(expect) : 0);
+            mismatches++;
+        } else {
+            shown++;
+        }
+
+        // showNext() has just queued the next image: change the playlist under it.
+        // Each cycle shows the directory, the missing file behind it and some of the appended files
+        switch (round % (CHECK_SET_SIZE + 4)) {
+        case 0: {
+            int64_t t = esp_timer_get_time();
+            show.clear();
+            int64_t us = esp_timer_get_time() - t;
+            max_clear_us = us > max_clear_us ? us : max_clear_us;
+            clears++;
+            set ^= 1;
+            model.clear();
+            show.loadDirectory(dir[set].c_str());
+            for (int i = 0; i < CHECK_SET_SIZE; i++) {
+                model.push_back(set * CHECK_SET_SIZE + i);
+            }
+            break;
+        }
+        case 1:
+            show.addFile((std::string(root) + "/missing.jpg").c_str());
+            model.push_back(-1);
+            break;
+        case 2:
+            // Enough entries that the vector reallocates while the path is being read
+            for (int i = 0; i < 4 * CHECK_SET_SIZE; i++) {
+                int id = (i * 5 + round) % (2 * CHECK_SET_SIZE);
+                show.addFile(image_path(dir[id / CHECK_SET_SIZE], id).c_str());
+                model.push_back(id);
+            }
+            appends++;
+            break;
+        default:
+            break;
+        }
+    }
+
+    // Stops the SD task before the slideshow and its buffers go away
+    show.end();
+
+    slideshow_stats_t st = show.stats();
+    printf("rounds %d: %d shown, %d missing files skipped, %d mismatches\n", rounds, shown, failed_expected, mismatches);
+    printf("%d clears with a prefetch in flight (longest wait %.1f ms), %d bulk appends\n",
+           clears, max_clear_us / 1000.0, appends);
+    printf("slideshow stats: %u transitions, %u stalls, %u failed, %u decode failed\n",
+           (unsigned)st.transitions, (unsigned)st.stalls, (unsigned)st.failed, (unsigned)st.decode_failed);
+    if (st.failed != (uint32_t)failed_expected) {
+        fprintf(stderr, "slideshow counted %u failed loads, expected %d\n", (unsigned)st.failed, failed_expected);
+        mismatches++;
+    }
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,252 @@
+/*
+ * strip_golden: golden-image check for the strip renderer (src/gfx/strip_renderer.h).
+ *
+ *   g++ -O2 -I../host -o strip_golden strip_golden.cpp ../../src/gfx/strip_renderer.cpp \
+ *       ../../src/gfx/fonts/font_lato_20.cpp ../../src/gfx/fonts/font_lato_48_digits.cpp \
+ *       ../host/host_runtime.cpp -lpthread
+ *   ./strip_golden [--update] [--dump DIR]
+ *
+ * Every scene is composed over the same synthetic "photo" at several strip
+ * heights and once more through a window narrower than the panel, the way a
+ * cropped decode would call render(). All of them must give the same frame,
+ * and the frame hash must match the table below. --update prints a new table
+ * after a deliberate change to the renderer or the fonts, --dump writes each
+ * frame as a PPM for a look. The blend routine is also checked against a
+ * per-channel reference for every color pair on a grid of alphas.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "../../src/gfx/strip_renderer.h"
+
+#define W (480)
+#define H (272)
+
+typedef struct {
+    const char *name;
+    void (*build)(strip_renderer &r);
+    uint32_t golden;
+} scene_t;
+
+static void scene_shapes(strip_renderer &r)
+{
+    r.fillRect(10, 10, 120, 60, 0xF800);
+    r.fillRect(60, 40, 120, 60, 0x001F, 128);
+    r.fillRoundRect(200, 12, 140, 80, 12, 0x07E0);
+    r.fillRoundRect(360, 20, 100, 100, 50, 0xFFE0, 200);
+    r.fillRoundRect(20, 150, 200, 100, 24, 0x0000, 96);
+    // Lines at a spread of angles and widths, including both near-axis cases
+    r.drawLine(240, 140, 470, 140, 0xFFFF);
+    r.drawLine(240, 150, 470, 158, 0xFFFF);
+    r.drawLine(240, 170, 470, 260, 0xF81F, 3);
+    r.drawLine(250, 260, 300, 120, 0x07FF, 2);
+    r.drawLine(320, 120, 321, 260, 0xFFFF);
+    r.drawLine(340, 250, 460, 180, 0xFD20, 8, 160);
+    r.drawLine(400, 200, 400, 200, 0x0000, 6);
+}
+
+static void scene_text(strip_renderer &r)
+{
+    r.fillRoundRect(8, 196, 464, 68, 10, 0x0000, 140);
+    r.drawText(20, 204, "12:34", &font_lato_48_digits, 0xFFFF);
+    int label = r.drawText(180, 210, "placeholder", &font_lato_20, 0xFFE0);
+    r.setText(label, "IMG_0042.JPG  480x272");
+    r.drawText(180, 234, "Quick brown fox: {jumps} over 9 lazy dogs!", &font_lato_20, 0xC618, 180);
+    r.drawText(300, 8, "AVWTyg", &font_lato_20, 0x0000);
+}
+
+static void scene_clip(strip_renderer &r)
+{
+    // Items hanging off every edge, a hidden one, and strings the fonts do not cover
+    r.fillRoundRect(-40, -30, 120, 90, 30, 0x7BEF);
+    r.fillRect(420, 230, 100, 100, 0xF800, 100);
+    r.drawLine(-20, 260, 500, -10, 0x001F, 4);
+    r.drawText(430, 100, "clipped text", &font_lato_20, 0xFFFF);
+    r.drawText(-30, 120, "-12:0", &font_lato_48_digits, 0xFFE0);
+    r.drawText(200, 120, "", &font_lato_20, 0xFFFF);
+    r.drawText(200, 150, "abc", &font_lato_48_digits, 0xFFFF);
+    int hidden = r.fillRect(0, 0, W, H, 0x0000);
+    r.setVisible(hidden, false);
+}
+
+static scene_t scenes[] = {
+    {"shapes", scene_shapes, 0x9b8b875bu},
+    {"text", scene_text, 0x5e977009u},
+    {"clip", scene_clip, 0x13a8bbffu},
+};
+
+// A smooth gradient with some texture, in panel byte order like decoder output
+static void background(uint16_t *frame)
+{
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            uint16_t r = (x * 31) / (W - 1);
+            uint16_t g = (y * 63) / (H - 1);
+            uint16_t b = ((x ^ y) >> 3) & 31;
+            uint16_t c = (r << 11) | (g << 5) | b;
+            frame[y * W + x] = (c >> 8) | (c << 8);
+        }
+    }
+}
+
+// Compose the frame the way the decoder would: one strip at a time, copied out after render()
+static void compose(strip_renderer &r, uint16_t *frame, int strip_h, int x, int w)
+{
+    uint16_t *strip = (uint16_t *)malloc((size_t)w * strip_h * 2);
+    background(frame);
+    for (int y = 0; y < H; y += strip_h) {
+        int h = H - y < strip_h ? H - y : strip_h;
+        for (int row = 0; row < h; row++) {
+            memcpy(strip + row * w, frame + (y + row) * W + x, w * 2);
+        }
+        r.render(strip, x, y, w, h);
+        for (int row = 0; row < h; row++) {
+            memcpy(frame + (y + row) * W + x, strip + row * w, w * 2);
+        }
+    }
+    free(strip);
+}
+
+static uint32_t fnv1a(const uint16_t *frame)
+{
+    const uint8_t *p = (const uint8_t *)frame;
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < (size_t)W * H * 2; i++) {
+        h = (h ^ p[i]) * 16777619u;
+    }
+    return h;
+}
+
+static void dump(const char *dir, const char *name, const uint16_t *frame)
+{
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s.ppm", dir, name);
+    FILE *f = fopen(path, "wb");
+    if (f == NULL) {
+        fprintf(stderr, "%s: cannot write\n", path);
+        return;
+    }
+    fprintf(f, "P6\n%d %d\n255\n", W, H);
+    for (int i = 0; i < W * H; i++) {
+        uint16_t c = (frame[i] >> 8) | (frame[i] << 8);
+        uint8_t rgb[3] = {(uint8_t)((c >> 11) * 255 / 31), (uint8_t)(((c >> 5) & 63) * 255 / 63), (uint8_t)((c & 31) * 255 / 31)};
+        fwrite(rgb, 1, 3, f);
+    }
+    fclose(f);
+}
+
+// The renderer blends with 5-bit alpha on all three channels packed into one word;
+// every channel must land within one step of a per-channel blend at that alpha
+static int check_blend()
+{
+    strip_renderer r(1, 1);
+    r.begin();
+    int bad = 0;
+    for (int alpha = 0; alpha <= 255; alpha += 5) {
+        for (uint32_t fg = 0; fg < 0x10000; fg += 257) {
+            for (uint32_t bg = 0; bg < 0x10000; bg += 263) {
+                r.clear();
+                r.fillRect(0, 0, 1, 1, fg, alpha);
+                uint16_t px = (bg >> 8) | (bg << 8);
+                r.render(&px, 0, 0, 1, 1);
+                uint16_t out = (px >> 8) | (px << 8);
+                const int shift[3] = {11, 5, 0};
+                const int mask[3] = {31, 63, 31};
+                for (int ch = 0; ch < 3; ch++) {
+                    int f = (fg >> shift[ch]) & mask[ch];
+                    int b = (bg >> shift[ch]) & mask[ch];
+                    int o = (out >> shift[ch]) & mask[ch];
+                    double want = alpha < 4 ? b : (alpha >= 252 ? f : b + (f - b) * ((alpha + 4) >> 3) / 32.0);
+                    if (o < want - 1.0 || o > want + 1.0) {
+                        if (bad++ < 5) {
+                            printf("blend: fg %04x bg %04x alpha %d -> %04x\n", fg, bg, alpha, out);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return bad;
+}
+
+int main(int argc, char **argv)
+{
+    bool update = false;
+    const char *dump_dir = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--update") == 0) {
+            update = true;
+        } else if (strcmp(argv[i], "--dump") == 0 && i + 1 < argc) {
+            dump_dir = argv[++i];
+        } else {
+            fprintf(stderr, "usage: strip_golden [--update] [--dump DIR]\n");
+            return 2;
+        }
+    }
+
+    static const int heights[] = {16, 8, 13, 1, H};
+    uint16_t *ref = (uint16_t *)malloc(W * H * 2);
+    uint16_t *frame = (uint16_t *)malloc(W * H * 2);
+    int failures = 0;
+
+    int bad = check_blend();
+    printf("blend565: %s (%d channel errors)\n", bad ? "FAIL" : "ok", bad);
+    failures += bad ? 1 : 0;
+
+    for (size_t s = 0; s < sizeof(scenes) / sizeof(scenes[0]); s++) {
+        strip_renderer r(H, 32);
+        if (!r.begin()) {
+            fprintf(stderr, "renderer: out of memory\n");
+            return 1;
+        }
+        scenes[s].build(r);
+
+        compose(r, ref, heights[0], 0, W);
+        strip_render_stats_t st = r.stats();
+        bool same = true;
+        for (size_t k = 1; k < sizeof(heights) / sizeof(heights[0]); k++) {
+            compose(r, frame, heights[k], 0, W);
+            if (memcmp(frame, ref, W * H * 2) != 0) {
+                printf("%s: strip height %d differs from %d\n", scenes[s].name, heights[k], heights[0]);
+                same = false;
+            }
+        }
+        // A window away from the panel origin: only those columns may change
+        uint16_t *bg = (uint16_t *)malloc(W * H * 2);
+        background(bg);
+        compose(r, frame, 16, 100, 200);
+        for (int y = 0; y < H && same; y++) {
+            for (int x = 0; x < W; x++) {
+                uint16_t want = (x >= 100 && x < 300) ? ref[y * W + x] : bg[y * W + x];
+                if (frame[y * W + x] != want) {
+                    printf("%s: windowed render differs at %d,%d\n", scenes[s].name, x, y);
+                    same = false;
+                    break;
+                }
+            }
+        }
+        free(bg);
+
+        uint32_t hash = fnv1a(ref);
+        bool match = hash == scenes[s].golden;
+        if (update) {
+            printf("    {\"%s\", scene_%s, 0x%08xu},\n", scenes[s].name, scenes[s].name, hash);
+        } else {
+            printf("%-7s %08x %s, strips %s; per 16-line frame: %u strips, %u drawn, %u skipped, %u spans, %llu px, %llu us\n",
+                   scenes[s].name, hash, match ? "ok" : "MISMATCH", same ? "consistent" : "INCONSISTENT",
+                   st.strips, st.items_drawn, st.items_skipped, st.spans,
+                   (unsigned long long)st.pixels, (unsigned long long)st.render_us);
+        }
+        if (dump_dir != NULL) {
+            dump(dump_dir, scenes[s].name, ref);
+        }
+        if (!same || (!match && !update)) {
+            failures++;
+        }
+    }
+
+    free(ref);
+    free(frame);
+    return failures ? 1 : 0;
+}
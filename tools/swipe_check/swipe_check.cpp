@@ -0,0 +1,308 @@
+/*
+ * swipe_check: host run of the swipe prefetcher (src/gallery/swipe_prefetch.h) through a gesture script.
+ *
+ *   g++ -O1 -g -fsanitize=address,undefined -I../host -o swipe_check swipe_check.cpp \
+ *       ../host/esp_jpeg_host.cpp ../host/host_runtime.cpp ../host/host_fs.cpp ../host/host_lcd.cpp \
+ *       ../../src/mem/pipeline_arena.cpp ../../src/decode/image_source.cpp \
+ *       ../../src/decode/baseline_jpeg.cpp ../../src/decode/baseline_idct.cpp \
+ *       ../../src/decode/jpeg_thumb.cpp ../../src/sd/sd_loader.cpp \
+ *       ../../src/trace/pipeline_trace.cpp ../../src/gallery/swipe_prefetch.cpp -ljpeg -lpthread
+ *   ./swipe_check [--rounds 20] [--read-delay-us 10000] [--max-cancel-ms 100] DIR
+ *
+ * Writes a gallery of JPEGs under DIR, each a solid color that tells it apart,
+ * one of them larger than the panel, plus a path to a file that does not exist.
+ * tools/host/host_fs delays every read, so the speculative decode started at
+ * the beginning of a drag is still in flight for a while. Each round plays the
+ * gestures the sketch's loop() turns touches into, with hold times from none to
+ * longer than a decode: swipes that complete, a drag that reverses before the
+ * release, a drag let go before it commits, and a fling the other way than the
+ * drag began. After every hit the panel (tools/host/host_lcd) must show the
+ * image swiped to. The check fails unless every completed swipe onto an
+ * existing file was a hit, every abandoned speculative decode was counted as
+ * cancelled, every decode started is accounted for as a hit, a cancel or a
+ * failure, and no cancel took longer than --max-cancel-ms to let the decoder go.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <sys/stat.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <jpeglib.h>
+#include "host_lcd.h"
+#include "../../src/gallery/swipe_prefetch.h"
+
+#define CHECK_IMAGES (6)
+#define CHECK_BIG (3)        // this one is 1600x1200, cropped to the panel
+#define CHECK_MISSING (5)    // no file behind this path
+
+typedef struct {
+    struct jpeg_error_mgr pub;
+    jmp_buf jmp;
+} enc_err_t;
+
+typedef enum {
+    GESTURE_SWIPE,    // drag one way, release past the commit distance
+    GESTURE_REVERSE,  // drag one way, come back past the start, release the other way
+    GESTURE_ABANDON,  // drag, then let go short of the commit distance
+    GESTURE_FLING,    // drag one way, then fling the other without a drag update in between
+} gesture_t;
+
+typedef struct {
+    uint32_t swipes;   // completions onto an existing file
+    uint32_t hits;
+    uint32_t misses;   // flings and swipes onto the missing file
+    uint32_t drops;    // speculative decodes of existing files the gestures dropped
+    uint32_t doomed;   // speculative decodes of the missing file: dropped while queued, or failed
+    uint32_t wrong;    // hits that left the panel showing another image
+} tally_t;
+
+// A speculative decode of `index` is dropped
+static void drop(tally_t *t, int index)
+{
+    if (index == CHECK_MISSING) {
+        t->doomed++;
+    } else {
+        t->drops++;
+    }
+}
+
+static void enc_error_exit(j_common_ptr cinfo)
+{
+    longjmp(((enc_err_t *)cinfo->err)->jmp, 1);
+}
+
+// Red level of image `id`, far enough apart to survive JPEG and RGB565
+static uint8_t id_red(int id)
+{
+    return (uint8_t)(24 + id * 40);
+}
+
+static bool write_jpeg(const std::string &path, int id, int w, int h)
+{
+    std::vector<uint8_t> row((size_t)w * 3);
+    for (int x = 0; x < w; x++) {
+        row[x * 3 + 0] = id_red(id);
+        row[x * 3 + 1] = 128;
+        row[x * 3 + 2] = 64;
+    }
+
+    FILE *f = fopen(path.c_str(), "wb");
+    if (f == NULL) {
+        return false;
+    }
+    struct jpeg_compress_struct cinfo;
+    enc_err_t err;
+    cinfo.err = jpeg_std_error(&err.pub);
+    err.pub.error_exit = enc_error_exit;
+    if (setjmp(err.jmp)) {
+        jpeg_destroy_compress(&cinfo);
+        fclose(f);
+        return false;
+    }
+    jpeg_create_compress(&cinfo);
+    jpeg_stdio_dest(&cinfo, f);
+    cinfo.image_width = w;
+    cinfo.image_height = h;
+    cinfo.input_components = 3;
+    cinfo.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, 90, TRUE);
+    jpeg_start_compress(&cinfo, TRUE);
+    while (cinfo.next_scanline < cinfo.image_height) {
+        JSAMPROW p = row.data();
+        jpeg_write_scanlines(&cinfo, &p, 1);
+    }
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+    return fclose(f) == 0;
+}
+
+// Image id whose red level the panel shows at its centre, -1 if none is close
+static int shown_id(nv3041a_lcd &lcd)
+{
+    uint16_t v = host_lcd_frame(lcd)[(size_t)lcd.height() / 2 * lcd.width() + lcd.width() / 2];
+    uint16_t px = (v >> 8) | (v << 8);
+    int red = (px >> 11) << 3;
+    for (int id = 0; id < CHECK_IMAGES; id++) {
+        if (abs(red - id_red(id)) <= 12) {
+            return id;
+        }
+    }
+    return -1;
+}
+
+static void sleep_ms(uint32_t ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+// Plays one gesture from image `cur`; returns the image shown afterwards
+static int play(swipe_prefetch &swipe, nv3041a_lcd &lcd, gesture_t g, int cur, int dir, uint32_t hold_ms, tally_t *t)
+{
+    swipe.dragBegin(cur, dir);
+    sleep_ms(hold_ms);
+    int target = swipe.neighbour(cur, dir);
+    switch (g) {
+    case GESTURE_REVERSE:
+        drop(t, target);
+        dir = -dir;
+        swipe.dragUpdate(cur, dir);
+        target = swipe.neighbour(cur, dir);
+        sleep_ms(hold_ms);
+        break;
+    case GESTURE_ABANDON:
+        drop(t, target);
+        swipe.cancel();
+        return cur;
+    case GESTURE_FLING:
+        drop(t, target);
+        target = swipe.neighbour(cur, -dir);
+        break;
+    default:
+        break;
+    }
+    t->doomed += target == CHECK_MISSING && g != GESTURE_FLING ? 1 : 0;
+
+    bool hit = swipe.complete(target, lcd);
+    if (g == GESTURE_FLING || target == CHECK_MISSING) {
+        // Those decode on demand in the sketch; the prefetcher only has to say so
+        t->misses++;
+        if (hit) {
+            fprintf(stderr, "%s onto %d reported as a hit\n", g == GESTURE_FLING ? "fling" : "swipe", target);
+            t->wrong++;
+        }
+        return target;
+    }
+    t->swipes++;
+    if (!hit) {
+        fprintf(stderr, "swipe %d -> %d after %u ms missed\n", cur, target, hold_ms);
+        return target;
+    }
+    t->hits++;
+    if (shown_id(lcd) != target) {
+        fprintf(stderr, "swipe %d -> %d shows image %d\n", cur, target, shown_id(lcd));
+        t->wrong++;
+    }
+    return target;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [--rounds N] [--read-delay-us US] [--max-cancel-ms MS] DIR\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+    int rounds = 20;
+    uint32_t read_delay_us = 10000;
+    uint32_t max_cancel_ms = 100;
+    const char *root = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc) {
+            rounds = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--read-delay-us") == 0 && i + 1 < argc) {
+            read_delay_us = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--max-cancel-ms") == 0 && i + 1 < argc) {
+            max_cancel_ms = strtoul(argv[++i], NULL, 10);
+        } else if (argv[i][0] == '-') {
+            usage(argv[0]);
+            return 2;
+        } else {
+            root = argv[i];
+        }
+    }
+    if (root == NULL || rounds <= 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    mkdir(root, 0755);
+    std::vector<std::string> names;
+    for (int id = 0; id < CHECK_IMAGES; id++) {
+        char name[32];
+        snprintf(name, sizeof(name), "/swipe_%d.jpg", id);
+        names.push_back(std::string(root) + name);
+        remove(names.back().c_str());
+        if (id == CHECK_MISSING) {
+            continue;
+        }
+        bool big = id == CHECK_BIG;
+        if (!write_jpeg(names.back(), id, big ? 1600 : 480, big ? 1200 : 272)) {
+            fprintf(stderr, "failed to write %s\n", names.back().c_str());
+            return 1;
+        }
+    }
+    std::vector<const char *> paths;
+    for (const std::string &n : names) {
+        paths.push_back(n.c_str());
+    }
+
+    fs::FS sd;
+    sd.setReadDelay(read_delay_us);
+    nv3041a_lcd lcd(-1, -1, -1, -1, -1, -1, -1);
+    lcd.begin();
+    swipe_prefetch swipe(sd, paths.data(), paths.size());
+    if (!swipe.begin()) {
+        fprintf(stderr, "swipe prefetch failed to start\n");
+        return 1;
+    }
+
+    // From a flick released at once to a drag held past the read and decode
+    static const uint32_t holds[] = {0, 2, 8, 25, 60};
+    static const gesture_t script[] = {
+        GESTURE_SWIPE, GESTURE_SWIPE, GESTURE_REVERSE, GESTURE_SWIPE, GESTURE_ABANDON,
+        GESTURE_SWIPE, GESTURE_FLING, GESTURE_REVERSE, GESTURE_ABANDON, GESTURE_SWIPE,
+    };
+    tally_t t = {};
+    int cur = 0;
+    int step = 0;
+    for (int round = 0; round < rounds; round++) {
+        for (gesture_t g : script) {
+            int dir = (step / 3) % 2 ? -1 : 1;
+            cur = play(swipe, lcd, g, cur, dir, holds[step % (sizeof(holds) / sizeof(holds[0]))], &t);
+            step++;
+        }
+    }
+    // Whatever the last gesture left behind
+    swipe.cancel();
+    swipe.end();
+
+    swipe_prefetch_stats_t st = swipe.stats();
+    printf("%d gestures: %u swipes, %u hits (%.1f%%), %u misses expected\n", step, t.swipes, t.hits,
+           t.swipes ? 100.0 * t.hits / t.swipes : 0.0, t.misses);
+    printf("prefetch: %u started, %u hits, %u misses, %u cancelled (%u dropped), %u failed, "
+           "%u lines and %u us wasted, longest cancel %.1f ms\n",
+           st.started, st.hits, st.misses, st.cancelled, t.drops + t.doomed, st.failed, st.wasted_lines,
+           st.wasted_us, st.max_cancel_us / 1000.0);
+
+    int failures = 0;
+    if (t.hits != t.swipes || t.wrong != 0) {
+        fprintf(stderr, "completed swipes were missed or showed the wrong image\n");
+        failures++;
+    }
+    if (st.hits != t.hits || st.misses != t.misses) {
+        fprintf(stderr, "prefetcher counted %u hits and %u misses, expected %u and %u\n", st.hits, st.misses, t.hits,
+                t.misses);
+        failures++;
+    }
+    // A dropped decode of the missing file fails instead if it got as far as opening it
+    if (st.cancelled < t.drops || st.cancelled + st.failed != t.drops + t.doomed) {
+        fprintf(stderr, "prefetcher counted %u cancelled and %u failed, the gestures dropped %u and %u were doomed\n",
+                st.cancelled, st.failed, t.drops, t.doomed);
+        failures++;
+    }
+    if (st.started != st.hits + st.cancelled + st.failed) {
+        fprintf(stderr, "%u decodes started but %u accounted for\n", st.started, st.hits + st.cancelled + st.failed);
+        failures++;
+    }
+    if (st.max_cancel_us > max_cancel_ms * 1000) {
+        fprintf(stderr, "a cancel took %.1f ms to stop the decoder\n", st.max_cancel_us / 1000.0);
+        failures++;
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,174 @@
+/*
+ * te_sim: run the TE flush scheduler (src/lcd/te_sync.h) against a simulated panel.
+ *
+ *   g++ -O2 -I../host -o te_sim te_sim.cpp ../../src/lcd/te_sync.cpp \
+ *       ../host/host_panel.cpp ../host/host_runtime.cpp -lpthread
+ *   ./te_sim [--period 16667] [--images 120] [--strip 16] [--decode-us 300] [--jitter 50]
+ *            [--decode-jitter 0]
+ *
+ * Each image is sent as strips of --strip rows, with --decode-us of simulated
+ * decode work before every strip, the way the block decoder drives the panel;
+ * --decode-jitter adds up to that many microseconds more to each strip, as a
+ * slow SD read would. The same sequence is played free-running and then paced
+ * by te_sync, and the tool reports how many scan passes showed a tear in each
+ * case together with the scheduler's frame-phase statistics.
+ *
+ * Everything runs on the simulated clock (tools/host/host_clock.h) with fixed
+ * seeds, so a run gives the same numbers on any host. A strip that falls
+ * behind the learnt pace tears its image, and te_sync counts each pass shown
+ * that way in `late`. The exit code is 1 if a paced run shows more torn passes
+ * than that, or if the scan line ran through a strip te_sync did not call
+ * `unsafe`: either means a prediction was wrong.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_timer.h"
+#include "host_clock.h"
+#include "host_panel.h"
+#include "../../src/lcd/te_sync.h"
+
+#define SIM_WIDTH (480)
+#define SIM_LINES (272)
+
+typedef struct {
+    uint32_t period_us;
+    uint32_t scan_delay_us;
+    uint32_t bytes_per_ms;
+    uint32_t jitter_us;
+    int images;
+    int strip;
+    int decode_us;
+    int decode_jitter_us;
+} sim_config_t;
+
+static void onTe(void *ctx, int64_t t_us)
+{
+    ((te_sync *)ctx)->onEdge(t_us);
+}
+
+// Returns the tears te_sync did not see coming: torn passes beyond its late count,
+// and strips the scan line ran through beyond the ones it called unsafe
+static uint32_t play(const sim_config_t &cfg, bool paced, bool from_top)
+{
+    uint32_t seed = 1;
+    host_panel panel(SIM_LINES, cfg.period_us, cfg.scan_delay_us, cfg.bytes_per_ms);
+    te_sync te(SIM_LINES);
+    te.setBusRate(cfg.bytes_per_ms);
+    te.setScanDelay(cfg.scan_delay_us);
+    panel.setJitter(cfg.jitter_us);
+    panel.start(onTe, &te);
+
+    // Let the scheduler measure the period first
+    while (!te.locked()) {
+        host_clock_advance(1000);
+    }
+    te.resetStats();
+
+    int64_t t = esp_timer_get_time();
+    for (int i = 0; i < cfg.images; i++) {
+        if (paced) {
+            te.beginFrame(from_top);
+        }
+        for (int y = 0; y < SIM_LINES; y += cfg.strip) {
+            int h = SIM_LINES - y < cfg.strip ? SIM_LINES - y : cfg.strip;
+            uint32_t bytes = (uint32_t)SIM_WIDTH * h * 2;
+            int decode_us = cfg.decode_us;
+            if (cfg.decode_jitter_us > 0) {
+                seed = seed * 1103515245u + 12345u;
+                decode_us += (seed >> 8) % (cfg.decode_jitter_us + 1);
+            }
+            host_clock_advance(decode_us);
+            if (paced) {
+                te.waitStrip(y, h, bytes);
+            }
+            panel.write(y, h, bytes, i);
+        }
+    }
+    t = esp_timer_get_time() - t;
+    // One more period so the last image is scanned out
+    host_clock_advance(2 * cfg.period_us);
+    panel.stop();
+
+    uint32_t passes, torn, crossed;
+    panel.scanReport(&passes, &torn, &crossed);
+    te_stats_t s = te.stats();
+    printf("%-18s %6.1f fps  %4u/%-4u torn passes", !paced ? "free-running" : from_top ? "te_sync from top" : "te_sync",
+           cfg.images * 1e6 / t, torn, passes);
+    if (paced) {
+        printf("  delayed %u/%u strips, wait %.1f ms, late %u, unsafe %u, crossed %u", s.delayed, s.strips, s.wait_us / 1000.0,
+               s.late, s.unsafe, crossed);
+    }
+    printf("\n");
+    if (paced) {
+        printf("%-18s period %u us (%u..%u), jitter %u us, missed %u, phase", "", s.period_us, s.period_min_us, s.period_max_us,
+               s.jitter_us, s.missed);
+        for (int b = 0; b < TE_PHASE_BINS; b++) {
+            printf(" %u", s.phase_hist[b]);
+        }
+        printf("\n");
+    }
+    if (!paced) {
+        return 0;
+    }
+    uint32_t missed = torn > s.late ? torn - s.late : 0;
+    missed += crossed > s.unsafe ? crossed - s.unsafe : 0;
+    if (missed > 0) {
+        printf("%-18s %u torn passes not reported as late, %u strips crossed the scan line without being unsafe\n", "",
+               torn > s.late ? torn - s.late : 0, crossed > s.unsafe ? crossed - s.unsafe : 0);
+    }
+    return missed;
+}
+
+int main(int argc, char **argv)
+{
+    sim_config_t cfg = {16667, 0, 16000, 50, 120, 16, 300, 0};
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) {
+            fprintf(stderr, "%s: missing value\n", argv[i]);
+            return 2;
+        }
+        int v = atoi(argv[i + 1]);
+        if (strcmp(argv[i], "--period") == 0) {
+            cfg.period_us = v;
+        } else if (strcmp(argv[i], "--scan-delay") == 0) {
+            cfg.scan_delay_us = v;
+        } else if (strcmp(argv[i], "--rate") == 0) {
+            cfg.bytes_per_ms = v;
+        } else if (strcmp(argv[i], "--jitter") == 0) {
+            cfg.jitter_us = v;
+        } else if (strcmp(argv[i], "--images") == 0) {
+            cfg.images = v;
+        } else if (strcmp(argv[i], "--strip") == 0) {
+            cfg.strip = v;
+        } else if (strcmp(argv[i], "--decode-us") == 0) {
+            cfg.decode_us = v;
+        } else if (strcmp(argv[i], "--decode-jitter") == 0) {
+            cfg.decode_jitter_us = v;
+        } else {
+            fprintf(stderr, "usage: te_sim [--period US] [--scan-delay US] [--rate BYTES_PER_MS] [--jitter US]\n"
+                            "              [--images N] [--strip ROWS] [--decode-us US] [--decode-jitter US]\n");
+            return 2;
+        }
+        i++;
+    }
+    if (cfg.period_us == 0 || cfg.bytes_per_ms == 0 || cfg.images <= 0 || cfg.strip <= 0 || cfg.decode_us < 0 ||
+            cfg.decode_jitter_us < 0) {
+        fprintf(stderr, "invalid configuration\n");
+        return 2;
+    }
+
+    printf("panel %dx%d, TE period %u us, bus %u bytes/ms, %d-row strips, %d us decode per strip\n", SIM_WIDTH, SIM_LINES,
+           cfg.period_us, cfg.bytes_per_ms, cfg.strip, cfg.decode_us);
+    host_clock_start(1000000);
+    play(cfg, false, false);
+    uint32_t torn = play(cfg, true, false);
+    torn += play(cfg, true, true);
+    host_clock_stop();
+    if (torn > 0) {
+        fprintf(stderr, "%u tears with te_sync pacing that it did not report\n", torn);
+        return 1;
+    }
+    return 0;
+}
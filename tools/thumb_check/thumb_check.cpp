@@ -0,0 +1,414 @@
+/*
+ * thumb_check: host check of the thumbnail cache file and the thumbnail grid.
+ *
+ *   g++ -O1 -g -fsanitize=address,undefined -I../host -o thumb_check thumb_check.cpp \
+ *       ../host/esp_jpeg_host.cpp ../host/host_runtime.cpp ../host/host_fs.cpp ../host/host_lcd.cpp \
+ *       ../../src/mem/pipeline_arena.cpp ../../src/decode/image_source.cpp \
+ *       ../../src/decode/baseline_jpeg.cpp ../../src/decode/baseline_idct.cpp \
+ *       ../../src/decode/jpeg_thumb.cpp ../../src/sd/sd_loader.cpp ../../src/gfx/strip_scaler.cpp \
+ *       ../../src/trace/pipeline_trace.cpp ../../src/gallery/thumb_cache.cpp \
+ *       ../../src/gallery/media_catalog.cpp ../../src/gallery/thumb_grid.cpp -ljpeg -lpthread
+ *   ./thumb_check [--files 24] [--read-delay-us 2000] DIR
+ *
+ * The cache part stores tiles in a small thumb_cache (src/gallery/thumb_cache.h)
+ * through tools/host/host_fs and reads the file back byte by byte against the
+ * layout in the header: magic, tile size, slot count, index entries and
+ * sector-aligned tiles. It then reopens the file and expects every tile back,
+ * expects a changed mtime to miss as stale, overfills the slots and expects
+ * the evictions to be counted and the evicted paths to miss, and opens the
+ * file with another tile size and expects it started afresh.
+ *
+ * The grid part writes --files JPEGs under DIR, shows the first page of a
+ * thumb_grid with the sketch's tile size on tools/host/host_lcd, and waits
+ * for the cold page to fill while every read is delayed. It then starts a new
+ * cache and grid on the same file, as after a reboot, and expects the page to
+ * be full from the cache alone, without a decode, and faster than the cold
+ * one. Both times every cell must hold its tile. The exit code is 1 on any
+ * failure.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <jpeglib.h>
+#include "esp_timer.h"
+#include "host_lcd.h"
+#include "../../src/gallery/thumb_cache.h"
+#include "../../src/gallery/thumb_grid.h"
+
+// The sketch's grid: 110 x 84 tiles, 4 x 3 cells
+#define CHECK_TILE_W (110)
+#define CHECK_TILE_H (84)
+#define CHECK_COLS (4)
+#define CHECK_ROWS (3)
+#define CHECK_IMAGE_W (320)
+#define CHECK_IMAGE_H (240)
+// Small enough to overfill: the probe window covers every slot
+#define CHECK_SLOTS (8)
+#define CHECK_FILL_TIMEOUT_MS (60 * 1000)
+
+typedef struct {
+    struct jpeg_error_mgr pub;
+    jmp_buf jmp;
+} enc_err_t;
+
+static int s_failures;
+
+static void fail(const char *what)
+{
+    fprintf(stderr, "FAIL: %s\n", what);
+    s_failures++;
+}
+
+static void enc_error_exit(j_common_ptr cinfo)
+{
+    longjmp(((enc_err_t *)cinfo->err)->jmp, 1);
+}
+
+static bool write_jpeg(const std::string &path, int id)
+{
+    std::vector<uint8_t> rgb((size_t)CHECK_IMAGE_W * CHECK_IMAGE_H * 3);
+    for (int y = 0; y < CHECK_IMAGE_H; y++) {
+        for (int x = 0; x < CHECK_IMAGE_W; x++) {
+            uint8_t *p = &rgb[((size_t)y * CHECK_IMAGE_W + x) * 3];
+            p[0] = (uint8_t)(x + id * 40);
+            p[1] = (uint8_t)(y + id * 20);
+            p[2] = (uint8_t)(id * 60);
+        }
+    }
+
+    FILE *f = fopen(path.c_str(), "wb");
+    if (f == NULL) {
+        return false;
+    }
+    struct jpeg_compress_struct cinfo;
+    enc_err_t err;
+    cinfo.err = jpeg_std_error(&err.pub);
+    err.pub.error_exit = enc_error_exit;
+    if (setjmp(err.jmp)) {
+        jpeg_destroy_compress(&cinfo);
+        fclose(f);
+        return false;
+    }
+    jpeg_create_compress(&cinfo);
+    jpeg_stdio_dest(&cinfo, f);
+    cinfo.image_width = CHECK_IMAGE_W;
+    cinfo.image_height = CHECK_IMAGE_H;
+    cinfo.input_components = 3;
+    cinfo.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, 85, TRUE);
+    jpeg_start_compress(&cinfo, TRUE);
+    while (cinfo.next_scanline < cinfo.image_height) {
+        JSAMPROW row = &rgb[(size_t)cinfo.next_scanline * CHECK_IMAGE_W * 3];
+        jpeg_write_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+    return fclose(f) == 0;
+}
+
+static std::vector<uint8_t> read_file(const std::string &path)
+{
+    std::vector<uint8_t> data;
+    FILE *f = fopen(path.c_str(), "rb");
+    if (f == NULL) {
+        return data;
+    }
+    uint8_t buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+        data.insert(data.end(), buf, buf + n);
+    }
+    fclose(f);
+    return data;
+}
+
+static uint32_t le32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint32_t round_up(uint32_t v, uint32_t a)
+{
+    return (v + a - 1) / a * a;
+}
+
+static std::vector<uint16_t> make_tile(uint16_t w, uint16_t h, int id)
+{
+    std::vector<uint16_t> tile((size_t)w * h);
+    for (size_t i = 0; i < tile.size(); i++) {
+        tile[i] = (uint16_t)(i * 13 + id * 977);
+    }
+    return tile;
+}
+
+static std::string tile_path(int id)
+{
+    char path[32];
+    snprintf(path, sizeof(path), "/photos/p%03d.jpg", id);
+    return path;
+}
+
+static void check_cache(fs::FS &sd, const std::string &root)
+{
+    const uint16_t tw = 16, th = 12;
+    std::string file = root + "/cache.bin";
+    remove(file.c_str());
+
+    // Three tiles, then the file as the header describes it
+    const int stored = 3;
+    int slot[stored];
+    {
+        thumb_cache cache(sd, file.c_str(), tw, th, CHECK_SLOTS);
+        if (!cache.begin()) {
+            fail("cache: begin() on a new file");
+            return;
+        }
+        for (int i = 0; i < stored; i++) {
+            slot[i] = cache.store(tile_path(i).c_str(), 1000 + i, 2000 + i, make_tile(tw, th, i).data());
+            if (slot[i] < 0) {
+                fail("cache: store() on a new file");
+                return;
+            }
+        }
+    }
+
+    std::vector<uint8_t> raw = read_file(file);
+    uint32_t base = round_up(THUMB_CACHE_HEADER_SIZE + CHECK_SLOTS * THUMB_CACHE_ENTRY_SIZE, THUMB_CACHE_ALIGN);
+    uint32_t stride = round_up((uint32_t)tw * th * 2, THUMB_CACHE_ALIGN);
+    if (raw.size() < base) {
+        fail("cache: file shorter than its index");
+        return;
+    }
+    if (memcmp(raw.data(), THUMB_CACHE_MAGIC, 4) != 0 || raw[4] != THUMB_CACHE_VERSION ||
+            (raw[6] | raw[7] << 8) != tw || (raw[8] | raw[9] << 8) != th || (raw[10] | raw[11] << 8) != CHECK_SLOTS) {
+        fail("cache: header does not match the layout");
+    }
+    for (int i = 0; i < stored; i++) {
+        const uint8_t *e = &raw[THUMB_CACHE_HEADER_SIZE + (size_t)slot[i] * THUMB_CACHE_ENTRY_SIZE];
+        uint64_t hash = le32(e) | ((uint64_t)le32(e + 4) << 32);
+        if (hash != thumb_cache::hashPath(tile_path(i).c_str()) || le32(e + 8) != 1000u + i || le32(e + 12) != 2000u + i) {
+            fail("cache: index entry does not match the layout");
+        }
+        std::vector<uint16_t> tile = make_tile(tw, th, i);
+        if (raw.size() < base + (size_t)slot[i] * stride + tile.size() * 2 ||
+                memcmp(&raw[base + (size_t)slot[i] * stride], tile.data(), tile.size() * 2) != 0) {
+            fail("cache: tile not at its sector-aligned offset");
+        }
+    }
+
+    // Reopened, as after a reboot
+    {
+        thumb_cache cache(sd, file.c_str(), tw, th, CHECK_SLOTS);
+        if (!cache.begin()) {
+            fail("cache: begin() on an existing file");
+            return;
+        }
+        if (cache.used() != stored) {
+            fail("cache: reopened file lost entries");
+        }
+        std::vector<uint16_t> got((size_t)tw * th);
+        for (int i = 0; i < stored; i++) {
+            int s = cache.find(tile_path(i).c_str(), 1000 + i, 2000 + i);
+            if (s != slot[i] || !cache.read(s, got.data()) || got != make_tile(tw, th, i)) {
+                fail("cache: tile not found back after reopening");
+            }
+        }
+
+        // An edited file: same path and size, newer mtime
+        if (cache.find(tile_path(0).c_str(), 1000, 2001) >= 0 || cache.stats().stale != 1) {
+            fail("cache: changed mtime not treated as stale");
+        }
+
+        // Overfill: every store past the last free slot retires a valid tile
+        int total = CHECK_SLOTS + 4;
+        for (int i = stored; i < total; i++) {
+            if (cache.store(tile_path(i).c_str(), 1000 + i, 2000 + i, make_tile(tw, th, i).data()) < 0) {
+                fail("cache: store() while full");
+            }
+        }
+        int found = 0;
+        for (int i = 0; i < total; i++) {
+            found += cache.find(tile_path(i).c_str(), 1000 + i, 2000 + i) >= 0 ? 1 : 0;
+        }
+        thumb_cache_stats_t st = cache.stats();
+        printf("cache: %d tiles in %d slots, %u evictions, %d still found\n", total, CHECK_SLOTS,
+               (unsigned)st.evictions, found);
+        if (cache.used() != CHECK_SLOTS || st.evictions != (uint32_t)(total - CHECK_SLOTS) || found != CHECK_SLOTS) {
+            fail("cache: evictions not counted or evicted tiles still found");
+        }
+        if (cache.find(tile_path(total - 1).c_str(), 1000 + total - 1, 2000 + total - 1) < 0) {
+            fail("cache: latest tile evicted");
+        }
+    }
+
+    // Another tile size: the file is started afresh
+    {
+        thumb_cache cache(sd, file.c_str(), tw + 4, th, CHECK_SLOTS);
+        if (!cache.begin() || cache.used() != 0) {
+            fail("cache: file with another layout not started afresh");
+        }
+    }
+    raw = read_file(file);
+    if (raw.size() < THUMB_CACHE_HEADER_SIZE || (raw[6] | raw[7] << 8) != tw + 4) {
+        fail("cache: header not rewritten for the new layout");
+    }
+}
+
+// Every cell of page 0 holds the tile the cache has for its file
+static bool grid_painted(nv3041a_lcd &lcd, thumb_grid &grid, thumb_cache &cache, int files)
+{
+    const uint16_t *frame = host_lcd_frame(lcd);
+    std::vector<uint16_t> tile((size_t)CHECK_TILE_W * CHECK_TILE_H);
+    int cells = std::min(files, CHECK_COLS * CHECK_ROWS);
+    int seen = 0;
+    // Walk the panel and match the top-left pixel of each cell found by hit()
+    for (uint16_t y = 0; y < lcd.height(); y++) {
+        for (uint16_t x = 0; x < lcd.width(); x++) {
+            int index = grid.hit(x, y);
+            if (index < 0 || grid.hit(x - 1, y) == index || grid.hit(x, y - 1) == index) {
+                continue;
+            }
+            struct stat st;
+            if (stat(grid.path(index), &st) != 0) {
+                return false;
+            }
+            int slot = cache.find(grid.path(index), st.st_size, st.st_mtime);
+            if (slot < 0 || !cache.read(slot, tile.data())) {
+                return false;
+            }
+            for (uint16_t row = 0; row < CHECK_TILE_H; row++) {
+                if (memcmp(frame + (size_t)(y + row) * lcd.width() + x, &tile[(size_t)row * CHECK_TILE_W],
+                           CHECK_TILE_W * 2) != 0) {
+                    return false;
+                }
+            }
+            seen++;
+        }
+    }
+    return seen == cells;
+}
+
+// Shows page 0 and waits until it is full; the grid's stats, or zeros on a timeout
+static thumb_grid_stats_t fill_page(thumb_grid &grid)
+{
+    grid.resetStats();
+    grid.show(0);
+    int64_t start = esp_timer_get_time();
+    while (!grid.update()) {
+        if (esp_timer_get_time() - start > (int64_t)CHECK_FILL_TIMEOUT_MS * 1000) {
+            fail("grid: page not full before the timeout");
+            thumb_grid_stats_t none = {};
+            return none;
+        }
+        vTaskDelay(1);
+    }
+    return grid.stats();
+}
+
+static void check_grid(fs::FS &sd, const std::string &root, int files)
+{
+    std::string dir = root + "/img";
+    mkdir(dir.c_str(), 0755);
+    for (int i = 0; i < files; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "/img_%03d.jpg", i);
+        if (!write_jpeg(dir + name, i)) {
+            fail("grid: cannot write test images");
+            return;
+        }
+    }
+    std::string file = root + "/thumbs.bin";
+    remove(file.c_str());
+    int page = std::min(files, CHECK_COLS * CHECK_ROWS);
+    nv3041a_lcd lcd(-1, -1, -1, -1, -1, -1, -1);
+    lcd.begin();
+
+    thumb_grid_stats_t cold;
+    {
+        thumb_cache cache(sd, file.c_str(), CHECK_TILE_W, CHECK_TILE_H);
+        thumb_grid grid(sd, lcd, cache, CHECK_COLS, CHECK_ROWS);
+        if (!cache.begin() || grid.loadDirectory(dir.c_str()) != files || !grid.begin()) {
+            fail("grid: cold start");
+            return;
+        }
+        cold = fill_page(grid);
+        if (!grid_painted(lcd, grid, cache, files)) {
+            fail("grid: cold page cells do not hold their tiles");
+        }
+        // Stop the task, busy with the next page, before the cache it writes to goes away
+        grid.end();
+        if (!cold.last_cold || cold.misses != (uint32_t)page || cold.hits != 0 || cold.made < (uint32_t)page ||
+                cold.failed != 0) {
+            fail("grid: cold page did not decode every cell");
+        }
+    }
+
+    // A new cache and grid on the same file, as after a reboot
+    thumb_grid_stats_t warm;
+    {
+        thumb_cache cache(sd, file.c_str(), CHECK_TILE_W, CHECK_TILE_H);
+        thumb_grid grid(sd, lcd, cache, CHECK_COLS, CHECK_ROWS);
+        if (!cache.begin() || grid.loadDirectory(dir.c_str()) != files || !grid.begin()) {
+            fail("grid: warm start");
+            return;
+        }
+        lcd.fillScreen(0xFFFF);
+        warm = fill_page(grid);
+        if (!grid_painted(lcd, grid, cache, files)) {
+            fail("grid: warm page cells do not hold their tiles");
+        }
+        grid.end();
+        if (warm.last_cold || warm.hits != (uint32_t)page || warm.misses != 0) {
+            fail("grid: warm page needed a decode");
+        }
+    }
+
+    printf("grid: %d files, %d cells: cold %u ms (%u made, %u ms each), warm %u ms\n", files, page,
+           (unsigned)cold.cold_ms, (unsigned)cold.made, cold.made ? (unsigned)(cold.make_us / cold.made / 1000) : 0,
+           (unsigned)warm.warm_ms);
+    if (warm.warm_ms >= cold.cold_ms) {
+        fail("grid: warm page not faster than the cold one");
+    }
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [--files N] [--read-delay-us US] DIR\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+    int files = 24;
+    uint32_t read_delay_us = 2000;
+    const char *root = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--files") == 0 && i + 1 < argc) {
+            files = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--read-delay-us") == 0 && i + 1 < argc) {
+            read_delay_us = strtoul(argv[++i], NULL, 10);
+        } else if (argv[i][0] == '-') {
+            usage(argv[0]);
+            return 2;
+        } else {
+            root = argv[i];
+        }
+    }
+    if (root == NULL || files <= 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    mkdir(root, 0755);
+    fs::FS sd;
+    check_cache(sd, root);
+    sd.setReadDelay(read_delay_us);
+    check_grid(sd, root, files);
+    return s_failures ? 1 : 0;
+}
@@ -0,0 +1,271 @@
+/*
+ * touch_replay: score touch_predictor (src/touch/touch_predictor.h) on recorded drags.
+ *
+ *   g++ -O2 -o touch_replay touch_replay.cpp ../../src/touch/touch_predictor.cpp
+ *   ./touch_replay --gen drags.txt
+ *   ./touch_replay --latency-us 45000 --jitter-us 10000 drags.txt
+ *
+ * A trace has one touch sample per line, "t_us x y", and "up" where the finger
+ * lifted; '#' starts a comment. --gen writes a synthetic one: flicks that speed
+ * up and slow down, circles, slow drags and a reversal, sampled every 10 ms as
+ * the GT911 reports them, with timing jitter and a pixel of noise.
+ *
+ * Replay models the sketch's drag loop: one redraw per sample, which reaches
+ * the panel --latency-us (plus up to --jitter-us) after the sample was taken and
+ * is fed back through addLatencySample(). Each prediction is scored against
+ * where the trace says the finger was when the redraw landed, interpolated
+ * between samples; redraws landing after the finger lifted are not scored.
+ * The same is done for the raw sample, i.e. drawing without prediction. The
+ * exit code is 1 if prediction did not lower the mean error, or if its mean
+ * went past --max-error px.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+#include "../../pins_config.h"
+#include "../../src/touch/touch_predictor.h"
+
+#define REPLAY_SAMPLE_US (10000)
+#define REPLAY_STROKE_GAP_US (100000) // same as the predictor's stale limit
+
+typedef struct {
+    uint32_t t_us;
+    int x, y;
+} sample_t;
+
+typedef std::vector<sample_t> stroke_t;
+
+static bool load_trace(const char *path, std::vector<stroke_t> &strokes)
+{
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return false;
+    }
+    char line[128];
+    stroke_t cur;
+    while (fgets(line, sizeof(line), f) != NULL) {
+        char *p = line;
+        while (*p == ' ' || *p == '\t') {
+            p++;
+        }
+        if (*p == '#' || *p == '\n' || *p == '\r' || *p == '\0') {
+            continue;
+        }
+        sample_t s;
+        unsigned long t;
+        if (strncmp(p, "up", 2) == 0) {
+            if (!cur.empty()) {
+                strokes.push_back(cur);
+                cur.clear();
+            }
+        } else if (sscanf(p, "%lu %d %d", &t, &s.x, &s.y) == 3) {
+            s.t_us = (uint32_t)t;
+            // A gap in the reports ends the stroke as well, as it does for the predictor
+            if (!cur.empty() && s.t_us - cur.back().t_us > REPLAY_STROKE_GAP_US) {
+                strokes.push_back(cur);
+                cur.clear();
+            }
+            cur.push_back(s);
+        } else {
+            fprintf(stderr, "%s: cannot parse \"%s\"\n", path, p);
+            fclose(f);
+            return false;
+        }
+    }
+    if (!cur.empty()) {
+        strokes.push_back(cur);
+    }
+    fclose(f);
+    return true;
+}
+
+// Position at t_us by linear interpolation; false past the end of the stroke
+static bool position_at(const stroke_t &stroke, uint32_t t_us, double *x, double *y)
+{
+    if (t_us > stroke.back().t_us) {
+        return false;
+    }
+    size_t i = 1;
+    while (i < stroke.size() && stroke[i].t_us < t_us) {
+        i++;
+    }
+    if (i == stroke.size()) {
+        *x = stroke.back().x;
+        *y = stroke.back().y;
+        return true;
+    }
+    const sample_t &a = stroke[i - 1];
+    const sample_t &b = stroke[i];
+    double f = b.t_us > a.t_us ? (double)(t_us - a.t_us) / (b.t_us - a.t_us) : 1.0;
+    *x = a.x + (b.x - a.x) * f;
+    *y = a.y + (b.y - a.y) * f;
+    return true;
+}
+
+static int gen_trace(const char *path)
+{
+    FILE *f = fopen(path, "w");
+    if (f == NULL) {
+        fprintf(stderr, "cannot write %s\n", path);
+        return 1;
+    }
+    srand(26);
+    fprintf(f, "# t_us x y, \"up\" on release; synthetic drags at %u us per report\n", REPLAY_SAMPLE_US);
+
+    uint32_t t = 1000000;
+    int strokes = 0;
+    // kind 0: flick, 1: circle, 2: slow drag, 3: drag that reverses
+    for (int n = 0; n < 24; n++) {
+        int kind = n % 4;
+        double dur_ms = kind == 0 ? 180 + 40 * (n % 3) : kind == 1 ? 1200 : kind == 2 ? 1500 : 900;
+        double cx = LCD_H_RES / 2.0, cy = LCD_V_RES / 2.0;
+        double dir = (n / 4) % 2 ? -1.0 : 1.0;
+        for (double ms = 0; ms <= dur_ms; ms += REPLAY_SAMPLE_US / 1000.0) {
+            double s = ms / dur_ms;
+            double x, y;
+            if (kind == 0) {
+                // Speeds up and slows down over 300 px
+                x = cx - dir * 150 + dir * 300 * (1 - cos(M_PI * s)) / 2;
+                y = cy + 20 * sin(M_PI * s);
+            } else if (kind == 1) {
+                x = cx + 90 * cos(2 * M_PI * s * dir);
+                y = cy + 90 * sin(2 * M_PI * s * dir);
+            } else if (kind == 2) {
+                x = cx - dir * 100 + dir * 200 * s;
+                y = cy - 60 + 120 * s;
+            } else {
+                // Out and back
+                x = cx + dir * 160 * sin(M_PI * s);
+                y = cy + 30 * s;
+            }
+            int jitter_us = rand() % 2001 - 1000;
+            int px = (int)lround(x) + rand() % 3 - 1;
+            int py = (int)lround(y) + rand() % 3 - 1;
+            fprintf(f, "%u %d %d\n", (unsigned)(t + (uint32_t)(ms * 1000) + jitter_us), px, py);
+        }
+        fprintf(f, "up\n");
+        t += (uint32_t)(dur_ms * 1000) + 400000;
+        strokes++;
+    }
+    fclose(f);
+    printf("wrote %d strokes to %s\n", strokes, path);
+    return 0;
+}
+
+static double percentile(std::vector<double> v, double p)
+{
+    if (v.empty()) {
+        return 0;
+    }
+    std::sort(v.begin(), v.end());
+    size_t i = (size_t)ceil(p * v.size()) - 1;
+    return v[i < v.size() ? i : v.size() - 1];
+}
+
+static double mean(const std::vector<double> &v)
+{
+    double sum = 0;
+    for (double e : v) {
+        sum += e;
+    }
+    return v.empty() ? 0 : sum / v.size();
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [--latency-us US] [--jitter-us US] [--max-error PX] TRACE\n"
+                    "       %s --gen TRACE\n", prog, prog);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t latency_us = 45000;
+    uint32_t jitter_us = 10000;
+    double max_error = 0;
+    const char *gen = NULL;
+    const char *path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--gen") == 0 && i + 1 < argc) {
+            gen = argv[++i];
+        } else if (strcmp(argv[i], "--latency-us") == 0 && i + 1 < argc) {
+            latency_us = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--jitter-us") == 0 && i + 1 < argc) {
+            jitter_us = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--max-error") == 0 && i + 1 < argc) {
+            max_error = atof(argv[++i]);
+        } else if (argv[i][0] == '-') {
+            usage(argv[0]);
+            return 2;
+        } else {
+            path = argv[i];
+        }
+    }
+    if (gen != NULL) {
+        return gen_trace(gen);
+    }
+    if (path == NULL) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::vector<stroke_t> strokes;
+    if (!load_trace(path, strokes)) {
+        return 1;
+    }
+
+    // As in gt911_touch: predictions are clamped to the panel
+    touch_predictor predictor(LCD_H_RES - 1, LCD_V_RES - 1);
+    std::vector<double> err_pred, err_raw;
+    srand(1);
+    for (const stroke_t &stroke : strokes) {
+        predictor.release();
+        for (const sample_t &s : stroke) {
+            uint16_t px, py;
+            predictor.update(s.x, s.y, s.t_us);
+            bool ok = predictor.predict(&px, &py);
+
+            // This redraw lands after the pipeline latency, which is then measured
+            uint32_t lat = latency_us + (jitter_us ? (uint32_t)(rand() % (jitter_us + 1)) : 0);
+            predictor.addLatencySample(lat);
+
+            double tx, ty;
+            if (!ok || !position_at(stroke, s.t_us + lat, &tx, &ty)) {
+                continue;
+            }
+            err_pred.push_back(hypot(px - tx, py - ty));
+            err_raw.push_back(hypot(s.x - tx, s.y - ty));
+        }
+    }
+
+    double pred_mean = mean(err_pred);
+    double raw_mean = mean(err_raw);
+    printf("%zu strokes, %zu redraws scored, latency %u..%u us (filter settled at %u us)\n", strokes.size(),
+           err_pred.size(), (unsigned)latency_us, (unsigned)(latency_us + jitter_us), (unsigned)predictor.latency());
+    printf("%-10s %8s %8s %8s %8s\n", "error px", "mean", "p50", "p95", "max");
+    printf("%-10s %8.1f %8.1f %8.1f %8.1f\n", "raw", raw_mean, percentile(err_raw, 0.50), percentile(err_raw, 0.95),
+           percentile(err_raw, 1.0));
+    printf("%-10s %8.1f %8.1f %8.1f %8.1f\n", "predicted", pred_mean, percentile(err_pred, 0.50),
+           percentile(err_pred, 0.95), percentile(err_pred, 1.0));
+    if (raw_mean > 0) {
+        printf("prediction removes %.0f%% of the mean lag error\n", 100.0 * (1.0 - pred_mean / raw_mean));
+    }
+
+    int rc = 0;
+    if (err_pred.empty()) {
+        fprintf(stderr, "no redraw could be scored\n");
+        rc = 1;
+    } else if (pred_mean >= raw_mean) {
+        fprintf(stderr, "prediction did not reduce the error\n");
+        rc = 1;
+    }
+    if (max_error > 0 && pred_mean > max_error) {
+        fprintf(stderr, "mean error %.1f px is over %.1f px\n", pred_mean, max_error);
+        rc = 1;
+    }
+    return rc;
+}
@@ -0,0 +1,262 @@
+/*
+ * trace_json: convert a pipeline_trace dump (src/trace/pipeline_trace.h) to
+ * Chrome trace-event JSON, for chrome://tracing or ui.perfetto.dev.
+ *
+ *   g++ -O2 -o trace_json trace_json.cpp
+ *   ./trace_json [-o trace.json] [--dump N] capture.bin
+ *
+ * The input is anything that contains a dump: a raw capture of the serial
+ * port (text before and after it is skipped), or the file jpeg_bench --trace
+ * writes. Blocks whose CRC does not match are ignored; with several dumps
+ * the last one is converted unless --dump picks another. Begin/end records
+ * become slices on one track per core, LCD transfers become async slices
+ * from tx_color() to their done interrupt, and a per-event summary (count,
+ * total, mean and max duration, share of the traced time) goes to stderr.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "../../src/trace/pipeline_trace.h"
+
+#define TRACE_HEADER_BYTES (16)
+
+typedef struct {
+    std::vector<std::string> names;
+    std::vector<trace_record_t> records;
+    uint32_t overwritten;
+} dump_t;
+
+typedef struct {
+    uint32_t count;
+    uint64_t total_us;
+    uint32_t max_us;
+} event_sum_t;
+
+static uint32_t le32(const uint8_t *p)
+{
+    return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint32_t crc32(const uint8_t *p, size_t len)
+{
+    uint32_t c = 0xFFFFFFFFu;
+    while (len--) {
+        c ^= *p++;
+        for (int k = 0; k < 8; k++) {
+            c = (c >> 1) ^ (0xEDB88320u & (0u - (c & 1)));
+        }
+    }
+    return ~c;
+}
+
+// A valid dump starting at p, or false
+static bool parse(const uint8_t *p, size_t avail, dump_t *d)
+{
+    if (avail < TRACE_HEADER_BYTES || memcmp(p, PIPELINE_TRACE_MAGIC, 4) != 0 || p[4] != PIPELINE_TRACE_VERSION ||
+        p[5] != sizeof(trace_record_t)) {
+        return false;
+    }
+    int events = p[6];
+    uint32_t count = le32(p + 8);
+    size_t pos = TRACE_HEADER_BYTES;
+
+    d->names.clear();
+    for (int e = 0; e < events; e++) {
+        if (pos >= avail || pos + 1 + p[pos] > avail) {
+            return false;
+        }
+        d->names.push_back(std::string((const char *)p + pos + 1, p[pos]));
+        pos += 1 + p[pos];
+    }
+    if ((avail - pos) / sizeof(trace_record_t) < count || avail - pos - count * sizeof(trace_record_t) < 4) {
+        return false;
+    }
+    size_t body = pos + count * sizeof(trace_record_t);
+    if (crc32(p, body) != le32(p + body)) {
+        return false;
+    }
+    d->records.resize(count);
+    for (uint32_t i = 0; i < count; i++) {
+        const uint8_t *r = p + pos + i * sizeof(trace_record_t);
+        d->records[i].us = le32(r);
+        d->records[i].arg = r[4] | r[5] << 8;
+        d->records[i].event = r[6];
+        d->records[i].flags = r[7];
+    }
+    d->overwritten = le32(p + 12);
+    return true;
+}
+
+static int track(uint8_t flags)
+{
+    return ((flags >> 4) & 1) * 2 + ((flags >> 3) & 1);
+}
+
+int main(int argc, char **argv)
+{
+    const char *in_path = NULL;
+    const char *out_path = NULL;
+    int pick = -1;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            out_path = argv[++i];
+        } else if (strcmp(argv[i], "--dump") == 0 && i + 1 < argc) {
+            pick = atoi(argv[++i]);
+        } else if (argv[i][0] != '-' && in_path == NULL) {
+            in_path = argv[i];
+        } else {
+            in_path = NULL;
+            break;
+        }
+    }
+    if (in_path == NULL) {
+        fprintf(stderr, "usage: trace_json [-o OUT.json] [--dump N] CAPTURE\n");
+        return 2;
+    }
+
+    FILE *f = fopen(in_path, "rb");
+    if (f == NULL) {
+        perror(in_path);
+        return 1;
+    }
+    std::vector<uint8_t> buf;
+    uint8_t chunk[65536];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) {
+        buf.insert(buf.end(), chunk, chunk + n);
+    }
+    fclose(f);
+
+    // Every occurrence of the magic that parses and checks out is a dump
+    std::vector<size_t> found;
+    dump_t d;
+    for (size_t i = 0; i + TRACE_HEADER_BYTES <= buf.size(); i++) {
+        if (buf[i] == PIPELINE_TRACE_MAGIC[0] && parse(buf.data() + i, buf.size() - i, &d)) {
+            found.push_back(i);
+        }
+    }
+    if (found.empty()) {
+        fprintf(stderr, "%s: no complete trace dump\n", in_path);
+        return 1;
+    }
+    if (pick < 0) {
+        pick = found.size() - 1;
+    }
+    if (pick >= (int)found.size()) {
+        fprintf(stderr, "%s: %u dump(s), no dump %d\n", in_path, (unsigned)found.size(), pick);
+        return 1;
+    }
+    parse(buf.data() + found[pick], buf.size() - found[pick], &d);
+    if (d.records.empty()) {
+        fprintf(stderr, "%s: dump %d is empty\n", in_path, pick);
+        return 1;
+    }
+
+    FILE *out = out_path != NULL ? fopen(out_path, "w") : stdout;
+    if (out == NULL) {
+        perror(out_path);
+        return 1;
+    }
+    fprintf(out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(out, "{\"ph\":\"M\",\"pid\":1,\"name\":\"process_name\",\"args\":{\"name\":\"decode pipeline\"}}");
+    static const char *track_names[] = { "core 0", "core 1", "isr core 0", "isr core 1" };
+    for (int t = 0; t < 4; t++) {
+        fprintf(out, ",\n{\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"name\":\"thread_name\",\"args\":{\"name\":\"%s\"}}", t, track_names[t]);
+    }
+
+    // Timestamps are the low 32 bits of the microsecond clock: unwrap them against the previous record.
+    // Records from the two cores can be slightly out of order, so time starts at the earliest one
+    std::vector<int64_t> ts(d.records.size());
+    int64_t t = 0, t_min = 0, t_max = 0;
+    for (size_t i = 0; i < d.records.size(); i++) {
+        t += i > 0 ? (int32_t)(d.records[i].us - d.records[i - 1].us) : 0;
+        ts[i] = t;
+        t_min = t < t_min ? t : t_min;
+        t_max = t > t_max ? t : t_max;
+    }
+
+    size_t events = d.names.size();
+    std::vector<event_sum_t> sums(events, event_sum_t{0, 0, 0});
+    std::vector<std::vector<std::pair<int, uint64_t>>> open(4);  // per track: event, begin time
+    std::map<uint32_t, uint64_t> in_flight;                      // async begins not yet ended, by event and arg
+    uint32_t dropped = 0;
+
+    for (size_t i = 0; i < d.records.size(); i++) {
+        const trace_record_t &r = d.records[i];
+        uint64_t now = ts[i] - t_min;
+        if (r.event >= events) {
+            dropped++;
+            continue;
+        }
+        const char *name = d.names[r.event].c_str();
+        int tid = track(r.flags);
+        int phase = r.flags & 7;
+        uint64_t dur = 0;
+        bool ended = false;
+
+        if (phase == TRACE_BEGIN) {
+            open[tid].push_back(std::make_pair((int)r.event, now));
+            fprintf(out, ",\n{\"ph\":\"B\",\"pid\":1,\"tid\":%d,\"ts\":%llu,\"name\":\"%s\",\"args\":{\"arg\":%u}}", tid,
+                    (unsigned long long)now, name, r.arg);
+        } else if (phase == TRACE_END) {
+            // An end whose begin was overwritten, or that does not close the innermost slice, is dropped
+            if (open[tid].empty() || open[tid].back().first != r.event) {
+                dropped++;
+                continue;
+            }
+            dur = now > open[tid].back().second ? now - open[tid].back().second : 0;
+            open[tid].pop_back();
+            ended = true;
+            fprintf(out, ",\n{\"ph\":\"E\",\"pid\":1,\"tid\":%d,\"ts\":%llu,\"name\":\"%s\",\"args\":{\"arg\":%u}}", tid,
+                    (unsigned long long)now, name, r.arg);
+        } else if (phase == TRACE_ASYNC_BEGIN) {
+            in_flight[r.event << 16 | r.arg] = now;
+            fprintf(out, ",\n{\"ph\":\"b\",\"pid\":1,\"tid\":%d,\"ts\":%llu,\"name\":\"%s\",\"cat\":\"async\",\"id\":%u}",
+                    tid, (unsigned long long)now, name, r.arg);
+        } else if (phase == TRACE_ASYNC_END) {
+            // An end whose begin was overwritten has nothing to close
+            std::map<uint32_t, uint64_t>::iterator it = in_flight.find(r.event << 16 | r.arg);
+            if (it == in_flight.end()) {
+                dropped++;
+                continue;
+            }
+            dur = now > it->second ? now - it->second : 0;
+            in_flight.erase(it);
+            ended = true;
+            fprintf(out, ",\n{\"ph\":\"e\",\"pid\":1,\"tid\":%d,\"ts\":%llu,\"name\":\"%s\",\"cat\":\"async\",\"id\":%u}", tid,
+                    (unsigned long long)now, name, r.arg);
+        } else {
+            fprintf(out, ",\n{\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,\"ts\":%llu,\"name\":\"%s\",\"args\":{\"arg\":%u}}", tid,
+                    (unsigned long long)now, name, r.arg);
+        }
+        if (ended) {
+            sums[r.event].count++;
+            sums[r.event].total_us += dur;
+            if (dur > sums[r.event].max_us) {
+                sums[r.event].max_us = dur;
+            }
+        }
+    }
+    fprintf(out, "\n]}\n");
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    uint64_t span = t_max > t_min ? t_max - t_min : 1;
+    fprintf(stderr, "dump %d of %u: %u records over %.3f ms, %u overwritten before the dump, %u unmatched\n", pick,
+            (unsigned)found.size(), (unsigned)d.records.size(), span / 1000.0, d.overwritten, dropped);
+    fprintf(stderr, "%-24s %8s %12s %10s %10s %8s\n", "event", "count", "total ms", "mean us", "max us", "share");
+    for (size_t e = 0; e < events; e++) {
+        const event_sum_t &s = sums[e];
+        if (s.count == 0) {
+            continue;
+        }
+        fprintf(stderr, "%-24s %8u %12.3f %10.1f %10u %7.1f%%\n", d.names[e].c_str(), s.count, s.total_us / 1000.0,
+                (double)s.total_us / s.count, s.max_us, 100.0 * s.total_us / span);
+    }
+    return 0;
+}